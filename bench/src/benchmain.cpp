@@ -0,0 +1,33 @@
+/// @file benchmain.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+///
+/// @section DESCRIPTION
+/// Entry point of the benchmarks. Global operator new is replaced here to count allocations made by the benchmarks.
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "benchutils.h"
+
+static std::atomic<long> allocationCounter(0); //number of calls of operator new
+
+void* operator new(std::size_t size)
+{
+    allocationCounter.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size ? size : 1);
+    if(!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+long GetAllocationCount()
+{
+    return allocationCounter.load(std::memory_order_relaxed);
+}
+
+BENCHMARK_MAIN();
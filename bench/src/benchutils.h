@@ -0,0 +1,58 @@
+/// @file benchutils.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+///
+/// @section DESCRIPTION
+/// Helpers shared by the benchmarks: counting of allocations and per-event counters.
+#ifndef BENCHUTILS_H
+#define BENCHUTILS_H
+#include "benchmark/benchmark.h"
+#include "../../src/parammanager.h"
+
+///
+/// \brief GetAllocationCount Number of calls of the global operator new since the start of the program.
+/// Operator new is replaced in benchmain.cpp.
+///
+long GetAllocationCount();
+
+///
+/// \brief SetEventCounters Sets counters "ns/event" and "allocs/event", which are also written to the JSON output.
+/// \param state State of the benchmark, called after the benchmark loop.
+/// \param eventsPerIteration Number of events processed in one iteration.
+/// \param allocations Number of allocations made in the benchmark loop.
+///
+inline void SetEventCounters(benchmark::State& state, long eventsPerIteration, long allocations)
+{
+    const double events = static_cast<double>(state.iterations())*eventsPerIteration;
+    state.SetItemsProcessed(state.iterations()*eventsPerIteration);
+    //inverted rate of events in units of 1e9 gives nanoseconds per event
+    state.counters["ns/event"] = benchmark::Counter(events*1e-9, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["allocs/event"] = events > 0 ? allocations/events : 0.0;
+}
+
+///
+/// \brief GetBenchParams Parameters of the simulation used by the benchmarks, the same as in the unit tests.
+/// \param events Number of events in a run.
+/// \return ParamManager with the parameters.
+///
+inline ParamManager GetBenchParams(long events)
+{
+    ParamManager pManag;
+    pManag.SetR(437.3);
+    pManag.SetL(500);
+    pManag.SetEff(0.5);
+    pManag.SetP(0.98);
+    pManag.SetE(1157);
+    pManag.SetSeed(123456789);
+    pManag.SetSimEvents(events);
+    pManag.SetUseOfPhantom(true);
+    pManag.SetPhantomNaive511Prob(0.5);
+    pManag.SetPhantomNaivePromptProb(0.5);
+    pManag.SetEventTypeToSave(ALL);
+    pManag.EnableSilentMode();
+    pManag.SetSelectedNuclides(std::vector<std::string>(1, "Sc-44"));
+    pManag.Import2nNdata("../2nN_data.dat");
+    return pManag;
+}
+
+#endif // BENCHUTILS_H
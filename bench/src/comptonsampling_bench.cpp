@@ -0,0 +1,53 @@
+/// @file comptonsampling_bench.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+///
+/// @section DESCRIPTION
+/// Benchmarks of drawing Compton scattering angles. Photons alternate between 511 keV and 1157 keV,
+/// as in 2&1 decays of 44Sc.
+#include "benchmark/benchmark.h"
+#include "../../src/comptonscattering.h"
+#include "../../src/kleinnishinasampler.h"
+#include "../../src/randomstream.h"
+
+static const double kEnergies[2] = {0.511, 1.157};
+
+///
+/// \brief BM_ThetaTF1 Drawing with TF1::GetRandom, which rebuilds its integral whenever the energy changes.
+///
+static void BM_ThetaTF1(benchmark::State& state)
+{
+    ComptonScattering cs(TWOandONE);
+    long n = 0;
+    for(auto _ : state)
+    {
+        cs.fPDF_Theta->SetParameter(0, kEnergies[n++ & 1]);
+        benchmark::DoNotOptimize(cs.fPDF_Theta->GetRandom());
+    }
+}
+BENCHMARK(BM_ThetaTF1);
+
+///
+/// \brief BM_CosThetaTable Drawing with the interpolated inverse CDF table.
+///
+static void BM_CosThetaTable(benchmark::State& state)
+{
+    const KleinNishinaSampler& sampler = KleinNishinaSampler::GetDefault();
+    RandomStream rng(1);
+    long n = 0;
+    for(auto _ : state)
+        benchmark::DoNotOptimize(sampler.SampleCosTheta(kEnergies[n++ & 1], &rng));
+}
+BENCHMARK(BM_CosThetaTable);
+
+///
+/// \brief BM_CosThetaKahn Drawing with Kahn's rejection method.
+///
+static void BM_CosThetaKahn(benchmark::State& state)
+{
+    RandomStream rng(1);
+    long n = 0;
+    for(auto _ : state)
+        benchmark::DoNotOptimize(KleinNishinaSampler::SampleCosThetaKahn(kEnergies[n++ & 1], &rng));
+}
+BENCHMARK(BM_CosThetaKahn);
@@ -0,0 +1,326 @@
+/// @file stages_bench.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+///
+/// @section DESCRIPTION
+/// Benchmarks of every stage of the simulation pipeline and of the whole pipeline. Stages are benchmarked through
+/// their batch entry points (see EventBatch), which are called by SimulationWorker in the event loop. One iteration
+/// processes one block of SimulationWorker::kBlockSize events, the argument of a benchmark is the DecayType.
+/// Every benchmark reports "ns/event" and "allocs/event".
+#include <string>
+#include "benchmark/benchmark.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "benchutils.h"
+#include "../../src/eventbatch.h"
+#include "../../src/particlegenerator.h"
+#include "../../src/psdecay.h"
+#include "../../src/phantom.h"
+#include "../../src/initialcuts.h"
+#include "../../src/comptonscattering.h"
+#include "../../src/rootwriter.h"
+#include "../../src/simulationworker.h"
+#include "../../src/treefiller.h"
+
+static const long kBlock = SimulationWorker::kBlockSize;
+
+///
+/// \brief The StageInput class Block of generated events and objects needed by the stages of the pipeline.
+///
+class StageInput
+{
+    public:
+        ParamManager fParams;
+        TLorentzVector fPs; //four-momentum vector of the source
+        TLorentzVector fSource; //position of the source
+        DecayType fType;
+        int fMaxDecayProducts;
+        PhaseSpaceGenerator fGenerator; //generic generator, for comparison
+        MasslessPhaseSpace fMasslessGenerator; //generator used by SimulationWorker
+        RandomStream fRandom;
+        EventBatch fBatch; //generated events, processed by the stages up to the benchmarked one
+        EventBatch fWork; //copy of fBatch modified by the benchmarked stage
+
+        StageInput(DecayType type, int maxDecayProducts) :
+            fParams(GetBenchParams(kBlock)),
+            fPs(0.0, 0.0, 0.0, 1.022/1000),
+            fSource(0.0, 0.0, 0.0, 10.0),
+            fType(type),
+            fMaxDecayProducts(maxDecayProducts),
+            fMasslessGenerator(kBlock),
+            fRandom(fParams.GetSeed()),
+            fBatch(type, kBlock, maxDecayProducts),
+            fWork(type, kBlock, maxDecayProducts)
+        {
+            int noOfGammas = 0;
+            recognizeType(type, noOfGammas);
+            if(noOfGammas>1)
+            {
+                double masses[3] = {0.0, 0.0, 0.0};
+                fGenerator.SetDecay(fPs, noOfGammas, masses);
+                fMasslessGenerator.SetDecay(fPs, noOfGammas);
+            }
+            generateEvents(fBatch, 0, kBlock, fMasslessGenerator, fSource, fParams, &fRandom);
+        }
+};
+
+///
+/// \brief GetMaxDecayProducts The highest possible number of photons in an event of the given type.
+/// \param type Type of decays.
+/// \param pManag Parameters of the simulation.
+/// \return Maximal number of photons.
+///
+static int GetMaxDecayProducts(DecayType type, const ParamManager& pManag)
+{
+    int noOfGammas = 0;
+    recognizeType(type, noOfGammas);
+    int maxDecayProducts = type==TWOandONE ? noOfGammas+1 : noOfGammas;
+    if(type==TWOandN)
+    {
+        //only one decay branch is realized in an event
+        int maxBranchSize = 0;
+        for(int ii=0; ii<pManag.GetNumberOfDecayBranches(); ii++)
+            maxBranchSize = pManag.GetBranchSize(ii) > maxBranchSize ? pManag.GetBranchSize(ii) : maxBranchSize;
+        maxDecayProducts += maxBranchSize;
+    }
+    return maxDecayProducts;
+}
+
+///
+/// \brief CreateInput Creates the input of a stage benchmark, or skips the benchmark if 2&N data are missing.
+/// \param state State of the benchmark, its argument is the DecayType.
+/// \return Input of the benchmark, nullptr if the benchmark is skipped.
+///
+static StageInput* CreateInput(benchmark::State& state)
+{
+    const DecayType type = static_cast<DecayType>(state.range(0));
+    ParamManager pManag = GetBenchParams(kBlock);
+    if(type==TWOandN && !pManag.Is2nNDataImported())
+    {
+        state.SkipWithError("2&N data not found in ../2nN_data.dat");
+        return nullptr;
+    }
+    return new StageInput(type, GetMaxDecayProducts(type, pManag));
+}
+
+///
+/// \brief BM_GenerateEvents Generation of decays with MasslessPhaseSpace, as in SimulationWorker.
+///
+static void BM_GenerateEvents(benchmark::State& state)
+{
+    StageInput* input = CreateInput(state);
+    if(!input)
+        return;
+    long block = 0;
+    const long allocations = GetAllocationCount();
+    for(auto _ : state)
+    {
+        generateEvents(input->fWork, (block++)*kBlock, kBlock, input->fMasslessGenerator, input->fSource, input->fParams, &input->fRandom);
+        benchmark::DoNotOptimize(input->fWork.fPx.data());
+    }
+    SetEventCounters(state, kBlock, GetAllocationCount()-allocations);
+    delete input;
+}
+BENCHMARK(BM_GenerateEvents)->Arg(ONE)->Arg(TWO)->Arg(THREE)->Arg(TWOandONE)->Arg(TWOandN);
+
+///
+/// \brief BM_GenerateEventsGeneric Generation of the same decays with the generic PhaseSpaceGenerator, event by event.
+///
+static void BM_GenerateEventsGeneric(benchmark::State& state)
+{
+    StageInput* input = CreateInput(state);
+    if(!input)
+        return;
+    long block = 0;
+    const long allocations = GetAllocationCount();
+    for(auto _ : state)
+    {
+        generateEvents(input->fWork, (block++)*kBlock, kBlock, input->fGenerator, input->fSource, input->fParams, &input->fRandom);
+        benchmark::DoNotOptimize(input->fWork.fPx.data());
+    }
+    SetEventCounters(state, kBlock, GetAllocationCount()-allocations);
+    delete input;
+}
+BENCHMARK(BM_GenerateEventsGeneric)->Arg(TWO)->Arg(THREE)->Arg(TWOandONE);
+
+///
+/// \brief BM_PsDecayAddEvents Filling of histograms of generated events.
+///
+static void BM_PsDecayAddEvents(benchmark::State& state)
+{
+    StageInput* input = CreateInput(state);
+    if(!input)
+        return;
+    PsDecay decay(input->fType);
+    decay.EnableSilentMode();
+    const long allocations = GetAllocationCount();
+    for(auto _ : state)
+        decay.AddEvents(input->fBatch);
+    SetEventCounters(state, kBlock, GetAllocationCount()-allocations);
+    delete input;
+}
+BENCHMARK(BM_PsDecayAddEvents)->Arg(TWO)->Arg(THREE)->Arg(TWOandONE);
+
+///
+/// \brief BM_PhantomNaiveScatter Scattering in the phantom. Generated events are restored before every iteration.
+///
+static void BM_PhantomNaiveScatter(benchmark::State& state)
+{
+    StageInput* input = CreateInput(state);
+    if(!input)
+        return;
+    Phantom phantom(input->fParams.GetPhantomNaive511Prob(), input->fParams.GetPhantomNaivePromptProb(),\
+                    input->fParams.GetPhantomSmear(), input->fType);
+    RandomStream rng(input->fParams.GetSeed());
+    const long allocations = GetAllocationCount();
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        input->fWork = input->fBatch;
+        state.ResumeTiming();
+        phantom.NaiveScatter(input->fWork, &rng);
+    }
+    SetEventCounters(state, kBlock, GetAllocationCount()-allocations);
+    delete input;
+}
+BENCHMARK(BM_PhantomNaiveScatter)->Arg(TWO)->Arg(THREE)->Arg(TWOandONE);
+
+///
+/// \brief BM_InitialCutsAddCuts Calculation of hit points and detection cuts.
+///
+static void BM_InitialCutsAddCuts(benchmark::State& state)
+{
+    StageInput* input = CreateInput(state);
+    if(!input)
+        return;
+    InitialCuts cuts(input->fType, input->fParams.GetR(), input->fParams.GetL(), input->fParams.GetEff());
+    cuts.EnableSilentMode();
+    RandomStream rng(input->fParams.GetSeed());
+    input->fWork = input->fBatch;
+    const long allocations = GetAllocationCount();
+    for(auto _ : state)
+        cuts.AddCuts(input->fWork, &rng); //cuts overwrite all their results, so the input does not have to be restored
+    SetEventCounters(state, kBlock, GetAllocationCount()-allocations);
+    delete input;
+}
+BENCHMARK(BM_InitialCutsAddCuts)->Arg(TWO)->Arg(THREE)->Arg(TWOandONE);
+
+///
+/// \brief BM_ComptonScatter Compton scattering in the detector of events which passed the cuts.
+///
+static void BM_ComptonScatter(benchmark::State& state)
+{
+    StageInput* input = CreateInput(state);
+    if(!input)
+        return;
+    InitialCuts cuts(input->fType, input->fParams.GetR(), input->fParams.GetL(), input->fParams.GetEff());
+    cuts.EnableSilentMode();
+    ComptonScattering compton(input->fType, input->fParams.GetSmearLowLimit(), input->fParams.GetSmearHighLimit());
+    compton.EnableSilentMode();
+    compton.SetSamplingMethod(input->fParams.GetComptonSampling());
+    RandomStream rng(input->fParams.GetSeed());
+    input->fWork = input->fBatch;
+    cuts.AddCuts(input->fWork, &rng);
+    const long allocations = GetAllocationCount();
+    for(auto _ : state)
+        compton.Scatter(input->fWork, &rng); //deposited energies are overwritten, the input does not have to be restored
+    SetEventCounters(state, kBlock, GetAllocationCount()-allocations);
+    delete input;
+}
+BENCHMARK(BM_ComptonScatter)->Arg(TWO)->Arg(THREE)->Arg(TWOandONE);
+
+///
+/// \brief BM_TreeFilling Writing of processed events to a tree in a file, the second argument is the TreeSchema.
+/// The tree is filled by the calling thread, so the benchmark measures the cost of filling, not of the queue.
+///
+static void BM_TreeFilling(benchmark::State& state)
+{
+    StageInput* input = CreateInput(state);
+    if(!input)
+        return;
+    const TreeSchema schema = static_cast<TreeSchema>(state.range(1));
+    TFile file("stages_bench_tree.root", "RECREATE");
+    TTree* tree = new TTree("Tree", "Tree");
+    RootWriter writer(false);
+    TreeFiller* filler = new TreeFiller(tree, writer, input->fType, input->fMaxDecayProducts, kBlock, true, schema);
+    input->fWork = input->fBatch;
+    input->fWork.CalculateHitPoints(input->fParams.GetR(), input->fParams.GetL());
+    input->fWork.DeducePassFlags();
+    const long allocations = GetAllocationCount();
+    for(auto _ : state)
+    {
+        for(int ii=0; ii<input->fWork.GetSize(); ii++)
+        {
+            Event* event = filler->AcquireEvent();
+            input->fWork.CopyToEvent(ii, *event);
+            filler->Push(event);
+        }
+        filler->Flush();
+    }
+    SetEventCounters(state, kBlock, GetAllocationCount()-allocations);
+    delete filler;
+    delete tree;
+    file.Close();
+    delete input;
+}
+BENCHMARK(BM_TreeFilling)->Args({TWOandONE, OBJECT})->Args({TWOandONE, FLAT});
+
+///
+/// \brief BM_EndToEnd Whole pipeline of SimulationWorker with writing of all events to a tree, as in simulateDecay.
+/// Events are filled into the tree by the writer thread, so the wall time is measured. The second argument is
+/// the OutputOptions: TREE fills all histograms, HEADLESS creates none of them.
+///
+static void BM_EndToEnd(benchmark::State& state)
+{
+    const DecayType type = static_cast<DecayType>(state.range(0));
+    const long noOfBlocks = 10;
+    ParamManager pManag = GetBenchParams(noOfBlocks*kBlock);
+    pManag.SetOutputType(static_cast<OutputOptions>(state.range(1)));
+    TFile file("stages_bench_e2e.root", "RECREATE");
+    TTree* tree = new TTree("Tree", "Tree");
+    RootWriter writer(true);
+    SimulationWorker* worker = new SimulationWorker(TLorentzVector(0.0, 0.0, 0.0, 1.022/1000), TLorentzVector(0.0, 0.0, 0.0, 10.0),\
+                                                    pManag, type, 0, true);
+    TreeFiller* filler = new TreeFiller(tree, writer, type, worker->GetMaxDecayProducts(), pManag.GetOutputQueueSize(), true);
+    const long allocations = GetAllocationCount();
+    for(auto _ : state)
+    {
+        for(long block=0; block<noOfBlocks; block++)
+        {
+            worker->ProcessBlock(block);
+            for(long ii=0; ii<worker->GetNumberOfStoredEvents(); ii++)
+                filler->Push(worker->ExchangeStoredEvent(ii, filler->AcquireEvent()));
+            worker->ClearStoredEvents();
+        }
+        filler->Flush();
+    }
+    SetEventCounters(state, noOfBlocks*kBlock, GetAllocationCount()-allocations);
+    delete filler;
+    delete worker;
+    writer.Execute([&](){delete tree; file.Close();});
+}
+BENCHMARK(BM_EndToEnd)->Args({TWO, TREE})->Args({TWO, HEADLESS})->Args({THREE, TREE})->Args({THREE, HEADLESS})\
+    ->Args({TWOandONE, TREE})->Args({TWOandONE, HEADLESS})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+///
+/// \brief BM_EarlyReject Pipeline of SimulationWorker saving only passed events, for a short detector and an off-centre source
+/// (low acceptance). The second argument enables the removal of events that missed the detector right after generation.
+///
+static void BM_EarlyReject(benchmark::State& state)
+{
+    const DecayType type = static_cast<DecayType>(state.range(0));
+    ParamManager pManag = GetBenchParams(kBlock);
+    pManag.SetL(50);
+    pManag.SetOutputType(HEADLESS);
+    pManag.SetEventTypeToSave(PASS);
+    pManag.SetEarlyReject(state.range(1)!=0);
+    SimulationWorker worker(TLorentzVector(0.0, 0.0, 0.0, 1.022/1000), TLorentzVector(200.0, 0.0, 0.0, 10.0), pManag, type, 0, true);
+    const long allocations = GetAllocationCount();
+    for(auto _ : state)
+    {
+        worker.ClearStoredEvents();
+        worker.ProcessBlock(0);
+    }
+    SetEventCounters(state, kBlock, GetAllocationCount()-allocations);
+}
+BENCHMARK(BM_EarlyReject)->Args({TWO, 0})->Args({TWO, 1})->Args({THREE, 0})->Args({THREE, 1})->Args({TWOandONE, 0})->Args({TWOandONE, 1});
@@ -0,0 +1,139 @@
+/// @file treeschema_bench.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+///
+/// @section DESCRIPTION
+/// Comparison of the tree schemas: Event objects in the split branch "event_split" (OBJECT) and one branch per
+/// column (FLAT). Writing reports the compressed size per event, reading sums the smeared deposited energy with
+/// RDataFrame and reports the throughput in bytes of the file per second.
+#include <string>
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "ROOT/RDataFrame.hxx"
+#include "TFile.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "../../src/flatevent.h"
+#include "../../src/simulationworker.h"
+
+static const long kEvents = 10*SimulationWorker::kBlockSize;
+
+///
+/// \brief GetEvents Simulates 2&1 events once, they are shared by all benchmarks.
+/// \return Simulated events.
+///
+static const std::vector<Event*>& GetEvents()
+{
+    static std::vector<Event*> events;
+    if(!events.empty())
+        return events;
+    static ParamManager pManag;
+    pManag.SetR(437.3);
+    pManag.SetL(500);
+    pManag.SetEff(0.5);
+    pManag.SetP(0.98);
+    pManag.SetE(1157);
+    pManag.SetSeed(123456789);
+    pManag.SetSimEvents(kEvents);
+    pManag.SetEventTypeToSave(ALL);
+    pManag.EnableSilentMode();
+    SimulationWorker worker(TLorentzVector(0.0, 0.0, 0.0, 1.022/1000), TLorentzVector(0.0, 0.0, 0.0, 10.0), pManag, TWOandONE, 0, true);
+    for(long block=0; block<SimulationWorker::GetNumberOfBlocks(kEvents); block++)
+    {
+        worker.ProcessBlock(block);
+        for(long ii=0; ii<worker.GetNumberOfStoredEvents(); ii++)
+            events.push_back(new Event(*worker.GetStoredEvent(ii)));
+        worker.ClearStoredEvents();
+    }
+    return events;
+}
+
+///
+/// \brief GetFileName Name of the file written by the benchmarks of a schema.
+/// \param schema Layout of events in the tree.
+/// \return Name of the file.
+///
+static std::string GetFileName(TreeSchema schema)
+{
+    return schema==FLAT ? "treeschema_bench_flat.root" : "treeschema_bench_object.root";
+}
+
+///
+/// \brief WriteTree Writes all events to a file in the selected schema.
+/// \param schema Layout of events in the tree.
+/// \return Size of the file [bytes].
+///
+static Long64_t WriteTree(TreeSchema schema)
+{
+    const std::vector<Event*>& events = GetEvents();
+    TFile file(GetFileName(schema).c_str(), "RECREATE");
+    TTree* tree = new TTree("Tree", "Tree");
+    FlatEvent flat(3);
+    Event* event = events[0];
+    if(schema==FLAT)
+        flat.Attach(tree);
+    else
+        tree->Branch("event_split", "Event", &event, 32000, 99);
+    for(std::vector<Event*>::const_iterator it = events.begin(); it != events.end(); ++it)
+    {
+        if(schema==FLAT)
+            flat.Set(**it);
+        else
+            event = *it;
+        tree->Fill();
+    }
+    tree->Write();
+    tree->ResetBranchAddresses();
+    delete tree;
+    file.Close();
+    FileStat_t stat;
+    gSystem->GetPathInfo(GetFileName(schema).c_str(), stat);
+    return stat.fSize;
+}
+
+///
+/// \brief BM_WriteTree Writing events to a file, the argument is the schema (0: OBJECT, 1: FLAT).
+///
+static void BM_WriteTree(benchmark::State& state)
+{
+    const TreeSchema schema = static_cast<TreeSchema>(state.range(0));
+    const std::vector<Event*>& events = GetEvents();
+    Long64_t size = 0;
+    for(auto _ : state)
+        size = WriteTree(schema);
+    state.SetItemsProcessed(state.iterations()*events.size());
+    state.SetBytesProcessed(state.iterations()*size);
+    state.counters["bytes/event"] = size/static_cast<double>(events.size());
+}
+BENCHMARK(BM_WriteTree)->Arg(OBJECT)->Arg(FLAT)->Unit(benchmark::kMillisecond);
+
+///
+/// \brief BM_ReadRDataFrame Summing the smeared deposited energy with RDataFrame, the argument is the schema
+/// (0: OBJECT, 1: FLAT).
+///
+static void BM_ReadRDataFrame(benchmark::State& state)
+{
+    const TreeSchema schema = static_cast<TreeSchema>(state.range(0));
+    const Long64_t size = WriteTree(schema);
+    const std::string fileName = GetFileName(schema);
+    for(auto _ : state)
+    {
+        ROOT::RDataFrame df("Tree", fileName);
+        if(schema==FLAT)
+            benchmark::DoNotOptimize(*df.Define("edepSum", "Sum(edepSmear)").Sum<double>("edepSum"));
+        else
+        {
+            auto sumEvent = [](const Event& event)
+            {
+                double sum = 0.0;
+                for(int ii=0; ii<event.GetNumberOfDecayProducts(); ii++)
+                    sum += event.GetEdepSmearOf(ii);
+                return sum;
+            };
+            benchmark::DoNotOptimize(*df.Define("edepSum", sumEvent, {"event_split"}).Sum<double>("edepSum"));
+        }
+    }
+    state.SetItemsProcessed(state.iterations()*GetEvents().size());
+    state.SetBytesProcessed(state.iterations()*size);
+}
+BENCHMARK(BM_ReadRDataFrame)->Arg(OBJECT)->Arg(FLAT)->Unit(benchmark::kMillisecond);
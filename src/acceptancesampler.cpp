@@ -0,0 +1,155 @@
+/// @file acceptancesampler.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <string>
+#include "TMath.h"
+#include "decaytraits.h"
+#include "acceptancesampler.h"
+
+///
+/// \brief AcceptanceSampler::AcceptanceSampler Basic constructor.
+/// \param R Radius of the detector [mm].
+/// \param L Length of the detector [mm].
+///
+AcceptanceSampler::AcceptanceSampler(double R, double L) :
+    fR_(R),
+    fL_(L)
+{}
+
+///
+/// \brief AcceptanceSampler::SampleDirection Draws a direction, in which a photon emitted from the given point hits the barrel.
+/// The emission point has to be inside the barrel (x0*x0+y0*y0 < R*R).
+/// \param x0 X coordinate of the emission point [mm].
+/// \param y0 Y coordinate of the emission point [mm].
+/// \param z0 Z coordinate of the emission point [mm].
+/// \param u1 Uniform random number from [0, 1), used for the azimuthal angle.
+/// \param u2 Uniform random number from [0, 1), used for the polar angle.
+/// \param direction Array filled with the unit vector of the direction.
+/// \return Ratio of the isotropic density to the density of the sampled direction, i.e. the factor of the weight.
+///
+double AcceptanceSampler::SampleDirection(double x0, double y0, double z0, double u1, double u2, double* direction) const
+{
+    double phi = 2*TMath::Pi()*u1;
+    double cosPhi = TMath::Cos(phi);
+    double sinPhi = TMath::Sin(phi);
+    //horizontal distance to the side surface along the azimuthal direction
+    double a = x0*cosPhi+y0*sinPhi;
+    double distance = -a+TMath::Sqrt(a*a+fR_*fR_-x0*x0-y0*y0);
+    //the photon hits the barrel if cot(theta) is between the bounds
+    double cotLow = (-fL_/2.0-z0)/distance;
+    double cotHigh = (fL_/2.0-z0)/distance;
+    double cosLow = cotLow/TMath::Sqrt(1+cotLow*cotLow);
+    double cosHigh = cotHigh/TMath::Sqrt(1+cotHigh*cotHigh);
+    double cosTheta = cosLow+(cosHigh-cosLow)*u2;
+    double sinTheta = TMath::Sqrt(TMath::Max(0.0, 1-cosTheta*cosTheta));
+    direction[0] = sinTheta*cosPhi;
+    direction[1] = sinTheta*sinPhi;
+    direction[2] = cosTheta;
+    //isotropic density is 1/(4pi), the sampled one 1/(2pi)/(cosHigh-cosLow)
+    return (cosHigh-cosLow)/2.0;
+}
+
+///
+/// \brief AcceptanceSampler::Rotate Rotates momenta by the rotation of the smallest angle, which maps one direction onto another.
+/// \param from Unit vector of the direction before the rotation.
+/// \param to Unit vector of the direction after the rotation.
+/// \param n Number of momenta.
+/// \param px X components of momenta.
+/// \param py Y components of momenta.
+/// \param pz Z components of momenta.
+/// \param stride Distance between consecutive momenta in the arrays.
+///
+void AcceptanceSampler::Rotate(const double* from, const double* to, int n, double* px, double* py, double* pz, int stride)
+{
+    double c = from[0]*to[0]+from[1]*to[1]+from[2]*to[2];
+    if(c > -1+1e-12)
+    {
+        //Rodrigues formula with the axis k=from x to, where |k|=sin and (1-cos)/sin^2=1/(1+cos)
+        double k[3] = {from[1]*to[2]-from[2]*to[1], from[2]*to[0]-from[0]*to[2], from[0]*to[1]-from[1]*to[0]};
+        double f = 1/(1+c);
+        for(int ii=0; ii<n*stride; ii+=stride)
+        {
+            double v[3] = {px[ii], py[ii], pz[ii]};
+            double kv = (k[0]*v[0]+k[1]*v[1]+k[2]*v[2])*f;
+            px[ii] = v[0]*c+k[1]*v[2]-k[2]*v[1]+k[0]*kv;
+            py[ii] = v[1]*c+k[2]*v[0]-k[0]*v[2]+k[1]*kv;
+            pz[ii] = v[2]*c+k[0]*v[1]-k[1]*v[0]+k[2]*kv;
+        }
+    }
+    else
+    {
+        //opposite directions, rotation by pi around an axis perpendicular to them
+        int axis = TMath::Abs(from[0]) < TMath::Abs(from[1]) ? (TMath::Abs(from[0]) < TMath::Abs(from[2]) ? 0 : 2) : (TMath::Abs(from[1]) < TMath::Abs(from[2]) ? 1 : 2);
+        double e[3] = {0.0, 0.0, 0.0};
+        e[axis] = 1.0;
+        double u[3] = {from[1]*e[2]-from[2]*e[1], from[2]*e[0]-from[0]*e[2], from[0]*e[1]-from[1]*e[0]};
+        double norm = TMath::Sqrt(u[0]*u[0]+u[1]*u[1]+u[2]*u[2]);
+        u[0] /= norm;
+        u[1] /= norm;
+        u[2] /= norm;
+        for(int ii=0; ii<n*stride; ii+=stride)
+        {
+            double uv = 2*(u[0]*px[ii]+u[1]*py[ii]+u[2]*pz[ii]);
+            px[ii] = u[0]*uv-px[ii];
+            py[ii] = u[1]*uv-py[ii];
+            pz[ii] = u[2]*uv-pz[ii];
+        }
+    }
+}
+
+///
+/// \brief AcceptanceSampler::Sample Draws directions of first photons of all events of a batch inside the acceptance
+/// of the barrel and corrects weights of events. Events emitted outside the barrel are left unchanged.
+/// \tparam kType Type of decays stored in the batch.
+/// \param batch Batch of generated events, decays have to be isotropic.
+/// \param rng Random number generator, switched to the substream of every event before it is sampled.
+///
+template<DecayType kType>
+void AcceptanceSampler::Sample(EventBatch& batch, RandomStream* rng)
+{
+    double from[3];
+    double to[3];
+    for(int jj=0; jj<batch.GetSize(); jj++)
+    {
+        rng->SetSubstream(batch.GetIndexInRun(jj));
+        double u1 = rng->Rndm();
+        double u2 = rng->Rndm();
+        const int first = batch.Index(0, jj);
+        double x0 = batch.fX[first];
+        double y0 = batch.fY[first];
+        if(x0*x0+y0*y0 >= fR_*fR_)
+            continue;
+        double p = TMath::Sqrt(batch.fPx[first]*batch.fPx[first]+batch.fPy[first]*batch.fPy[first]+batch.fPz[first]*batch.fPz[first]);
+        if(!(p > 0))
+            continue;
+        from[0] = batch.fPx[first]/p;
+        from[1] = batch.fPy[first]/p;
+        from[2] = batch.fPz[first]/p;
+        batch.fWeight[jj] *= SampleDirection(x0, y0, batch.fZ[first], u1, u2, to);
+        Rotate(from, to, batch.GetNumberOfDecayProducts<kType>(jj), &batch.fPx[first], &batch.fPy[first], &batch.fPz[first], batch.GetCapacity());
+    }
+}
+
+template void AcceptanceSampler::Sample<ONE>(EventBatch& batch, RandomStream* rng);
+template void AcceptanceSampler::Sample<TWO>(EventBatch& batch, RandomStream* rng);
+template void AcceptanceSampler::Sample<THREE>(EventBatch& batch, RandomStream* rng);
+template void AcceptanceSampler::Sample<TWOandONE>(EventBatch& batch, RandomStream* rng);
+template void AcceptanceSampler::Sample<TWOandN>(EventBatch& batch, RandomStream* rng);
+
+///
+/// \brief AcceptanceSampler::Sample The same as the template version, the type of decays is taken from the batch.
+/// \param batch Batch of generated events, decays have to be isotropic.
+/// \param rng Random number generator, switched to the substream of every event before it is sampled.
+///
+void AcceptanceSampler::Sample(EventBatch& batch, RandomStream* rng)
+{
+    switch(batch.GetDecayType())
+    {
+        case ONE: Sample<ONE>(batch, rng); break;
+        case TWO: Sample<TWO>(batch, rng); break;
+        case THREE: Sample<THREE>(batch, rng); break;
+        case TWOandONE: Sample<TWOandONE>(batch, rng); break;
+        case TWOandN: Sample<TWOandN>(batch, rng); break;
+        default: throw(std::string("[ERROR] Wrong decay type of EventBatch!"));
+    }
+}
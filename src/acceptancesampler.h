@@ -0,0 +1,38 @@
+/// @file acceptancesampler.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef ACCEPTANCESAMPLER_H
+#define ACCEPTANCESAMPLER_H
+#include "event.h"
+#include "eventbatch.h"
+#include "randomstream.h"
+
+///
+/// \brief The AcceptanceSampler class Importance sampling of the direction of the first photon inside the geometrical
+/// acceptance of the barrel.
+///
+/// The direction of the first photon is drawn only from the solid angle subtended by the side surface of the cylinder
+/// of radius R and length L, as seen from the emission point: the azimuthal angle is drawn uniformly and the cosine of
+/// the polar angle uniformly between the bounds in which the photon hits the barrel. All photons of the event are rotated
+/// by the same rotation, so the relative angles are preserved, and the weight of the event is multiplied by the ratio of
+/// isotropic and sampled densities. This is exact only for isotropic decays (source at rest). Weighted sums over events
+/// in which the first photon is required to hit the detector (e.g. events that passed cuts) are the same as in unbiased
+/// runs, unweighted counts and histograms describe the biased sample.
+///
+class AcceptanceSampler
+{
+    public:
+        AcceptanceSampler(double R=437.3, double L=500);
+        void Sample(EventBatch& batch, RandomStream* rng);
+        template<DecayType kType> void Sample(EventBatch& batch, RandomStream* rng);
+        double SampleDirection(double x0, double y0, double z0, double u1, double u2, double* direction) const;
+        static void Rotate(const double* from, const double* to, int n, double* px, double* py, double* pz, int stride=1);
+        inline double GetRadius() const {return fR_;}
+        inline double GetLength() const {return fL_;}
+
+    private:
+        double fR_; //radius of the detector [mm]
+        double fL_; //length of the detector [mm]
+};
+
+#endif // ACCEPTANCESAMPLER_H
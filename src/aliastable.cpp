@@ -0,0 +1,86 @@
+/// @file aliastable.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <string>
+#include "aliastable.h"
+
+///
+/// \brief AliasTable::AliasTable Builds the table for the given weights, see Build.
+/// \param weights Non-negative weights of indices, they do not have to be normalized.
+///
+AliasTable::AliasTable(const std::vector<double>& weights)
+{
+    Build(weights);
+}
+
+///
+/// \brief AliasTable::Build Builds the table with Vose's algorithm.
+/// \param weights Non-negative weights of indices, they do not have to be normalized. An empty table is built if there are no weights.
+///
+void AliasTable::Build(const std::vector<double>& weights)
+{
+    const int n = weights.size();
+    double sum = 0.0;
+    for(int ii=0; ii<n; ii++)
+    {
+        if(!(weights[ii] >= 0.0))
+            throw(std::string("[ERROR] Negative weight in AliasTable!"));
+        sum += weights[ii];
+    }
+    if(n > 0 && !(sum > 0.0))
+        throw(std::string("[ERROR] All weights in AliasTable are zero!"));
+    fProbability_.assign(n, 1.0);
+    fAlias_.resize(n);
+    //weights scaled so that their mean is 1, columns are split into the ones below and above the mean
+    std::vector<double> scaled(n);
+    std::vector<int> small;
+    std::vector<int> large;
+    for(int ii=0; ii<n; ii++)
+    {
+        fAlias_[ii] = ii;
+        scaled[ii] = weights[ii]*n/sum;
+        if(scaled[ii] < 1.0)
+            small.push_back(ii);
+        else
+            large.push_back(ii);
+    }
+    //every small column is filled up to 1 with a large one, which becomes its alias
+    while(!small.empty() && !large.empty())
+    {
+        int less = small.back();
+        small.pop_back();
+        int more = large.back();
+        fProbability_[less] = scaled[less];
+        fAlias_[less] = more;
+        scaled[more] = (scaled[more]+scaled[less])-1.0;
+        if(scaled[more] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    //remaining columns are full up to rounding errors
+    for(unsigned ii=0; ii<large.size(); ii++)
+        fProbability_[large[ii]] = 1.0;
+    for(unsigned ii=0; ii<small.size(); ii++)
+        fProbability_[small[ii]] = 1.0;
+}
+
+///
+/// \brief AliasTable::GetProbabilityOf Calculates the probability of drawing an index from the table.
+/// \param index Index to be checked.
+/// \return Probability of drawing the index, it is equal to its normalized weight up to rounding errors.
+///
+double AliasTable::GetProbabilityOf(int index) const
+{
+    const int n = fProbability_.size();
+    if(index < 0 || index >= n)
+        return 0.0;
+    double probability = fProbability_[index];
+    for(int ii=0; ii<n; ii++)
+    {
+        if(fAlias_[ii] == index && ii != index)
+            probability += 1.0-fProbability_[ii];
+    }
+    return probability/n;
+}
@@ -0,0 +1,46 @@
+/// @file aliastable.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef ALIASTABLE_H
+#define ALIASTABLE_H
+#include <vector>
+#include "TRandom.h"
+
+///
+/// \brief The AliasTable class Walker's alias method of drawing from a discrete (categorical) distribution.
+///
+/// The table is built in O(n) time (Vose's algorithm), afterwards every draw takes O(1) time and one random number:
+/// its integer part selects a column and the fractional part decides between the column and its alias.
+///
+class AliasTable
+{
+    public:
+        AliasTable() {}
+        explicit AliasTable(const std::vector<double>& weights);
+        void Build(const std::vector<double>& weights);
+        ///
+        /// \brief Sample Draws an index with probability proportional to its weight.
+        /// \param u Uniform random number from [0, 1).
+        /// \return Drawn index, -1 if the table is empty.
+        ///
+        inline int Sample(double u) const
+        {
+            const int n = fProbability_.size();
+            if(n == 0)
+                return -1;
+            double x = u*n;
+            int column = static_cast<int>(x);
+            column = column < n ? column : n-1;
+            return x-column < fProbability_[column] ? column : fAlias_[column];
+        }
+        inline int Sample(TRandom* rng) const {return Sample(rng->Rndm());}
+        inline int GetSize() const {return fProbability_.size();}
+        double GetProbabilityOf(int index) const;
+        inline bool operator==(const AliasTable& table) const {return fProbability_==table.fProbability_ && fAlias_==table.fAlias_;}
+
+    private:
+        std::vector<double> fProbability_; //probability of keeping the column, otherwise its alias is drawn
+        std::vector<int> fAlias_; //alias of every column
+};
+
+#endif // ALIASTABLE_H
@@ -0,0 +1,106 @@
+/// @file blockoutput.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include "blockoutput.h"
+
+///
+/// \brief BlockOutput::BlockOutput The only constructor used.
+/// \param firstBlock Index of the first block to be taken.
+/// \param window Maximal number of blocks waiting for the output thread (at least 1).
+/// \param type Type of simulated decays.
+/// \param maxDecayProducts Capacity of stored events, see SimulationWorker::GetMaxDecayProducts.
+///
+BlockOutput::BlockOutput(long firstBlock, unsigned window, DecayType type, int maxDecayProducts) :
+    fNextBlock_(firstBlock),
+    fWindow_(window > 0 ? window : 1),
+    fDecayType_(type),
+    fMaxDecayProducts_(maxDecayProducts),
+    fAborted_(false)
+{
+}
+
+///
+/// \brief BlockOutput::~BlockOutput Releases free events and events of blocks that were not taken.
+///
+BlockOutput::~BlockOutput()
+{
+    for(std::map<long, std::vector<Event*> >::iterator it = fReady_.begin(); it != fReady_.end(); ++it)
+        fFree_.insert(fFree_.end(), it->second.begin(), it->second.end());
+    for(std::vector<Event*>::iterator it = fFree_.begin(); it != fFree_.end(); ++it)
+        delete *it;
+}
+
+///
+/// \brief BlockOutput::Put Takes events stored by the worker after simulating the block. Called by worker threads.
+/// Waits while the block is `window` or more blocks ahead of the next block to be taken.
+/// \param block Index of the simulated block.
+/// \param worker Worker that simulated the block, its stored events are replaced with free events and cleared.
+///
+void BlockOutput::Put(long block, SimulationWorker& worker)
+{
+    std::unique_lock<std::mutex> lock(fMutex_);
+    fCondition_.wait(lock, [&]{return fAborted_ || block < fNextBlock_+static_cast<long>(fWindow_);});
+    if(fAborted_)
+        return;
+    std::vector<Event*>& events = fReady_[block];
+    for(long ii=0; ii<worker.GetNumberOfStoredEvents(); ii++)
+    {
+        Event* replacement = nullptr;
+        if(fFree_.empty())
+            replacement = new Event(fDecayType_, fMaxDecayProducts_);
+        else
+        {
+            replacement = fFree_.back();
+            fFree_.pop_back();
+        }
+        events.push_back(worker.ExchangeStoredEvent(ii, replacement));
+    }
+    worker.ClearStoredEvents();
+    lock.unlock();
+    fCondition_.notify_all();
+}
+
+///
+/// \brief BlockOutput::Take Waits until the block is put and moves its events to the vector. Called by the output thread.
+/// \param block Index of the block, blocks must be taken one after another starting from the first block.
+/// \param events Vector, to which events of the block are moved. They are to be returned with Release.
+/// \return False if the output was aborted before the block was put.
+///
+bool BlockOutput::Take(long block, std::vector<Event*>& events)
+{
+    std::unique_lock<std::mutex> lock(fMutex_);
+    fCondition_.wait(lock, [&]{return fAborted_ || fReady_.count(block) > 0;});
+    std::map<long, std::vector<Event*> >::iterator it = fReady_.find(block);
+    if(it == fReady_.end())
+        return false;
+    events.swap(it->second);
+    fReady_.erase(it);
+    fNextBlock_ = block+1;
+    lock.unlock();
+    fCondition_.notify_all();
+    return true;
+}
+
+///
+/// \brief BlockOutput::Release Returns events to the pool of free events, so they are reused by Put.
+/// \param events Events that are no longer needed, the vector is cleared.
+///
+void BlockOutput::Release(std::vector<Event*>& events)
+{
+    std::lock_guard<std::mutex> lock(fMutex_);
+    fFree_.insert(fFree_.end(), events.begin(), events.end());
+    events.clear();
+}
+
+///
+/// \brief BlockOutput::Abort Wakes up all waiting threads, from now on Put ignores blocks and Take returns false
+/// for blocks that were not put. Called when a worker thread fails.
+///
+void BlockOutput::Abort()
+{
+    {
+        std::lock_guard<std::mutex> lock(fMutex_);
+        fAborted_ = true;
+    }
+    fCondition_.notify_all();
+}
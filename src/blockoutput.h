@@ -0,0 +1,47 @@
+/// @file blockoutput.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef BLOCKOUTPUT_H
+#define BLOCKOUTPUT_H
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "event.h"
+#include "simulationworker.h"
+
+///
+/// \brief The BlockOutput class Passes events of simulated blocks from worker threads to the output thread in the order of blocks.
+///
+/// Every worker thread calls Put after simulating a block, which takes stored events out of the worker (replacing them with
+/// free events), so the worker continues with the next block immediately. The output thread calls Take for consecutive
+/// block indices and returns written events with Release. Blocks finished ahead of the next one to be taken wait in the
+/// reorder buffer, which holds at most `window` blocks; a worker that gets further ahead waits in Put, so memory is bounded.
+///
+class BlockOutput
+{
+    public:
+        BlockOutput(long firstBlock, unsigned window, DecayType type, int maxDecayProducts);
+        BlockOutput(const BlockOutput&) = delete;
+        BlockOutput& operator=(const BlockOutput&) = delete;
+        ~BlockOutput();
+
+        void Put(long block, SimulationWorker& worker);
+        bool Take(long block, std::vector<Event*>& events);
+        void Release(std::vector<Event*>& events);
+        void Abort();
+        inline unsigned GetWindow() const {return fWindow_;}
+
+    private:
+        std::mutex fMutex_; //protects all members below
+        std::condition_variable fCondition_; //notifies about put and taken blocks
+        std::map<long, std::vector<Event*> > fReady_; //events of finished blocks, waiting for the output thread
+        std::vector<Event*> fFree_; //events exchanged for stored events of workers
+        long fNextBlock_; //index of the next block to be taken
+        unsigned fWindow_; //maximal number of blocks in the reorder buffer
+        DecayType fDecayType_; //type of decays, used to allocate free events
+        int fMaxDecayProducts_; //capacity of allocated events
+        bool fAborted_; //if true, Put and Take return without waiting
+};
+
+#endif // BLOCKOUTPUT_H
@@ -0,0 +1,87 @@
+/// @file boundedqueue.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+#include <atomic>
+#include <vector>
+
+///
+/// \brief The BoundedQueue class Lock-free ring buffer with one producer and one consumer thread.
+///
+/// TryPush may be called only by the producer and TryPop only by the consumer. The capacity is rounded up to a power of two.
+///
+template<typename T>
+class BoundedQueue
+{
+    public:
+        explicit BoundedQueue(unsigned capacity);
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        bool TryPush(const T& value);
+        bool TryPop(T& value);
+        inline unsigned GetCapacity() const {return fMask_+1;}
+        inline unsigned Size() const {return static_cast<unsigned>(fTail_.load(std::memory_order_acquire)-fHead_.load(std::memory_order_acquire));}
+
+    private:
+        std::vector<T> fBuffer_; //elements of the queue
+        unsigned fMask_; //capacity-1, used to wrap indices
+        //indices are separated by padding, so the producer and the consumer do not write to the same cache line
+        char fPadHead_[64];
+        std::atomic<unsigned long> fHead_; //index of the next element to pop, written only by the consumer
+        char fPadTail_[64];
+        std::atomic<unsigned long> fTail_; //index of the next element to push, written only by the producer
+        char fPadEnd_[64];
+};
+
+///
+/// \brief BoundedQueue::BoundedQueue The only constructor used, memory for all elements is allocated here.
+/// \param capacity Minimal number of elements stored in the queue.
+///
+template<typename T>
+BoundedQueue<T>::BoundedQueue(unsigned capacity) :
+    fMask_(0),
+    fHead_(0),
+    fTail_(0)
+{
+    unsigned size = 1;
+    while(size < capacity)
+        size <<= 1;
+    fBuffer_.resize(size);
+    fMask_ = size-1;
+}
+
+///
+/// \brief BoundedQueue::TryPush Appends an element to the queue. Called only by the producer.
+/// \param value Element to be appended.
+/// \return False if the queue is full.
+///
+template<typename T>
+bool BoundedQueue<T>::TryPush(const T& value)
+{
+    unsigned long tail = fTail_.load(std::memory_order_relaxed);
+    if(tail - fHead_.load(std::memory_order_acquire) > fMask_)
+        return false;
+    fBuffer_[tail & fMask_] = value;
+    fTail_.store(tail+1, std::memory_order_release);
+    return true;
+}
+
+///
+/// \brief BoundedQueue::TryPop Removes the oldest element from the queue. Called only by the consumer.
+/// \param value Set to the removed element.
+/// \return False if the queue is empty.
+///
+template<typename T>
+bool BoundedQueue<T>::TryPop(T& value)
+{
+    unsigned long head = fHead_.load(std::memory_order_relaxed);
+    if(head == fTail_.load(std::memory_order_acquire))
+        return false;
+    value = fBuffer_[head & fMask_];
+    fHead_.store(head+1, std::memory_order_release);
+    return true;
+}
+
+#endif // BOUNDEDQUEUE_H
@@ -0,0 +1,138 @@
+/// @file checkpoint.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <fstream>
+#include <sstream>
+#include "checkpoint.h"
+
+///
+/// \brief Checkpoint::Checkpoint The only constructor used, the file is neither read nor written.
+/// \param fileName Path to the checkpoint file.
+///
+Checkpoint::Checkpoint(const std::string& fileName) :
+    fFileName_(fileName),
+    fSeed_(0),
+    fEvents_(0),
+    fRuns_(0)
+{
+}
+
+///
+/// \brief Checkpoint::Start Creates a new checkpoint file without completed runs, the old one is overwritten.
+/// \param seed Seed of all random number streams, it must be resolved (non-zero).
+/// \param events Number of events simulated in each run.
+/// \param runs Number of runs.
+/// \param paramDigest Digest of parameters of the simulation, see ParamManager::GetDigest.
+///
+void Checkpoint::Start(int seed, int events, int runs, const std::string& paramDigest)
+{
+    std::lock_guard<std::mutex> lock(fMutex_);
+    fSeed_ = seed;
+    fEvents_ = events;
+    fRuns_ = runs;
+    fParamDigest_ = paramDigest;
+    fCompletedRuns_.clear();
+    fCompletedRunDirectories_.clear();
+    std::ofstream file(fFileName_.c_str(), std::ios::trunc);
+    if(!file)
+        throw(std::string("[ERROR] Cannot create the checkpoint file: ")+fFileName_);
+    file<<"# checkpoint of the simulation, used by sim --resume"<<std::endl;
+    file<<"seed "<<fSeed_<<std::endl;
+    file<<"events "<<fEvents_<<std::endl;
+    file<<"runs "<<fRuns_<<std::endl;
+    file<<"parameters "<<fParamDigest_<<std::endl;
+}
+
+///
+/// \brief Checkpoint::Load Reads the checkpoint file.
+/// \return False if the file does not exist.
+///
+bool Checkpoint::Load()
+{
+    std::lock_guard<std::mutex> lock(fMutex_);
+    std::ifstream file(fFileName_.c_str());
+    if(!file)
+        return false;
+    fCompletedRuns_.clear();
+    fCompletedRunDirectories_.clear();
+    fParamDigest_.clear();
+    std::string row;
+    while(std::getline(file, row))
+    {
+        if(row.empty() || row[0]=='#')
+            continue;
+        std::istringstream is(row);
+        std::string token;
+        is>>token;
+        if(token=="seed")
+            is>>fSeed_;
+        else if(token=="events")
+            is>>fEvents_;
+        else if(token=="runs")
+            is>>fRuns_;
+        else if(token=="parameters")
+            is>>fParamDigest_;
+        else if(token=="run")
+        {
+            int run = -1;
+            std::string runDirectory;
+            is>>run>>runDirectory;
+            //the last line is incomplete, if the program was interrupted while writing it; such run is simulated again
+            if(is.fail())
+                continue;
+            fCompletedRuns_.insert(run);
+            fCompletedRunDirectories_.insert(runDirectory);
+        }
+        if(is.fail())
+            throw(std::string("[ERROR] Corrupted checkpoint file: ")+fFileName_+" (line: "+row+")");
+    }
+    if(fSeed_==0)
+        throw(std::string("[ERROR] Seed not found in the checkpoint file: ")+fFileName_);
+    return true;
+}
+
+///
+/// \brief Checkpoint::MarkCompleted Records the run as completed, the file is updated immediately.
+/// \param run Number of the run.
+/// \param runDirectory Name of the directory of the run in the output file.
+///
+void Checkpoint::MarkCompleted(int run, const std::string& runDirectory)
+{
+    std::lock_guard<std::mutex> lock(fMutex_);
+    fCompletedRuns_.insert(run);
+    fCompletedRunDirectories_.insert(runDirectory);
+    std::ofstream file(fFileName_.c_str(), std::ios::app);
+    file<<"run "<<run<<" "<<runDirectory<<std::endl;
+}
+
+///
+/// \brief Checkpoint::IsCompleted Checks if the run was completed.
+/// \param run Number of the run.
+/// \return True if the run was completed.
+///
+bool Checkpoint::IsCompleted(int run) const
+{
+    std::lock_guard<std::mutex> lock(fMutex_);
+    return fCompletedRuns_.count(run)>0;
+}
+
+///
+/// \brief Checkpoint::IsCompletedRunDirectory Checks if the directory of the output file belongs to a completed run.
+/// \param runDirectory Name of the directory.
+/// \return True if the directory was written by a completed run.
+///
+bool Checkpoint::IsCompletedRunDirectory(const std::string& runDirectory) const
+{
+    std::lock_guard<std::mutex> lock(fMutex_);
+    return fCompletedRunDirectories_.count(runDirectory)>0;
+}
+
+///
+/// \brief Checkpoint::GetNumberOfCompletedRuns Returns the number of completed runs.
+/// \return Number of completed runs.
+///
+int Checkpoint::GetNumberOfCompletedRuns() const
+{
+    std::lock_guard<std::mutex> lock(fMutex_);
+    return static_cast<int>(fCompletedRuns_.size());
+}
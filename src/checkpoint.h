@@ -0,0 +1,51 @@
+/// @file checkpoint.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+#include <string>
+#include <set>
+#include <mutex>
+
+///
+/// \brief The Checkpoint class Record of completed runs, used to resume an interrupted simulation (sim --resume).
+///
+/// Random numbers of every run are drawn from streams derived from the seed and the number of the run (see RandomStream),
+/// so the seed is the only state of generators to be saved: a resumed simulation skips completed runs and simulates
+/// the others exactly as the interrupted one would, provided that the parameters are the same (see ParamManager::GetDigest,
+/// the digest is saved with the seed). A run is marked as completed after its tree, histograms and images
+/// were written and the output file was saved, hence results of completed runs are never simulated again. Directories
+/// of the output file which do not belong to completed runs are left by interrupted runs and should be removed.
+///
+class Checkpoint
+{
+    public:
+        explicit Checkpoint(const std::string& fileName);
+        Checkpoint(const Checkpoint&) = delete;
+        Checkpoint& operator=(const Checkpoint&) = delete;
+
+        void Start(int seed, int events, int runs, const std::string& paramDigest);
+        bool Load();
+        void MarkCompleted(int run, const std::string& runDirectory);
+        bool IsCompleted(int run) const;
+        bool IsCompletedRunDirectory(const std::string& runDirectory) const;
+        int GetNumberOfCompletedRuns() const;
+        //setters and getters
+        inline const std::string& GetFileName() const {return fFileName_;}
+        inline int GetSeed() const {return fSeed_;}
+        inline int GetEvents() const {return fEvents_;}
+        inline int GetRuns() const {return fRuns_;}
+        inline const std::string& GetParamDigest() const {return fParamDigest_;}
+
+    private:
+        std::string fFileName_; //path to the checkpoint file
+        int fSeed_; //seed of all random number streams
+        int fEvents_; //number of events simulated in each run
+        int fRuns_; //number of runs
+        std::string fParamDigest_; //digest of parameters of the simulation, empty in checkpoints of older versions
+        std::set<int> fCompletedRuns_; //numbers of completed runs
+        std::set<std::string> fCompletedRunDirectories_; //directories of completed runs in the output file
+        mutable std::mutex fMutex_; //runs are completed by the writer thread and checked by run threads
+};
+
+#endif // CHECKPOINT_H
@@ -1,6 +1,7 @@
 #include "TImage.h"
 #include "TCanvas.h"
 #include "TLine.h"
+#include "particlegenerator.h"
 #include "comptonscattering.h"
 
 unsigned ComptonScattering::objectID_= 1;
@@ -9,44 +10,56 @@ unsigned ComptonScattering::objectID_= 1;
 /// \param type Type of the decay, can be: TWO, THREE or TWOandTHREE.
 /// \param low Lower limit for smearing effect.
 /// \param high Higher limit for smearing effect.
+/// \param histograms If false, no histograms are created and filling them is skipped (production mode).
 ///
-ComptonScattering::ComptonScattering(DecayType type, float low, float high) : fSilentMode_(false), fDecayType_(type), fSmearLowLimit_(low), fSmearHighLimit_(high)
+ComptonScattering::ComptonScattering(DecayType type, float low, float high, bool histograms) : fSilentMode_(false), fHistograms_(histograms),\
+    fDecayType_(type), fH_PDF_(nullptr), fH_PDF_cross(nullptr), fH_PDF_Theta_(nullptr), fH_PDF_Theta_cross(nullptr), fSmearLowLimit_(low),\
+    fSmearHighLimit_(high), fSamplingMethod_(TABLE), fSampler_(&KleinNishinaSampler::GetDefault()), fObjectID_(objectID_++)
+{
+    int noOfGammas = 0;
+    fTypeString_ = recognizeType(fDecayType_, noOfGammas);
+    if(fHistograms_)
+        CreateHistograms_();
+    //creating function wrapper around KleinNishina_ function
+    fPDF = new TF1((std::string("KleinNishima_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), KleinNishina_, 0.0 , TMath::Pi(), 1);
+    fPDF_Theta = new TF1((std::string("KleinNishimaTheta_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), KleinNishinaTheta_, 0.0 , TMath::Pi(), 1);
+}
+
+///
+/// \brief ComptonScattering::CreateHistograms_ Creates histograms of scattered photons and Compton electrons.
+///
+void ComptonScattering::CreateHistograms_()
 {
     if(fDecayType_==THREE)
     {
-        fTypeString_ = "3";
-        fH_photon_E_depos_ = new TH1F((std::string("fH_photon_E_depos_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_photon_E_depos_", 52, 0.0, 0.600);
-        fH_electron_E_ = new TH1F((std::string("fH_electron_E_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_electron_E_", 52, 0.0, 0.511);
-        fH_electron_E_blur_ = new TH1F((std::string("fH_electron_E_blur_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_electron_E_blur_", 52, 0.0, 0.511);
+        fH_photon_E_depos_ = new TH1F((std::string("fH_photon_E_depos_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_photon_E_depos_", 52, 0.0, 0.600);
+        fH_electron_E_ = new TH1F((std::string("fH_electron_E_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_electron_E_", 52, 0.0, 0.511);
+        fH_electron_E_blur_ = new TH1F((std::string("fH_electron_E_blur_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_electron_E_blur_", 52, 0.0, 0.511);
     }
     else if(fDecayType_==TWO)
     {
-        fTypeString_ = "2";
-        fH_photon_E_depos_ = new TH1F((std::string("fH_photon_E_depos_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_photon_E_depos_", 21, 0.510, 0.512);
+        fH_photon_E_depos_ = new TH1F((std::string("fH_photon_E_depos_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_photon_E_depos_", 21, 0.510, 0.512);
         fH_photon_E_depos_->GetXaxis()->SetNdivisions(7, false);
-        fH_electron_E_ = new TH1F((std::string("fH_electron_E_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_electron_E_", 52, 0.0, 0.511);
-        fH_electron_E_blur_ = new TH1F((std::string("fH_electron_E_blur_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_electron_E_blur_", 52, 0.0, 0.511);
+        fH_electron_E_ = new TH1F((std::string("fH_electron_E_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_electron_E_", 52, 0.0, 0.511);
+        fH_electron_E_blur_ = new TH1F((std::string("fH_electron_E_blur_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_electron_E_blur_", 52, 0.0, 0.511);
     }
     else if(fDecayType_==TWOandONE)
     {
-        fTypeString_ = "2&1";
-        fH_photon_E_depos_ = new TH1F((std::string("fH_photon_E_depos_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_photon_E_depos_", 52, 0.3, 1.3);
-        fH_electron_E_ = new TH1F((std::string("fH_electron_E_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_electron_E_", 52, 0.0, 1.3);
-        fH_electron_E_blur_ = new TH1F((std::string("fH_electron_E_blur_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_electron_E_blur_", 52, 0.0, 1.3);
+        fH_photon_E_depos_ = new TH1F((std::string("fH_photon_E_depos_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_photon_E_depos_", 52, 0.3, 1.3);
+        fH_electron_E_ = new TH1F((std::string("fH_electron_E_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_electron_E_", 52, 0.0, 1.3);
+        fH_electron_E_blur_ = new TH1F((std::string("fH_electron_E_blur_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_electron_E_blur_", 52, 0.0, 1.3);
     }
     else if(fDecayType_==TWOandN)
     {
-        fTypeString_ = "2&N";
-        fH_photon_E_depos_ = new TH1F((std::string("fH_photon_E_depos_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_photon_E_depos_", 104, 0.0, 4.0);
-        fH_electron_E_ = new TH1F((std::string("fH_electron_E_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_electron_E_", 104, 0.0, 4.0);
-        fH_electron_E_blur_ = new TH1F((std::string("fH_electron_E_blur_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_electron_E_blur_", 104, 0.0, 4.0);
+        fH_photon_E_depos_ = new TH1F((std::string("fH_photon_E_depos_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_photon_E_depos_", 104, 0.0, 4.0);
+        fH_electron_E_ = new TH1F((std::string("fH_electron_E_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_electron_E_", 104, 0.0, 4.0);
+        fH_electron_E_blur_ = new TH1F((std::string("fH_electron_E_blur_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_electron_E_blur_", 104, 0.0, 4.0);
     }
     else if(fDecayType_==ONE)
     {
-        fTypeString_ = "1";
-        fH_photon_E_depos_ = new TH1F((std::string("fH_photon_E_depos_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_photon_E_depos_", 52, 0.0, 2.0);
-        fH_electron_E_ = new TH1F((std::string("fH_electron_E_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_electron_E_", 52, 0.0, 2.0);
-        fH_electron_E_blur_ = new TH1F((std::string("fH_electron_E_blur_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_electron_E_blur_", 52, 0.0, 2.0);
+        fH_photon_E_depos_ = new TH1F((std::string("fH_photon_E_depos_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_photon_E_depos_", 52, 0.0, 2.0);
+        fH_electron_E_ = new TH1F((std::string("fH_electron_E_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_electron_E_", 52, 0.0, 2.0);
+        fH_electron_E_blur_ = new TH1F((std::string("fH_electron_E_blur_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_electron_E_blur_", 52, 0.0, 2.0);
     }
     fH_electron_E_->SetFillColor(kBlue);
     fH_electron_E_->SetTitle("Electrons' energy distribution");
@@ -66,37 +79,38 @@ ComptonScattering::ComptonScattering(DecayType type, float low, float high) : fS
     fH_photon_E_depos_->GetYaxis()->SetTitle("dN/dE");
     fH_photon_E_depos_->GetYaxis()->SetTitleOffset(1.8);
     
-    fH_photon_theta_ = new TH1F((std::string("fH_photon_theta_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_photon_theta_", 50, 0.0, TMath::Pi());
+    fH_photon_theta_ = new TH1F((std::string("fH_photon_theta_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_photon_theta_", 50, 0.0, TMath::Pi());
     fH_photon_theta_->SetFillColor(kBlue);
     fH_photon_theta_->SetTitle("Scattering angle distribution");
     fH_photon_theta_->GetXaxis()->SetTitle("#theta");
     fH_photon_theta_->GetYaxis()->SetTitle("dN/d#theta");
     fH_photon_theta_->GetYaxis()->SetTitleOffset(1.8);
+}
 
-    fH_PDF_ = new TH2D((std::string("fH_PDF_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_PDF_", 1000, 0.0, 1.022, 1000, 0.0, TMath::Pi());
+///
+/// \brief ComptonScattering::CreatePDFHistograms_ Creates plots of the Klein-Nishina function, they are needed only by DrawPDF.
+///
+void ComptonScattering::CreatePDFHistograms_()
+{
+    fH_PDF_ = new TH2D((std::string("fH_PDF_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_PDF_", 1000, 0.0, 1.022, 1000, 0.0, TMath::Pi());
     fH_PDF_->SetTitle("Klein-Nishima function");
     fH_PDF_->GetXaxis()->SetTitle("E [MeV]");
     fH_PDF_->GetYaxis()->SetTitle("#theta'");
     fH_PDF_->SetStats(kFALSE);
-    fH_PDF_cross = new TH1D((std::string("fH_PDF_cross_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_PDF_cross", 1000, 0.0, TMath::Pi());
+    fH_PDF_cross = new TH1D((std::string("fH_PDF_cross_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_PDF_cross", 1000, 0.0, TMath::Pi());
     fH_PDF_cross->GetYaxis()->SetTitle("d N/ d #Omega");
     fH_PDF_cross->GetXaxis()->SetTitle("#theta'");
     fH_PDF_cross->SetStats(kFALSE);
 
-    fH_PDF_Theta_ = new TH2D((std::string("fH_PDF_Theta_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_PDF_Theta_", 1000, 0.0, 1.022, 1000, 0.0, TMath::Pi());
+    fH_PDF_Theta_ = new TH2D((std::string("fH_PDF_Theta_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_PDF_Theta_", 1000, 0.0, 1.022, 1000, 0.0, TMath::Pi());
     fH_PDF_Theta_->SetTitle("Klein-Nishima function * 2*#pi*sin(#theta)");
     fH_PDF_Theta_->GetXaxis()->SetTitle("E [MeV]");
     fH_PDF_Theta_->GetYaxis()->SetTitle("#theta'");
     fH_PDF_Theta_->SetStats(kFALSE);
-    fH_PDF_Theta_cross = new TH1D((std::string("fH_PDF_Theta_cross_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_PDF_Theta_cross_", 1000, 0.0, TMath::Pi());
+    fH_PDF_Theta_cross = new TH1D((std::string("fH_PDF_Theta_cross_")+fTypeString_+"_"+std::to_string(fObjectID_)).c_str(), "fH_PDF_Theta_cross_", 1000, 0.0, TMath::Pi());
     fH_PDF_Theta_cross->GetYaxis()->SetTitle("d #N/ d #theta");
     fH_PDF_Theta_cross->GetXaxis()->SetTitle("#theta'");
     fH_PDF_Theta_cross->SetStats(kFALSE);
-    //creating function wrapper around KleinNishina_ function
-    fPDF = new TF1((std::string("KleinNishima_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), KleinNishina_, 0.0 , TMath::Pi(), 1);
-    fPDF_Theta = new TF1((std::string("KleinNishimaTheta_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), KleinNishinaTheta_, 0.0 , TMath::Pi(), 1);
-
-    objectID_++;
 }
 
 ///
@@ -107,19 +121,16 @@ ComptonScattering::ComptonScattering(const ComptonScattering &est)
 {
     fDecayType_=est.fDecayType_;
     fSilentMode_=est.fSilentMode_;
+    fHistograms_=est.fHistograms_;
     fTypeString_=est.fTypeString_;
     fSmearLowLimit_=est.fSmearLowLimit_;
     fSmearHighLimit_=est.fSmearHighLimit_;
+    fSamplingMethod_=est.fSamplingMethod_;
+    fSampler_=est.fSampler_;
+    fObjectID_=est.fObjectID_;
     fPDF = new TF1(*est.fPDF);  //special root object
     fPDF_Theta = new TF1(*est.fPDF_Theta);
-    fH_photon_E_depos_=new TH1F(*est.fH_photon_E_depos_); //distribution of energy deposited by incident photons
-    fH_electron_E_ = new TH1F(*est.fH_electron_E_);   //energy distribution for electrons
-    fH_electron_E_blur_ = new TH1F(*est.fH_electron_E_blur_);
-    fH_photon_theta_ = new TH1F(*est.fH_photon_theta_);   //angle distribution for electrons
-    fH_PDF_ = new TH2D(*est.fH_PDF_);  // Klein-Nishina function plot, for testing purpose only
-    fH_PDF_cross = new TH1D(*est.fH_PDF_cross);
-    fH_PDF_Theta_ = new TH2D(*est.fH_PDF_Theta_);
-    fH_PDF_Theta_cross = new TH1D(*est.fH_PDF_Theta_cross);
+    CopyHistograms_(est);
 }
 
 ///
@@ -131,21 +142,37 @@ ComptonScattering& ComptonScattering::operator=(const ComptonScattering &est)
 {
     fDecayType_=est.fDecayType_;
     fSilentMode_=est.fSilentMode_;
+    fHistograms_=est.fHistograms_;
     fTypeString_=est.fTypeString_;
     fSmearLowLimit_=est.fSmearLowLimit_;
     fSmearHighLimit_=est.fSmearHighLimit_;
+    fSamplingMethod_=est.fSamplingMethod_;
+    fSampler_=est.fSampler_;
+    fObjectID_=est.fObjectID_;
     fPDF = new TF1(*est.fPDF);  //special root object
     fPDF_Theta = new TF1(*est.fPDF_Theta);
-    fH_photon_E_depos_=new TH1F(*est.fH_photon_E_depos_); //distribution of energy deposited by incident photons
-    fH_electron_E_ = new TH1F(*est.fH_electron_E_);   //energy distribution for electrons
-    fH_electron_E_blur_ = new TH1F(*est.fH_electron_E_blur_);
-    fH_photon_theta_ = new TH1F(*est.fH_photon_theta_);   //angle distribution for electrons
-    fH_PDF_ = new TH2D(*est.fH_PDF_);  // Klein-Nishina function plot, for testing purpose only
-    fH_PDF_cross = new TH1D(*est.fH_PDF_cross);
-    fH_PDF_Theta_ = new TH2D(*est.fH_PDF_Theta_);
-    fH_PDF_Theta_cross = new TH1D(*est.fH_PDF_Theta_cross);
+    CopyHistograms_(est);
     return *this;
 }
+
+///
+/// \brief ComptonScattering::CopyHistograms_ Creates copies of histograms of another instance, only of these that were created.
+/// \param est ComptonScattering instance to be copied.
+///
+void ComptonScattering::CopyHistograms_(const ComptonScattering &est)
+{
+    if(fHistograms_)
+    {
+        fH_photon_E_depos_=new TH1F(*est.fH_photon_E_depos_.Get()); //distribution of energy deposited by incident photons
+        fH_electron_E_ = new TH1F(*est.fH_electron_E_.Get());   //energy distribution for electrons
+        fH_electron_E_blur_ = new TH1F(*est.fH_electron_E_blur_.Get());
+        fH_photon_theta_ = new TH1F(*est.fH_photon_theta_.Get());   //angle distribution for electrons
+    }
+    fH_PDF_ = est.fH_PDF_ ? new TH2D(*est.fH_PDF_) : nullptr;  // Klein-Nishina function plot, for testing purpose only
+    fH_PDF_cross = est.fH_PDF_cross ? new TH1D(*est.fH_PDF_cross) : nullptr;
+    fH_PDF_Theta_ = est.fH_PDF_Theta_ ? new TH2D(*est.fH_PDF_Theta_) : nullptr;
+    fH_PDF_Theta_cross = est.fH_PDF_Theta_cross ? new TH1D(*est.fH_PDF_Theta_cross) : nullptr;
+}
 ///
 /// \brief equal_histograms Checks integral, number of entries and mean of two histograms.
 /// \param h1 First histogram to be compared.
@@ -160,9 +187,9 @@ bool equal_histograms(const TH1* h1, const TH1* h2)
 bool ComptonScattering::operator==(const ComptonScattering &est) const
 {
     bool isEqual = (fDecayType_==est.fDecayType_) && (fSilentMode_==est.fSilentMode_) && (fTypeString_==est.fTypeString_) &&
-         (fSmearLowLimit_==est.fSmearLowLimit_) && (fSmearHighLimit_==est.fSmearHighLimit_) && \
-          equal_histograms(fH_photon_E_depos_, est.fH_photon_E_depos_) && equal_histograms(fH_electron_E_, est.fH_electron_E_) &&\
-          equal_histograms(fH_electron_E_blur_, est.fH_electron_E_blur_) && equal_histograms(fH_photon_theta_, est.fH_photon_theta_);
+         (fSmearLowLimit_==est.fSmearLowLimit_) && (fSmearHighLimit_==est.fSmearHighLimit_) && (fHistograms_==est.fHistograms_) && \
+          (!fHistograms_ || (equal_histograms(fH_photon_E_depos_.Get(), est.fH_photon_E_depos_.Get()) && equal_histograms(fH_electron_E_.Get(), est.fH_electron_E_.Get()) &&\
+          equal_histograms(fH_electron_E_blur_.Get(), est.fH_electron_E_blur_.Get()) && equal_histograms(fH_photon_theta_.Get(), est.fH_photon_theta_.Get())));
     return isEqual;
 }
 
@@ -171,10 +198,10 @@ bool ComptonScattering::operator==(const ComptonScattering &est) const
 ///
 ComptonScattering::~ComptonScattering()
 {
-    if(fH_electron_E_) delete fH_electron_E_;
-    if(fH_electron_E_blur_) delete fH_electron_E_blur_;
-    if(fH_photon_theta_) delete fH_photon_theta_;
-    if(fH_photon_E_depos_) delete fH_photon_E_depos_;
+    delete fH_electron_E_.Release();
+    delete fH_electron_E_blur_.Release();
+    delete fH_photon_theta_.Release();
+    delete fH_photon_E_depos_.Release();
     if(fH_PDF_) delete fH_PDF_;
     if(fH_PDF_cross) delete fH_PDF_cross;
     if(fPDF) delete fPDF;
@@ -191,6 +218,8 @@ ComptonScattering::~ComptonScattering()
 void ComptonScattering::DrawPDF(std::string filePrefix, double crossSectionE)
 {
     std::cout<<"\n[INFO] Drawing Klein-Nishima function."<<std::endl;
+    if(fH_PDF_==nullptr)
+        CreatePDFHistograms_();
     int range = 1000;
     //Two loops create a grid, where the value of function is calculated.
     double crossE[1] = {crossSectionE};
@@ -248,6 +277,8 @@ void ComptonScattering::DrawPDF(std::string filePrefix, double crossSectionE)
 ///
 void ComptonScattering::DrawComptonHistograms(std::string filePrefix, OutputOptions output)
 {
+    if(!fHistograms_)
+        return;
     if(!fSilentMode_)
         std::cout<<"[INFO] Drawing histograms for Compton electrons and scattered photons."<<std::endl;
     TCanvas* c = new TCanvas((fTypeString_+"-gammas_compton_distr").c_str(), "Compton effect distributions", 1300, 1200);
@@ -294,11 +325,63 @@ void ComptonScattering::DrawComptonHistograms(std::string filePrefix, OutputOpti
         std::cout<<"[INFO] Saving histograms for Compton effect.\n"<<std::endl;
 }
 
+///
+/// \brief ComptonScattering::ScatterPhoton_ Scatters a single photon, performs smearing and fills histograms.
+/// \tparam kHistograms If true, histograms are filled.
+/// \param E Energy of the photon [MeV].
+/// \param rng Random number generator to be used.
+/// \param edep Set to the energy deposited by the photon.
+/// \param edepSmear Set to the deposited energy with experimental smearing.
+///
+template<bool kHistograms>
+void ComptonScattering::ScatterPhoton_(double E, TRandom* rng, double& edep, double& edepSmear) const
+{
+    double theta = SampleTheta_(E, rng); //get scattering angle
+    double new_E = E * (1.0 - 1.0/(1.0+(E/(e_mass_MeV))*(1-TMath::Cos(theta)))); //E*(1-P) -- Compton electron's energy
+    edep = new_E;
+    //if new_E is within limit -- smear, otherwise use new_E
+    if((new_E >= fSmearLowLimit_) && (new_E <= fSmearHighLimit_))
+        edepSmear = rng->Gaus(new_E, sigmaE(new_E));
+    else
+        edepSmear = new_E;
+    if(kHistograms)
+    {
+        fH_photon_E_depos_.Fill(E);
+        fH_photon_theta_.Fill(theta);
+        fH_electron_E_.Fill(new_E);
+        fH_electron_E_blur_.Fill(edepSmear);
+    }
+}
+
+///
+/// \brief ComptonScattering::ScatterBatch_ Scatters gammas of all events in a batch.
+/// \tparam kType Type of decays stored in the batch.
+/// \tparam kHistograms If true, histograms are filled.
+/// \param batch Batch of events.
+/// \param rng Random number generator, switched to the substream of every event before it is scattered.
+///
+template<DecayType kType, bool kHistograms>
+void ComptonScattering::ScatterBatch_(EventBatch& batch, RandomStream* rng) const
+{
+    for(int jj=0; jj<batch.GetSize(); jj++)
+    {
+        rng->SetSubstream(batch.GetIndexInRun(jj));
+        for(int ii=0; ii<batch.GetNumberOfDecayProducts<kType>(jj); ii++)
+        {
+            int kk = batch.Index(ii, jj);
+            if(batch.fCutPassing[kk])
+                ScatterPhoton_<kHistograms>(batch.fE[kk], rng, batch.fEdep[kk], batch.fEdepSmear[kk]);
+        }
+    }
+}
+
 ///
 /// \brief ComptonScattering::Scatter Scatters gammas from the event, performs smearing and fills histograms.
 /// \param event Pointer to Event object that is to be scattered.
+/// \param rng Random number generator to be used.
+/// \param index Index of the photon to be scattered, all photons are scattered if negative.
 ///
-void ComptonScattering::Scatter(Event* event, int index) const
+void ComptonScattering::Scatter(Event* event, TRandom* rng, int index) const
 {
     int lowLimit = 0;
     int highLimit = event->GetNumberOfDecayProducts();
@@ -311,30 +394,118 @@ void ComptonScattering::Scatter(Event* event, int index) const
     {
         if(event->GetFourMomentumOf(ii) != nullptr && event->GetCutPassingOf(ii))
         {
-            double E = event->GetFourMomentumOf(ii)->Energy();
-            fH_photon_E_depos_->Fill(E);
-            fPDF_Theta->SetParameter(0, E); //set incident photon energy
-            double theta = fPDF_Theta->GetRandom(); //get scattering angle
-            fH_photon_theta_->Fill(theta);
-            double new_E = E * (1.0 - 1.0/(1.0+(E/(e_mass_MeV))*(1-TMath::Cos(theta)))); //E*(1-P) -- Compton electron's energy
-            fH_electron_E_->Fill(new_E);
-            event->SetEdepOf(ii, new_E);
-            //if new_E is within limit -- smear, otherwise fill histogram with new_E
-            if((new_E >= fSmearLowLimit_) && (new_E <= fSmearHighLimit_))
-            {
-                double Esmear = gRandom->Gaus(new_E, sigmaE(new_E));
-                fH_electron_E_blur_->Fill(Esmear);
-                event->SetEdepSmearOf(ii, Esmear);
-            }
+            double edep = 0.0;
+            double edepSmear = 0.0;
+            if(fHistograms_)
+                ScatterPhoton_<true>(event->GetFourMomentumOf(ii)->Energy(), rng, edep, edepSmear);
             else
-            {
-                fH_electron_E_blur_->Fill(new_E);
-                event->SetEdepSmearOf(ii, new_E);
-            }
+                ScatterPhoton_<false>(event->GetFourMomentumOf(ii)->Energy(), rng, edep, edepSmear);
+            event->SetEdepOf(ii, edep);
+            event->SetEdepSmearOf(ii, edepSmear);
         }
     }
 }
 
+///
+/// \brief ComptonScattering::Scatter Scatters gammas of one event of a batch, the same as Scatter for Event.
+/// \param batch Batch of events.
+/// \param event Index of the event in the batch.
+/// \param rng Random number generator to be used.
+/// \param index Index of the photon to be scattered, all photons are scattered if negative.
+///
+void ComptonScattering::Scatter(EventBatch& batch, int event, TRandom* rng, int index) const
+{
+    int lowLimit = 0;
+    int highLimit = batch.GetNumberOfDecayProducts(event);
+    if(index > -1)
+    {
+        lowLimit = index;
+        highLimit = index+1 < highLimit ? index+1 : highLimit;
+    }
+    for(int ii=lowLimit; ii<highLimit; ii++)
+    {
+        int jj = batch.Index(ii, event);
+        if(!batch.fCutPassing[jj])
+            continue;
+        if(fHistograms_)
+            ScatterPhoton_<true>(batch.fE[jj], rng, batch.fEdep[jj], batch.fEdepSmear[jj]);
+        else
+            ScatterPhoton_<false>(batch.fE[jj], rng, batch.fEdep[jj], batch.fEdepSmear[jj]);
+    }
+}
+
+///
+/// \brief ComptonScattering::Scatter Scatters gammas of all events in a batch.
+/// \tparam kType Type of decays stored in the batch.
+/// \param batch Batch of events.
+/// \param rng Random number generator, switched to the substream of every event before it is scattered.
+///
+template<DecayType kType>
+void ComptonScattering::Scatter(EventBatch& batch, RandomStream* rng) const
+{
+    //checked once per batch, so without histograms the loop is compiled without any filling
+    if(fHistograms_)
+        ScatterBatch_<kType, true>(batch, rng);
+    else
+        ScatterBatch_<kType, false>(batch, rng);
+}
+
+template void ComptonScattering::Scatter<ONE>(EventBatch& batch, RandomStream* rng) const;
+template void ComptonScattering::Scatter<TWO>(EventBatch& batch, RandomStream* rng) const;
+template void ComptonScattering::Scatter<THREE>(EventBatch& batch, RandomStream* rng) const;
+template void ComptonScattering::Scatter<TWOandONE>(EventBatch& batch, RandomStream* rng) const;
+template void ComptonScattering::Scatter<TWOandN>(EventBatch& batch, RandomStream* rng) const;
+
+///
+/// \brief ComptonScattering::Scatter Scatters gammas of all events in a batch, the decay type is dispatched at run time.
+/// \param batch Batch of events.
+/// \param rng Random number generator, switched to the substream of every event before it is scattered.
+///
+void ComptonScattering::Scatter(EventBatch& batch, RandomStream* rng) const
+{
+    switch(batch.GetDecayType())
+    {
+        case ONE: Scatter<ONE>(batch, rng); break;
+        case TWO: Scatter<TWO>(batch, rng); break;
+        case THREE: Scatter<THREE>(batch, rng); break;
+        case TWOandONE: Scatter<TWOandONE>(batch, rng); break;
+        case TWOandN: Scatter<TWOandN>(batch, rng); break;
+        default: throw(std::string("[ERROR] Wrong decay type of EventBatch!"));
+    }
+}
+
+///
+/// \brief ComptonScattering::Merge Adds histograms filled by another instance to histograms of this one.
+/// \param est Instance of ComptonScattering created for the same decay type, e.g. by a worker thread.
+///
+void ComptonScattering::Merge(const ComptonScattering& est)
+{
+    if(fDecayType_ != est.fDecayType_)
+        throw(std::string("[ERROR] Cannot merge ComptonScattering objects created for different decay types!"));
+    if(fHistograms_ != est.fHistograms_)
+        throw(std::string("[ERROR] Cannot merge ComptonScattering objects with and without histograms!"));
+    if(!fHistograms_)
+        return;
+    fH_photon_E_depos_->Add(est.fH_photon_E_depos_.Get());
+    fH_electron_E_->Add(est.fH_electron_E_.Get());
+    fH_electron_E_blur_->Add(est.fH_electron_E_blur_.Get());
+    fH_photon_theta_->Add(est.fH_photon_theta_.Get());
+}
+
+///
+/// \brief ComptonScattering::SampleTheta_ Draws the scattering angle from the Klein-Nishina distribution.
+/// By default the precomputed table of KleinNishinaSampler is used, the exact Kahn's method can be selected instead.
+/// \param E Incident photon's energy in MeV.
+/// \param rng Random number generator to be used.
+/// \return Scattering angle in radians.
+///
+double ComptonScattering::SampleTheta_(double E, TRandom* rng) const
+{
+    if(fSamplingMethod_==KAHN)
+        return TMath::ACos(KleinNishinaSampler::SampleCosThetaKahn(E, rng));
+    return TMath::ACos(fSampler_->SampleCosTheta(E, rng));
+}
+
 ///
 /// \brief ComptonScattering::KleinNishina_ Klein-Nishina formula
 /// \param angle Scattering angle.
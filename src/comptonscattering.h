@@ -11,7 +11,11 @@
 #include "TRandom3.h"
 #include "constants.h"
 #include "event.h"
+#include "eventbatch.h"
+#include "randomstream.h"
 #include "parammanager.h"
+#include "histogramaccumulator.h"
+#include "kleinnishinasampler.h"
 
 ///
 /// \brief The ComptonScattering class Class responsible for Compton scattering according to the Klein-Nishina formula.
@@ -19,32 +23,40 @@
 class ComptonScattering
 {
     public:
-        ComptonScattering(DecayType type, float low=0.0, float high=2.0);
+        ComptonScattering(DecayType type, float low=0.0, float high=2.0, bool histograms=true);
         ComptonScattering(const ComptonScattering& est);
         ComptonScattering& operator=(const ComptonScattering& est);
         bool operator==(const ComptonScattering &cs) const;
         ~ComptonScattering();
         void DrawPDF(std::string filePrefix="", double crossSectionE=0.511);
         void DrawComptonHistograms(std::string filePrefix, OutputOptions output=PNG);
-        void Scatter(Event* event, int index=-1) const; //perfors scattering
+        void Scatter(Event* event, TRandom* rng, int index=-1) const; //perfors scattering
+        void Scatter(EventBatch& batch, int event, TRandom* rng, int index=-1) const; //scattering of one event of a batch
+        void Scatter(EventBatch& batch, RandomStream* rng) const; //scattering of all events of a batch
+        template<DecayType kType> void Scatter(EventBatch& batch, RandomStream* rng) const; //the same, the type known at compile time
+        void Merge(const ComptonScattering& est); //adds histograms of another instance (e.g. filled by a worker thread)
         inline void EnableSilentMode() {fSilentMode_=true;}
         inline void DisableSilentMode() {fSilentMode_=false;}
+        inline bool HasHistograms() const {return fHistograms_;}
         inline float GetSmearLowLimit() const {return fSmearLowLimit_;}
         inline float GetSmearHighLimit() const {return fSmearLowLimit_;}
         inline void SetSmearLowLimit(float limit) {fSmearLowLimit_=limit;}
         inline void SetSmearHighLimit(float limit) {fSmearHighLimit_=limit;}
+        inline ComptonSamplingMethod GetSamplingMethod() const {return fSamplingMethod_;}
+        inline void SetSamplingMethod(ComptonSamplingMethod method) {fSamplingMethod_=method;}
         TF1* fPDF;  //root function wrapper, Klein-Nishina formula
         TF1* fPDF_Theta;  //root function wrapper, dN/d theta
 
     private:
         bool fSilentMode_; //if true then less output is generated
+        bool fHistograms_; //if false, histograms of scattered photons are neither created nor filled
         DecayType fDecayType_;
         std::string fTypeString_;
-        TH1F* fH_electron_E_;   //energy distribution for electrons
-        TH1F* fH_electron_E_blur_;   //energy distribution for electrons blurred by detector effects
-        TH1F* fH_photon_E_depos_; //distribution of energy deposited by incident photons
-        TH1F* fH_photon_theta_;   //angle distribution for scattered photons
-        TH2D* fH_PDF_;  // Klein-Nishina function plot, for testing purpose only
+        HistogramAccumulator<TH1F> fH_electron_E_;   //energy distribution for electrons
+        HistogramAccumulator<TH1F> fH_electron_E_blur_;   //energy distribution for electrons blurred by detector effects
+        HistogramAccumulator<TH1F> fH_photon_E_depos_; //distribution of energy deposited by incident photons
+        HistogramAccumulator<TH1F> fH_photon_theta_;   //angle distribution for scattered photons
+        TH2D* fH_PDF_;  // Klein-Nishina function plot, for testing purpose only, created by DrawPDF
         TH1D* fH_PDF_cross; //Klein-Nishina function for specified value of incident's photon energy
         TH2D* fH_PDF_Theta_; //Klein-Nishina based theta PDF function
         TH1D* fH_PDF_Theta_cross; //Klein-Nishina based theta PDF function for specified value of incident's photon energy
@@ -53,7 +65,16 @@ class ComptonScattering
         static long double KleinNishina_(double* angle, double* energy); //Klein-Nishina function
         static long double KleinNishinaTheta_(double* angle, double* energy); //Klein-Nishina based theta PDF
         double sigmaE(double E, double coeff=0.044) const; //calculate std dev for the smearing effevt
+        double SampleTheta_(double E, TRandom* rng) const; //draws the scattering angle for a photon with energy E
+        void CreateHistograms_();
+        void CopyHistograms_(const ComptonScattering& est);
+        void CreatePDFHistograms_();
+        template<bool kHistograms> void ScatterPhoton_(double E, TRandom* rng, double& edep, double& edepSmear) const; //scatters a single photon
+        template<DecayType kType, bool kHistograms> void ScatterBatch_(EventBatch& batch, RandomStream* rng) const; //scatters all photons of a batch
+        ComptonSamplingMethod fSamplingMethod_; //method of drawing the scattering angle
+        const KleinNishinaSampler* fSampler_; //tabulated inverse CDF of the scattering angle, shared by all instances
 
+        unsigned fObjectID_; //number of this instance, used in names of ROOT objects
         static unsigned objectID_;
 
 };
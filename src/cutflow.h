@@ -0,0 +1,56 @@
+/// @file cutflow.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef CUTFLOW_H
+#define CUTFLOW_H
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include "TH1D.h"
+
+///
+/// \brief The CutFlow class Converts counts of gammas/events passing consecutive cuts into percentages drawn on plots.
+///
+/// Counts are written to files, so results of many processes (shards) can be summed. Percentages are derived from them
+/// only when drawing, in the same way by the simulation and by the shard merger.
+/// Bins of counts: 1 - before cuts, 2 - geometrical acceptance, 3 - interaction probability.
+///
+class CutFlow
+{
+    public:
+        ///
+        /// \brief GetCountsName Returns the name, under which counts are written.
+        /// \param type Type of decay as a string, see InitialCuts.
+        /// \param events True for events, false for gammas.
+        ///
+        static inline std::string GetCountsName(const std::string& type, bool events)
+        {
+            return type+(events ? "-events_cuts_counts" : "-gammas_cuts_counts");
+        }
+        ///
+        /// \brief MakePercent Creates a histogram with percentages of gammas/events that passed cuts.
+        /// \param counts Counts of gammas/events.
+        /// \param name Name of the new histogram.
+        /// \return Histogram not attached to any directory, owned by the caller.
+        ///
+        static inline TH1D* MakePercent(const TH1D* counts, const std::string& name)
+        {
+            TH1D* percent = static_cast<TH1D*>(counts->Clone(name.c_str()));
+            percent->SetDirectory(nullptr);
+            if(counts->GetBinContent(1) > 0)
+                percent->Scale(100.0/counts->GetBinContent(1));
+            return percent;
+        }
+        ///
+        /// \brief GetPassedLabel Returns the label with the percent of gammas/events that passed all cuts.
+        /// \param counts Counts of gammas/events.
+        ///
+        static inline std::string GetPassedLabel(const TH1D* counts)
+        {
+            std::stringstream ss;
+            ss<<std::setprecision(2)<<counts->GetBinContent(3)/counts->GetBinContent(1)*100.0;
+            return ss.str()+std::string("%");
+        }
+};
+
+#endif // CUTFLOW_H
@@ -0,0 +1,33 @@
+/// @file decaytraits.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef DECAYTRAITS_H
+#define DECAYTRAITS_H
+#include "event.h"
+
+///
+/// \brief The DecayTraits struct Properties of a decay type known at compile time.
+///
+/// Stages of the pipeline are templated on the decay type (see SimulationWorker::ProcessBlock_), so branches on
+/// the type inside loops over events and photons are resolved by the compiler. The type is dispatched once per run.
+///
+template<DecayType kType>
+struct DecayTraits
+{
+    //number of photons of every event, 0 if it varies from event to event (deexcitation photons)
+    static const int kFixedPhotons = kType==ONE ? 1 : (kType==TWO ? 2 : (kType==THREE ? 3 : 0));
+    //the highest number of photons in an event, 0 if it depends on parameters of the simulation (2&N decay branches)
+    static const int kMaxPhotons = kType==TWOandONE ? 3 : (kType==TWOandN ? 0 : kFixedPhotons);
+    //number of photons from the phase space generator
+    static const int kDecayPhotons = kType==ONE ? 0 : (kType==THREE ? 3 : 2);
+    //the first kRequiredPhotons photons have to pass cuts to reconstruct the event, they are also treated as 511 keV photons
+    //by the phantom, deexcitation photons are not required
+    static const int kRequiredPhotons = kType==THREE ? 3 : 2;
+};
+
+template<DecayType kType> const int DecayTraits<kType>::kFixedPhotons;
+template<DecayType kType> const int DecayTraits<kType>::kMaxPhotons;
+template<DecayType kType> const int DecayTraits<kType>::kDecayPhotons;
+template<DecayType kType> const int DecayTraits<kType>::kRequiredPhotons;
+
+#endif // DECAYTRAITS_H
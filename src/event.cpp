@@ -4,11 +4,10 @@
 #include <iostream>
 #include "event.h"
 #include "constants.h"
+#include "hitpointkernel.h"
 //ROOT stuff
 ClassImp(Event)
 
-long Event::fCounter_ = 0;
-
 ///
 /// \brief Event::Event Basic constructor. Should not be used!
 ///
@@ -17,8 +16,7 @@ Event::Event()
     fWeight_=0;
     fDecayType_=TWO;
     fPassFlag_=false;
-    fCounter_++;
-    fId = fCounter_;
+    fId = 0;
     for(int ii=0; ii<2; ii++)
     {
         fFourMomentum_.push_back(TLorentzVector(0.0, 0.0, 1.022, 1.022)); //scale from GeV to MeV
@@ -28,6 +26,29 @@ Event::Event()
     std::cerr<<"[WARNING] Default constructor used for Event class!"<<std::endl;
 }
 
+///
+/// \brief Event::Event Creates an event without decay products, which are added with AddDecayProduct.
+/// The id is 0 until it is assigned (see SimulationWorker::GetEventId).
+/// \param type Type of the event.
+/// \param capacity Number of decay products for which memory is reserved.
+///
+Event::Event(DecayType type, int capacity) :
+    fWeight_(0.0),
+    fDecayType_(type),
+    fPassFlag_(true)
+{
+    fId = 0;
+    fEmissionPoint_.reserve(capacity);
+    fFourMomentum_.reserve(capacity);
+    fCutPassing_.reserve(capacity);
+    fPrimaryPhoton_.reserve(capacity);
+    fHitPhi_.reserve(capacity);
+    fHitTheta_.reserve(capacity);
+    fHitPoint_.reserve(capacity);
+    fEdep_.reserve(capacity);
+    fEdepSmear_.reserve(capacity);
+}
+
 ///
 /// \brief Event::Event The main constructor.
 /// \param emissionCoordinates Coordinates of the emission point in mm.
@@ -40,8 +61,7 @@ Event::Event(std::vector<TLorentzVector*>* emissionCoordinates, std::vector<TLor
     fDecayType_(type),
     fPassFlag_(true)
 {
-    fCounter_++;
-    fId = fCounter_;
+    fId = 0;
     int totalGammaNo = emissionCoordinates->size();
     for(int ii=0; ii<totalGammaNo; ii++)
     {
@@ -77,7 +97,6 @@ Event::Event(std::vector<TLorentzVector> &sourcePos, std::vector<TLorentzVector>
     std::vector<double> &phi, std::vector<double> &theta, std::vector<bool> &cutPassing, std::vector<bool> &primary,\
     std::vector<double> &edep, std::vector<double> &edepSmear, long Id, int decayType)
 {
-    fCounter_++;
     fId = Id;
     fWeight_ = 1.0;
     fDecayType_ = (DecayType)decayType;
@@ -158,46 +177,72 @@ Event::~Event()
 }
 
 ///
-/// \brief Event::CalculateHitPoints Calculates hit points on the detector's surface
+/// \brief Event::Reset Removes all decay products and hit points. Memory of the vectors is kept, so an event filled
+/// again with the same (or lower) number of decay products does not allocate memory.
+/// \param type Type of the event.
+/// \param weight Weight of the event.
+///
+void Event::Reset(DecayType type, double weight)
+{
+    fWeight_ = weight;
+    fDecayType_ = type;
+    fPassFlag_ = true;
+    fEmissionPoint_.clear();
+    fFourMomentum_.clear();
+    fCutPassing_.clear();
+    fPrimaryPhoton_.clear();
+    fHitPhi_.clear();
+    fHitTheta_.clear();
+    fHitPoint_.clear();
+    fEdep_.clear();
+    fEdepSmear_.clear();
+}
+
+///
+/// \brief Event::AddDecayProduct Adds a photon to the event.
+/// \param emissionPoint Coordinates of the emission point in mm.
+/// \param fourMomentum Fourmomentum of the photon in GeV.
+/// \param inMeV If true, the fourmomentum is given in MeV (the unit of stored fourmomenta) and it is not scaled.
+///
+void Event::AddDecayProduct(const TLorentzVector& emissionPoint, const TLorentzVector& fourMomentum, bool inMeV)
+{
+    fEmissionPoint_.push_back(emissionPoint);
+    fFourMomentum_.push_back(inMeV ? fourMomentum : fourMomentum*1000); //scale from GeV to MeV
+    fCutPassing_.push_back(true);
+    fPrimaryPhoton_.push_back(true);
+    fEdep_.push_back(0.0);
+    fEdepSmear_.push_back(0.0);
+}
+
+///
+/// \brief Event::AddHitPoint Adds a hit point of the next photon on the detector's surface.
+/// \param hitPoint Coordinates of the hit point [mm and mikro s].
+/// \param phi Azimuthal angle of the hit point.
+/// \param theta Polar angle of the hit point.
+///
+void Event::AddHitPoint(const TLorentzVector& hitPoint, double phi, double theta)
+{
+    fHitPoint_.push_back(hitPoint);
+    fHitPhi_.push_back(phi);
+    fHitTheta_.push_back(theta);
+}
+
+///
+/// \brief Event::CalculateHitPoints Calculates hit points on the detector's surface, see HitPointKernel.
 /// \param R Radius of the detector.
+/// \param L Length of the detector.
 ///
 void Event::CalculateHitPoints(double R, double L)
 {
     for(auto it = fFourMomentum_.begin(); it != fFourMomentum_.end(); ++it)
     {
-        if(it->Pt() > TMath::Power(10, -10))
-        {
-            int iter = it-fFourMomentum_.begin();
-            double x0 = fEmissionPoint_[iter].X();
-            double y0 = fEmissionPoint_[iter].Y();
-            double z0 = fEmissionPoint_[iter].Z();
-            double px = it->X();
-            double py = it->Y();
-            double pt2 = px*px+py*py;
-            double delta = 4*(x0*px+y0*py)*(x0*px+y0*py) - 4*(x0*x0+y0*y0-R*R)*pt2;
-            double s = (-2*(x0*px+y0*py)+TMath::Sqrt(delta))/2/pt2;
-            if(TMath::Abs(z0+it->Z()*s) > L/2.0)
-            {
-                //getting out of detector
-                TLorentzVector hit(-2000, -2000, -2000, -2000);
-                fHitPoint_.push_back(hit);
-                fHitPhi_.push_back(-4);
-                fHitTheta_.push_back(-4);
-                continue;
-            }
-            TLorentzVector hit(x0+it->X()*s, y0+it->Y()*s, z0+it->Z()*s, it->T()*s*1000000/light_speed_SI);
-            fHitPoint_.push_back(hit);
-            fHitPhi_.push_back(hit.Phi());//(hit-fEmissionPoint_[it-fFourMomentum_.begin()]).Phi());
-            fHitTheta_.push_back(hit.Theta());//(hit-fEmissionPoint_[it-fFourMomentum_.begin()]).Theta());
-        }
-        else
-        {
-             TLorentzVector hit(-2000, -2000, -2000, -2000);
-             fHitPoint_.push_back(hit);
-             fHitPhi_.push_back(-4);
-             fHitTheta_.push_back(-4);
-
-        }
+        int iter = it-fFourMomentum_.begin();
+        double x, y, z, t, phi, theta;
+        HitPointKernel::CalculateOne(fEmissionPoint_[iter].X(), fEmissionPoint_[iter].Y(), fEmissionPoint_[iter].Z(),\
+                                     it->X(), it->Y(), it->Z(), it->T(), R, L, x, y, z, t, phi, theta);
+        fHitPoint_.push_back(TLorentzVector(x, y, z, t));
+        fHitPhi_.push_back(phi);
+        fHitTheta_.push_back(theta);
     }
 }
 
@@ -28,6 +28,7 @@ class Event : public TObject
 {
     public:
         Event();
+        explicit Event(DecayType type, int capacity=0);
         Event(std::vector<TLorentzVector*>* emissionCoordinates, std::vector<TLorentzVector*>* fourMomentum, double weight, DecayType type);
         Event(std::vector<TLorentzVector> &sourcePos, std::vector<TLorentzVector> &pos, std::vector<TLorentzVector> &momentum,\
         std::vector<double> &phi, std::vector<double> &theta, std::vector<bool> &cutPassing, std::vector<bool> &primary,\
@@ -61,7 +62,14 @@ class Event : public TObject
         inline void SetPrimaryPhoton(const unsigned ii, bool isPrimary) {fPrimaryPhoton_.at(ii)=isPrimary;}
         inline void SetEdepOf(const unsigned ii, double val) {fEdep_[ii]=val;}
         inline void SetEdepSmearOf(const unsigned ii, double val) {fEdepSmear_[ii]=val;}
+        inline void SetPassFlag(bool flag) {fPassFlag_=flag;}
 
+        //clears the event without releasing memory, so that it can be filled again
+        void Reset(DecayType type, double weight);
+        //adds a photon emitted from a given point, fourmomentum in GeV (or in MeV, if inMeV is true)
+        void AddDecayProduct(const TLorentzVector& emissionPoint, const TLorentzVector& fourMomentum, bool inMeV=false);
+        //adds a hit point calculated elsewhere (e.g. by EventBatch), angles are -4 if the detector was missed
+        void AddHitPoint(const TLorentzVector& hitPoint, double phi, double theta);
         //set fPassFlag_ by checking values in fCutPassing_
         void DeducePassFlag();
         //calculates hit point of gammas on a detectors surface and fills fHitTheta_ and fHitPhi_ histograms
@@ -73,7 +81,6 @@ class Event : public TObject
         ClassDef(Event, 18)
 
     private:
-        static long fCounter_; //static variable incremented with every call of a constructor (but not copy constructor)
         std::vector<TLorentzVector> fEmissionPoint_; //x, y, z, t(irrelevant) [mm and s]
         std::vector<TLorentzVector> fFourMomentum_; //pX, pY, pZ, E [MeV/c and MeV]
         std::vector<bool> fCutPassing_; //indicates if gamma failed passing through cuts
@@ -0,0 +1,272 @@
+/// @file eventbatch.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <string>
+#include "TMath.h"
+#include "eventbatch.h"
+#include "hitpointkernel.h"
+
+///
+/// \brief EventBatch::EventBatch The only constructor used, memory for all events is allocated here.
+/// \param type Type of decays stored in the batch.
+/// \param capacity Maximal number of events.
+/// \param maxPhotons Maximal number of photons in one event.
+///
+EventBatch::EventBatch(DecayType type, int capacity, int maxPhotons) :
+    fIndexInBlock(capacity, 0),
+    fNoOfPhotons(capacity, 0),
+    fWeight(capacity, 0.0),
+    fPassFlag(capacity, true),
+    fPx(capacity*maxPhotons, 0.0), fPy(capacity*maxPhotons, 0.0), fPz(capacity*maxPhotons, 0.0), fE(capacity*maxPhotons, 0.0),
+    fX(capacity*maxPhotons, 0.0), fY(capacity*maxPhotons, 0.0), fZ(capacity*maxPhotons, 0.0),
+    fHitX(capacity*maxPhotons, 0.0), fHitY(capacity*maxPhotons, 0.0), fHitZ(capacity*maxPhotons, 0.0), fHitT(capacity*maxPhotons, 0.0),
+    fHitPhi(capacity*maxPhotons, 0.0), fHitTheta(capacity*maxPhotons, 0.0),
+    fEdep(capacity*maxPhotons, 0.0), fEdepSmear(capacity*maxPhotons, 0.0),
+    fCutPassing(capacity*maxPhotons, false),
+    fPrimaryPhoton(capacity*maxPhotons, true),
+    fDecayType_(type),
+    fCapacity_(capacity),
+    fMaxPhotons_(maxPhotons),
+    fSize_(0),
+    fFirstIndex_(0)
+{
+}
+
+///
+/// \brief EventBatch::Clear Removes all events from the batch without releasing memory.
+/// \param firstIndex Index in the run of the first event which will be added.
+///
+void EventBatch::Clear(long firstIndex)
+{
+    fSize_ = 0;
+    fFirstIndex_ = firstIndex;
+}
+
+///
+/// \brief EventBatch::AddEvent Appends an empty event to the batch.
+/// \return Handle used to fill the event.
+///
+EventBatch::EventSlot EventBatch::AddEvent()
+{
+    if(fSize_ >= fCapacity_)
+        throw(std::string("[ERROR] Too many events added to EventBatch!"));
+    fIndexInBlock[fSize_] = fSize_;
+    fNoOfPhotons[fSize_] = 0;
+    fWeight[fSize_] = 0.0;
+    fPassFlag[fSize_] = true;
+    return EventSlot(*this, fSize_++);
+}
+
+///
+/// \brief EventBatch::EventSlot::Reset Removes all photons of the event.
+/// \param type Type of the event, has to be the type of the batch.
+/// \param weight Weight of the event.
+///
+void EventBatch::EventSlot::Reset(DecayType type, double weight)
+{
+    if(type != fBatch_.fDecayType_)
+        throw(std::string("[ERROR] Event of a different type added to EventBatch!"));
+    fBatch_.fNoOfPhotons[fIndex_] = 0;
+    fBatch_.fWeight[fIndex_] = weight;
+    fBatch_.fPassFlag[fIndex_] = true;
+}
+
+///
+/// \brief EventBatch::EventSlot::AddDecayProduct Adds a photon to the event, the same as Event::AddDecayProduct.
+/// \param emissionPoint Coordinates of the emission point in mm.
+/// \param fourMomentum Fourmomentum of the photon in GeV.
+///
+void EventBatch::EventSlot::AddDecayProduct(const TLorentzVector& emissionPoint, const TLorentzVector& fourMomentum)
+{
+    int photon = fBatch_.fNoOfPhotons[fIndex_];
+    if(photon >= fBatch_.fMaxPhotons_)
+        throw(std::string("[ERROR] Too many photons added to an event of EventBatch!"));
+    int jj = fBatch_.Index(photon, fIndex_);
+    fBatch_.fX[jj] = emissionPoint.X();
+    fBatch_.fY[jj] = emissionPoint.Y();
+    fBatch_.fZ[jj] = emissionPoint.Z();
+    //scale from GeV to MeV
+    fBatch_.fPx[jj] = fourMomentum.X()*1000;
+    fBatch_.fPy[jj] = fourMomentum.Y()*1000;
+    fBatch_.fPz[jj] = fourMomentum.Z()*1000;
+    fBatch_.fE[jj] = fourMomentum.T()*1000;
+    fBatch_.fCutPassing[jj] = true;
+    fBatch_.fPrimaryPhoton[jj] = true;
+    fBatch_.fEdep[jj] = 0.0;
+    fBatch_.fEdepSmear[jj] = 0.0;
+    fBatch_.fNoOfPhotons[fIndex_] = photon+1;
+}
+
+///
+/// \brief EventBatch::CalculateHitPoints Calculates hit points on the detector's surface with the vectorized HitPointKernel.
+/// \param R Radius of the detector.
+/// \param L Length of the detector.
+///
+void EventBatch::CalculateHitPoints(double R, double L)
+{
+    //empty photon slots are processed too, their results are never read
+    for(int ii=0; ii<fMaxPhotons_; ii++)
+    {
+        const int first = ii*fCapacity_;
+        PhotonRays rays = {&fX[first], &fY[first], &fZ[first], &fPx[first], &fPy[first], &fPz[first], &fE[first]};
+        CylinderHits hits = {&fHitX[first], &fHitY[first], &fHitZ[first], &fHitT[first], &fHitPhi[first], &fHitTheta[first]};
+        HitPointKernel::Calculate(fSize_, rays, R, L, hits);
+    }
+}
+
+///
+/// \brief EventBatch::DeducePassFlags Checks if relevant gammas passed through cuts and sets pass flags of events.
+/// \tparam kType Type of decays stored in the batch.
+///
+template<DecayType kType>
+void EventBatch::DeducePassFlags()
+{
+    for(int ii=0; ii<DecayTraits<kType>::kRequiredPhotons && ii<fMaxPhotons_; ii++)
+    {
+        const int first = ii*fCapacity_;
+        for(int jj=0; jj<fSize_; jj++)
+            fPassFlag[jj] = fPassFlag[jj] && (ii >= GetNumberOfDecayProducts<kType>(jj) || fCutPassing[first+jj]);
+    }
+}
+
+template void EventBatch::DeducePassFlags<ONE>();
+template void EventBatch::DeducePassFlags<TWO>();
+template void EventBatch::DeducePassFlags<THREE>();
+template void EventBatch::DeducePassFlags<TWOandONE>();
+template void EventBatch::DeducePassFlags<TWOandN>();
+
+///
+/// \brief EventBatch::DeducePassFlags Checks if relevant gammas passed through cuts and sets pass flags of events,
+/// the decay type is dispatched at run time.
+///
+void EventBatch::DeducePassFlags()
+{
+    switch(fDecayType_)
+    {
+        case ONE: DeducePassFlags<ONE>(); break;
+        case TWO: DeducePassFlags<TWO>(); break;
+        case THREE: DeducePassFlags<THREE>(); break;
+        case TWOandONE: DeducePassFlags<TWOandONE>(); break;
+        case TWOandN: DeducePassFlags<TWOandN>(); break;
+        default: throw(std::string("[ERROR] Wrong decay type of EventBatch!"));
+    }
+}
+
+///
+/// \brief EventBatch::RemoveFailedEvents Removes events with the pass flag set to false. The remaining events are moved
+/// to the front of the batch in the same order and keep their indices in the run (see GetIndexInRun).
+/// \return Number of removed events.
+///
+int EventBatch::RemoveFailedEvents()
+{
+    int size = 0;
+    for(int jj=0; jj<fSize_; jj++)
+    {
+        if(!fPassFlag[jj])
+            continue;
+        if(size != jj)
+        {
+            fIndexInBlock[size] = fIndexInBlock[jj];
+            fNoOfPhotons[size] = fNoOfPhotons[jj];
+            fWeight[size] = fWeight[jj];
+            fPassFlag[size] = fPassFlag[jj];
+            for(int ii=0; ii<fNoOfPhotons[jj]; ii++)
+            {
+                const int from = Index(ii, jj);
+                const int to = Index(ii, size);
+                fPx[to] = fPx[from]; fPy[to] = fPy[from]; fPz[to] = fPz[from]; fE[to] = fE[from];
+                fX[to] = fX[from]; fY[to] = fY[from]; fZ[to] = fZ[from];
+                fHitX[to] = fHitX[from]; fHitY[to] = fHitY[from]; fHitZ[to] = fHitZ[from]; fHitT[to] = fHitT[from];
+                fHitPhi[to] = fHitPhi[from]; fHitTheta[to] = fHitTheta[from];
+                fEdep[to] = fEdep[from]; fEdepSmear[to] = fEdepSmear[from];
+                fCutPassing[to] = fCutPassing[from];
+                fPrimaryPhoton[to] = fPrimaryPhoton[from];
+            }
+        }
+        size++;
+    }
+    int removed = fSize_-size;
+    fSize_ = size;
+    return removed;
+}
+
+///
+/// \brief EventBatch::CopyToEvent Copies an event from the batch to an Event object, e.g. to write it to the tree.
+/// Memory of the target is reused, see Event::Reset.
+/// \param event Index of the event in the batch.
+/// \param target Event to be filled.
+///
+void EventBatch::CopyToEvent(int event, Event& target) const
+{
+    target.Reset(fDecayType_, fWeight[event]);
+    for(int ii=0; ii<fNoOfPhotons[event]; ii++)
+    {
+        int jj = Index(ii, event);
+        //fourmomenta in the batch are already in MeV
+        target.AddDecayProduct(TLorentzVector(fX[jj], fY[jj], fZ[jj], 0.0), TLorentzVector(fPx[jj], fPy[jj], fPz[jj], fE[jj]), true);
+        target.AddHitPoint(TLorentzVector(fHitX[jj], fHitY[jj], fHitZ[jj], fHitT[jj]), fHitPhi[jj], fHitTheta[jj]);
+        target.SetCutPassing(ii, fCutPassing[jj]);
+        target.SetPrimaryPhoton(ii, fPrimaryPhoton[jj]);
+        target.SetEdepOf(ii, fEdep[jj]);
+        target.SetEdepSmearOf(ii, fEdepSmear[jj]);
+    }
+    target.SetPassFlag(fPassFlag[event]);
+}
+
+///
+/// \brief EventBatch::GetMomentum Calculates the momentum of a photon, as TLorentzVector::P.
+/// \param photon Index of the photon.
+/// \param event Index of the event.
+/// \return Momentum [MeV/c].
+///
+double EventBatch::GetMomentum(int photon, int event) const
+{
+    int jj = Index(photon, event);
+    return TMath::Sqrt(fPx[jj]*fPx[jj] + fPy[jj]*fPy[jj] + fPz[jj]*fPz[jj]);
+}
+
+///
+/// \brief EventBatch::GetPhi Calculates the azimuthal angle of a photon's momentum, as TLorentzVector::Phi.
+/// \param photon Index of the photon.
+/// \param event Index of the event.
+/// \return Azimuthal angle.
+///
+double EventBatch::GetPhi(int photon, int event) const
+{
+    int jj = Index(photon, event);
+    return fPx[jj] == 0.0 && fPy[jj] == 0.0 ? 0.0 : TMath::ATan2(fPy[jj], fPx[jj]);
+}
+
+///
+/// \brief EventBatch::GetCosTheta Calculates the cosine of the polar angle of a photon's momentum, as TLorentzVector::CosTheta.
+/// \param photon Index of the photon.
+/// \param event Index of the event.
+/// \return Cosine of the polar angle.
+///
+double EventBatch::GetCosTheta(int photon, int event) const
+{
+    double ptot = GetMomentum(photon, event);
+    return ptot == 0.0 ? 1.0 : fPz[Index(photon, event)]/ptot;
+}
+
+///
+/// \brief EventBatch::GetAngle Calculates the angle between momenta of two photons, as TLorentzVector::Angle.
+/// \param photon1 Index of the first photon.
+/// \param photon2 Index of the second photon.
+/// \param event Index of the event.
+/// \return Angle between the momenta.
+///
+double EventBatch::GetAngle(int photon1, int photon2, int event) const
+{
+    int j1 = Index(photon1, event);
+    int j2 = Index(photon2, event);
+    double ptot2 = (fPx[j1]*fPx[j1] + fPy[j1]*fPy[j1] + fPz[j1]*fPz[j1])*(fPx[j2]*fPx[j2] + fPy[j2]*fPy[j2] + fPz[j2]*fPz[j2]);
+    if(ptot2 <= 0)
+        return 0.0;
+    double arg = (fPx[j1]*fPx[j2] + fPy[j1]*fPy[j2] + fPz[j1]*fPz[j2])/TMath::Sqrt(ptot2);
+    if(arg > 1.0)
+        arg = 1.0;
+    if(arg < -1.0)
+        arg = -1.0;
+    return TMath::ACos(arg);
+}
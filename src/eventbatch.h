@@ -0,0 +1,85 @@
+/// @file eventbatch.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef EVENTBATCH_H
+#define EVENTBATCH_H
+#include <vector>
+#include "TLorentzVector.h"
+#include "event.h"
+#include "decaytraits.h"
+
+///
+/// \brief The EventBatch class Structure of arrays holding a block of events of one decay type.
+///
+/// Every quantity is stored in a separate contiguous array. Values of photon k of event i are stored at the index
+/// k*capacity+i, so loops over events for a given photon run over contiguous memory and can be vectorized by the compiler.
+/// Units and meaning of all values are the same as in the Event class, which is used only to write events to the tree.
+///
+class EventBatch
+{
+    public:
+        ///
+        /// \brief The EventSlot class Handle to one event of the batch, used to fill it in the same way as Event.
+        ///
+        class EventSlot
+        {
+            public:
+                EventSlot(EventBatch& batch, int index) : fBatch_(batch), fIndex_(index) {}
+                void Reset(DecayType type, double weight);
+                void AddDecayProduct(const TLorentzVector& emissionPoint, const TLorentzVector& fourMomentum); //fourmomentum in GeV
+                inline int GetIndex() const {return fIndex_;}
+            private:
+                EventBatch& fBatch_;
+                int fIndex_;
+        };
+
+        EventBatch(DecayType type, int capacity, int maxPhotons);
+        void Clear(long firstIndex);
+        EventSlot AddEvent();
+        void CalculateHitPoints(double R, double L);
+        void DeducePassFlags();
+        template<DecayType kType> void DeducePassFlags();
+        int RemoveFailedEvents();
+        void CopyToEvent(int event, Event& target) const;
+        //getters
+        inline DecayType GetDecayType() const {return fDecayType_;}
+        inline int GetSize() const {return fSize_;}
+        inline int GetCapacity() const {return fCapacity_;}
+        inline int GetMaxPhotons() const {return fMaxPhotons_;}
+        inline long GetFirstIndex() const {return fFirstIndex_;}
+        //index of the event in the run, it selects substreams of random numbers and is kept when events are removed
+        inline long GetIndexInRun(int event) const {return fFirstIndex_+fIndexInBlock[event];}
+        inline int GetNumberOfDecayProducts(int event) const {return fNoOfPhotons[event];}
+        //the same, but known at compile time for decay types with a fixed number of photons
+        template<DecayType kType> inline int GetNumberOfDecayProducts(int event) const
+            {return DecayTraits<kType>::kFixedPhotons>0 ? DecayTraits<kType>::kFixedPhotons : fNoOfPhotons[event];}
+        inline int Index(int photon, int event) const {return photon*fCapacity_ + event;}
+        //kinematics of photons, calculated in the same way as by TLorentzVector
+        double GetMomentum(int photon, int event) const;
+        double GetPhi(int photon, int event) const;
+        double GetCosTheta(int photon, int event) const;
+        double GetAngle(int photon1, int photon2, int event) const;
+
+        //per-event values
+        std::vector<int> fIndexInBlock; //position of the event in the block, at which it was added
+        std::vector<int> fNoOfPhotons; //number of photons in the event
+        std::vector<double> fWeight; //weight of the event
+        std::vector<char> fPassFlag; //if true, event can be reconstructed -- all necessary gammas passed through cuts
+        //per-photon values, indexed with Index(photon, event)
+        std::vector<double> fPx, fPy, fPz, fE; //fourmomentum [MeV/c and MeV]
+        std::vector<double> fX, fY, fZ; //emission point [mm]
+        std::vector<double> fHitX, fHitY, fHitZ, fHitT; //hit point [mm and mikro s]
+        std::vector<double> fHitPhi, fHitTheta; //angles of the hit point, -4 if the detector was missed
+        std::vector<double> fEdep, fEdepSmear; //deposited energy, without and with experimental smearing
+        std::vector<char> fCutPassing; //indicates if gamma passed through cuts
+        std::vector<char> fPrimaryPhoton; //true if photon is primary (not scattered)
+
+    private:
+        DecayType fDecayType_; //type of all events in the batch
+        int fCapacity_; //maximal number of events
+        int fMaxPhotons_; //maximal number of photons in one event
+        int fSize_; //current number of events
+        long fFirstIndex_; //index of the first event of the batch in the run
+};
+
+#endif // EVENTBATCH_H
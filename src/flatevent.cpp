@@ -0,0 +1,143 @@
+/// @file flatevent.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <string>
+#include "flatevent.h"
+
+const char* FlatEvent::kPhotonColumns[] = {"x", "y", "z", "px", "py", "pz", "E", "hitX", "hitY", "hitZ", "hitT", "hitPhi",
+                                           "hitTheta", "edep", "edepSmear", "cutPassing", "primary", nullptr};
+
+///
+/// \brief FlatEvent::FlatEvent The only constructor used, memory of all arrays is allocated here.
+/// \param capacity Maximal number of photons in an event.
+///
+FlatEvent::FlatEvent(int capacity) :
+    fCapacity_(capacity > 0 ? capacity : 1),
+    fId_(0),
+    fDecayType_(0),
+    fWeight_(0.0),
+    fPassFlag_(false),
+    fNoOfPhotons_(0)
+{
+    fX_ = new Double_t[fCapacity_]();
+    fY_ = new Double_t[fCapacity_]();
+    fZ_ = new Double_t[fCapacity_]();
+    fPx_ = new Double_t[fCapacity_]();
+    fPy_ = new Double_t[fCapacity_]();
+    fPz_ = new Double_t[fCapacity_]();
+    fE_ = new Double_t[fCapacity_]();
+    fHitX_ = new Double_t[fCapacity_]();
+    fHitY_ = new Double_t[fCapacity_]();
+    fHitZ_ = new Double_t[fCapacity_]();
+    fHitT_ = new Double_t[fCapacity_]();
+    fHitPhi_ = new Double_t[fCapacity_]();
+    fHitTheta_ = new Double_t[fCapacity_]();
+    fEdep_ = new Double_t[fCapacity_]();
+    fEdepSmear_ = new Double_t[fCapacity_]();
+    fCutPassing_ = new Bool_t[fCapacity_]();
+    fPrimary_ = new Bool_t[fCapacity_]();
+}
+
+FlatEvent::~FlatEvent()
+{
+    delete[] fX_;
+    delete[] fY_;
+    delete[] fZ_;
+    delete[] fPx_;
+    delete[] fPy_;
+    delete[] fPz_;
+    delete[] fE_;
+    delete[] fHitX_;
+    delete[] fHitY_;
+    delete[] fHitZ_;
+    delete[] fHitT_;
+    delete[] fHitPhi_;
+    delete[] fHitTheta_;
+    delete[] fEdep_;
+    delete[] fEdepSmear_;
+    delete[] fCutPassing_;
+    delete[] fPrimary_;
+}
+
+///
+/// \brief FlatEvent::Attach Creates branches of the flat schema in the tree or, if they exist (e.g. they were created for
+/// another decay type), sets their addresses to the buffers of this object.
+/// \param tree Tree to be filled.
+///
+void FlatEvent::Attach(TTree* tree)
+{
+    if(tree->GetBranch("nPhotons"))
+    {
+        tree->SetBranchAddress("id", &fId_);
+        tree->SetBranchAddress("decayType", &fDecayType_);
+        tree->SetBranchAddress("weight", &fWeight_);
+        tree->SetBranchAddress("passFlag", &fPassFlag_);
+        tree->SetBranchAddress("nPhotons", &fNoOfPhotons_);
+    }
+    else
+    {
+        tree->Branch("id", &fId_, "id/L");
+        tree->Branch("decayType", &fDecayType_, "decayType/I");
+        tree->Branch("weight", &fWeight_, "weight/D");
+        tree->Branch("passFlag", &fPassFlag_, "passFlag/O");
+        tree->Branch("nPhotons", &fNoOfPhotons_, "nPhotons/I");
+    }
+    void* addresses[] = {fX_, fY_, fZ_, fPx_, fPy_, fPz_, fE_, fHitX_, fHitY_, fHitZ_, fHitT_, fHitPhi_, fHitTheta_, fEdep_,
+                         fEdepSmear_, fCutPassing_, fPrimary_};
+    const char leafTypes[] = "DDDDDDDDDDDDDDDOO"; //ROOT type codes of the columns
+    for(int ii=0; kPhotonColumns[ii]!=nullptr; ii++)
+        AttachArray_(tree, kPhotonColumns[ii], addresses[ii], leafTypes[ii]);
+}
+
+///
+/// \brief FlatEvent::AttachArray_ Creates an array branch indexed by nPhotons or sets the address of an existing one.
+/// \param tree Tree to be filled.
+/// \param name Name of the branch.
+/// \param address Address of the array.
+/// \param leafType ROOT type code of the elements ('D' or 'O').
+///
+void FlatEvent::AttachArray_(TTree* tree, const char* name, void* address, char leafType)
+{
+    if(tree->GetBranch(name))
+        tree->SetBranchAddress(name, address);
+    else
+        tree->Branch(name, address, (std::string(name)+"[nPhotons]/"+leafType).c_str());
+}
+
+///
+/// \brief FlatEvent::Set Copies an event to the buffers, so that it is written by the next TTree::Fill.
+/// \param event Event to be copied, it can not have more photons than the capacity.
+///
+void FlatEvent::Set(const Event& event)
+{
+    if(event.GetNumberOfDecayProducts() > fCapacity_)
+        throw(std::string("[ERROR] Event has more photons than the capacity of FlatEvent!"));
+    fId_ = event.fId;
+    fDecayType_ = event.GetDecayType();
+    fWeight_ = event.GetWeight();
+    fPassFlag_ = event.GetPassFlag();
+    fNoOfPhotons_ = event.GetNumberOfDecayProducts();
+    for(int ii=0; ii<fNoOfPhotons_; ii++)
+    {
+        const TLorentzVector* emission = event.GetEmissionPointOf(ii);
+        const TLorentzVector* momentum = event.GetFourMomentumOf(ii);
+        const TLorentzVector* hit = event.GetHitPointOf(ii);
+        fX_[ii] = emission->X();
+        fY_[ii] = emission->Y();
+        fZ_[ii] = emission->Z();
+        fPx_[ii] = momentum->Px();
+        fPy_[ii] = momentum->Py();
+        fPz_[ii] = momentum->Pz();
+        fE_[ii] = momentum->E();
+        fHitX_[ii] = hit->X();
+        fHitY_[ii] = hit->Y();
+        fHitZ_[ii] = hit->Z();
+        fHitT_[ii] = hit->T();
+        fHitPhi_[ii] = event.GetHitPhiOf(ii);
+        fHitTheta_[ii] = event.GetHitThetaOf(ii);
+        fEdep_[ii] = event.GetEdepOf(ii);
+        fEdepSmear_[ii] = event.GetEdepSmearOf(ii);
+        fCutPassing_[ii] = event.GetCutPassingOf(ii);
+        fPrimary_[ii] = event.GetPrimaryPhoton(ii);
+    }
+}
@@ -0,0 +1,60 @@
+/// @file flatevent.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef FLATEVENT_H
+#define FLATEVENT_H
+#include "TTree.h"
+#include "event.h"
+
+///
+/// \brief The FlatEvent class Buffers of the flat (columnar) tree schema, one branch per primitive column.
+///
+/// Scalars of the event are stored in branches id, decayType, weight, passFlag and nPhotons. Every photon quantity
+/// is a variable length array indexed by nPhotons, e.g. px[nPhotons], so the tree can be read by RDataFrame or
+/// TTreeReader without the Event dictionary. Units are the same as in Event: mm, MeV, MeV/c and mikro s.
+///
+class FlatEvent
+{
+    public:
+        explicit FlatEvent(int capacity);
+        FlatEvent(const FlatEvent&) = delete;
+        FlatEvent& operator=(const FlatEvent&) = delete;
+        ~FlatEvent();
+
+        void Attach(TTree* tree);
+        void Set(const Event& event);
+        inline int GetCapacity() const {return fCapacity_;}
+
+        static const char* kPhotonColumns[]; //names of the array branches, terminated with nullptr
+
+    private:
+        int fCapacity_; //size of all arrays, the maximal number of photons in an event
+        //scalars
+        Long64_t fId_;
+        Int_t fDecayType_;
+        Double_t fWeight_;
+        Bool_t fPassFlag_;
+        Int_t fNoOfPhotons_;
+        //arrays, the order of columns is the same as in kPhotonColumns
+        Double_t* fX_; //emission point [mm]
+        Double_t* fY_;
+        Double_t* fZ_;
+        Double_t* fPx_; //momentum [MeV/c]
+        Double_t* fPy_;
+        Double_t* fPz_;
+        Double_t* fE_; //energy [MeV]
+        Double_t* fHitX_; //hit point [mm]
+        Double_t* fHitY_;
+        Double_t* fHitZ_;
+        Double_t* fHitT_; //time of the hit [mikro s]
+        Double_t* fHitPhi_; //azimuthal angle of the hit point, -4 if the detector was missed
+        Double_t* fHitTheta_; //polar angle of the hit point, -4 if the detector was missed
+        Double_t* fEdep_; //deposited energy [MeV]
+        Double_t* fEdepSmear_; //deposited energy with experimental smearing [MeV]
+        Bool_t* fCutPassing_; //true if the photon passed the cuts
+        Bool_t* fPrimary_; //true if the photon was not scattered in the phantom
+
+        void AttachArray_(TTree* tree, const char* name, void* address, char leafType);
+};
+
+#endif // FLATEVENT_H
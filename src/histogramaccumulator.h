@@ -0,0 +1,209 @@
+/// @file histogramaccumulator.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef HISTOGRAMACCUMULATOR_H
+#define HISTOGRAMACCUMULATOR_H
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include "TH1.h"
+#include "TH2.h"
+#include "TAxis.h"
+
+///
+/// \brief The HistogramDimension struct Dimension of histograms supported by HistogramAccumulator, other types do not compile.
+///
+template<typename T> struct HistogramDimension;
+template<> struct HistogramDimension<TH1F> {static const int value = 1;};
+template<> struct HistogramDimension<TH1D> {static const int value = 1;};
+template<> struct HistogramDimension<TH2F> {static const int value = 2;};
+
+///
+/// \brief The HistogramAccumulator class Fixed-binning accumulator standing in front of a TH1F or TH2F.
+///
+/// Fill computes the bin inline (in the same way as TAxis::FindBin for fixed bins) and adds the weight to plain arrays,
+/// together with the statistics kept by TH1::Fill. Nothing is added to the ROOT histogram until it is accessed through
+/// the accumulator (operator-> or Get), which merges the accumulated content into it. The accumulator does not own
+/// the histogram: it is assigned a new histogram and the owner takes it back with Release (e.g. to delete it), while
+/// filling is cheap and does not touch ROOT. Like filling through a pointer, Fill is allowed in const methods.
+/// Fill takes the arguments of TH1::Fill for one-dimensional histograms and of TH2::Fill for two-dimensional ones.
+/// An accumulator is used by one thread (e.g. one per SimulationWorker); parallel results are merged with TH1::Add.
+///
+template<typename T>
+class HistogramAccumulator
+{
+    public:
+        HistogramAccumulator();
+        HistogramAccumulator(const HistogramAccumulator&) = delete; //two copies would merge the same content twice
+        HistogramAccumulator& operator=(const HistogramAccumulator&) = delete;
+        HistogramAccumulator& operator=(T* hist);
+
+        inline T* Get() const {Flush_(); return fHist_;}
+        inline T* operator->() const {return Get();}
+        T* Release();
+        //TH1::Fill(x, w)
+        template<int D = HistogramDimension<T>::value>
+        inline typename std::enable_if<D==1>::type Fill(double x, double w = 1.0) const {Fill1D_(x, w);}
+        //TH2::Fill(x, y, w)
+        template<int D = HistogramDimension<T>::value>
+        inline typename std::enable_if<D==2>::type Fill(double x, double y, double w = 1.0) const {Fill2D_(x, y, w);}
+
+    private:
+        T* fHist_; //histogram receiving the accumulated content
+        int fNoOfBinsX_, fNoOfBinsY_; //numbers of bins, fNoOfBinsY_ is 0 for one-dimensional histograms
+        double fXmin_, fXmax_, fYmin_, fYmax_; //ranges of axes
+        mutable std::vector<double> fSumw_; //bin contents, including underflow and overflow bins
+        mutable std::vector<double> fSumw2_; //sums of squares of weights in bins
+        mutable double fStats_[7]; //sumw, sumw2, sumwx, sumwx2, sumwy, sumwy2, sumwxy, as in TH1::GetStats
+        mutable double fEntries_; //number of fills
+        mutable bool fWeighted_; //true if a weight other than 1 was used, ROOT enables Sumw2 in that case
+        mutable bool fEmpty_; //true if nothing was accumulated since the last flush
+
+        static inline int FindBin_(double x, int noOfBins, double min, double max)
+        {
+            if(x < min)
+                return 0;
+            if(!(x < max))
+                return noOfBins+1;
+            return 1 + int(noOfBins*(x-min)/(max-min));
+        }
+        inline void Fill1D_(double x, double w) const
+        {
+            int bin = FindBin_(x, fNoOfBinsX_, fXmin_, fXmax_);
+            Add_(bin, w);
+            if(bin==0 || bin>fNoOfBinsX_)
+                return;
+            fStats_[0] += w;
+            fStats_[1] += w*w;
+            fStats_[2] += w*x;
+            fStats_[3] += w*x*x;
+        }
+        inline void Fill2D_(double x, double y, double w) const
+        {
+            int binx = FindBin_(x, fNoOfBinsX_, fXmin_, fXmax_);
+            int biny = FindBin_(y, fNoOfBinsY_, fYmin_, fYmax_);
+            Add_(biny*(fNoOfBinsX_+2) + binx, w);
+            if(binx==0 || binx>fNoOfBinsX_ || biny==0 || biny>fNoOfBinsY_)
+                return;
+            fStats_[0] += w;
+            fStats_[1] += w*w;
+            fStats_[2] += w*x;
+            fStats_[3] += w*x*x;
+            fStats_[4] += w*y;
+            fStats_[5] += w*y*y;
+            fStats_[6] += w*x*y;
+        }
+        inline void Add_(int bin, double w) const
+        {
+            fSumw_[bin] += w;
+            fSumw2_[bin] += w*w;
+            fEntries_ += 1.0;
+            fWeighted_ |= w!=1.0;
+            fEmpty_ = false;
+        }
+        void Flush_() const;
+        void Clear_() const;
+};
+
+///
+/// \brief HistogramAccumulator::HistogramAccumulator Creates an accumulator without a histogram, it must be assigned before filling.
+///
+template<typename T>
+HistogramAccumulator<T>::HistogramAccumulator() :
+    fHist_(nullptr),
+    fNoOfBinsX_(0),
+    fNoOfBinsY_(0),
+    fXmin_(0.0),
+    fXmax_(0.0),
+    fYmin_(0.0),
+    fYmax_(0.0),
+    fEntries_(0.0),
+    fWeighted_(false),
+    fEmpty_(true)
+{
+    Clear_();
+}
+
+///
+/// \brief HistogramAccumulator::operator= Assigns a histogram, its binning is used from now on.
+/// Content accumulated for the previous histogram is merged into it first.
+/// \param hist Histogram with fixed bins, may be nullptr.
+/// \return Reference to this accumulator.
+///
+template<typename T>
+HistogramAccumulator<T>& HistogramAccumulator<T>::operator=(T* hist)
+{
+    Flush_();
+    fHist_ = hist;
+    fNoOfBinsX_ = hist ? hist->GetXaxis()->GetNbins() : 0;
+    fXmin_ = hist ? hist->GetXaxis()->GetXmin() : 0.0;
+    fXmax_ = hist ? hist->GetXaxis()->GetXmax() : 0.0;
+    fNoOfBinsY_ = hist && HistogramDimension<T>::value>1 ? hist->GetYaxis()->GetNbins() : 0;
+    fYmin_ = fNoOfBinsY_>0 ? hist->GetYaxis()->GetXmin() : 0.0;
+    fYmax_ = fNoOfBinsY_>0 ? hist->GetYaxis()->GetXmax() : 0.0;
+    const int noOfCells = (fNoOfBinsX_+2)*(fNoOfBinsY_>0 ? fNoOfBinsY_+2 : 1);
+    fSumw_.assign(noOfCells, 0.0);
+    fSumw2_.assign(noOfCells, 0.0);
+    Clear_();
+    return *this;
+}
+
+///
+/// \brief HistogramAccumulator::Release Merges the accumulated content and gives the histogram back to the caller.
+/// \return Histogram assigned to the accumulator (may be nullptr), the accumulator is left without a histogram.
+///
+template<typename T>
+T* HistogramAccumulator<T>::Release()
+{
+    T* hist = Get();
+    *this = nullptr;
+    return hist;
+}
+
+///
+/// \brief HistogramAccumulator::Clear_ Sets accumulated content to zero.
+///
+template<typename T>
+void HistogramAccumulator<T>::Clear_() const
+{
+    std::fill(fSumw_.begin(), fSumw_.end(), 0.0);
+    std::fill(fSumw2_.begin(), fSumw2_.end(), 0.0);
+    for(int ii=0; ii<7; ii++)
+        fStats_[ii] = 0.0;
+    fEntries_ = 0.0;
+    fWeighted_ = false;
+    fEmpty_ = true;
+}
+
+///
+/// \brief HistogramAccumulator::Flush_ Adds the accumulated content (bins, errors, statistics and entries) to the histogram.
+///
+template<typename T>
+void HistogramAccumulator<T>::Flush_() const
+{
+    if(fEmpty_ || !fHist_)
+        return;
+    //statistics are read before bins change, otherwise ROOT could recompute them from the bins
+    double stats[13] = {0.0};
+    fHist_->GetStats(stats);
+    const double entries = fHist_->GetEntries();
+    if(fWeighted_ && fHist_->GetSumw2N()==0)
+        fHist_->Sumw2();
+    const bool hasSumw2 = fHist_->GetSumw2N()>0;
+    for(unsigned ii=0; ii<fSumw_.size(); ii++)
+    {
+        if(fSumw_[ii]==0.0 && fSumw2_[ii]==0.0)
+            continue;
+        fHist_->AddBinContent(ii, fSumw_[ii]);
+        if(hasSumw2)
+            fHist_->GetSumw2()->fArray[ii] += fSumw2_[ii];
+    }
+    const int noOfStats = fNoOfBinsY_>0 ? 7 : 4;
+    for(int ii=0; ii<noOfStats; ii++)
+        stats[ii] += fStats_[ii];
+    fHist_->PutStats(stats);
+    fHist_->SetEntries(entries+fEntries_);
+    Clear_();
+}
+
+#endif // HISTOGRAMACCUMULATOR_H
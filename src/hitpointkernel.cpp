@@ -0,0 +1,286 @@
+/// @file hitpointkernel.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <string>
+#include "TMath.h"
+#include "hitpointkernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HITPOINTKERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    const double kMinPt = TMath::Power(10, -10); //photons with lower transverse momentum miss the barrel
+    const double kLightSpeed = 299792458.0; //[m/s], the same as light_speed_SI
+    const double kMissPoint = -2000; //coordinates of a hit point for photons that missed the detector
+    const double kMissAngle = -4; //angles of a hit point for photons that missed the detector
+}
+
+///
+/// \brief HitPointKernel::CalculateOne Calculates the hit point of a single photon.
+/// \param x0 X coordinate of the emission point.
+/// \param y0 Y coordinate of the emission point.
+/// \param z0 Z coordinate of the emission point.
+/// \param px X component of the momentum.
+/// \param py Y component of the momentum.
+/// \param pz Z component of the momentum.
+/// \param E Energy of the photon.
+/// \param R Radius of the detector.
+/// \param L Length of the detector.
+/// \param hitX Set to X coordinate of the hit point.
+/// \param hitY Set to Y coordinate of the hit point.
+/// \param hitZ Set to Z coordinate of the hit point.
+/// \param hitT Set to the time of flight.
+/// \param hitPhi Set to the azimuthal angle of the hit point.
+/// \param hitTheta Set to the polar angle of the hit point.
+///
+void HitPointKernel::CalculateOne(double x0, double y0, double z0, double px, double py, double pz, double E, double R, double L,\
+                                  double& hitX, double& hitY, double& hitZ, double& hitT, double& hitPhi, double& hitTheta)
+{
+    double b = x0*px+y0*py;
+    double pt2 = px*px+py*py;
+    double delta = 4*b*b - 4*(x0*x0+y0*y0-R*R)*pt2;
+    double s = (-2*b+TMath::Sqrt(delta))/2/pt2;
+    double z = z0+pz*s;
+    if(!(TMath::Sqrt(pt2) > kMinPt) || TMath::Abs(z) > L/2.0)
+    {
+        hitX = hitY = hitZ = hitT = kMissPoint;
+        hitPhi = hitTheta = kMissAngle;
+        return;
+    }
+    hitX = x0+px*s;
+    hitY = y0+py*s;
+    hitZ = z;
+    hitT = E*s*1000000/kLightSpeed;
+    //the same as TVector3::Phi and TVector3::Theta
+    hitPhi = hitX == 0.0 && hitY == 0.0 ? 0.0 : TMath::ATan2(hitY, hitX);
+    hitTheta = hitX == 0.0 && hitY == 0.0 && hitZ == 0.0 ? 0.0 : TMath::ATan2(TMath::Sqrt(hitX*hitX + hitY*hitY), hitZ);
+}
+
+///
+/// \brief HitPointKernel::Calculate Calculates hit points of n photons.
+/// \param n Number of photons.
+/// \param rays Emission points and fourmomenta of photons.
+/// \param R Radius of the detector.
+/// \param L Length of the detector.
+/// \param hits Arrays to be filled with hit points, each has to hold at least n values.
+/// \param impl Implementation to be used, the best supported by the CPU if AUTO.
+///
+void HitPointKernel::Calculate(int n, const PhotonRays& rays, double R, double L, CylinderHits& hits, Implementation impl)
+{
+    if(impl == AUTO)
+        impl = GetBestImplementation();
+    else if(!IsSupported(impl))
+        throw(std::string("[ERROR] Selected implementation of HitPointKernel is not supported by the CPU!"));
+    if(impl == AVX512)
+        CalculateAVX512_(n, rays, R, L, hits);
+    else if(impl == AVX2)
+        CalculateAVX2_(n, rays, R, L, hits);
+    else
+        CalculateScalar_(0, n, rays, R, L, hits);
+}
+
+///
+/// \brief HitPointKernel::IsSupported Checks if the implementation can be used on this CPU.
+/// \param impl Implementation to be checked.
+/// \return True if the implementation is available.
+///
+bool HitPointKernel::IsSupported(Implementation impl)
+{
+    if(impl == AUTO || impl == SCALAR)
+        return true;
+#ifdef HITPOINTKERNEL_X86
+    if(impl == AVX2)
+        return __builtin_cpu_supports("avx2");
+    if(impl == AVX512)
+        return __builtin_cpu_supports("avx512f");
+#endif
+    return false;
+}
+
+///
+/// \brief HitPointKernel::GetBestImplementation Chooses the fastest implementation supported by the CPU, checked only once.
+/// \return Implementation used when AUTO is selected.
+///
+HitPointKernel::Implementation HitPointKernel::GetBestImplementation()
+{
+    static const Implementation best = IsSupported(AVX512) ? AVX512 : (IsSupported(AVX2) ? AVX2 : SCALAR);
+    return best;
+}
+
+///
+/// \brief HitPointKernel::CalculateScalar_ Scalar implementation, also used for the remainders of vector loops.
+/// \param first Index of the first photon.
+/// \param n Number of photons, photons from first to n-1 are processed.
+/// \param rays Emission points and fourmomenta of photons.
+/// \param R Radius of the detector.
+/// \param L Length of the detector.
+/// \param hits Arrays to be filled with hit points.
+///
+void HitPointKernel::CalculateScalar_(int first, int n, const PhotonRays& rays, double R, double L, CylinderHits& hits)
+{
+    for(int ii=first; ii<n; ii++)
+        CalculateOne(rays.fX[ii], rays.fY[ii], rays.fZ[ii], rays.fPx[ii], rays.fPy[ii], rays.fPz[ii], rays.fE[ii], R, L,\
+                     hits.fX[ii], hits.fY[ii], hits.fZ[ii], hits.fT[ii], hits.fPhi[ii], hits.fTheta[ii]);
+}
+
+///
+/// \brief HitPointKernel::CalculateAngles_ Calculates angles of hit points, which have no vector implementation.
+/// Hit points with angles already set to -4 missed the detector and are skipped.
+/// \param first Index of the first hit point.
+/// \param n Number of hit points, points from first to n-1 are processed.
+/// \param hits Arrays with hit points.
+///
+void HitPointKernel::CalculateAngles_(int first, int n, CylinderHits& hits)
+{
+    for(int ii=first; ii<n; ii++)
+    {
+        if(hits.fPhi[ii] == kMissAngle)
+            continue;
+        double x = hits.fX[ii];
+        double y = hits.fY[ii];
+        double z = hits.fZ[ii];
+        hits.fPhi[ii] = x == 0.0 && y == 0.0 ? 0.0 : TMath::ATan2(y, x);
+        hits.fTheta[ii] = x == 0.0 && y == 0.0 && z == 0.0 ? 0.0 : TMath::ATan2(TMath::Sqrt(x*x + y*y), z);
+    }
+}
+
+#ifdef HITPOINTKERNEL_X86
+
+namespace
+{
+    ///
+    /// \brief Sqrt512_ Square root of eight values. The masked intrinsic avoids a false maybe-uninitialized warning
+    /// issued for _mm512_sqrt_pd by some versions of GCC.
+    ///
+    __attribute__((target("avx512f")))
+    inline __m512d Sqrt512_(__m512d x)
+    {
+        return _mm512_mask_sqrt_pd(x, static_cast<__mmask8>(0xFF), x);
+    }
+}
+
+///
+/// \brief HitPointKernel::CalculateAVX2_ AVX2 implementation, four photons per iteration.
+/// \param n Number of photons.
+/// \param rays Emission points and fourmomenta of photons.
+/// \param R Radius of the detector.
+/// \param L Length of the detector.
+/// \param hits Arrays to be filled with hit points.
+///
+__attribute__((target("avx2")))
+void HitPointKernel::CalculateAVX2_(int n, const PhotonRays& rays, double R, double L, CylinderHits& hits)
+{
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d minusTwo = _mm256_set1_pd(-2.0);
+    const __m256d R2 = _mm256_set1_pd(R*R);
+    const __m256d halfL = _mm256_set1_pd(L/2.0);
+    const __m256d minPt = _mm256_set1_pd(kMinPt);
+    const __m256d scaleT = _mm256_set1_pd(1000000.0);
+    const __m256d lightSpeed = _mm256_set1_pd(kLightSpeed);
+    const __m256d missPoint = _mm256_set1_pd(kMissPoint);
+    const __m256d missAngle = _mm256_set1_pd(kMissAngle);
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    int ii = 0;
+    for(; ii+4<=n; ii+=4)
+    {
+        __m256d x0 = _mm256_loadu_pd(rays.fX+ii);
+        __m256d y0 = _mm256_loadu_pd(rays.fY+ii);
+        __m256d z0 = _mm256_loadu_pd(rays.fZ+ii);
+        __m256d px = _mm256_loadu_pd(rays.fPx+ii);
+        __m256d py = _mm256_loadu_pd(rays.fPy+ii);
+        __m256d pz = _mm256_loadu_pd(rays.fPz+ii);
+        __m256d E = _mm256_loadu_pd(rays.fE+ii);
+        __m256d b = _mm256_add_pd(_mm256_mul_pd(x0, px), _mm256_mul_pd(y0, py));
+        __m256d pt2 = _mm256_add_pd(_mm256_mul_pd(px, px), _mm256_mul_pd(py, py));
+        __m256d r02 = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(x0, x0), _mm256_mul_pd(y0, y0)), R2);
+        __m256d delta = _mm256_sub_pd(_mm256_mul_pd(_mm256_mul_pd(four, b), b), _mm256_mul_pd(_mm256_mul_pd(four, r02), pt2));
+        __m256d s = _mm256_div_pd(_mm256_div_pd(_mm256_add_pd(_mm256_mul_pd(minusTwo, b), _mm256_sqrt_pd(delta)), two), pt2);
+        __m256d z = _mm256_add_pd(z0, _mm256_mul_pd(pz, s));
+        //hit if sqrt(pt2) > minPt and not |z| > L/2, as in the scalar implementation
+        __m256d hit = _mm256_and_pd(_mm256_cmp_pd(_mm256_sqrt_pd(pt2), minPt, _CMP_GT_OQ),\
+                                    _mm256_cmp_pd(_mm256_andnot_pd(signMask, z), halfL, _CMP_NGT_UQ));
+        __m256d x = _mm256_add_pd(x0, _mm256_mul_pd(px, s));
+        __m256d y = _mm256_add_pd(y0, _mm256_mul_pd(py, s));
+        __m256d t = _mm256_div_pd(_mm256_mul_pd(_mm256_mul_pd(E, s), scaleT), lightSpeed);
+        _mm256_storeu_pd(hits.fX+ii, _mm256_blendv_pd(missPoint, x, hit));
+        _mm256_storeu_pd(hits.fY+ii, _mm256_blendv_pd(missPoint, y, hit));
+        _mm256_storeu_pd(hits.fZ+ii, _mm256_blendv_pd(missPoint, z, hit));
+        _mm256_storeu_pd(hits.fT+ii, _mm256_blendv_pd(missPoint, t, hit));
+        _mm256_storeu_pd(hits.fPhi+ii, _mm256_blendv_pd(missAngle, _mm256_setzero_pd(), hit));
+        _mm256_storeu_pd(hits.fTheta+ii, missAngle);
+    }
+    CalculateAngles_(0, ii, hits);
+    CalculateScalar_(ii, n, rays, R, L, hits);
+}
+
+///
+/// \brief HitPointKernel::CalculateAVX512_ AVX-512 implementation, eight photons per iteration.
+/// \param n Number of photons.
+/// \param rays Emission points and fourmomenta of photons.
+/// \param R Radius of the detector.
+/// \param L Length of the detector.
+/// \param hits Arrays to be filled with hit points.
+///
+__attribute__((target("avx512f")))
+void HitPointKernel::CalculateAVX512_(int n, const PhotonRays& rays, double R, double L, CylinderHits& hits)
+{
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d four = _mm512_set1_pd(4.0);
+    const __m512d minusTwo = _mm512_set1_pd(-2.0);
+    const __m512d R2 = _mm512_set1_pd(R*R);
+    const __m512d halfL = _mm512_set1_pd(L/2.0);
+    const __m512d minPt = _mm512_set1_pd(kMinPt);
+    const __m512d scaleT = _mm512_set1_pd(1000000.0);
+    const __m512d lightSpeed = _mm512_set1_pd(kLightSpeed);
+    const __m512d missPoint = _mm512_set1_pd(kMissPoint);
+    const __m512d missAngle = _mm512_set1_pd(kMissAngle);
+    int ii = 0;
+    for(; ii+8<=n; ii+=8)
+    {
+        __m512d x0 = _mm512_loadu_pd(rays.fX+ii);
+        __m512d y0 = _mm512_loadu_pd(rays.fY+ii);
+        __m512d z0 = _mm512_loadu_pd(rays.fZ+ii);
+        __m512d px = _mm512_loadu_pd(rays.fPx+ii);
+        __m512d py = _mm512_loadu_pd(rays.fPy+ii);
+        __m512d pz = _mm512_loadu_pd(rays.fPz+ii);
+        __m512d E = _mm512_loadu_pd(rays.fE+ii);
+        __m512d b = _mm512_add_pd(_mm512_mul_pd(x0, px), _mm512_mul_pd(y0, py));
+        __m512d pt2 = _mm512_add_pd(_mm512_mul_pd(px, px), _mm512_mul_pd(py, py));
+        __m512d r02 = _mm512_sub_pd(_mm512_add_pd(_mm512_mul_pd(x0, x0), _mm512_mul_pd(y0, y0)), R2);
+        __m512d delta = _mm512_sub_pd(_mm512_mul_pd(_mm512_mul_pd(four, b), b), _mm512_mul_pd(_mm512_mul_pd(four, r02), pt2));
+        __m512d s = _mm512_div_pd(_mm512_div_pd(_mm512_add_pd(_mm512_mul_pd(minusTwo, b), Sqrt512_(delta)), two), pt2);
+        __m512d z = _mm512_add_pd(z0, _mm512_mul_pd(pz, s));
+        //hit if sqrt(pt2) > minPt and not |z| > L/2, as in the scalar implementation
+        __mmask8 hit = _mm512_cmp_pd_mask(Sqrt512_(pt2), minPt, _CMP_GT_OQ)\
+                       & _mm512_cmp_pd_mask(_mm512_abs_pd(z), halfL, _CMP_NGT_UQ);
+        __m512d x = _mm512_add_pd(x0, _mm512_mul_pd(px, s));
+        __m512d y = _mm512_add_pd(y0, _mm512_mul_pd(py, s));
+        __m512d t = _mm512_div_pd(_mm512_mul_pd(_mm512_mul_pd(E, s), scaleT), lightSpeed);
+        _mm512_storeu_pd(hits.fX+ii, _mm512_mask_blend_pd(hit, missPoint, x));
+        _mm512_storeu_pd(hits.fY+ii, _mm512_mask_blend_pd(hit, missPoint, y));
+        _mm512_storeu_pd(hits.fZ+ii, _mm512_mask_blend_pd(hit, missPoint, z));
+        _mm512_storeu_pd(hits.fT+ii, _mm512_mask_blend_pd(hit, missPoint, t));
+        _mm512_storeu_pd(hits.fPhi+ii, _mm512_mask_blend_pd(hit, missAngle, _mm512_setzero_pd()));
+        _mm512_storeu_pd(hits.fTheta+ii, missAngle);
+    }
+    CalculateAngles_(0, ii, hits);
+    CalculateScalar_(ii, n, rays, R, L, hits);
+}
+
+#else
+
+void HitPointKernel::CalculateAVX2_(int n, const PhotonRays& rays, double R, double L, CylinderHits& hits)
+{
+    CalculateScalar_(0, n, rays, R, L, hits);
+}
+
+void HitPointKernel::CalculateAVX512_(int n, const PhotonRays& rays, double R, double L, CylinderHits& hits)
+{
+    CalculateScalar_(0, n, rays, R, L, hits);
+}
+
+#endif
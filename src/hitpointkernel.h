@@ -0,0 +1,61 @@
+/// @file hitpointkernel.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef HITPOINTKERNEL_H
+#define HITPOINTKERNEL_H
+
+///
+/// \brief The PhotonRays struct Pointers to contiguous arrays with emission points [mm] and fourmomenta [MeV] of photons.
+///
+struct PhotonRays
+{
+    const double* fX;
+    const double* fY;
+    const double* fZ;
+    const double* fPx;
+    const double* fPy;
+    const double* fPz;
+    const double* fE;
+};
+
+///
+/// \brief The CylinderHits struct Pointers to contiguous arrays filled with hit points [mm and mikro s] and their angles.
+///
+struct CylinderHits
+{
+    double* fX;
+    double* fY;
+    double* fZ;
+    double* fT;
+    double* fPhi;
+    double* fTheta;
+};
+
+///
+/// \brief The HitPointKernel class Intersection of photon rays with the barrel of the detector.
+///
+/// Rays are intersected with the side surface of a cylinder of radius R and length L, centered at the origin.
+/// Photons that do not hit the barrel get coordinates -2000 and angles -4, as in Event::CalculateHitPoints.
+/// The vector implementations (AVX2, AVX-512) perform the same IEEE operations in the same order as the scalar one,
+/// so all implementations give bit-identical results as long as the compiler does not fuse them into FMA instructions
+/// (hence -ffp-contract=off in the Makefiles). The best implementation supported by the CPU is chosen at run time.
+///
+class HitPointKernel
+{
+    public:
+        enum Implementation {AUTO=0, SCALAR, AVX2, AVX512};
+
+        static void Calculate(int n, const PhotonRays& rays, double R, double L, CylinderHits& hits, Implementation impl=AUTO);
+        static void CalculateOne(double x0, double y0, double z0, double px, double py, double pz, double E, double R, double L,\
+                                 double& hitX, double& hitY, double& hitZ, double& hitT, double& hitPhi, double& hitTheta);
+        static bool IsSupported(Implementation impl);
+        static Implementation GetBestImplementation();
+
+    private:
+        static void CalculateScalar_(int first, int n, const PhotonRays& rays, double R, double L, CylinderHits& hits);
+        static void CalculateAVX2_(int n, const PhotonRays& rays, double R, double L, CylinderHits& hits);
+        static void CalculateAVX512_(int n, const PhotonRays& rays, double R, double L, CylinderHits& hits);
+        static void CalculateAngles_(int first, int n, CylinderHits& hits);
+};
+
+#endif // HITPOINTKERNEL_H
@@ -8,6 +8,8 @@
 #include "TImage.h"
 #include "TLegend.h"
 #include "TText.h"
+#include "particlegenerator.h"
+#include "cutflow.h"
 #include "initialcuts.h"
 
 unsigned InitialCuts::objectID_ = 1;
@@ -18,8 +20,11 @@ unsigned InitialCuts::objectID_ = 1;
 /// \param R Radius of the detector.
 /// \param L Length of the detector.
 /// \param p Probability to interacti with scintillator.
+/// \param histograms If false, no histograms are created and filling them is skipped (production mode).
 ///
-InitialCuts::InitialCuts(DecayType type, float R, float L, float p) :
+InitialCuts::InitialCuts(DecayType type, float R, float L, float p, bool histograms) :
+    fSilentMode_(false),
+    fHistograms_(histograms),
     fDecayType_(type),
     fR_(R),
     fL_(L),
@@ -42,12 +47,22 @@ InitialCuts::InitialCuts(DecayType type, float R, float L, float p) :
     fH_12_31_fail_ = nullptr;
     fH_23_31_fail_ = nullptr;
     fH_en_pass_mid_ = nullptr;
+    int noOfGammas = 0;
+    fTypeString_ = recognizeType(fDecayType_, noOfGammas);
+    if(noOfGammas == 0)
+        throw(std::string("Invalid no of decay products!"));
+    if(fHistograms_)
+        CreateHistograms_();
+}
 
+///
+/// \brief InitialCuts::CreateHistograms_ Creates histograms applicable to the type of decay.
+///
+void InitialCuts::CreateHistograms_()
+{
     //Creating histograms for angle distributions
-    if(type==THREE)
+    if(fDecayType_==THREE)
     {
-        fTypeString_="3";
-
         fH_en_pass_ = new TH1F((std::string("fH_en_pass_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.0, 0.6);
         fH_p_pass_ = new TH1F((std::string("fH_p_pass_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_p_", 52, 0.0, 0.6);
         fH_en_fail_ = new TH1F((std::string("fH_en_fail_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.0, 0.6);
@@ -107,10 +122,8 @@ InitialCuts::InitialCuts(DecayType type, float R, float L, float p) :
         fH_en_pass_mid_ -> GetYaxis()->SetTitle("dN/dE");
         fH_en_pass_mid_ -> GetYaxis()->SetTitleOffset(2.);
     }
-    else if(type==TWO)
+    else if(fDecayType_==TWO)
     {
-        fTypeString_ = "2";
-
         fH_en_pass_ = new TH1F((std::string("fH_en_pass_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.0, 0.6);
         fH_p_pass_ = new TH1F((std::string("fH_p_pass_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_p_", 52, 0.0, 0.6);
         fH_en_fail_ = new TH1F((std::string("fH_en_fail_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.0, 0.6);
@@ -142,10 +155,8 @@ InitialCuts::InitialCuts(DecayType type, float R, float L, float p) :
         fH_12_fail_ -> GetYaxis()->SetTitle("dN/d#theta_{12}");
         fH_12_fail_ -> GetYaxis()->SetTitleOffset(1.4);
     }
-    else if(type==TWOandONE)
+    else if(fDecayType_==TWOandONE)
     {
-        fTypeString_ = "2&1";
-
         fH_en_pass_ = new TH1F((std::string("fH_en_pass_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.3, 1.3);
         fH_p_pass_ = new TH1F((std::string("fH_p_pass_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_p_", 52, 0.3, 1.3);
         fH_en_fail_ = new TH1F((std::string("fH_en_fail_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.3, 1.3);
@@ -208,10 +219,8 @@ InitialCuts::InitialCuts(DecayType type, float R, float L, float p) :
         fH_31_fail_ -> GetYaxis()->SetTitle("dN/d#theta_{31}");
         fH_31_fail_ -> GetYaxis()->SetTitleOffset(1.4);
     }
-    else if(type==TWOandN)
+    else if(fDecayType_==TWOandN)
     {
-        fTypeString_ = "2&N";
-
         fH_en_pass_ = new TH1F((std::string("fH_en_pass_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_en_", 104, 0.0, 4.0);
         fH_p_pass_ = new TH1F((std::string("fH_p_pass_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_p_", 104, 0.0, 4.0);
         fH_en_fail_ = new TH1F((std::string("fH_en_fail_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_en_", 104, 0.0, 4.0);
@@ -245,7 +254,6 @@ InitialCuts::InitialCuts(DecayType type, float R, float L, float p) :
     }
     else if(fDecayType_ == ONE)
     {
-        fTypeString_ = "1";
         fH_en_pass_ = new TH1F((std::string("fH_en_pass_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.0, 2.0);
         fH_p_pass_ = new TH1F((std::string("fH_p_pass_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_p_", 52, 0.0, 2.0);
         fH_en_fail_ = new TH1F((std::string("fH_en_fail_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.0, 2.0);
@@ -336,14 +344,14 @@ InitialCuts::InitialCuts(DecayType type, float R, float L, float p) :
     fH_en_pass_high_ -> GetYaxis()->SetTitleOffset(1.8);
 
     //histograms to monitor cuts passing
-    fH_event_cuts_ = new TH1F((std::string("fH_event_cuts_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(),\
+    fH_event_cuts_ = new TH1D((std::string("fH_event_cuts_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(),\
             "fH_event_cuts_", 3, 0.0, 3.0);
     fH_event_cuts_->SetTitle("Passing cuts by events");
     fH_event_cuts_->GetYaxis()->SetTitle("% passed");
     fH_event_cuts_->GetYaxis()->SetTitleOffset(1.4);
     fH_event_cuts_->GetXaxis()->SetLabelSize(0);
     fH_event_cuts_->GetXaxis()->SetTickLength(0);
-    fH_gamma_cuts_ = new TH1F((std::string("fH_gamma_cuts_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(),\
+    fH_gamma_cuts_ = new TH1D((std::string("fH_gamma_cuts_")+std::to_string(fDecayType_)+std::to_string(objectID_)).c_str(),\
             "fH_gamma_cuts_", 3, 0.0, 3.0);
     fH_gamma_cuts_->SetTitle("Passing cuts by gammas");
     fH_gamma_cuts_->GetYaxis()->SetTitle("% passed");
@@ -361,65 +369,15 @@ InitialCuts::InitialCuts(DecayType type, float R, float L, float p) :
 InitialCuts::InitialCuts(const InitialCuts& est)
 {
     fSilentMode_=est.fSilentMode_;
+    fHistograms_=est.fHistograms_;
     fR_ = est.fR_;  //radius in m
     fL_ = est.fL_;  //length in m
     fDetectionProbability_ = est.fDetectionProbability_;
     fDecayType_ = est.fDecayType_;
     fTypeString_ = est.fTypeString_;
 
-    fH_12_pass_ = nullptr;
-    fH_12_fail_ = nullptr;
-    fH_23_pass_ = nullptr;
-    fH_31_pass_ = nullptr;
-    fH_12_23_pass_ = nullptr;
-    fH_12_31_pass_ = nullptr;
-    fH_23_31_pass_ = nullptr;
-    fH_12_23_fail_ = nullptr;
-    fH_12_31_fail_ = nullptr;
-    fH_23_31_fail_ = nullptr;
-    fH_31_fail_ = nullptr;
-    fH_23_fail_ = nullptr;
-    fH_en_pass_mid_ = nullptr;
-
-    if(fDecayType_==TWO)
-    {
-        fH_12_pass_ = new TH1F(*est.fH_12_pass_);
-        fH_12_fail_ = new TH1F(*est.fH_12_fail_);
-    }
-    else if(fDecayType_==THREE)
-    {
-        fH_12_23_pass_ = new TH2F(*est.fH_12_23_pass_);
-        fH_12_31_pass_ = new TH2F(*est.fH_12_31_pass_);
-        fH_23_31_pass_ = new TH2F(*est.fH_23_31_pass_);
-        fH_12_23_fail_ = new TH2F(*est.fH_12_23_fail_);
-        fH_12_31_fail_ = new TH2F(*est.fH_12_31_fail_);
-        fH_23_31_fail_ = new TH2F(*est.fH_23_31_fail_);
-        fH_en_pass_mid_ = new TH1F(*est.fH_en_pass_mid_);
-    }
-    else if(fDecayType_==TWOandONE)
-    {
-        fH_12_pass_ = new TH1F(*est.fH_12_pass_);
-        fH_12_fail_ = new TH1F(*est.fH_12_fail_);
-        fH_23_pass_ = new TH1F(*est.fH_23_pass_);
-        fH_23_fail_ = new TH1F(*est.fH_23_fail_);
-        fH_31_pass_ = new TH1F(*est.fH_31_pass_);
-        fH_31_fail_ = new TH1F(*est.fH_31_fail_);
-    }
-
-    fH_en_pass_ = new TH1F(*est.fH_en_pass_);
-    fH_p_pass_ = new TH1F(*est.fH_p_pass_);
-    fH_phi_pass_= new TH1F(*est.fH_phi_pass_);
-    fH_cosTheta_pass_ = new TH1F(*est.fH_cosTheta_pass_);
-    fH_en_fail_ = new TH1F(*est.fH_en_fail_);
-    fH_p_fail_ = new TH1F(*est.fH_p_fail_);
-    fH_phi_fail_= new TH1F(*est.fH_phi_fail_);
-    fH_cosTheta_fail_ = new TH1F(*est.fH_cosTheta_fail_);
-    fH_en_pass_low_ = new TH1F(*est.fH_en_pass_low_);
-    fH_en_pass_high_ = new TH1F(*est.fH_en_pass_high_);
-    fH_en_pass_event_ = new TH1F(*est.fH_en_pass_event_);
-
-    fH_event_cuts_ = new TH1F(*est.fH_event_cuts_);
-    fH_gamma_cuts_ = new TH1F(*est.fH_gamma_cuts_);
+    if(fHistograms_)
+        CopyHistograms_(est);
     fNumberOfEvents_ = est.fNumberOfEvents_;
     fNumberOfGammas_ = est.fNumberOfGammas_;
     fAcceptedEvents_ = est.fAcceptedEvents_;
@@ -434,12 +392,28 @@ InitialCuts::InitialCuts(const InitialCuts& est)
 InitialCuts& InitialCuts::operator=(const InitialCuts& est)
 {
     fSilentMode_=est.fSilentMode_;
+    fHistograms_=est.fHistograms_;
     fR_ = est.fR_;  //radius in m
     fL_ = est.fL_;  //length in m
     fDetectionProbability_ = est.fDetectionProbability_;
     fDecayType_ = est.fDecayType_;
     fTypeString_ = est.fTypeString_;
 
+    if(fHistograms_)
+        CopyHistograms_(est);
+    fNumberOfEvents_ = est.fNumberOfEvents_;
+    fNumberOfGammas_ = est.fNumberOfGammas_;
+    fAcceptedEvents_ = est.fAcceptedEvents_;
+    fAcceptedGammas_ = est.fAcceptedGammas_;
+    return *this;
+}
+
+///
+/// \brief InitialCuts::CopyHistograms_ Creates copies of histograms of another instance.
+/// \param est Instance of InitialCuts with histograms enabled.
+///
+void InitialCuts::CopyHistograms_(const InitialCuts& est)
+{
     fH_12_pass_ = nullptr;
     fH_12_fail_ = nullptr;
     fH_23_pass_ = nullptr;
@@ -456,48 +430,43 @@ InitialCuts& InitialCuts::operator=(const InitialCuts& est)
 
     if(fDecayType_==TWO)
     {
-        fH_12_pass_ = new TH1F(*est.fH_12_pass_);
-        fH_12_fail_ = new TH1F(*est.fH_12_fail_);
+        fH_12_pass_ = new TH1F(*est.fH_12_pass_.Get());
+        fH_12_fail_ = new TH1F(*est.fH_12_fail_.Get());
     }
     else if(fDecayType_==THREE)
     {
-        fH_12_23_pass_ = new TH2F(*est.fH_12_23_pass_);
-        fH_12_31_pass_ = new TH2F(*est.fH_12_31_pass_);
-        fH_23_31_pass_ = new TH2F(*est.fH_23_31_pass_);
-        fH_12_23_fail_ = new TH2F(*est.fH_12_23_fail_);
-        fH_12_31_fail_ = new TH2F(*est.fH_12_31_fail_);
-        fH_23_31_fail_ = new TH2F(*est.fH_23_31_fail_);
-        fH_en_pass_mid_ = new TH1F(*est.fH_en_pass_mid_);
+        fH_12_23_pass_ = new TH2F(*est.fH_12_23_pass_.Get());
+        fH_12_31_pass_ = new TH2F(*est.fH_12_31_pass_.Get());
+        fH_23_31_pass_ = new TH2F(*est.fH_23_31_pass_.Get());
+        fH_12_23_fail_ = new TH2F(*est.fH_12_23_fail_.Get());
+        fH_12_31_fail_ = new TH2F(*est.fH_12_31_fail_.Get());
+        fH_23_31_fail_ = new TH2F(*est.fH_23_31_fail_.Get());
+        fH_en_pass_mid_ = new TH1F(*est.fH_en_pass_mid_.Get());
     }
     else if(fDecayType_==TWOandONE)
     {
-        fH_12_pass_ = new TH1F(*est.fH_12_pass_);
-        fH_12_fail_ = new TH1F(*est.fH_12_fail_);
-        fH_23_pass_ = new TH1F(*est.fH_23_pass_);
-        fH_23_fail_ = new TH1F(*est.fH_23_fail_);
-        fH_31_pass_ = new TH1F(*est.fH_31_pass_);
-        fH_31_fail_ = new TH1F(*est.fH_31_fail_);
+        fH_12_pass_ = new TH1F(*est.fH_12_pass_.Get());
+        fH_12_fail_ = new TH1F(*est.fH_12_fail_.Get());
+        fH_23_pass_ = new TH1F(*est.fH_23_pass_.Get());
+        fH_23_fail_ = new TH1F(*est.fH_23_fail_.Get());
+        fH_31_pass_ = new TH1F(*est.fH_31_pass_.Get());
+        fH_31_fail_ = new TH1F(*est.fH_31_fail_.Get());
     }
 
-    fH_en_pass_ = new TH1F(*est.fH_en_pass_);
-    fH_p_pass_ = new TH1F(*est.fH_p_pass_);
-    fH_phi_pass_= new TH1F(*est.fH_phi_pass_);
-    fH_cosTheta_pass_ = new TH1F(*est.fH_cosTheta_pass_);
-    fH_en_fail_ = new TH1F(*est.fH_en_fail_);
-    fH_p_fail_ = new TH1F(*est.fH_p_fail_);
-    fH_phi_fail_= new TH1F(*est.fH_phi_fail_);
-    fH_cosTheta_fail_ = new TH1F(*est.fH_cosTheta_fail_);
-    fH_en_pass_low_ = new TH1F(*est.fH_en_pass_low_);
-    fH_en_pass_high_ = new TH1F(*est.fH_en_pass_high_);
-    fH_en_pass_event_ = new TH1F(*est.fH_en_pass_event_);
-
-    fH_event_cuts_ = new TH1F(*est.fH_event_cuts_);
-    fH_gamma_cuts_ = new TH1F(*est.fH_gamma_cuts_);
-    fNumberOfEvents_ = est.fNumberOfEvents_;
-    fNumberOfGammas_ = est.fNumberOfGammas_;
-    fAcceptedEvents_ = est.fAcceptedEvents_;
-    fAcceptedGammas_ = est.fAcceptedGammas_;
-    return *this;
+    fH_en_pass_ = new TH1F(*est.fH_en_pass_.Get());
+    fH_p_pass_ = new TH1F(*est.fH_p_pass_.Get());
+    fH_phi_pass_= new TH1F(*est.fH_phi_pass_.Get());
+    fH_cosTheta_pass_ = new TH1F(*est.fH_cosTheta_pass_.Get());
+    fH_en_fail_ = new TH1F(*est.fH_en_fail_.Get());
+    fH_p_fail_ = new TH1F(*est.fH_p_fail_.Get());
+    fH_phi_fail_= new TH1F(*est.fH_phi_fail_.Get());
+    fH_cosTheta_fail_ = new TH1F(*est.fH_cosTheta_fail_.Get());
+    fH_en_pass_low_ = new TH1F(*est.fH_en_pass_low_.Get());
+    fH_en_pass_high_ = new TH1F(*est.fH_en_pass_high_.Get());
+    fH_en_pass_event_ = new TH1F(*est.fH_en_pass_event_.Get());
+
+    fH_event_cuts_ = new TH1D(*est.fH_event_cuts_.Get());
+    fH_gamma_cuts_ = new TH1D(*est.fH_gamma_cuts_.Get());
 }
 
 ///
@@ -505,56 +474,103 @@ InitialCuts& InitialCuts::operator=(const InitialCuts& est)
 ///
 InitialCuts::~InitialCuts()
 {
-    if(fH_12_23_pass_) delete fH_12_23_pass_;
-    if(fH_12_31_pass_) delete fH_12_31_pass_;
-    if(fH_23_31_pass_) delete fH_23_31_pass_;
-    if(fH_12_pass_) delete fH_12_pass_;
-    if(fH_23_pass_) delete fH_23_pass_;
-    if(fH_31_pass_) delete fH_31_pass_;
-    if(fH_12_23_fail_) delete fH_12_23_fail_;
-    if(fH_12_31_fail_) delete fH_12_31_fail_;
-    if(fH_23_31_fail_) delete fH_23_31_fail_;
-    if(fH_12_fail_) delete fH_12_fail_;
-    if(fH_23_fail_) delete fH_23_fail_;
-    if(fH_31_fail_) delete fH_31_fail_;
-    if(fH_en_pass_) delete fH_en_pass_;
-    if(fH_p_pass_) delete fH_p_pass_;
-    if(fH_phi_pass_) delete fH_phi_pass_;
-    if(fH_cosTheta_pass_) delete fH_cosTheta_pass_;
-    if(fH_en_fail_) delete fH_en_fail_;
-    if(fH_p_fail_) delete fH_p_fail_;
-    if(fH_phi_fail_) delete fH_phi_fail_;
-    if(fH_cosTheta_fail_) delete fH_cosTheta_fail_;
-    if(fH_en_pass_low_) delete fH_en_pass_low_;
-    if(fH_en_pass_mid_) delete fH_en_pass_mid_;
-    if(fH_en_pass_high_) delete fH_en_pass_high_;
-    if(fH_en_pass_event_) delete fH_en_pass_event_;
-    if(fH_event_cuts_) delete fH_event_cuts_;
-    if(fH_gamma_cuts_) delete fH_gamma_cuts_;
+    delete fH_12_23_pass_.Release();
+    delete fH_12_31_pass_.Release();
+    delete fH_23_31_pass_.Release();
+    delete fH_12_pass_.Release();
+    delete fH_23_pass_.Release();
+    delete fH_31_pass_.Release();
+    delete fH_12_23_fail_.Release();
+    delete fH_12_31_fail_.Release();
+    delete fH_23_31_fail_.Release();
+    delete fH_12_fail_.Release();
+    delete fH_23_fail_.Release();
+    delete fH_31_fail_.Release();
+    delete fH_en_pass_.Release();
+    delete fH_p_pass_.Release();
+    delete fH_phi_pass_.Release();
+    delete fH_cosTheta_pass_.Release();
+    delete fH_en_fail_.Release();
+    delete fH_p_fail_.Release();
+    delete fH_phi_fail_.Release();
+    delete fH_cosTheta_fail_.Release();
+    delete fH_en_pass_low_.Release();
+    delete fH_en_pass_mid_.Release();
+    delete fH_en_pass_high_.Release();
+    delete fH_en_pass_event_.Release();
+    delete fH_event_cuts_.Release();
+    delete fH_gamma_cuts_.Release();
+}
+
+///
+/// \brief InitialCuts::Merge Adds histograms and counters of another instance to this one.
+/// \param est Instance of InitialCuts created for the same decay type, e.g. by a worker thread.
+///
+void InitialCuts::Merge(const InitialCuts& est)
+{
+    if(fDecayType_ != est.fDecayType_)
+        throw(std::string("[ERROR] Cannot merge InitialCuts objects created for different decay types!"));
+    if(fHistograms_ != est.fHistograms_)
+        throw(std::string("[ERROR] Cannot merge InitialCuts objects with and without histograms!"));
+    if(fH_12_pass_.Get()) fH_12_pass_->Add(est.fH_12_pass_.Get());
+    if(fH_23_pass_.Get()) fH_23_pass_->Add(est.fH_23_pass_.Get());
+    if(fH_31_pass_.Get()) fH_31_pass_->Add(est.fH_31_pass_.Get());
+    if(fH_12_23_pass_.Get()) fH_12_23_pass_->Add(est.fH_12_23_pass_.Get());
+    if(fH_12_31_pass_.Get()) fH_12_31_pass_->Add(est.fH_12_31_pass_.Get());
+    if(fH_23_31_pass_.Get()) fH_23_31_pass_->Add(est.fH_23_31_pass_.Get());
+    if(fH_12_fail_.Get()) fH_12_fail_->Add(est.fH_12_fail_.Get());
+    if(fH_23_fail_.Get()) fH_23_fail_->Add(est.fH_23_fail_.Get());
+    if(fH_31_fail_.Get()) fH_31_fail_->Add(est.fH_31_fail_.Get());
+    if(fH_12_23_fail_.Get()) fH_12_23_fail_->Add(est.fH_12_23_fail_.Get());
+    if(fH_12_31_fail_.Get()) fH_12_31_fail_->Add(est.fH_12_31_fail_.Get());
+    if(fH_23_31_fail_.Get()) fH_23_31_fail_->Add(est.fH_23_31_fail_.Get());
+    if(fH_en_pass_.Get()) fH_en_pass_->Add(est.fH_en_pass_.Get());
+    if(fH_en_pass_event_.Get()) fH_en_pass_event_->Add(est.fH_en_pass_event_.Get());
+    if(fH_en_pass_low_.Get()) fH_en_pass_low_->Add(est.fH_en_pass_low_.Get());
+    if(fH_en_pass_mid_.Get()) fH_en_pass_mid_->Add(est.fH_en_pass_mid_.Get());
+    if(fH_en_pass_high_.Get()) fH_en_pass_high_->Add(est.fH_en_pass_high_.Get());
+    if(fH_p_pass_.Get()) fH_p_pass_->Add(est.fH_p_pass_.Get());
+    if(fH_phi_pass_.Get()) fH_phi_pass_->Add(est.fH_phi_pass_.Get());
+    if(fH_cosTheta_pass_.Get()) fH_cosTheta_pass_->Add(est.fH_cosTheta_pass_.Get());
+    if(fH_en_fail_.Get()) fH_en_fail_->Add(est.fH_en_fail_.Get());
+    if(fH_p_fail_.Get()) fH_p_fail_->Add(est.fH_p_fail_.Get());
+    if(fH_phi_fail_.Get()) fH_phi_fail_->Add(est.fH_phi_fail_.Get());
+    if(fH_cosTheta_fail_.Get()) fH_cosTheta_fail_->Add(est.fH_cosTheta_fail_.Get());
+    if(fH_gamma_cuts_.Get()) fH_gamma_cuts_->Add(est.fH_gamma_cuts_.Get());
+    if(fH_event_cuts_.Get()) fH_event_cuts_->Add(est.fH_event_cuts_.Get());
+    fAcceptedEvents_ += est.fAcceptedEvents_;
+    fAcceptedGammas_ += est.fAcceptedGammas_;
+    fNumberOfEvents_ += est.fNumberOfEvents_;
+    fNumberOfGammas_ += est.fNumberOfGammas_;
 }
 
 ///
 /// \brief InitialCuts::AddCuts Checks if an event and particular gammas passed through cuts. Sets flags in Event instance. Fills histograms.
 /// \param event Pointer to an Event object representing a single decay.
+/// \param rng Random number generator used by the detection cut.
 ///
-void InitialCuts::AddCuts(Event* event)
+void InitialCuts::AddCuts(Event* event, TRandom* rng)
 {
     //Calculate real hit points for pass, and fake hit points for fail (we assume infinite long detector)
     event->CalculateHitPoints(fR_, fL_); //calculates hit points position and their theta/phi angles
     fNumberOfEvents_++;
     bool geo_event_pass = true;
     bool inter_event_pass = true;
-    fH_event_cuts_->Fill(0); //events at the beginning
+    if(fHistograms_)
+        fH_event_cuts_.Fill(0); //events at the beginning
     for(int ii=0; ii<event->GetNumberOfDecayProducts(); ii++)
     {
         if(event->GetFourMomentumOf(ii)!=nullptr)
         {
-            fH_gamma_cuts_->Fill(0); //gammas at the beginning
             fNumberOfGammas_++;
             bool geo_pass = event->GetHitPhiOf(ii)!=-4; //Event::CalculateHitPoints(D, D) sets Phi to -4 when a particle missed detector
-            if(geo_pass)
-                fH_gamma_cuts_->Fill(1);
-            bool inter_pass = geo_pass ? DetectionCut_() : false; //if passed geom. then test detector eff
+            if(fHistograms_)
+            {
+                fH_gamma_cuts_.Fill(0); //gammas at the beginning
+                if(geo_pass)
+                    fH_gamma_cuts_.Fill(1);
+            }
+            bool inter_pass = geo_pass ? DetectionCut_(rng) : false; //if passed geom. then test detector eff
             event->SetCutPassing(ii, inter_pass);
             if(!(ii>=2 && event->GetDecayType() != THREE)) // gammas from deexcitation are not required to reconstruct event
             {
@@ -565,38 +581,209 @@ void InitialCuts::AddCuts(Event* event)
         else
             event->SetCutPassing(ii, false);
     }
-    if(geo_event_pass)
-        fH_event_cuts_->Fill(1);
-    if(inter_event_pass)
-        fH_event_cuts_->Fill(2);
     if(geo_event_pass && inter_event_pass)
-        FillValidEventHistograms_(event);
-    else
-        FillInvalidEventHistograms_(event);
-    //Fills pass/fail distribution histograms
-    FillDistributionHistograms_(event);
+        fAcceptedEvents_++;
+    if(fHistograms_)
+    {
+        if(geo_event_pass)
+            fH_event_cuts_.Fill(1);
+        if(inter_event_pass)
+            fH_event_cuts_.Fill(2);
+        if(geo_event_pass && inter_event_pass)
+            FillValidEventHistograms_(event);
+        else
+            FillInvalidEventHistograms_(event);
+        //Fills pass/fail distribution histograms
+        FillDistributionHistograms_(event);
+    }
 
     //Let event deduce its flag!
     event->DeducePassFlag();
 }
 
+///
+/// \brief InitialCuts::CutEvent_ Applies cuts to gammas of one event of a batch and updates counters and cut-flow histograms.
+/// \tparam kType Type of decays stored in the batch.
+/// \tparam kHistograms If true, cut-flow histograms are filled.
+/// \param batch Batch of events with calculated hit points.
+/// \param event Index of the event in the batch.
+/// \param rng Random number generator used by the detection cut, switched to the substream of the event.
+/// \param geo_event_pass Set to false if any of the required gammas missed the detector.
+/// \param inter_event_pass Set to false if any of the required gammas did not interact with the detector.
+///
+template<DecayType kType, bool kHistograms>
+void InitialCuts::CutEvent_(EventBatch& batch, int event, RandomStream* rng, bool& geo_event_pass, bool& inter_event_pass)
+{
+    rng->SetSubstream(batch.GetIndexInRun(event));
+    fNumberOfEvents_++;
+    if(kHistograms)
+        fH_event_cuts_.Fill(0); //events at the beginning
+    for(int ii=0; ii<batch.GetNumberOfDecayProducts<kType>(event); ii++)
+    {
+        int kk = batch.Index(ii, event);
+        fNumberOfGammas_++;
+        bool geo_pass = batch.fHitPhi[kk]!=-4; //EventBatch::CalculateHitPoints(D, D) sets Phi to -4 when a particle missed detector
+        if(kHistograms)
+        {
+            fH_gamma_cuts_.Fill(0); //gammas at the beginning
+            if(geo_pass)
+                fH_gamma_cuts_.Fill(1);
+        }
+        bool inter_pass = geo_pass ? DetectionCut_(rng) : false; //if passed geom. then test detector eff
+        batch.fCutPassing[kk] = inter_pass;
+        if(ii < DecayTraits<kType>::kRequiredPhotons) // gammas from deexcitation are not required to reconstruct event
+        {
+            geo_event_pass &= geo_pass;
+            inter_event_pass &= inter_pass;
+        }
+    }
+    if(geo_event_pass && inter_event_pass)
+        fAcceptedEvents_++;
+    if(!kHistograms)
+        return;
+    if(geo_event_pass)
+        fH_event_cuts_.Fill(1);
+    if(inter_event_pass)
+        fH_event_cuts_.Fill(2);
+}
+
+///
+/// \brief InitialCuts::AddCuts_ Implementation of AddCuts for a batch.
+/// \tparam kType Type of decays stored in the batch.
+/// \tparam kHistograms If true, histograms are filled.
+/// \param batch Batch of events.
+/// \param rng Random number generator used by the detection cut, switched to the substream of every event.
+///
+template<DecayType kType, bool kHistograms>
+void InitialCuts::AddCuts_(EventBatch& batch, RandomStream* rng)
+{
+    batch.CalculateHitPoints(fR_, fL_);
+    for(int jj=0; jj<batch.GetSize(); jj++)
+    {
+        bool geo_event_pass = true;
+        bool inter_event_pass = true;
+        CutEvent_<kType, kHistograms>(batch, jj, rng, geo_event_pass, inter_event_pass);
+        if(!kHistograms)
+            continue;
+        if(geo_event_pass && inter_event_pass)
+            FillValidEventHistograms_(batch, jj);
+        else
+            FillInvalidEventHistograms_(batch, jj);
+        FillDistributionHistograms_(batch, jj);
+    }
+    batch.DeducePassFlags<kType>();
+}
+
+///
+/// \brief InitialCuts::AddCuts Checks which events of a batch and their gammas passed through cuts, the same as AddCuts for Event.
+/// \tparam kType Type of decays stored in the batch.
+/// \param batch Batch of events.
+/// \param rng Random number generator used by the detection cut, switched to the substream of every event.
+///
+template<DecayType kType>
+void InitialCuts::AddCuts(EventBatch& batch, RandomStream* rng)
+{
+    //checked once per batch, so without histograms the loop is compiled without any filling
+    if(fHistograms_)
+        AddCuts_<kType, true>(batch, rng);
+    else
+        AddCuts_<kType, false>(batch, rng);
+}
+
+template void InitialCuts::AddCuts<ONE>(EventBatch& batch, RandomStream* rng);
+template void InitialCuts::AddCuts<TWO>(EventBatch& batch, RandomStream* rng);
+template void InitialCuts::AddCuts<THREE>(EventBatch& batch, RandomStream* rng);
+template void InitialCuts::AddCuts<TWOandONE>(EventBatch& batch, RandomStream* rng);
+template void InitialCuts::AddCuts<TWOandN>(EventBatch& batch, RandomStream* rng);
+
+///
+/// \brief InitialCuts::AddCuts Checks which events of a batch and their gammas passed through cuts, the decay type
+/// is dispatched at run time.
+/// \param batch Batch of events.
+/// \param rng Random number generator used by the detection cut, switched to the substream of every event.
+///
+void InitialCuts::AddCuts(EventBatch& batch, RandomStream* rng)
+{
+    switch(batch.GetDecayType())
+    {
+        case ONE: AddCuts<ONE>(batch, rng); break;
+        case TWO: AddCuts<TWO>(batch, rng); break;
+        case THREE: AddCuts<THREE>(batch, rng); break;
+        case TWOandONE: AddCuts<TWOandONE>(batch, rng); break;
+        case TWOandN: AddCuts<TWOandN>(batch, rng); break;
+        default: throw(std::string("[ERROR] Wrong decay type of EventBatch!"));
+    }
+}
+
+///
+/// \brief InitialCuts::RejectMissed_ Implementation of RejectMissed.
+/// \tparam kType Type of decays stored in the batch.
+/// \tparam kHistograms If true, cut-flow histograms are filled.
+/// \param batch Batch of events.
+/// \param rng Random number generator used by the detection cut, switched to the substream of every rejected event.
+///
+template<DecayType kType, bool kHistograms>
+void InitialCuts::RejectMissed_(EventBatch& batch, RandomStream* rng)
+{
+    batch.CalculateHitPoints(fR_, fL_);
+    for(int jj=0; jj<batch.GetSize(); jj++)
+    {
+        bool geo_event_pass = true;
+        for(int ii=0; ii<DecayTraits<kType>::kRequiredPhotons && ii<batch.GetNumberOfDecayProducts<kType>(jj); ii++)
+            geo_event_pass &= batch.fHitPhi[batch.Index(ii, jj)]!=-4;
+        if(geo_event_pass)
+            continue;
+        //the event is counted as by AddCuts, the same random numbers are drawn by the detection cut
+        bool inter_event_pass = true;
+        CutEvent_<kType, kHistograms>(batch, jj, rng, geo_event_pass, inter_event_pass);
+        batch.fPassFlag[jj] = false;
+    }
+    batch.RemoveFailedEvents();
+}
+
+///
+/// \brief InitialCuts::RejectMissed Removes from a batch events, in which any of the required gammas missed the detector,
+/// so the following stages are not applied to events that cannot pass cuts. Counters and cut-flow histograms are updated
+/// for removed events in the same way as by AddCuts, other histograms are not filled. The remaining events should be
+/// passed to AddCuts afterwards, their directions must not be changed in the meantime.
+/// \tparam kType Type of decays stored in the batch.
+/// \param batch Batch of events.
+/// \param rng Random number generator used by the detection cut, switched to the substream of every removed event.
+///
+template<DecayType kType>
+void InitialCuts::RejectMissed(EventBatch& batch, RandomStream* rng)
+{
+    if(fHistograms_)
+        RejectMissed_<kType, true>(batch, rng);
+    else
+        RejectMissed_<kType, false>(batch, rng);
+}
+
+template void InitialCuts::RejectMissed<ONE>(EventBatch& batch, RandomStream* rng);
+template void InitialCuts::RejectMissed<TWO>(EventBatch& batch, RandomStream* rng);
+template void InitialCuts::RejectMissed<THREE>(EventBatch& batch, RandomStream* rng);
+template void InitialCuts::RejectMissed<TWOandONE>(EventBatch& batch, RandomStream* rng);
+template void InitialCuts::RejectMissed<TWOandN>(EventBatch& batch, RandomStream* rng);
+
 ///
 /// \brief InitialCuts::DetectionCut_ Checks if gamma interacted with the detector.
+/// \param rng Random number generator to be used.
 /// \return True if gamma interacted with the detector, false otherwise.
 ///
-bool InitialCuts::DetectionCut_()
+bool InitialCuts::DetectionCut_(TRandom* rng)
 {
     bool pass = false;
     if(fDetectionProbability_ == 1)
         pass = true;
     else
     {
-        float p = gRandom->Uniform();
+        float p = rng->Uniform();
         pass = p < fDetectionProbability_;
     }
     if(pass)
     {
-        fH_gamma_cuts_->Fill(2);
+        if(fHistograms_)
+            fH_gamma_cuts_.Fill(2);
         fAcceptedGammas_++;
     }
     return pass;
@@ -608,7 +795,6 @@ bool InitialCuts::DetectionCut_()
 ///
 void InitialCuts::FillValidEventHistograms_(const Event* event)
 {
-    fAcceptedEvents_++;
     bool thirdGammaPrompt = false;
     int minIndex=0; //indices of min and max energy out of 2 or 3 gammas
     int maxIndex=0;
@@ -621,13 +807,13 @@ void InitialCuts::FillValidEventHistograms_(const Event* event)
                 thirdGammaPrompt = true;
                 break;
             }
-            fH_en_pass_event_->Fill(event->GetFourMomentumOf(ii)->Energy());
+            fH_en_pass_event_.Fill(event->GetFourMomentumOf(ii)->Energy());
             minIndex = event->GetFourMomentumOf(ii)->E() < event->GetFourMomentumOf(minIndex)->E() ? ii : minIndex;
             maxIndex = event->GetFourMomentumOf(ii)->E() > event->GetFourMomentumOf(maxIndex)->E() ? ii : maxIndex;
         }
     }
-    fH_en_pass_low_->Fill(event->GetFourMomentumOf(minIndex)->Energy());
-    fH_en_pass_high_->Fill(event->GetFourMomentumOf(maxIndex)->Energy());
+    fH_en_pass_low_.Fill(event->GetFourMomentumOf(minIndex)->Energy());
+    fH_en_pass_high_.Fill(event->GetFourMomentumOf(maxIndex)->Energy());
     if(fDecayType_==THREE)
     {
         if(event->GetNumberOfDecayProducts() != 3)
@@ -637,23 +823,23 @@ void InitialCuts::FillValidEventHistograms_(const Event* event)
         }
         //If there are 3 gammas, draw also middle value.
         int midIndex = minIndex==maxIndex ? minIndex : 3-minIndex-maxIndex;
-        fH_en_pass_mid_->Fill(event->GetFourMomentumOf(midIndex)->Energy());
-        fH_12_23_pass_->Fill(event->GetFourMomentumOf(0)->Angle(event->GetFourMomentumOf(1)->Vect()), \
+        fH_en_pass_mid_.Fill(event->GetFourMomentumOf(midIndex)->Energy());
+        fH_12_23_pass_.Fill(event->GetFourMomentumOf(0)->Angle(event->GetFourMomentumOf(1)->Vect()), \
                              event->GetFourMomentumOf(1)->Angle(event->GetFourMomentumOf(2)->Vect()), event->GetWeight());
-        fH_12_31_pass_->Fill(event->GetFourMomentumOf(0)->Angle(event->GetFourMomentumOf(1)->Vect()), \
+        fH_12_31_pass_.Fill(event->GetFourMomentumOf(0)->Angle(event->GetFourMomentumOf(1)->Vect()), \
                              event->GetFourMomentumOf(2)->Angle(event->GetFourMomentumOf(0)->Vect()), event->GetWeight());
-        fH_23_31_pass_->Fill(event->GetFourMomentumOf(1)->Angle(event->GetFourMomentumOf(2)->Vect()), \
+        fH_23_31_pass_.Fill(event->GetFourMomentumOf(1)->Angle(event->GetFourMomentumOf(2)->Vect()), \
                              event->GetFourMomentumOf(2)->Angle(event->GetFourMomentumOf(0)->Vect()), event->GetWeight());
     }
     else if(fDecayType_ == TWO || fDecayType_ == TWOandN)
-        fH_12_pass_->Fill(event->GetFourMomentumOf(0)->Angle((event->GetFourMomentumOf(1))->Vect()), event->GetWeight());
+        fH_12_pass_.Fill(event->GetFourMomentumOf(0)->Angle((event->GetFourMomentumOf(1))->Vect()), event->GetWeight());
     else if(fDecayType_ == TWOandONE)
     {
-        fH_12_pass_->Fill(event->GetFourMomentumOf(0)->Angle((event->GetFourMomentumOf(1))->Vect()), event->GetWeight());
+        fH_12_pass_.Fill(event->GetFourMomentumOf(0)->Angle((event->GetFourMomentumOf(1))->Vect()), event->GetWeight());
         if(thirdGammaPrompt)
         {
-            fH_23_pass_->Fill(event->GetFourMomentumOf(1)->Angle((event->GetFourMomentumOf(2))->Vect()), event->GetWeight());
-            fH_31_pass_->Fill(event->GetFourMomentumOf(2)->Angle((event->GetFourMomentumOf(0))->Vect()), event->GetWeight());
+            fH_23_pass_.Fill(event->GetFourMomentumOf(1)->Angle((event->GetFourMomentumOf(2))->Vect()), event->GetWeight());
+            fH_31_pass_.Fill(event->GetFourMomentumOf(2)->Angle((event->GetFourMomentumOf(0))->Vect()), event->GetWeight());
         }
     }
     else if(fDecayType_ != ONE)
@@ -671,22 +857,22 @@ void InitialCuts::FillInvalidEventHistograms_(const Event* event)
 
     if(fDecayType_==THREE)
     {
-        fH_12_23_fail_->Fill(event->GetFourMomentumOf(0)->Angle(event->GetFourMomentumOf(1)->Vect()), \
+        fH_12_23_fail_.Fill(event->GetFourMomentumOf(0)->Angle(event->GetFourMomentumOf(1)->Vect()), \
                              event->GetFourMomentumOf(1)->Angle(event->GetFourMomentumOf(2)->Vect()), event->GetWeight());
-        fH_12_31_fail_->Fill(event->GetFourMomentumOf(0)->Angle(event->GetFourMomentumOf(1)->Vect()), \
+        fH_12_31_fail_.Fill(event->GetFourMomentumOf(0)->Angle(event->GetFourMomentumOf(1)->Vect()), \
                              event->GetFourMomentumOf(2)->Angle(event->GetFourMomentumOf(0)->Vect()), event->GetWeight());
-        fH_23_31_fail_->Fill(event->GetFourMomentumOf(1)->Angle(event->GetFourMomentumOf(2)->Vect()), \
+        fH_23_31_fail_.Fill(event->GetFourMomentumOf(1)->Angle(event->GetFourMomentumOf(2)->Vect()), \
                              event->GetFourMomentumOf(2)->Angle(event->GetFourMomentumOf(0)->Vect()), event->GetWeight());
     }
     else if(fDecayType_ == TWO || fDecayType_ == TWOandN)
-        fH_12_fail_->Fill(event->GetFourMomentumOf(0)->Angle((event->GetFourMomentumOf(1))->Vect()), event->GetWeight());
+        fH_12_fail_.Fill(event->GetFourMomentumOf(0)->Angle((event->GetFourMomentumOf(1))->Vect()), event->GetWeight());
     else if(fDecayType_ == TWOandONE)
     {
-        fH_12_fail_->Fill(event->GetFourMomentumOf(0)->Angle((event->GetFourMomentumOf(1))->Vect()), event->GetWeight());
+        fH_12_fail_.Fill(event->GetFourMomentumOf(0)->Angle((event->GetFourMomentumOf(1))->Vect()), event->GetWeight());
         if(event->GetFourMomentumOf(2) != nullptr)
         {
-                fH_23_fail_->Fill(event->GetFourMomentumOf(1)->Angle((event->GetFourMomentumOf(2))->Vect()), event->GetWeight());
-                fH_31_fail_->Fill(event->GetFourMomentumOf(2)->Angle((event->GetFourMomentumOf(0))->Vect()), event->GetWeight());
+                fH_23_fail_.Fill(event->GetFourMomentumOf(1)->Angle((event->GetFourMomentumOf(2))->Vect()), event->GetWeight());
+                fH_31_fail_.Fill(event->GetFourMomentumOf(2)->Angle((event->GetFourMomentumOf(0))->Vect()), event->GetWeight());
         }
     }
     else if(fDecayType_ != ONE)
@@ -707,22 +893,136 @@ void InitialCuts::FillDistributionHistograms_(const Event* event)
         {
             if(event->GetCutPassingOf(ii))
             {
-                fH_en_pass_->Fill(event->GetFourMomentumOf(ii)->Energy());
-                fH_p_pass_->Fill(event->GetFourMomentumOf(ii)->P());
-                fH_phi_pass_->Fill(event->GetFourMomentumOf(ii)->Phi());
-                fH_cosTheta_pass_->Fill(event->GetFourMomentumOf(ii)->CosTheta());
+                fH_en_pass_.Fill(event->GetFourMomentumOf(ii)->Energy());
+                fH_p_pass_.Fill(event->GetFourMomentumOf(ii)->P());
+                fH_phi_pass_.Fill(event->GetFourMomentumOf(ii)->Phi());
+                fH_cosTheta_pass_.Fill(event->GetFourMomentumOf(ii)->CosTheta());
             }
             else
             {
-                fH_en_fail_->Fill(event->GetFourMomentumOf(ii)->Energy());
-                fH_p_fail_->Fill(event->GetFourMomentumOf(ii)->P());
-                fH_phi_fail_->Fill(event->GetFourMomentumOf(ii)->Phi());
-                fH_cosTheta_fail_->Fill(event->GetFourMomentumOf(ii)->CosTheta());
+                fH_en_fail_.Fill(event->GetFourMomentumOf(ii)->Energy());
+                fH_p_fail_.Fill(event->GetFourMomentumOf(ii)->P());
+                fH_phi_fail_.Fill(event->GetFourMomentumOf(ii)->Phi());
+                fH_cosTheta_fail_.Fill(event->GetFourMomentumOf(ii)->CosTheta());
             }
         }
     }
 }
 
+///
+/// \brief InitialCuts::FillValidEventHistograms_ Fills histograms for an event of a batch that passed cuts.
+/// \param batch Batch of events.
+/// \param event Index of the event in the batch.
+///
+void InitialCuts::FillValidEventHistograms_(const EventBatch& batch, int event)
+{
+    bool thirdGammaPrompt = false;
+    int minIndex=0; //indices of min and max energy out of 2 or 3 gammas
+    int maxIndex=0;
+    for(int ii=0; ii<batch.GetNumberOfDecayProducts(event); ii++)
+    {
+        if(ii==2 && (fDecayType_==TWOandONE || fDecayType_==TWOandN))
+        {
+            thirdGammaPrompt = true;
+            break;
+        }
+        double E = batch.fE[batch.Index(ii, event)];
+        fH_en_pass_event_.Fill(E);
+        minIndex = E < batch.fE[batch.Index(minIndex, event)] ? ii : minIndex;
+        maxIndex = E > batch.fE[batch.Index(maxIndex, event)] ? ii : maxIndex;
+    }
+    fH_en_pass_low_.Fill(batch.fE[batch.Index(minIndex, event)]);
+    fH_en_pass_high_.Fill(batch.fE[batch.Index(maxIndex, event)]);
+    double weight = batch.fWeight[event];
+    if(fDecayType_==THREE)
+    {
+        if(batch.GetNumberOfDecayProducts(event) != 3)
+        {
+            std::cout<<"[ERROR] Invalid number of decay products for event of type: THREE"<<std::endl;
+            throw("[ERROR] Invalid number of decay products for event of type: THREE");
+        }
+        //If there are 3 gammas, draw also middle value.
+        int midIndex = minIndex==maxIndex ? minIndex : 3-minIndex-maxIndex;
+        fH_en_pass_mid_.Fill(batch.fE[batch.Index(midIndex, event)]);
+        fH_12_23_pass_.Fill(batch.GetAngle(0, 1, event), batch.GetAngle(1, 2, event), weight);
+        fH_12_31_pass_.Fill(batch.GetAngle(0, 1, event), batch.GetAngle(2, 0, event), weight);
+        fH_23_31_pass_.Fill(batch.GetAngle(1, 2, event), batch.GetAngle(2, 0, event), weight);
+    }
+    else if(fDecayType_ == TWO || fDecayType_ == TWOandN)
+        fH_12_pass_.Fill(batch.GetAngle(0, 1, event), weight);
+    else if(fDecayType_ == TWOandONE)
+    {
+        fH_12_pass_.Fill(batch.GetAngle(0, 1, event), weight);
+        if(thirdGammaPrompt)
+        {
+            fH_23_pass_.Fill(batch.GetAngle(1, 2, event), weight);
+            fH_31_pass_.Fill(batch.GetAngle(2, 0, event), weight);
+        }
+    }
+    else if(fDecayType_ != ONE)
+    {
+         throw(std::string("Invalid no of decay products in InitialCuts!"));
+    }
+}
+
+///
+/// \brief InitialCuts::FillInvalidEventHistograms_ Fills histograms for an event of a batch that did not pass cuts.
+/// \param batch Batch of events.
+/// \param event Index of the event in the batch.
+///
+void InitialCuts::FillInvalidEventHistograms_(const EventBatch& batch, int event)
+{
+    double weight = batch.fWeight[event];
+    if(fDecayType_==THREE)
+    {
+        fH_12_23_fail_.Fill(batch.GetAngle(0, 1, event), batch.GetAngle(1, 2, event), weight);
+        fH_12_31_fail_.Fill(batch.GetAngle(0, 1, event), batch.GetAngle(2, 0, event), weight);
+        fH_23_31_fail_.Fill(batch.GetAngle(1, 2, event), batch.GetAngle(2, 0, event), weight);
+    }
+    else if(fDecayType_ == TWO || fDecayType_ == TWOandN)
+        fH_12_fail_.Fill(batch.GetAngle(0, 1, event), weight);
+    else if(fDecayType_ == TWOandONE)
+    {
+        fH_12_fail_.Fill(batch.GetAngle(0, 1, event), weight);
+        if(batch.GetNumberOfDecayProducts(event) > 2)
+        {
+                fH_23_fail_.Fill(batch.GetAngle(1, 2, event), weight);
+                fH_31_fail_.Fill(batch.GetAngle(2, 0, event), weight);
+        }
+    }
+    else if(fDecayType_ != ONE)
+    {
+         throw(std::string("Invalid no of decay products in InitialCuts!"));
+    }
+}
+
+///
+/// \brief InitialCuts::FillDistributionHistograms_ Fill histograms with distributions of E, p, phi and cos(theta) for an event of a batch.
+/// \param batch Batch of events.
+/// \param event Index of the event in the batch.
+///
+void InitialCuts::FillDistributionHistograms_(const EventBatch& batch, int event)
+{
+    for(int ii=0; ii<batch.GetNumberOfDecayProducts(event); ii++)
+    {
+        int kk = batch.Index(ii, event);
+        if(batch.fCutPassing[kk])
+        {
+            fH_en_pass_.Fill(batch.fE[kk]);
+            fH_p_pass_.Fill(batch.GetMomentum(ii, event));
+            fH_phi_pass_.Fill(batch.GetPhi(ii, event));
+            fH_cosTheta_pass_.Fill(batch.GetCosTheta(ii, event));
+        }
+        else
+        {
+            fH_en_fail_.Fill(batch.fE[kk]);
+            fH_p_fail_.Fill(batch.GetMomentum(ii, event));
+            fH_phi_fail_.Fill(batch.GetPhi(ii, event));
+            fH_cosTheta_fail_.Fill(batch.GetCosTheta(ii, event));
+        }
+    }
+}
+
 ///
 /// \brief InitialCuts::DrawHistograms One function to rule... draw them all!
 /// \param prefix Prefix of histograms file names.
@@ -742,6 +1042,8 @@ void InitialCuts::DrawHistograms(std::string prefix, OutputOptions output)
 ///
 void InitialCuts::DrawCutsHistograms(std::string prefix, OutputOptions output)
 {
+    if(!fHistograms_)
+        return;
     std::string outFile;
     if(!fSilentMode_) std::cout<<"[INFO] Drawing histograms for cuts passing."<<std::endl;
     TCanvas* cuts = new TCanvas((fTypeString_+"-gammas_cuts_passed").c_str(),\
@@ -762,34 +1064,27 @@ void InitialCuts::DrawCutsHistograms(std::string prefix, OutputOptions output)
     labelPercent->SetNDC();
     labelPercent->SetTextColor(kRed+2);
 
-    //string stream for writing percentage values on the plots
-    std::stringstream ss;
-    ss<<std::setprecision(2);
-
-    //drawing histograms
+    //drawing histograms, percentages are drawn on copies, so counts can be written and summed over shards
     //for gammas
     cuts->cd(1);
-    fH_gamma_cuts_->Scale(100.0/(double)fNumberOfGammas_);
-    fH_gamma_cuts_->GetYaxis()->SetRangeUser(0.0, 101.0);
-    fH_gamma_cuts_->SetStats(kFALSE);
-    fH_gamma_cuts_->Draw("hist");
+    TH1D* gammaPercent = CutFlow::MakePercent(fH_gamma_cuts_.Get(), fTypeString_+"-gammas_cuts_percent");
+    gammaPercent->GetYaxis()->SetRangeUser(0.0, 101.0);
+    gammaPercent->SetStats(kFALSE);
+    gammaPercent->Draw("hist");
     labelBefore -> DrawText(0.15, 0.55, "before cuts");
     labelGeo -> DrawText(0.4, 0.55, "geom. accept.");
     labelP -> DrawText(0.65, 0.55, "interaction prob.");
-    ss<<(double)fAcceptedGammas_/(double)fNumberOfGammas_*100.0;
-    labelPercent->DrawText(0.75, 0.2, (ss.str()+std::string("%")).c_str());
-    ss.str(std::string());
+    labelPercent->DrawText(0.75, 0.2, CutFlow::GetPassedLabel(fH_gamma_cuts_.Get()).c_str());
     //for events
     cuts->cd(2);
-    fH_event_cuts_->Scale(100.0/fNumberOfEvents_);
-    fH_event_cuts_->GetYaxis()->SetRangeUser(0.0, 101.0);
-    fH_event_cuts_->SetStats(kFALSE);
-    fH_event_cuts_->Draw("hist");
+    TH1D* eventPercent = CutFlow::MakePercent(fH_event_cuts_.Get(), fTypeString_+"-events_cuts_percent");
+    eventPercent->GetYaxis()->SetRangeUser(0.0, 101.0);
+    eventPercent->SetStats(kFALSE);
+    eventPercent->Draw("hist");
     labelBefore -> DrawText(0.15, 0.55, "before cuts");
     labelGeo -> DrawText(0.4, 0.55, "geom. accept.");
     labelP -> DrawText(0.65, 0.55, "interaction prob.");
-    ss<<fAcceptedEvents_/(double)fNumberOfEvents_*100.0;
-    labelPercent->DrawText(0.75, 0.2, (ss.str()+std::string("%")).c_str());
+    labelPercent->DrawText(0.75, 0.2, CutFlow::GetPassedLabel(fH_event_cuts_.Get()).c_str());
 
     if(!fSilentMode_) std::cout<<"[INFO] Saving histograms for cuts passing."<<std::endl;
     if(output==BOTH || output==PNG)
@@ -803,8 +1098,12 @@ void InitialCuts::DrawCutsHistograms(std::string prefix, OutputOptions output)
     if(output==BOTH || output==TREE)
     {
         cuts->Write();
+        fH_gamma_cuts_->Write(CutFlow::GetCountsName(fTypeString_, false).c_str());
+        fH_event_cuts_->Write(CutFlow::GetCountsName(fTypeString_, true).c_str());
     }
     delete cuts;
+    delete gammaPercent;
+    delete eventPercent;
     delete labelBefore;
     delete labelGeo;
     delete labelP;
@@ -819,6 +1118,8 @@ void InitialCuts::DrawCutsHistograms(std::string prefix, OutputOptions output)
 ///
 void InitialCuts::DrawPassHistograms(std::string prefix, OutputOptions output)
 {
+    if(!fHistograms_)
+        return;
     std::string outFile1;
     std::string outFile2;
     if(!fSilentMode_) std::cout<<"[INFO] Drawing histograms for gammas that passed cuts."<<std::endl;
@@ -847,9 +1148,9 @@ void InitialCuts::DrawPassHistograms(std::string prefix, OutputOptions output)
     fH_en_pass_low_->SetFillColor(kBlue);
     fH_en_pass_high_->SetFillColor(kRed);
     TLegend* legend = new TLegend(0.1, 0.5, 0.4, 0.9);
-    legend->AddEntry(fH_en_pass_event_, "all gammas", "f");
-    legend->AddEntry(fH_en_pass_low_, "lowest energy", "f");
-    legend->AddEntry(fH_en_pass_high_, "highest energy", "f");
+    legend->AddEntry(fH_en_pass_event_.Get(), "all gammas", "f");
+    legend->AddEntry(fH_en_pass_low_.Get(), "lowest energy", "f");
+    legend->AddEntry(fH_en_pass_high_.Get(), "highest energy", "f");
 
     //angle distribution depends on the number of decay products
     if(fDecayType_ == THREE)
@@ -899,7 +1200,7 @@ void InitialCuts::DrawPassHistograms(std::string prefix, OutputOptions output)
                                       ("Distribution of energy for incident photons from "\
                                        +fTypeString_+std::string("-gamma events")).c_str(), 1000, 900);
         fH_en_pass_mid_->SetFillColor(kGreen);
-        legend->AddEntry(fH_en_pass_mid_, "medium energy", "f");
+        legend->AddEntry(fH_en_pass_mid_.Get(), "medium energy", "f");
         diff_en->Divide(2,2);
         diff_en->cd(2);
         objLow = (TH1F*)fH_en_pass_low_->DrawClone(); //need to draw clones to make it look pretty
@@ -993,6 +1294,8 @@ void InitialCuts::DrawPassHistograms(std::string prefix, OutputOptions output)
 ///
 void InitialCuts::DrawFailHistograms(std::string prefix, OutputOptions output)
 {
+        if(!fHistograms_)
+            return;
         std::string outFile1;
         std::string outFile2;
         if(!fSilentMode_) std::cout<<"[INFO] Drawing histograms for events that did not pass cuts."<<std::endl;
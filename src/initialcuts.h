@@ -7,7 +7,10 @@
 #include "TH2.h"
 #include "TRandom3.h"
 #include "event.h"
+#include "eventbatch.h"
+#include "randomstream.h"
 #include "parammanager.h"
+#include "histogramaccumulator.h"
 
 
 ///
@@ -16,7 +19,7 @@
 class InitialCuts
 {
     public:
-        InitialCuts(DecayType type=TWO, float R=437.3, float L=500, float p=1.0);
+        InitialCuts(DecayType type=TWO, float R=437.3, float L=500, float p=1.0, bool histograms=true);
         InitialCuts(const InitialCuts&);
         InitialCuts& operator=(const InitialCuts& est);
         ~InitialCuts();
@@ -29,13 +32,20 @@ class InitialCuts
         inline float GetLength() const {return fL_;}
         inline void SetLength(float L){fL_=L;}
         inline float GetDetectionProbability() const {return fDetectionProbability_;}
+        inline bool HasHistograms() const {return fHistograms_;}
         inline void SetDetectionProbability(float p){if(p>1.0) fDetectionProbability_=1.0; else if(p<0.0) fDetectionProbability_=0.0; else fDetectionProbability_=p;}
 
         //silent mode switch on/off
         inline void EnableSilentMode(){fSilentMode_=true;}
         inline void DisableSilentMode(){fSilentMode_=false;}
         //adding cuts
-        void AddCuts(Event* event);
+        void AddCuts(Event* event, TRandom* rng);
+        void AddCuts(EventBatch& batch, RandomStream* rng);
+        template<DecayType kType> void AddCuts(EventBatch& batch, RandomStream* rng);
+        //removing events that cannot pass cuts before the following stages
+        template<DecayType kType> void RejectMissed(EventBatch& batch, RandomStream* rng);
+        //merging results obtained by another instance (e.g. by a worker thread)
+        void Merge(const InitialCuts& est);
         //drawing histograms
         void DrawHistograms(std::string prefix, OutputOptions output=PNG);
         void DrawCutsHistograms(std::string prefix, OutputOptions output);
@@ -44,6 +54,8 @@ class InitialCuts
     private:
         //if set to true, no output is generated to std::cout
         bool fSilentMode_; //false by default
+        //if set to false, histograms are neither created nor filled, only events and gammas are counted
+        bool fHistograms_; //true by default
         //type of the managed decay
         DecayType fDecayType_;
         std::string fTypeString_;
@@ -58,45 +70,53 @@ class InitialCuts
         int fNumberOfGammas_; //total number of gammas
 
         // histograms with relative angles for events that passed cuts
-        TH1F* fH_12_pass_;
-        TH1F* fH_23_pass_;
-        TH1F* fH_31_pass_;
-        TH2F* fH_12_23_pass_;
-        TH2F* fH_12_31_pass_;
-        TH2F* fH_23_31_pass_;
+        HistogramAccumulator<TH1F> fH_12_pass_;
+        HistogramAccumulator<TH1F> fH_23_pass_;
+        HistogramAccumulator<TH1F> fH_31_pass_;
+        HistogramAccumulator<TH2F> fH_12_23_pass_;
+        HistogramAccumulator<TH2F> fH_12_31_pass_;
+        HistogramAccumulator<TH2F> fH_23_31_pass_;
 
         // histograms with relative angles for events that failed cuts
-        TH1F* fH_12_fail_;
-        TH1F* fH_23_fail_;
-        TH1F* fH_31_fail_;
-        TH2F* fH_12_23_fail_;
-        TH2F* fH_12_31_fail_;
-        TH2F* fH_23_31_fail_;
+        HistogramAccumulator<TH1F> fH_12_fail_;
+        HistogramAccumulator<TH1F> fH_23_fail_;
+        HistogramAccumulator<TH1F> fH_31_fail_;
+        HistogramAccumulator<TH2F> fH_12_23_fail_;
+        HistogramAccumulator<TH2F> fH_12_31_fail_;
+        HistogramAccumulator<TH2F> fH_23_31_fail_;
 
         //only for events that passed cuts
-        TH1F* fH_en_pass_; //all gammas that passed cuts
-        TH1F* fH_en_pass_event_; //gammas that passed cuts and could be used to reconstruct an event
-        TH1F* fH_en_pass_low_; //gammas that passed cuts and could be used to reconstruct an event; low energy
-        TH1F* fH_en_pass_mid_; //gammas that passed cuts and could be used to reconstruct an event; mid energy
-        TH1F* fH_en_pass_high_; ////gammas that passed cuts and could be used to reconstruct an event; high energy
-        TH1F* fH_p_pass_;
-        TH1F* fH_phi_pass_;
-        TH1F* fH_cosTheta_pass_;
+        HistogramAccumulator<TH1F> fH_en_pass_; //all gammas that passed cuts
+        HistogramAccumulator<TH1F> fH_en_pass_event_; //gammas that passed cuts and could be used to reconstruct an event
+        HistogramAccumulator<TH1F> fH_en_pass_low_; //gammas that passed cuts and could be used to reconstruct an event; low energy
+        HistogramAccumulator<TH1F> fH_en_pass_mid_; //gammas that passed cuts and could be used to reconstruct an event; mid energy
+        HistogramAccumulator<TH1F> fH_en_pass_high_; ////gammas that passed cuts and could be used to reconstruct an event; high energy
+        HistogramAccumulator<TH1F> fH_p_pass_;
+        HistogramAccumulator<TH1F> fH_phi_pass_;
+        HistogramAccumulator<TH1F> fH_cosTheta_pass_;
 
         //only for events that did not pass cuts
-        TH1F* fH_en_fail_;
-        TH1F* fH_p_fail_;
-        TH1F* fH_phi_fail_;
-        TH1F* fH_cosTheta_fail_;
+        HistogramAccumulator<TH1F> fH_en_fail_;
+        HistogramAccumulator<TH1F> fH_p_fail_;
+        HistogramAccumulator<TH1F> fH_phi_fail_;
+        HistogramAccumulator<TH1F> fH_cosTheta_fail_;
 
         //histogram for showing fraction of events that passed different cuts
-        TH1F* fH_gamma_cuts_;
-        TH1F* fH_event_cuts_;
+        HistogramAccumulator<TH1D> fH_gamma_cuts_; //counts, they are converted to percentages only when drawn
+        HistogramAccumulator<TH1D> fH_event_cuts_;
 
-        bool DetectionCut_();
+        void CreateHistograms_();
+        void CopyHistograms_(const InitialCuts& est);
+        template<DecayType kType, bool kHistograms> void AddCuts_(EventBatch& batch, RandomStream* rng);
+        template<DecayType kType, bool kHistograms> void RejectMissed_(EventBatch& batch, RandomStream* rng);
+        template<DecayType kType, bool kHistograms> void CutEvent_(EventBatch& batch, int event, RandomStream* rng, bool& geo_event_pass, bool& inter_event_pass);
+        bool DetectionCut_(TRandom* rng);
         void FillValidEventHistograms_(const Event* event);
         void FillInvalidEventHistograms_(const Event* event);
         void FillDistributionHistograms_(const Event* event);
+        void FillValidEventHistograms_(const EventBatch& batch, int event);
+        void FillInvalidEventHistograms_(const EventBatch& batch, int event);
+        void FillDistributionHistograms_(const EventBatch& batch, int event);
 
         static unsigned objectID_;
 
@@ -0,0 +1,178 @@
+/// @file kleinnishinasampler.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <cmath>
+#include <string>
+#include "constants.h"
+#include "kleinnishinasampler.h"
+
+///
+/// \brief KleinNishinaSampler::KleinNishinaSampler Tabulates the inverse cumulative distribution of cos(theta).
+/// \param minE Lowest tabulated energy [MeV].
+/// \param maxE Highest tabulated energy [MeV].
+/// \param energyPoints Number of tabulated energies.
+/// \param uniformPoints Number of intervals of the uniform variable.
+///
+KleinNishinaSampler::KleinNishinaSampler(double minE, double maxE, int energyPoints, int uniformPoints) :
+    fMinE_(minE),
+    fMaxE_(maxE),
+    fEnergyPoints_(energyPoints),
+    fUniformPoints_(uniformPoints),
+    fLogMinE_(std::log(minE)),
+    fLogStep_((std::log(maxE)-std::log(minE))/(energyPoints-1)),
+    fTable_(energyPoints*(uniformPoints+1))
+{
+    if(minE<=0.0 || maxE<=minE || energyPoints<2 || uniformPoints<1)
+        throw(std::string("[ERROR] Wrong parameters of the Klein-Nishina sampler!"));
+    //the cumulative distribution is integrated on a grid finer than the tabulated one and inverted linearly
+    const int cdfIntervals = 8*uniformPoints;
+    const double step = 2.0/cdfIntervals;
+    std::vector<double> cdf(cdfIntervals+1);
+    for(int ii=0; ii<fEnergyPoints_; ii++)
+    {
+        double k = std::exp(fLogMinE_ + ii*fLogStep_)/e_mass_MeV;
+        cdf[0] = 0.0;
+        double previous = Density_(k, -1.0);
+        for(int jj=1; jj<=cdfIntervals; jj++)
+        {
+            double current = Density_(k, -1.0 + jj*step);
+            cdf[jj] = cdf[jj-1] + 0.5*(previous+current)*step; //trapezoidal rule
+            previous = current;
+        }
+        double* row = &fTable_[ii*(fUniformPoints_+1)];
+        int bin = 0;
+        for(int jj=0; jj<=fUniformPoints_; jj++)
+        {
+            double target = cdf[cdfIntervals]*jj/fUniformPoints_;
+            while(bin<cdfIntervals-1 && cdf[bin+1]<target)
+                bin++;
+            double width = cdf[bin+1] - cdf[bin];
+            double fraction = width > 0 ? (target - cdf[bin])/width : 0.0;
+            fraction = fraction > 1.0 ? 1.0 : fraction;
+            row[jj] = -1.0 + (bin + fraction)*step;
+        }
+        row[0] = -1.0;
+        row[fUniformPoints_] = 1.0;
+    }
+}
+
+///
+/// \brief KleinNishinaSampler::GetDefault Returns the sampler with the default grid, which is created on the first call.
+/// \return Reference to the default sampler.
+///
+const KleinNishinaSampler& KleinNishinaSampler::GetDefault()
+{
+    static const KleinNishinaSampler sampler; //initialization of a local static is thread-safe in C++11
+    return sampler;
+}
+
+///
+/// \brief KleinNishinaSampler::Density_ Klein-Nishina distribution of cos(theta), the same as ComptonScattering::KleinNishina_
+/// up to a constant factor.
+/// \param k Energy of the incident photon in the units of electron's mass.
+/// \param cosTheta Cosine of the scattering angle.
+/// \return Value of the distribution.
+///
+double KleinNishinaSampler::Density_(double k, double cosTheta)
+{
+    double denom = 1.0 + k*(1.0 - cosTheta);
+    double P = 1.0/denom;
+    return P*P*(P + denom - (1.0 - cosTheta*cosTheta));
+}
+
+///
+/// \brief KleinNishinaSampler::CDF Calculates the cumulative distribution of cos(theta) by numerical integration, used for validation.
+/// \param E Energy of the incident photon [MeV].
+/// \param cosTheta Cosine of the scattering angle.
+/// \param intervals Number of intervals used by the trapezoidal rule over the whole range of cos(theta).
+/// \return Probability that the cosine is lower than cosTheta.
+///
+double KleinNishinaSampler::CDF(double E, double cosTheta, int intervals)
+{
+    const double k = E/e_mass_MeV;
+    const double step = 2.0/intervals;
+    double total = 0.0;
+    double below = 0.0;
+    double previous = Density_(k, -1.0);
+    for(int ii=1; ii<=intervals; ii++)
+    {
+        double x = -1.0 + ii*step;
+        double current = Density_(k, x);
+        double area = 0.5*(previous+current)*step;
+        total += area;
+        if(x <= cosTheta)
+            below += area;
+        else if(x-step < cosTheta)
+            below += area*(cosTheta-(x-step))/step;
+        previous = current;
+    }
+    return below/total;
+}
+
+///
+/// \brief KleinNishinaSampler::InverseCDF Returns the cosine of the scattering angle for a given value of the uniform variable.
+/// \param E Energy of the incident photon [MeV], has to be within the tabulated range.
+/// \param u Value of the uniform variable from [0,1].
+/// \return Cosine of the scattering angle.
+///
+double KleinNishinaSampler::InverseCDF(double E, double u) const
+{
+    double x = (std::log(E) - fLogMinE_)/fLogStep_;
+    int ii = static_cast<int>(x);
+    ii = ii < 0 ? 0 : (ii > fEnergyPoints_-2 ? fEnergyPoints_-2 : ii);
+    double fe = x - ii;
+    double y = u*fUniformPoints_;
+    int jj = static_cast<int>(y);
+    jj = jj < 0 ? 0 : (jj > fUniformPoints_-1 ? fUniformPoints_-1 : jj);
+    double fu = y - jj;
+    const double* low = &fTable_[ii*(fUniformPoints_+1) + jj];
+    const double* high = low + (fUniformPoints_+1);
+    double atLow = low[0] + fu*(low[1]-low[0]);
+    double atHigh = high[0] + fu*(high[1]-high[0]);
+    return atLow + fe*(atHigh-atLow);
+}
+
+///
+/// \brief KleinNishinaSampler::SampleCosTheta Draws the cosine of the scattering angle using the table.
+/// Energies outside of the tabulated range are sampled with Kahn's method.
+/// \param E Energy of the incident photon [MeV].
+/// \param rng Random number generator to be used.
+/// \return Cosine of the scattering angle.
+///
+double KleinNishinaSampler::SampleCosTheta(double E, TRandom* rng) const
+{
+    if(!IsInRange(E))
+        return SampleCosThetaKahn(E, rng);
+    return InverseCDF(E, rng->Rndm());
+}
+
+///
+/// \brief KleinNishinaSampler::SampleCosThetaKahn Draws the cosine of the scattering angle with Kahn's rejection method (exact).
+/// \param E Energy of the incident photon [MeV].
+/// \param rng Random number generator to be used.
+/// \return Cosine of the scattering angle.
+///
+double KleinNishinaSampler::SampleCosThetaKahn(double E, TRandom* rng)
+{
+    const double k = E/e_mass_MeV;
+    while(true)
+    {
+        double r1 = rng->Rndm();
+        double r2 = rng->Rndm();
+        double r3 = rng->Rndm();
+        //eta is the ratio of energies of the incident and scattered photon
+        if(r1 <= (1.0+2.0*k)/(9.0+2.0*k))
+        {
+            double eta = 1.0 + 2.0*k*r2;
+            if(r3 <= 4.0*(1.0/eta - 1.0/(eta*eta)))
+                return 1.0 - (eta-1.0)/k;
+        }
+        else
+        {
+            double eta = (1.0+2.0*k)/(1.0+2.0*k*r2);
+            double cosTheta = 1.0 - (eta-1.0)/k;
+            if(r3 <= 0.5*(cosTheta*cosTheta + 1.0/eta))
+                return cosTheta;
+        }
+    }
+}
@@ -0,0 +1,41 @@
+/// @file kleinnishinasampler.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef KLEINNISHINASAMPLER_H
+#define KLEINNISHINASAMPLER_H
+#include <vector>
+#include "TRandom.h"
+
+///
+/// \brief The KleinNishinaSampler class Draws cosines of Compton scattering angles from the Klein-Nishina distribution.
+///
+/// The inverse cumulative distribution of cos(theta) is tabulated once, on a grid of energies (logarithmic spacing)
+/// and values of the uniform variable (linear spacing). A cosine is then obtained by a bilinear interpolation in the table.
+/// Energies outside of the table are sampled with the exact Kahn's rejection method, which can also be used directly.
+///
+class KleinNishinaSampler
+{
+    public:
+        KleinNishinaSampler(double minE=0.001, double maxE=10.0, int energyPoints=256, int uniformPoints=1024);
+        double SampleCosTheta(double E, TRandom* rng) const; //table with Kahn's method outside of the range
+        double InverseCDF(double E, double u) const; //interpolated table value
+        inline bool IsInRange(double E) const {return E>=fMinE_ && E<=fMaxE_;}
+        inline double GetMinE() const {return fMinE_;}
+        inline double GetMaxE() const {return fMaxE_;}
+        static double SampleCosThetaKahn(double E, TRandom* rng); //exact rejection method
+        static double CDF(double E, double cosTheta, int intervals=10000); //numerically integrated cumulative distribution
+        static const KleinNishinaSampler& GetDefault(); //instance shared by all threads
+
+    private:
+        double fMinE_; //lowest tabulated energy [MeV]
+        double fMaxE_; //highest tabulated energy [MeV]
+        int fEnergyPoints_; //number of tabulated energies
+        int fUniformPoints_; //number of intervals of the uniform variable
+        double fLogMinE_; //log of fMinE_
+        double fLogStep_; //step of log(E) between tabulated energies
+        std::vector<double> fTable_; //cos(theta) for [energy index][uniform variable index]
+
+        static double Density_(double k, double cosTheta); //Klein-Nishina distribution of cos(theta), not normalized
+};
+
+#endif // KLEINNISHINASAMPLER_H
@@ -13,19 +13,37 @@
 #include <sys/stat.h>
 #include <sstream>
 #include <ctime>
-#include "TGenPhaseSpace.h"
+#include <thread>
+#include <random>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <chrono>
 #include "TFile.h"
 #include "TROOT.h"
 #include "TList.h"
+#include "TH1D.h"
+#include "TNamed.h"
+#include "TKey.h"
 #include "event.h"
 #include "parammanager.h"
 #include "psdecay.h"
 #include "initialcuts.h"
 #include "particlegenerator.h"
 #include "phantom.h"
+#include "simulationworker.h"
+#include "rootwriter.h"
+#include "treefiller.h"
+#include "blockoutput.h"
+#include "stageprofiler.h"
+#include "checkpoint.h"
 
 // Paths to folders containing results.
 static std::string generalPrefix("results/");
+// ROOT objects of workers (histograms, functions) are created and deleted by one thread at a time, when runs are concurrent.
+static std::mutex rootObjectsMutex;
+// Canvases are drawn by the writer and the renderer threads, never at the same time (a new canvas deletes an existing one with the same name).
+static std::mutex canvasMutex;
 
 ///
 /// \brief Small function to convert double numbers into strings with pretty appearence
@@ -38,93 +56,241 @@ std::string toStringPretty(const T a_value)
     return out.str();
 }
 
+///
+/// \brief writeProfile Writes the profile of simulated decays to the output file. Stage times [ns/event] are stored in
+/// a histogram with one labelled bin per stage, the whole report as the title of a TNamed.
+/// \param profiler Merged profiler of all threads.
+/// \param report Report returned by StageProfiler::GetReport.
+/// \param typeString Type of simulated decays, used in names of objects.
+/// \param dir Directory in which objects are written.
+///
+void writeProfile(const StageProfiler& profiler, const std::string& report, const std::string& typeString, TDirectory* dir)
+{
+    dir->cd();
+    TH1D stageTimes(("stageTimes_"+typeString).c_str(), "Time of stages [ns/event]", StageProfiler::kNoOfStages, 0, StageProfiler::kNoOfStages);
+    stageTimes.SetDirectory(nullptr);
+    for(int ii=0; ii<StageProfiler::kNoOfStages; ii++)
+    {
+        stageTimes.GetXaxis()->SetBinLabel(ii+1, StageProfiler::GetStageName(static_cast<StageProfiler::Stage>(ii)));
+        stageTimes.SetBinContent(ii+1, profiler.GetNsPerEvent(static_cast<StageProfiler::Stage>(ii)));
+    }
+    stageTimes.SetEntries(profiler.GetEvents());
+    dir->WriteTObject(&stageTimes);
+    TNamed profile(("profile_"+typeString).c_str(), report.c_str());
+    dir->WriteTObject(&profile);
+}
+
+///
+/// \brief drawHistograms Draws merged histograms of a run. Called by the writer (TREE) or the renderer (PNG) thread.
+/// \param results Worker with merged histograms of all workers.
+/// \param pManag ParamManager reference containing parameters of the simulation.
+/// \param filePrefix Prefix for all files.
+/// \param output PNG to save images, TREE to write canvases to the current directory.
+///
+void drawHistograms(SimulationWorker* results, const ParamManager& pManag, const std::string& filePrefix, OutputOptions output)
+{
+    if(!pManag.AreHistogramsEnabled())
+        return;
+    try
+    {
+        results->GetPsDecay().DrawHistograms(filePrefix, output);
+        results->GetCuts().DrawHistograms(filePrefix, output);
+        results->GetComptonScattering().DrawComptonHistograms(filePrefix, output); //Draw histograms with scattering angle and electron's energy distributions.
+        //plots of the Klein-Nishina function are written only as images, their histograms are created when drawn
+        if(pManag.GetHistogramLevel()==FULL_HISTOGRAMS && output==PNG)
+        {
+            std::lock_guard<std::mutex> lock(rootObjectsMutex);
+            results->GetComptonScattering().DrawPDF(filePrefix);
+        }
+    }
+    catch(std::string e)
+    {
+        std::cout<<e<<std::endl;
+    }
+}
+
+///
+/// \brief simulateBlocks Function executed by every worker thread of a run, simulates blocks until all of them are taken.
+/// \param nextBlock Index of the next block to be simulated, shared by all worker threads.
+/// \param lastBlock Index of the block after the last one to be simulated.
+/// \param worker Pipeline owned by this thread.
+/// \param output Receives events of simulated blocks, so they are written while the next block is simulated.
+///
+void simulateBlocks(std::atomic<long>& nextBlock, const long lastBlock, SimulationWorker* worker, BlockOutput& output)
+{
+    for(long block=nextBlock++; block<lastBlock; block=nextBlock++)
+    {
+        worker->ProcessBlock(block);
+        //the error is rethrown by simulateDecay, the output thread must not wait for this block
+        if(worker->HasFailed())
+        {
+            output.Abort();
+            return;
+        }
+        PROFILE_STAGE(worker->GetProfiler(), StageProfiler::OUTPUT);
+        output.Put(block, *worker);
+    }
+}
+
 ///
 /// \brief simulateDecay A function that performs run for many decays with one parameter set.
+/// Events are simulated in blocks by persistent worker threads, each of them owning a complete pipeline and taking the
+/// next block as soon as it finishes the previous one. Meanwhile this thread passes events of finished blocks to the tree
+/// in their natural order (see BlockOutput). Histograms of all workers are merged at the end, so the results do not depend
+/// on the number of threads. All operations on the output file are passed to the writer. Images are rendered by the renderer,
+/// so neither of them delays the next run.
 /// \param Ps Fourmomentum of the source [GeV]
 /// \param source Fourvector with the position of the source, fourth coordinate represents radius of the source ball [mm].
 /// \param pManag ParamManager reference containing parameters of the simulation.
 /// \param type TWO, THREE or TWOandONE.
+/// \param simRun Number of the current run, used to derive random number generator seeds.
+/// \param idOffset Offset of ids of events, see SimulationWorker::GetEventIdOffset.
+/// \param writer RootWriter executing operations on the output file.
+/// \param renderer RootWriter rendering images of histograms.
 /// \param filePrefix Prefix for all files.
 /// \param tree Instance of TTree to save results from this run.
+/// \param histDir Directory in the output file, where histograms are written.
 ///
-void simulateDecay(TLorentzVector Ps, const TLorentzVector& source, const ParamManager& pManag, const DecayType type, const std::string filePrefix = "", TTree* tree = nullptr)
+void simulateDecay(TLorentzVector Ps, const TLorentzVector& source, const ParamManager& pManag, const DecayType type, const int simRun, const long idOffset,\
+                   RootWriter& writer, RootWriter& renderer, const std::string filePrefix = "", TTree* tree = nullptr, TDirectory* histDir = nullptr)
 {
     std::string type_string;
     int noOfGammas = 0;
     type_string = recognizeType(type, noOfGammas);
-    ////////////////////////////////////////////////////////////////////////
-    double* masses = new double[noOfGammas]();
-    //(Momentum, Energy units are Gev/C, GeV)
-    TGenPhaseSpace phaseSpaceGen;
-    phaseSpaceGen.SetDecay(Ps, noOfGammas, masses);
-    // creating necessary objects
-    Event* eventDecay = nullptr;//new Event;
-    PsDecay decay(type);
-    Phantom phantom(pManag.GetPhantomNaive511Prob(), pManag.GetPhantomNaivePromptProb(), pManag.GetPhantomSmear());
-    InitialCuts cuts(type, pManag.GetR(), pManag.GetL(), pManag.GetEff());
-    ComptonScattering cs(type, pManag.GetSmearLowLimit(), pManag.GetSmearHighLimit());
-    //setting SilentMode if necessary
-    if(pManag.IsSilentMode())
+    //a shard (one of processes sharing the run) simulates a contiguous range of blocks
+    long firstShardBlock = 0, lastShardBlock = 0;
+    SimulationWorker::GetShardBlocks(pManag.GetSimEvents(), pManag.GetShardIndex(), pManag.GetShardCount(), firstShardBlock, lastShardBlock);
+    const long noOfBlocks = lastShardBlock-firstShardBlock;
+    long noOfThreads = pManag.GetThreads() > 0 ? pManag.GetThreads() : std::thread::hardware_concurrency();
+    noOfThreads = noOfThreads > noOfBlocks ? noOfBlocks : noOfThreads;
+    noOfThreads = noOfThreads < 1 ? 1 : noOfThreads;
+    // creating necessary objects, every worker has its own generator and histograms
+    std::vector<SimulationWorker*> workers;
     {
-        //Descriptive part
-        decay.EnableSilentMode();
-        cuts.EnableSilentMode();
-        cs.EnableSilentMode();
+        std::lock_guard<std::mutex> lock(rootObjectsMutex);
+        for(long ii=0; ii<noOfThreads; ii++)
+        {
+            workers.push_back(new SimulationWorker(Ps, source, pManag, type, simRun, tree!=nullptr));
+            workers.back()->SetEventIdOffset(idOffset);
+        }
     }
-    else
+    //simulated events are filled into the tree asynchronously by the writer thread
+    TreeFiller* filler = nullptr;
+    if(tree!=nullptr)
+    {
+        //the derivation of ids is saved with the tree, so events can be identified in results of other executions
+        std::ostringstream idScheme;
+        idScheme<<"id = "<<idOffset<<" + block*"<<SimulationWorker::kBlockSize<<" + index + 1 (run: "<<simRun<<", decay type: "<<type_string\
+                <<", events: "<<pManag.GetSimEvents()<<", seed: "<<pManag.GetSeed()<<")";
+        const std::string idSchemeName = "eventIds_"+type_string;
+        const std::string idSchemeTitle = idScheme.str();
+        writer.Execute([&]()
+        {
+            tree->GetUserInfo()->Add(new TNamed(idSchemeName.c_str(), idSchemeTitle.c_str()));
+        });
+        filler = new TreeFiller(tree, writer, type, workers[0]->GetMaxDecayProducts(), pManag.GetOutputQueueSize(), pManag.IsSilentMode(),\
+                                pManag.GetTreeSchema());
+    }
+    if(!pManag.IsSilentMode())
     {
+        //Descriptive part
         std::cout<<"[INFO] Simulating "<<type_string<<"-gamma decays"<<std::endl;
         std::cout<<"[INFO] Source coordinates: ("<<source.X()<<", "<<source.Y()<<", "<<source.Z()<<") r="<<source.T()<<" [mm]"<<std::endl;
+        std::cout<<"[INFO] Worker threads: "<<noOfThreads<<std::endl;
         std::cout<<"[INFO] Generation start!"<<std::endl;
     }
 
     //***   EVENT LOOP  ***
-    for (Int_t n=0; n<pManag.GetSimEvents(); n++)
+    StageProfiler outputProfiler; //time of passing events to the tree filler, spent by this thread
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    //up to two finished blocks per worker wait for writing, further workers wait for the output
+    BlockOutput output(firstShardBlock, 2*noOfThreads, type, workers[0]->GetMaxDecayProducts());
+    std::atomic<long> nextBlock(firstShardBlock);
+    std::vector<std::thread> threads;
+    for(long ii=0; ii<noOfThreads; ii++)
+        threads.push_back(std::thread(simulateBlocks, std::ref(nextBlock), lastShardBlock, workers[ii], std::ref(output)));
+    //passing events to the tree filler, blocks are written in the order of their indices
+    std::vector<Event*> events;
+    for(long block=firstShardBlock; block<lastShardBlock && output.Take(block, events); block++)
     {
-
-       //generation of an Event
-       eventDecay = generateEvent(phaseSpaceGen, source, pManag, type);
-       //Filling histograms, event analysis
-       try
-       {
-           //Getting initial distributions
-           decay.AddEvent(eventDecay);
-           //Aplying Compton scattering in phantom
-           if(pManag.GetPhantomUse())
-                phantom.NaiveScatter(eventDecay);
-           //Applying cuts
-           cuts.AddCuts(eventDecay);
-           //Performing the Compton Scattering
-           cs.Scatter(eventDecay);
-           //we select what kind of events will be saved to the tree and save them
-       }
-
-       catch(std::string e)
-       {
-           std::cout<<e;
-           exit(-1);
-       }
-       //writing to tree
-       if(tree!=nullptr && ((pManag.GetEventTypeToSave()==PASS && eventDecay->GetPassFlag()) || (pManag.GetEventTypeToSave()==FAIL && !(eventDecay->GetPassFlag())) || (pManag.GetEventTypeToSave()==ALL)))
-       {
-           if(n==0)
-           {
-               if(!pManag.IsSilentMode())
-                   std::cout<<"[INFO] Creating a new branch for storing events.\n"<<std::endl;
-               tree->Branch("event_split", "Event", &eventDecay, 32000, 99);
-           }
-           tree->Fill();
-       }
-       delete eventDecay;
-
+        PROFILE_STAGE(outputProfiler, StageProfiler::OUTPUT);
+        for(std::vector<Event*>::iterator it = events.begin(); it != events.end() && filler!=nullptr; ++it)
+        {
+            Event* empty = filler->AcquireEvent();
+            filler->Push(*it);
+            *it = empty;
+        }
+        output.Release(events);
     }
+    for(std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+        it->join();
     //***   END OF EVENT LOOP   ***
+    if(filler!=nullptr)
+    {
+        PROFILE_STAGE(outputProfiler, StageProfiler::OUTPUT);
+        filler->Flush();
+        if(!pManag.IsSilentMode())
+            filler->PrintMetrics();
+        delete filler;
+    }
+    //errors of worker threads are passed to this thread, events of blocks finished before are already written
+    try
+    {
+        for(unsigned ii=0; ii<workers.size(); ii++)
+            workers[ii]->RethrowError();
+    }
+    catch(...)
+    {
+        std::lock_guard<std::mutex> lock(rootObjectsMutex);
+        for(unsigned ii=0; ii<workers.size(); ii++)
+            delete workers[ii];
+        throw;
+    }
+
+    const double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
 
-    //Drawing results
-    decay.DrawHistograms(filePrefix, pManag.GetOutputType());
-    cuts.DrawHistograms(filePrefix, pManag.GetOutputType());
-    cs.DrawComptonHistograms(filePrefix, pManag.GetOutputType()); //Draw histograms with scattering angle and electron's energy distributions.
-    delete[] masses;
+    //Merging results of all workers
+    for(unsigned ii=1; ii<workers.size(); ii++)
+        workers[0]->Merge(*workers[ii]);
+    StageProfiler& profiler = workers[0]->GetProfiler();
+    profiler.Merge(outputProfiler);
+    const std::string report = profiler.GetReport(wallTime, workers[0]->GetCuts().GetAcceptedEvents());
+    if(!pManag.IsSilentMode())
+        std::cout<<"[INFO] Profile of "<<type_string<<"-gamma decays:"<<std::endl<<report;
+    //only the first worker is kept for drawing, so memory of pending drawings does not grow with the number of threads
+    {
+        std::lock_guard<std::mutex> lock(rootObjectsMutex);
+        for(unsigned ii=1; ii<workers.size(); ii++)
+            delete workers[ii];
+    }
+    SimulationWorker* results = workers[0];
+    //Drawing results, tasks are queued without waiting, so the next run starts immediately; the last one releases the worker
+    std::function<void()> writeResults = [=, &pManag]()
+    {
+        if(histDir)
+        {
+            std::lock_guard<std::mutex> lock(canvasMutex);
+            histDir->cd();
+            drawHistograms(results, pManag, filePrefix, TREE);
+            //the profile is saved in the directory of the run
+            writeProfile(results->GetProfiler(), report, type_string, histDir->GetMotherDir());
+        }
+        std::lock_guard<std::mutex> lock(rootObjectsMutex);
+        delete results;
+    };
+    if(pManag.AreHistogramsEnabled() && (pManag.GetOutputType()==BOTH || pManag.GetOutputType()==PNG))
+    {
+        renderer.Post([=, &pManag, &writer]()
+        {
+            {
+                std::lock_guard<std::mutex> lock(canvasMutex);
+                drawHistograms(results, pManag, filePrefix, PNG);
+            }
+            writer.Post(writeResults);
+        });
+    }
+    else
+        writer.Post(writeResults);
 }
 
 ///
@@ -132,10 +298,13 @@ void simulateDecay(TLorentzVector Ps, const TLorentzVector& source, const ParamM
 /// \param simRun Number of current run.
 /// \param pManag ParamManager reference with all necessary parameters.
 /// \param treeFile Pointer to TFile object in which all data may be stored.
+/// \param writer RootWriter executing operations on the output file.
+/// \param renderer RootWriter rendering images of histograms.
+/// \param checkpoint Record of completed runs, updated when a run is completed.
 /// \param outputFileAndDirName Name that will be used as output folder name (in PNG mode) and/or output file prefix (in TREE mode).
-/// \return Pointer to the TTree object.
 ///
-TTree* simulate(const int simRun, ParamManager& pManag, TFile* treeFile, std::string outputFileAndDirName="")
+void simulate(const int simRun, const ParamManager& pManag, TFile* treeFile, RootWriter& writer, RootWriter& renderer, Checkpoint& checkpoint,\
+              std::string outputFileAndDirName="")
 {
 
    // Settings
@@ -161,7 +330,13 @@ TTree* simulate(const int simRun, ParamManager& pManag, TFile* treeFile, std::st
    if((TMath::Abs(x)+r)*(TMath::Abs(x)+r)+(TMath::Abs(y)+r)*(TMath::Abs(y)+r) >= pManag.GetR()*pManag.GetR() || (TMath::Abs(z)+r)>=pManag.GetL())
    {
        std::cerr<<"[ERROR] Source outside the barrel! Terminating current run!"<<std::endl;
-       return nullptr;
+       return;
+   }
+   //importance sampling of directions is valid only for isotropic decays
+   if(pManag.IsAcceptanceSampling() && (px!=0 || py!=0 || pz!=0))
+   {
+       std::cerr<<"[ERROR] Acceptance sampling requires a source at rest! Terminating current run!"<<std::endl;
+       return;
    }
 
    //setting the parameters of the source and subdirectory name
@@ -177,57 +352,138 @@ TTree* simulate(const int simRun, ParamManager& pManag, TFile* treeFile, std::st
        mkdir((generalPrefix+outputFileAndDirName+subDir).c_str(), ACCESSPERMS);
        chmod((generalPrefix+outputFileAndDirName+subDir).c_str(), ACCESSPERMS);
    }
-   if(pManag.GetOutputType()==BOTH || pManag.GetOutputType()==TREE)
+   if(pManag.GetOutputType()==BOTH || pManag.GetOutputType()==TREE || pManag.GetOutputType()==HEADLESS)
    {
-       tree = new TTree("tree", "Tree with events and histograms");
-       runDir = treeFile->mkdir(subDir.c_str());
-       runDir->cd();
-       histDir = runDir->mkdir("Histograms");
-       histDir->cd();
+       writer.Execute([&]()
+       {
+           runDir = treeFile->mkdir(subDir.c_str());
+           runDir->cd();
+           tree = new TTree("tree", "Tree with events and histograms"); //the tree is kept in the directory of the run
+           histDir = runDir->mkdir("Histograms");
+       });
    }
 
    //Performing simulations based on the provided number of gammas
+   //ids of events continue the numbering from previous runs (two decay types are simulated in one run in the mixed mode)
+   const long events = pManag.GetSimEvents();
+   const int decayTypesInRun = (noOfGammas>=1 && noOfGammas<=5) ? 1 : 2;
+   const long idOffset = SimulationWorker::GetEventIdOffset(simRun, events, decayTypesInRun, 0);
+   const std::string filePrefix = generalPrefix+outputFileAndDirName+subDir;
    if(noOfGammas==1)
    {
        std::cout<<"::::::::::::Simulating 1-gamma generation::::::::::::"<<std::endl;
-       simulateDecay(Ps, sourcePos, pManag, ONE, generalPrefix+outputFileAndDirName+subDir, tree);
+       simulateDecay(Ps, sourcePos, pManag, ONE, simRun, idOffset, writer, renderer, filePrefix, tree, histDir);
    }
    else if(noOfGammas==2)
    {
        std::cout<<"::::::::::::Simulating 2-gamma decays::::::::::::"<<std::endl;
-       simulateDecay(Ps, sourcePos, pManag, TWO, generalPrefix+outputFileAndDirName+subDir, tree);
+       simulateDecay(Ps, sourcePos, pManag, TWO, simRun, idOffset, writer, renderer, filePrefix, tree, histDir);
    }
    else if(noOfGammas==3)
    {
        std::cout<<"::::::::::::Simulating 3-gamma decays::::::::::::"<<std::endl;
-       simulateDecay(Ps, sourcePos, pManag, THREE, generalPrefix+outputFileAndDirName+subDir, tree);
+       simulateDecay(Ps, sourcePos, pManag, THREE, simRun, idOffset, writer, renderer, filePrefix, tree, histDir);
    }
    else if(noOfGammas==4)
    {
         std::cout<<"::::::::::::Simulating 2+1-gamma decays::::::::::::"<<std::endl;
-        simulateDecay(Ps, sourcePos, pManag, TWOandONE, generalPrefix+outputFileAndDirName+subDir, tree);
+        simulateDecay(Ps, sourcePos, pManag, TWOandONE, simRun, idOffset, writer, renderer, filePrefix, tree, histDir);
    }
    else if(noOfGammas==5)
    {
         std::cout<<"::::::::::::Simulating 2+N-gamma decays::::::::::::"<<std::endl;
-        simulateDecay(Ps, sourcePos, pManag, TWOandN, generalPrefix+outputFileAndDirName+subDir, tree);
+        simulateDecay(Ps, sourcePos, pManag, TWOandN, simRun, idOffset, writer, renderer, filePrefix, tree, histDir);
    }
    else
    {
        std::cout<<"::::::::::::Simulating both 2-gamma and 3-gammas decays::::::::::::"<<std::endl;
-       simulateDecay(Ps, sourcePos, pManag, TWO, generalPrefix+outputFileAndDirName+subDir, tree);
-       simulateDecay(Ps, sourcePos, pManag, THREE, generalPrefix+outputFileAndDirName+subDir, tree);
+       simulateDecay(Ps, sourcePos, pManag, TWO, simRun, idOffset, writer, renderer, filePrefix, tree, histDir);
+       simulateDecay(Ps, sourcePos, pManag, THREE, simRun, SimulationWorker::GetEventIdOffset(simRun, events, decayTypesInRun, 1), writer, renderer, filePrefix, tree, histDir);
+   }
+   if(tree)
+   {
+       writer.Execute([&]()
+       {
+           tree->Write("", TObject::kOverwrite); //replaces the tree saved when other runs were completed
+           delete tree;
+       });
    }
-   if(pManag.GetOutputType()==BOTH || pManag.GetOutputType()==TREE)
-       runDir->cd();
-   return tree;
+   //histograms and images are written asynchronously, the run is completed after them (tasks of the renderer are passed to the writer)
+   const std::string runDirName = subDir.substr(0, subDir.size()-1);
+   std::function<void()> completeRun = [=, &checkpoint, &writer]()
+   {
+       //a run with a failed write is not saved as completed, so it is simulated again when resuming
+       if(writer.HasFailed())
+           return;
+       //the directory of the run and the structure of the file are saved, so results of completed runs survive
+       //an interruption of the program; directories of other runs are saved when they are completed
+       if(runDir)
+       {
+           runDir->Write("", TObject::kOverwrite);
+           treeFile->SaveSelf(kTRUE);
+           treeFile->WriteStreamerInfo();
+           treeFile->WriteFree();
+           treeFile->WriteHeader();
+           treeFile->Flush();
+       }
+       checkpoint.MarkCompleted(simRun, runDirName);
+   };
+   renderer.Post([=, &writer]()
+   {
+       writer.Post(completeRun);
+   });
+}
+
+///
+/// \brief simulateRuns Simulates runs one after another, taking numbers of runs from a counter shared by all run threads.
+/// \param nextRun Number of the next run to be simulated.
+/// \param pManag ParamManager reference with all necessary parameters.
+/// \param treeFile Pointer to TFile object in which all data may be stored.
+/// \param writer RootWriter executing operations on the output file.
+/// \param renderer RootWriter rendering images of histograms.
+/// \param checkpoint Record of completed runs, updated when a run is completed.
+/// \param outputFileAndDirName Name that will be used as output folder name (in PNG mode) and/or output file prefix (in TREE mode).
+/// \param failed Set to true if a run failed, other run threads finish their current runs and do not start new ones.
+///
+void simulateRuns(std::atomic<int>& nextRun, const ParamManager& pManag, TFile* treeFile, RootWriter& writer, RootWriter& renderer,\
+                  Checkpoint& checkpoint, const std::string& outputFileAndDirName, std::atomic<bool>& failed)
+{
+    for(int ii=nextRun++; ii<pManag.GetSimRuns(); ii=nextRun++)
+    {
+        if(checkpoint.IsCompleted(ii))
+        {
+            std::cout<<"[INFO] Run no "<<ii+1<<" completed before resuming, skipping."<<std::endl;
+            continue;
+        }
+        std::cout<<":::::::::::: START OF RUN NO: "<<ii+1<<" ::::::::::::"<<std::endl;
+        try
+        {
+            simulate(ii, pManag, treeFile, writer, renderer, checkpoint, outputFileAndDirName);
+        }
+        catch(std::string e)
+        {
+            std::cerr<<e<<std::endl;
+            failed = true;
+            nextRun = pManag.GetSimRuns();
+            return;
+        }
+        //e.g. rethrown by the writer after a failed task posted by an earlier run
+        catch(const std::exception& e)
+        {
+            std::cerr<<"[ERROR] "<<e.what()<<std::endl;
+            failed = true;
+            nextRun = pManag.GetSimRuns();
+            return;
+        }
+        std::cout<<":::::::::::: END OF RUN NO:  "<<ii+1<<" ::::::::::::"<<"\n"<<std::endl;
+    }
 }
 
 ///
 /// \brief main Main function of the program.
 /// \param argc Number of provided arguments.
 /// \param argv Array of arguments.
-/// \return 0
+/// \return 0 on success, 1 if parameters are wrong or a run failed
 ///
 int main(int argc, char* argv[])
 {
@@ -244,10 +500,16 @@ int main(int argc, char* argv[])
   std::string outputFileAndDirName = oss.str();
   */
   std::string outputFileAndDirName = "result";
+  bool resume = false;
   //parsing command line arguments
   for(int nn=1; nn<argc; nn++)
   {
-      if(argc > nn+1)
+      if(std::string(argv[nn]) == "--resume")
+      {
+          //continuing the interrupted simulation with the same output name
+          resume = true;
+      }
+      else if(argc > nn+1)
       {
           if(std::string(argv[nn]) == "-i")
           {
@@ -268,6 +530,22 @@ int main(int argc, char* argv[])
               par_man.Import2nNdata(argv[nn+1]);
               nn +=1;
           }
+          else if(std::string(argv[nn]) == "-s")
+          {
+              //simulating one shard of events of every run, e.g. "-s 0/4"; shards are merged by tools/shard_merger
+              int index = -1;
+              int count = 0;
+              char separator = 0;
+              std::istringstream is(argv[nn+1]);
+              is>>index>>separator>>count;
+              if(is.fail() || separator!='/' || count<1 || index<0 || index>=count)
+              {
+                  std::cerr<<"[ERROR] Invalid shard: "<<argv[nn+1]<<", expected index/count, e.g. -s 0/4! Terminating!"<<std::endl;
+                  return 1;
+              }
+              par_man.SetShard(index, count);
+              nn +=1;
+          }
       }
   }
 
@@ -282,40 +560,181 @@ int main(int argc, char* argv[])
       par_man.Import2nNdata();
       par_man.Print2nNdata();
   }
+  //every shard writes its own results, they are merged by tools/shard_merger
+  if(par_man.GetShardCount()>1)
+  {
+      //shards are equivalent to a single process only if all of them derive random numbers from the same seed
+      if(par_man.GetSeed()==0)
+      {
+          std::cerr<<"[ERROR] The seed has to be set in the parameter file to simulate shards! Terminating!"<<std::endl;
+          return 1;
+      }
+      outputFileAndDirName += "_shard"+std::to_string(par_man.GetShardIndex());
+  }
   //creating directories for storing the results
   mkdir(generalPrefix.c_str(), ACCESSPERMS);
   chmod(generalPrefix.c_str(), ACCESSPERMS);
   mkdir((generalPrefix+outputFileAndDirName).c_str(), ACCESSPERMS);
   chmod((generalPrefix+outputFileAndDirName).c_str(), ACCESSPERMS);
 
+  //completed runs are recorded, so the simulation can be resumed after an interruption
+  Checkpoint checkpoint(generalPrefix+outputFileAndDirName+"/"+outputFileAndDirName+".checkpoint");
+  try
+  {
+      if(resume && !checkpoint.Load())
+      {
+          std::cout<<"[WARNING] Checkpoint file "<<checkpoint.GetFileName()<<" not found! Starting a new simulation!"<<std::endl;
+          resume = false;
+      }
+  }
+  catch(std::string e)
+  {
+      std::cerr<<e<<std::endl;
+      return 1;
+  }
+  if(resume)
+  {
+      if(checkpoint.GetEvents()!=par_man.GetSimEvents() || checkpoint.GetRuns()!=par_man.GetSimRuns())
+      {
+          std::cerr<<"[ERROR] The checkpoint was created for a different number of events or runs! Terminating!"<<std::endl;
+          return 1;
+      }
+      //runs of a different setup (sources, decay type, saved events, schema, 2&N data...) must not be mixed in one file
+      if(checkpoint.GetParamDigest().empty())
+          std::cout<<"[WARNING] The checkpoint does not record parameters of the simulation, they cannot be compared!"<<std::endl;
+      else if(checkpoint.GetParamDigest()!=par_man.GetDigest())
+      {
+          std::cerr<<"[ERROR] The checkpoint was created with different parameters of the simulation! Terminating!"<<std::endl;
+          return 1;
+      }
+      //random number streams are derived from the seed, so the remaining runs are simulated as without the interruption
+      par_man.SetSeed(checkpoint.GetSeed());
+      std::cout<<"[INFO] Resuming the simulation, completed runs: "<<checkpoint.GetNumberOfCompletedRuns()<<"/"<<par_man.GetSimRuns()\
+               <<", seed: "<<checkpoint.GetSeed()<<std::endl;
+  }
+
   TFile *treeFile = nullptr;
-  TTree *tree = nullptr;
   if(par_man.GetOutputType() != PNG) //if necessary, create a file to store a tree
   {
-    treeFile = new TFile((generalPrefix+outputFileAndDirName+"/"+outputFileAndDirName+".root").c_str(), "recreate");
+    treeFile = new TFile((generalPrefix+outputFileAndDirName+"/"+outputFileAndDirName+".root").c_str(), resume ? "update" : "recreate");
+    if(resume)
+    {
+        //directories of runs interrupted before their completion are removed, these runs are simulated again
+        std::vector<std::string> incompleteRuns;
+        TIter next(treeFile->GetListOfKeys());
+        while(TKey* key = static_cast<TKey*>(next()))
+        {
+            if(key->IsFolder() && !checkpoint.IsCompletedRunDirectory(key->GetName()))
+                incompleteRuns.push_back(key->GetName());
+        }
+        for(std::vector<std::string>::iterator it = incompleteRuns.begin(); it != incompleteRuns.end(); ++it)
+        {
+            std::cout<<"[INFO] Removing results of the interrupted run: "<<*it<<std::endl;
+            treeFile->Delete((*it+";*").c_str());
+        }
+    }
     treeFile->cd();
   }
 
-  //setting the seed for global pseudo-random number generator
-  gRandom = new TRandom3(par_man.GetSeed());
-  //loop with simulation runs
-  for(int ii=0; ii< (par_man.GetSimRuns()); ii++)
+  //the seed is resolved once, because all random number streams are derived from it
+  if(par_man.GetSeed()==0)
+  {
+      std::random_device device;
+      int seed = 0;
+      while(seed==0)
+          seed = static_cast<int>(device() & 0x7fffffff);
+      par_man.SetSeed(seed);
+      std::cout<<"[INFO] Random seed drawn for this execution: "<<seed<<std::endl;
+  }
+  if(!resume)
   {
-      std::cout<<":::::::::::: START OF RUN NO: "<<ii+1<<" ::::::::::::"<<std::endl;
-      tree = simulate(ii, par_man, treeFile, outputFileAndDirName+"/");
-      if(tree)
+      try
       {
-          tree->Write();
-          delete tree;
+          checkpoint.Start(par_man.GetSeed(), par_man.GetSimEvents(), par_man.GetSimRuns(), par_man.GetDigest());
+      }
+      catch(std::string e)
+      {
+          std::cerr<<e<<std::endl;
+          return 1;
+      }
+  }
+  //runs are independent, so they are distributed among run threads; only the writer thread uses the output file
+  //run threads and worker threads of every run share all cores: a value set to 0 gets the cores left by the other one
+  //(both set to 0 give one worker thread per run thread), so the total number of threads does not exceed the number of cores
+  const int noOfCores = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+  int noOfRunThreads = par_man.GetRunThreads();
+  if(noOfRunThreads==0)
+      noOfRunThreads = par_man.GetThreads() > 0 ? noOfCores/par_man.GetThreads() : noOfCores;
+  noOfRunThreads = noOfRunThreads > par_man.GetSimRuns() ? par_man.GetSimRuns() : noOfRunThreads;
+  noOfRunThreads = noOfRunThreads < 1 ? 1 : noOfRunThreads;
+  if(par_man.GetThreads()==0)
+      par_man.SetThreads(noOfCores/noOfRunThreads > 1 ? noOfCores/noOfRunThreads : 1);
+  else if(par_man.GetThreads()*noOfRunThreads > noOfCores)
+      std::cout<<"[WARNING] "<<noOfRunThreads<<" run threads with "<<par_man.GetThreads()<<" worker threads each exceed "\
+               <<noOfCores<<" available cores!"<<std::endl;
+  //images are rendered in the background, so the next run does not wait for them
+  const bool renderImages = par_man.AreHistogramsEnabled() && (par_man.GetOutputType()==BOTH || par_man.GetOutputType()==PNG);
+  //histograms of stages are owned by workers, they are written only as drawn canvases (see drawHistograms); if they were
+  //added to the current directory, the writer would save them to a directory changed concurrently by the run threads
+  TH1::AddDirectory(kFALSE);
+  //the writer thread also fills trees, so the simulation does not wait for compression of baskets
+  const bool useWriterThread = noOfRunThreads>1 || treeFile!=nullptr;
+  //ROOT is used by more than one thread (worker, run, writer or renderer threads), e.g. all of them use gDirectory;
+  //its locks must be enabled before any of these threads starts
+  if(par_man.GetThreads()!=1 || noOfRunThreads!=1 || useWriterThread || renderImages)
+      ROOT::EnableThreadSafety();
+  //set if a run failed, the program stops after runs simulated at that moment
+  std::atomic<bool> failed(false);
+  {
+      RootWriter writer(useWriterThread);
+      //destroyed before the writer, because its tasks pass results of runs to the writer
+      RootWriter renderer(renderImages);
+      //canvases are drawn by the writer and renderer threads, they are never shown on the screen
+      if(writer.IsThreaded() || renderer.IsThreaded())
+          gROOT->SetBatch(kTRUE);
+      std::atomic<int> nextRun(0);
+      //loop with simulation runs
+      if(noOfRunThreads==1)
+          simulateRuns(nextRun, par_man, treeFile, writer, renderer, checkpoint, outputFileAndDirName+"/", failed);
+      else
+      {
+          std::vector<std::thread> runThreads;
+          for(int ii=0; ii<noOfRunThreads; ii++)
+              runThreads.push_back(std::thread(simulateRuns, std::ref(nextRun), std::cref(par_man), treeFile, std::ref(writer), std::ref(renderer),\
+                                                 std::ref(checkpoint), outputFileAndDirName+"/", std::ref(failed)));
+          for(std::vector<std::thread>::iterator it = runThreads.begin(); it != runThreads.end(); ++it)
+              it->join();
+      }
+      //waits for posted tasks, the renderer first, since its tasks are passed to the writer; their errors fail the program
+      RootWriter* const postingThreads[] = {&renderer, &writer};
+      for(RootWriter* postingThread : postingThreads)
+      {
+          try
+          {
+              postingThread->Close();
+          }
+          catch(std::string e)
+          {
+              std::cerr<<e<<std::endl;
+              failed = true;
+          }
+          catch(const std::exception& e)
+          {
+              std::cerr<<"[ERROR] "<<e.what()<<std::endl;
+              failed = true;
+          }
       }
-      std::cout<<":::::::::::: END OF RUN NO:  "<<ii+1<<" ::::::::::::"<<"\n"<<std::endl;
   }
   if(treeFile)
   {
-      treeFile->Write();
+      //completed runs are already saved, objects of the failed run are not written
+      if(!failed)
+          treeFile->Write();
       treeFile->Close();
       delete treeFile;
   }
+  if(failed)
+      return 1;
   std::cout<<"\n:::::::::::: END OF PROGRAM. ::::::::::::\n"<<std::endl;
   return 0;
 }
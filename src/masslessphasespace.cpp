@@ -0,0 +1,237 @@
+/// @file masslessphasespace.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <string>
+#include "TMath.h"
+#include "masslessphasespace.h"
+
+///
+/// \brief MasslessPhaseSpace::MasslessPhaseSpace Basic constructor, SetDecay must be called before generation.
+/// \param capacity Maximal number of events in a batch, memory for their random numbers is allocated here.
+///
+MasslessPhaseSpace::MasslessPhaseSpace(int capacity) :
+    fNt_(0),
+    fCapacity_(capacity),
+    fBoost_(false),
+    fTeCmTm_(0.0),
+    fWtMax_(0.0),
+    fPd2_(0.0),
+    fE2_(0.0),
+    fWt2_(0.0),
+    fRandom_(kMaxRandomNumbers*capacity, 0.0),
+    fPlaceholder_(0.0, 0.0, 0.0, 0.0)
+{
+    fBeta_[0] = fBeta_[1] = fBeta_[2] = 0.0;
+}
+
+///
+/// \brief MasslessPhaseSpace::PDK_ Calculates the momentum of products in a two-body decay, the same as PhaseSpaceGenerator.
+/// \param a Mass of the decaying particle.
+/// \param b Mass of the first product.
+/// \param c Mass of the second product.
+/// \return Momentum of the products in the rest frame of the decaying particle.
+///
+double MasslessPhaseSpace::PDK_(double a, double b, double c)
+{
+    double x = (a-b-c)*(a+b+c)*(a-b+c)*(a+b-c);
+    x = TMath::Sqrt(x)/(2*a);
+    return x;
+}
+
+///
+/// \brief MasslessPhaseSpace::SetDecay Sets the decaying particle, all products are massless.
+/// \param P Four-momentum of the decaying particle [GeV].
+/// \param nt Number of decay products, 2 or 3.
+/// \return False if the decay is kinematically forbidden or the number of products is not supported.
+///
+bool MasslessPhaseSpace::SetDecay(const TLorentzVector& P, int nt)
+{
+    fNt_ = 0;
+    if(nt<2 || nt>kMaxProducts)
+        return false;
+    fTeCmTm_ = P.Mag();
+    if(fTeCmTm_<=0)
+        return false;
+    fNt_ = nt;
+    //constant cross section as a function of TECM, as in PhaseSpaceGenerator with zero masses
+    double wtmax = 1;
+    for(int n=1; n<fNt_; n++)
+        wtmax *= PDK_(fTeCmTm_, 0.0, 0.0);
+    fWtMax_ = 1/wtmax;
+    //momenta and weights of 2-body decays do not depend on random numbers
+    fPd2_ = PDK_(fTeCmTm_, 0.0, 0.0);
+    fE2_ = TMath::Sqrt(fPd2_*fPd2_);
+    fWt2_ = fWtMax_*fPd2_;
+    //saving betas of the decaying particle
+    if(P.Beta())
+    {
+        double w = P.Beta()/P.Rho();
+        fBeta_[0] = P(0)*w;
+        fBeta_[1] = P(1)*w;
+        fBeta_[2] = P(2)*w;
+    }
+    else
+        fBeta_[0] = fBeta_[1] = fBeta_[2] = 0;
+    fBoost_ = fBeta_[0]!=0 || fBeta_[1]!=0 || fBeta_[2]!=0;
+    return true;
+}
+
+///
+/// \brief MasslessPhaseSpace::DrawRandomNumbers Draws random numbers of a decay in the order used by PhaseSpaceGenerator::Generate.
+/// \param event Index of the event in the batch.
+/// \param rng Random number generator to be used.
+///
+void MasslessPhaseSpace::DrawRandomNumbers(int event, TRandom* rng)
+{
+    if(event<0 || event>=fCapacity_)
+        throw(std::string("[ERROR] Event out of the capacity of MasslessPhaseSpace!"));
+    const int noOfRandoms = fNt_==3 ? 5 : 2;
+    for(int k=0; k<noOfRandoms; k++)
+        fRandom_[k*fCapacity_+event] = rng->Rndm();
+}
+
+///
+/// \brief MasslessPhaseSpace::Generate Generates a single decay, the same as PhaseSpaceGenerator::Generate.
+/// \param rng Random number generator to be used.
+/// \return Weight of the generated decay.
+///
+double MasslessPhaseSpace::Generate(TRandom* rng)
+{
+    double rnd[kMaxRandomNumbers];
+    const int noOfRandoms = fNt_==3 ? 5 : 2;
+    for(int k=0; k<noOfRandoms; k++)
+        rnd[k] = rng->Rndm();
+    double p[kMaxProducts][4];
+    double wt = Calculate_(rnd, p);
+    for(int n=0; n<fNt_; n++)
+        fDecPro_[n].SetPxPyPzE(p[n][0], p[n][1], p[n][2], p[n][3]);
+    return wt;
+}
+
+///
+/// \brief MasslessPhaseSpace::GenerateBatch Calculates decays of all events of the batch from random numbers stored
+/// by DrawRandomNumbers. Fourmomenta of the first GetNt() photons of every event [MeV] and weights of events are overwritten.
+/// \param batch Batch of events, filled by generateEvent with DeferredDecay.
+///
+void MasslessPhaseSpace::GenerateBatch(EventBatch& batch)
+{
+    if(batch.GetSize()>fCapacity_ || batch.GetMaxPhotons()<fNt_)
+        throw(std::string("[ERROR] Batch does not fit into MasslessPhaseSpace!"));
+    const int noOfRandoms = fNt_==3 ? 5 : 2;
+    double rnd[kMaxRandomNumbers];
+    double p[kMaxProducts][4];
+    for(int ii=0; ii<batch.GetSize(); ii++)
+    {
+        for(int k=0; k<noOfRandoms; k++)
+            rnd[k] = fRandom_[k*fCapacity_+ii];
+        batch.fWeight[ii] = Calculate_(rnd, p);
+        for(int n=0; n<fNt_; n++)
+        {
+            //scale from GeV to MeV, as in EventBatch::EventSlot::AddDecayProduct
+            const int jj = batch.Index(n, ii);
+            batch.fPx[jj] = p[n][0]*1000;
+            batch.fPy[jj] = p[n][1]*1000;
+            batch.fPz[jj] = p[n][2]*1000;
+            batch.fE[jj] = p[n][3]*1000;
+        }
+    }
+}
+
+///
+/// \brief MasslessPhaseSpace::Rotate_ Rotates a momentum around Z and then around Y, as in PhaseSpaceGenerator::Generate.
+/// \param p Fourmomentum (px, py, pz, E).
+/// \param cZ Cosine of the angle around Z.
+/// \param sZ Sine of the angle around Z.
+/// \param cY Cosine of the angle around Y.
+/// \param sY Sine of the angle around Y.
+///
+void MasslessPhaseSpace::Rotate_(double* p, double cZ, double sZ, double cY, double sY)
+{
+    double x = p[0];
+    double y = p[1];
+    p[0] = cZ*x - sZ*y;
+    p[1] = sZ*x + cZ*y; //rotation around Z
+    x = p[0];
+    double z = p[2];
+    p[0] = cY*x - sY*z;
+    p[2] = sY*x + cY*z; //rotation around Y
+}
+
+///
+/// \brief MasslessPhaseSpace::Boost_ Boosts a momentum with TLorentzVector::Boost, so the result is the same as in PhaseSpaceGenerator.
+/// \param p Fourmomentum (px, py, pz, E).
+/// \param bx Beta along X.
+/// \param by Beta along Y.
+/// \param bz Beta along Z.
+///
+void MasslessPhaseSpace::Boost_(double* p, double bx, double by, double bz)
+{
+    fBoosted_.SetPxPyPzE(p[0], p[1], p[2], p[3]);
+    fBoosted_.Boost(bx, by, bz);
+    p[0] = fBoosted_.X();
+    p[1] = fBoosted_.Y();
+    p[2] = fBoosted_.Z();
+    p[3] = fBoosted_.T();
+}
+
+///
+/// \brief MasslessPhaseSpace::Calculate_ Calculates a decay from its random numbers (Raubold-Lynch method).
+/// \param rnd Random numbers in the order in which PhaseSpaceGenerator::Generate draws them.
+/// \param p Array filled with fourmomenta (px, py, pz, E) of the products [GeV].
+/// \return Weight of the decay.
+///
+double MasslessPhaseSpace::Calculate_(const double* rnd, double (&p)[kMaxProducts][4])
+{
+    double wt = 0.0;
+    if(fNt_==2)
+    {
+        wt = fWt2_;
+        p[0][0] = 0; p[0][1] = fPd2_; p[0][2] = 0; p[0][3] = fE2_;
+        p[1][0] = 0; p[1][1] = -fPd2_; p[1][2] = 0; p[1][3] = fE2_;
+        double cZ = 2*rnd[0] - 1;
+        double sZ = TMath::Sqrt(1-cZ*cZ);
+        double angY = 2*TMath::Pi()*rnd[1];
+        double cY = TMath::Cos(angY);
+        double sY = TMath::Sin(angY);
+        Rotate_(p[0], cZ, sZ, cY, sY);
+        Rotate_(p[1], cZ, sZ, cY, sY);
+    }
+    else if(fNt_==3)
+    {
+        //invariant masses of the subsystems: 0, rnd[0]*fTeCmTm_ and fTeCmTm_
+        double invMas1 = rnd[0]*fTeCmTm_;
+        double pd0 = PDK_(invMas1, 0.0, 0.0);
+        double pd1 = PDK_(fTeCmTm_, invMas1, 0.0);
+        wt = fWtMax_;
+        wt *= pd0;
+        wt *= pd1;
+        p[0][0] = 0; p[0][1] = pd0; p[0][2] = 0; p[0][3] = TMath::Sqrt(pd0*pd0);
+        p[1][0] = 0; p[1][1] = -pd0; p[1][2] = 0; p[1][3] = TMath::Sqrt(pd0*pd0);
+        double cZ = 2*rnd[1] - 1;
+        double sZ = TMath::Sqrt(1-cZ*cZ);
+        double angY = 2*TMath::Pi()*rnd[2];
+        double cY = TMath::Cos(angY);
+        double sY = TMath::Sin(angY);
+        Rotate_(p[0], cZ, sZ, cY, sY);
+        Rotate_(p[1], cZ, sZ, cY, sY);
+        double beta = pd1 / TMath::Sqrt(pd1*pd1 + invMas1*invMas1);
+        Boost_(p[0], 0, beta, 0);
+        Boost_(p[1], 0, beta, 0);
+        p[2][0] = 0; p[2][1] = -pd1; p[2][2] = 0; p[2][3] = TMath::Sqrt(pd1*pd1);
+        cZ = 2*rnd[3] - 1;
+        sZ = TMath::Sqrt(1-cZ*cZ);
+        angY = 2*TMath::Pi()*rnd[4];
+        cY = TMath::Cos(angY);
+        sY = TMath::Sin(angY);
+        Rotate_(p[0], cZ, sZ, cY, sY);
+        Rotate_(p[1], cZ, sZ, cY, sY);
+        Rotate_(p[2], cZ, sZ, cY, sY);
+    }
+    //final boost of all particles
+    if(fBoost_)
+    {
+        for(int n=0; n<fNt_; n++)
+            Boost_(p[n], fBeta_[0], fBeta_[1], fBeta_[2]);
+    }
+    return wt;
+}
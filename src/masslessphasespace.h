@@ -0,0 +1,78 @@
+/// @file masslessphasespace.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef MASSLESSPHASESPACE_H
+#define MASSLESSPHASESPACE_H
+#include <vector>
+#include "TLorentzVector.h"
+#include "TRandom.h"
+#include "eventbatch.h"
+
+///
+/// \brief The MasslessPhaseSpace class Phase space generator specialized for decays into 2 or 3 massless products (photons).
+///
+/// The Raubold-Lynch method of PhaseSpaceGenerator is unrolled for the given number of products and terms with masses
+/// are removed, so no sorting, loops over products or copies of the event are needed. Random numbers are drawn in the same
+/// order and momenta are calculated with the same IEEE operations in the same order as in PhaseSpaceGenerator (boosts are
+/// done by TLorentzVector itself), hence the generated decays are bit-identical to the PhaseSpaceGenerator and TGenPhaseSpace
+/// ones for the same sequence of random numbers. The only exception is the final boost, which is skipped if the decaying
+/// particle is at rest -- it could only change the sign of components equal to zero.
+///
+/// A batch is generated in two passes: DrawRandomNumbers stores random numbers of every event (drawn from the substream of
+/// the event) and GenerateBatch calculates fourmomenta and weights of all events, writing them directly to the arrays
+/// of the EventBatch.
+///
+class MasslessPhaseSpace
+{
+    public:
+        ///
+        /// \brief The DeferredDecay class Generator used by generateEvent to fill events of a batch: it only draws random
+        /// numbers of the decay and adds placeholders of photons, which are calculated afterwards by GenerateBatch.
+        ///
+        class DeferredDecay
+        {
+            public:
+                DeferredDecay(MasslessPhaseSpace& generator, int event) : fGenerator_(generator), fEvent_(event) {}
+                inline double Generate(TRandom* rng) {fGenerator_.DrawRandomNumbers(fEvent_, rng); return 0.0;}
+                inline TLorentzVector* GetDecay(const int index) {return index<fGenerator_.fNt_ ? &fGenerator_.fPlaceholder_ : nullptr;}
+            private:
+                MasslessPhaseSpace& fGenerator_;
+                int fEvent_;
+        };
+
+        explicit MasslessPhaseSpace(int capacity=0);
+        bool SetDecay(const TLorentzVector& P, int nt);
+        double Generate(TRandom* rng);
+        void DrawRandomNumbers(int event, TRandom* rng);
+        void GenerateBatch(EventBatch& batch);
+        inline TLorentzVector* GetDecay(const int index)
+            {return index<fNt_ ? &fDecPro_[index] : nullptr;}
+        inline int GetNt() const {return fNt_;}
+        inline int GetCapacity() const {return fCapacity_;}
+        inline double GetWtMax() const {return fWtMax_;}
+
+        static const int kMaxProducts = 3;
+        static const int kMaxRandomNumbers = 5; //random numbers of a 3-body decay: 1 invariant mass and 2 pairs of angles
+
+    private:
+        int fNt_; //number of decay products, 0 if the decay is not set
+        int fCapacity_; //maximal number of events in a batch
+        double fBeta_[3]; //betas of the decaying particle
+        bool fBoost_; //false if the decaying particle is at rest
+        double fTeCmTm_; //total energy in the C.M.
+        double fWtMax_; //maximum weight
+        double fPd2_; //momentum of products of 2-body decays, which is constant
+        double fE2_; //energy of products of 2-body decays
+        double fWt2_; //weight of 2-body decays, which is constant
+        std::vector<double> fRandom_; //random numbers of events of the batch, number k of event i is at the index k*capacity+i
+        TLorentzVector fDecPro_[kMaxProducts]; //four-momenta of the decay products of the last event generated by Generate
+        TLorentzVector fPlaceholder_; //momentum of photons added by DeferredDecay
+        TLorentzVector fBoosted_; //helper vector used to boost momenta
+
+        double Calculate_(const double* rnd, double (&p)[kMaxProducts][4]);
+        void Boost_(double* p, double bx, double by, double bz);
+        static double PDK_(double a, double b, double c); //momentum in a two-body decay
+        static void Rotate_(double* p, double cZ, double sZ, double cY, double sY);
+};
+
+#endif // MASSLESSPHASESPACE_H
@@ -26,14 +26,24 @@ ParamManager::ParamManager() :
     fSmearLowLimit_(0.0),
     fSmearHighLimit_(2.0),
     fSeed_(0),
+    fThreads_(1),
+    fRunThreads_(1),
+    fShardIndex_(0),
+    fShardCount_(1),
+    fOutputQueueSize_(8192),
+    fComptonSampling_(TABLE),
     fSilentMode_(false),
     f2nNdataImported_(false),
     fUsePhantom_(false),
     fPPhantom511_(0.0),
     fPPhantomPrompt_(0.0),
     fPhantomSmear_(false),
+    fAcceptanceSampling_(false),
+    fEarlyReject_(false),
     fOutput_(PNG),
-    fEventTypeToSave_(ALL)
+    fEventTypeToSave_(ALL),
+    fTreeSchema_(OBJECT),
+    fHistogramLevel_(STANDARD_HISTOGRAMS)
     {}
 
 ///
@@ -46,27 +56,43 @@ ParamManager::ParamManager(const ParamManager &est)
     fSimRuns_=est.fSimRuns_;
     fNoOfGammas_=est.fNoOfGammas_;
     fEff_=est.fEff_;
-    fR_=est.fP_;
+    fR_=est.fR_;
     fL_=est.fL_;
     fE_=est.fE_;
     fP_=est.fP_;
     fSmearLowLimit_=est.fSmearLowLimit_;
     fSmearHighLimit_=est.fSmearHighLimit_;
     fSeed_=est.fSeed_;
+    fThreads_=est.fThreads_;
+    fRunThreads_=est.fRunThreads_;
+    fShardIndex_=est.fShardIndex_;
+    fShardCount_=est.fShardCount_;
+    fOutputQueueSize_=est.fOutputQueueSize_;
+    fComptonSampling_=est.fComptonSampling_;
     fSilentMode_=est.fSilentMode_;
     f2nNdataImported_=est.f2nNdataImported_;
     fOutput_=est.fOutput_;
     fEventTypeToSave_=est.fEventTypeToSave_;
+    fTreeSchema_=est.fTreeSchema_;
+    fHistogramLevel_=est.fHistogramLevel_;
     fData_.resize(est.fData_.size());
     std::copy(est.fData_.begin(), est.fData_.end(), fData_.begin());
     fDecayBranchProbability_.resize(est.fDecayBranchProbability_.size());
     std::copy(est.fDecayBranchProbability_.begin(), est.fDecayBranchProbability_.end(), fDecayBranchProbability_.begin());
-    for(unsigned ii=0; ii<fGammaEnergy_.size(); ii++)
-        fGammaEnergy_.push_back(est.fGammaEnergy_[ii]);
+    fGammaEnergy_=est.fGammaEnergy_;
+    fDecayBranchTable_=est.fDecayBranchTable_;
+    fNuclideName_=est.fNuclideName_;
+    fNuclideActivity_=est.fNuclideActivity_;
+    fLibraryBranchNuclide_=est.fLibraryBranchNuclide_;
+    fLibraryBranchProbability_=est.fLibraryBranchProbability_;
+    fLibraryGammaEnergy_=est.fLibraryGammaEnergy_;
+    fSelectedNuclides_=est.fSelectedNuclides_;
     fPPhantom511_=est.fPPhantom511_;
     fPPhantomPrompt_=est.fPPhantomPrompt_;
     fUsePhantom_=est.fUsePhantom_;
     fPhantomSmear_=est.fPhantomSmear_;
+    fAcceptanceSampling_=est.fAcceptanceSampling_;
+    fEarlyReject_=est.fEarlyReject_;
 }
 
 ///
@@ -80,27 +106,43 @@ ParamManager & ParamManager::operator= (const ParamManager &est) {
     fSimRuns_=est.fSimRuns_;
     fNoOfGammas_=est.fNoOfGammas_;
     fEff_=est.fEff_;
-    fR_=est.fP_;
+    fR_=est.fR_;
     fL_=est.fL_;
     fE_=est.fE_;
     fP_=est.fP_;
     fSmearLowLimit_=est.fSmearLowLimit_;
     fSmearHighLimit_=est.fSmearHighLimit_;
     fSeed_=est.fSeed_;
+    fThreads_=est.fThreads_;
+    fRunThreads_=est.fRunThreads_;
+    fShardIndex_=est.fShardIndex_;
+    fShardCount_=est.fShardCount_;
+    fOutputQueueSize_=est.fOutputQueueSize_;
+    fComptonSampling_=est.fComptonSampling_;
     fSilentMode_=est.fSilentMode_;
     f2nNdataImported_=est.f2nNdataImported_;
     fOutput_=est.fOutput_;
     fEventTypeToSave_=est.fEventTypeToSave_;
+    fTreeSchema_=est.fTreeSchema_;
+    fHistogramLevel_=est.fHistogramLevel_;
     fData_.resize(est.fData_.size());
     std::copy(est.fData_.begin(), est.fData_.end(), fData_.begin());
     fDecayBranchProbability_.resize(est.fDecayBranchProbability_.size());
     std::copy(est.fDecayBranchProbability_.begin(), est.fDecayBranchProbability_.end(), fDecayBranchProbability_.begin());
-    for(unsigned ii=0; ii<fGammaEnergy_.size(); ii++)
-        fGammaEnergy_.push_back(est.fGammaEnergy_[ii]);
+    fGammaEnergy_=est.fGammaEnergy_;
+    fDecayBranchTable_=est.fDecayBranchTable_;
+    fNuclideName_=est.fNuclideName_;
+    fNuclideActivity_=est.fNuclideActivity_;
+    fLibraryBranchNuclide_=est.fLibraryBranchNuclide_;
+    fLibraryBranchProbability_=est.fLibraryBranchProbability_;
+    fLibraryGammaEnergy_=est.fLibraryGammaEnergy_;
+    fSelectedNuclides_=est.fSelectedNuclides_;
     fPPhantom511_=est.fPPhantom511_;
     fPPhantomPrompt_=est.fPPhantomPrompt_;
     fUsePhantom_=est.fUsePhantom_;
     fPhantomSmear_=est.fPhantomSmear_;
+    fAcceptanceSampling_=est.fAcceptanceSampling_;
+    fEarlyReject_=est.fEarlyReject_;
     return *this;
 }
 
@@ -114,16 +156,61 @@ bool ParamManager::operator==(const ParamManager &est) const
     bool params = ((est.fData_ == fData_) && (fSimEvents_==est.fSimEvents_) && (fSimRuns_==est.fSimRuns_) && \
             (fEff_==est.fEff_) && (fL_==est.fL_) && (fR_==est.fR_) && (fNoOfGammas_==est.fNoOfGammas_) && \
             (fE_==est.fE_) && (fP_==est.fP_) && (fSilentMode_==est.fSilentMode_) && fOutput_==est.fOutput_)&&\
-            (fEventTypeToSave_==est.fEventTypeToSave_) && (fSmearLowLimit_==est.fSmearLowLimit_) && \
-            (fSmearHighLimit_==est.fSmearHighLimit_) && (f2nNdataImported_==est.f2nNdataImported_) && fSeed_==est.fSeed_ && \
-            (fUsePhantom_==est.fUsePhantom_) && (fPPhantom511_==fPPhantom511_) && (fPhantomSmear_==est.fPhantomSmear_) &&\
+            (fEventTypeToSave_==est.fEventTypeToSave_) && (fTreeSchema_==est.fTreeSchema_) && (fHistogramLevel_==est.fHistogramLevel_) && (fSmearLowLimit_==est.fSmearLowLimit_) && \
+            (fSmearHighLimit_==est.fSmearHighLimit_) && (f2nNdataImported_==est.f2nNdataImported_) && fSeed_==est.fSeed_ && fThreads_==est.fThreads_ && fRunThreads_==est.fRunThreads_ && fShardIndex_==est.fShardIndex_ && fShardCount_==est.fShardCount_ && fOutputQueueSize_==est.fOutputQueueSize_ && fComptonSampling_==est.fComptonSampling_ && \
+            (fUsePhantom_==est.fUsePhantom_) && (fPPhantom511_==fPPhantom511_) && (fPhantomSmear_==est.fPhantomSmear_) && (fAcceptanceSampling_==est.fAcceptanceSampling_) && (fEarlyReject_==est.fEarlyReject_) &&\
             (fPPhantomPrompt_==fPPhantomPrompt_);
     return params && std::equal(fData_.begin(), fData_.end(), est.fData_.begin())\
             && std::equal(fDecayBranchProbability_.begin(), fDecayBranchProbability_.end(), est.fDecayBranchProbability_.begin())\
-            && std::equal(fGammaEnergy_.begin(), fGammaEnergy_.end(), est.fGammaEnergy_.begin());
+            && std::equal(fGammaEnergy_.begin(), fGammaEnergy_.end(), est.fGammaEnergy_.begin())\
+            && fDecayBranchTable_==est.fDecayBranchTable_ && fNuclideName_==est.fNuclideName_ && fNuclideActivity_==est.fNuclideActivity_\
+            && fLibraryBranchNuclide_==est.fLibraryBranchNuclide_ && fLibraryBranchProbability_==est.fLibraryBranchProbability_\
+            && fLibraryGammaEnergy_==est.fLibraryGammaEnergy_ && fSelectedNuclides_==est.fSelectedNuclides_;
 }
 
 
+///
+/// \brief ParamManager::GetDigest Calculates a digest of parameters which determine simulated events and the layout of
+/// the output, including source parameters and the 2&N data. The seed (saved separately by Checkpoint) and parameters
+/// which do not change results (numbers of threads, size of the output queue, silent mode) are not included.
+/// \return 64-bit FNV-1a hash of the parameters, as a hexadecimal string.
+///
+std::string ParamManager::GetDigest() const
+{
+    std::ostringstream params;
+    params.precision(17);
+    params<<fSimEvents_<<" "<<fSimRuns_<<" "<<fNoOfGammas_<<" "<<fEff_<<" "<<fL_<<" "<<fR_<<" "<<fE_<<" "<<fP_<<" "\
+          <<fSmearLowLimit_<<" "<<fSmearHighLimit_<<" "<<fShardIndex_<<" "<<fShardCount_<<" "<<fComptonSampling_<<" "\
+          <<fUsePhantom_<<" "<<fPPhantom511_<<" "<<fPPhantomPrompt_<<" "<<fPhantomSmear_<<" "<<fAcceptanceSampling_<<" "\
+          <<fEarlyReject_<<" "<<fOutput_<<" "<<fEventTypeToSave_<<" "<<fTreeSchema_<<" "<<fHistogramLevel_<<"\n";
+    for(const std::vector<double>& source : fData_)
+    {
+        for(double value : source)
+            params<<value<<" ";
+        params<<"\n";
+    }
+    //decay branches of selected nuclides, as they are drawn
+    for(unsigned ii=0; ii<fDecayBranchProbability_.size(); ii++)
+    {
+        params<<fDecayBranchProbability_[ii]<<":";
+        for(double energy : fGammaEnergy_[ii])
+            params<<" "<<energy;
+        params<<"\n";
+    }
+    for(const std::string& name : fSelectedNuclides_)
+        params<<name<<" ";
+    const std::string text = params.str();
+    unsigned long long hash = 14695981039346656037ULL;
+    for(unsigned char c : text)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream digest;
+    digest<<std::hex<<hash;
+    return digest.str();
+}
+
 ///////////////////////////////////////////////////////////////////
 /// \brief trim Removes preceding and following white spaces from a string object.
 /// \param str String to be trimmed.
@@ -219,6 +306,24 @@ void ParamManager::ImportParams(const std::string& inFile)
                 fP_=atof(token[2].c_str());
               else if (token[0]=="seed")
                 fSeed_=atof(token[2].c_str());
+              else if (token[0]=="threads")
+                fThreads_=atoi(token[2].c_str());
+              else if (token[0]=="runThreads")
+                fRunThreads_=atoi(token[2].c_str());
+              else if (token[0]=="outputQueue")
+                fOutputQueueSize_=atoi(token[2].c_str());
+              else if (token[0]=="comptonSampling")
+              {
+                  if(token[2]=="table")
+                      fComptonSampling_=TABLE;
+                  else if(token[2]=="kahn")
+                      fComptonSampling_=KAHN;
+                  else
+                  {
+                      std::cerr<<"[WARNING] Unrecognized Compton sampling method! Setting to default (table)."<<std::endl;
+                      fComptonSampling_=TABLE;
+                  }
+              }
               else if(token[0]=="smearLow")
                 fSmearLowLimit_=atof(token[2].c_str());
               else if(token[0]=="smearHigh")
@@ -233,6 +338,22 @@ void ParamManager::ImportParams(const std::string& inFile)
                 fUsePhantom_ = atoi(token[2].c_str()) == 0 ? false :true;
               else if(token[0]=="phantomSmear")
                 fPhantomSmear_ = atoi(token[2].c_str()) == 0 ? false :true;
+              else if(token[0]=="acceptanceSampling")
+                fAcceptanceSampling_ = atoi(token[2].c_str()) == 0 ? false :true;
+              else if(token[0]=="earlyReject")
+                fEarlyReject_ = atoi(token[2].c_str()) == 0 ? false :true;
+              else if(token[0]=="nuclides")
+              {
+                  std::vector<std::string> names;
+                  std::istringstream list(token[2]);
+                  std::string name;
+                  while(std::getline(list, name, ','))
+                  {
+                      if(name.length() && name!="all")
+                        names.push_back(name);
+                  }
+                  SetSelectedNuclides(names);
+              }
               else if (token[0]=="output")
               {
                   if(token[2]=="tree")
@@ -241,6 +362,8 @@ void ParamManager::ImportParams(const std::string& inFile)
                       fOutput_=PNG;
                   else if(token[2]=="both")
                       fOutput_=BOTH;
+                  else if(token[2]=="headless")
+                      fOutput_=HEADLESS;
                   else
                   {
                       std::cerr<<"[WARNING] Unrecognized output type! Setting to default (png)."<<std::endl;
@@ -261,6 +384,32 @@ void ParamManager::ImportParams(const std::string& inFile)
                       fEventTypeToSave_=ALL;
                   }
               }
+              else if (token[0]=="treeSchema")
+              {
+                  if(token[2]=="object")
+                      fTreeSchema_=OBJECT;
+                  else if(token[2]=="flat")
+                      fTreeSchema_=FLAT;
+                  else
+                  {
+                      std::cerr<<"[WARNING] Unrecognized tree schema! Setting to default (object)."<<std::endl;
+                      fTreeSchema_=OBJECT;
+                  }
+              }
+              else if (token[0]=="histograms")
+              {
+                  if(token[2]=="none")
+                      fHistogramLevel_=NO_HISTOGRAMS;
+                  else if(token[2]=="standard")
+                      fHistogramLevel_=STANDARD_HISTOGRAMS;
+                  else if(token[2]=="full")
+                      fHistogramLevel_=FULL_HISTOGRAMS;
+                  else
+                  {
+                      std::cerr<<"[WARNING] Unrecognized histogram level! Setting to default (standard)."<<std::endl;
+                      fHistogramLevel_=STANDARD_HISTOGRAMS;
+                  }
+              }
               else
                 std::cerr<<"[WARNING] Unrecognized parameter in the param file: \""<<token[0]<<"\""<<std::endl;
           }
@@ -279,7 +428,9 @@ void ParamManager::ImportParams(const std::string& inFile)
 }
 
 ///
-/// \brief ParamManager::Import2nNdata Imports data for 2&N decays from a file.
+/// \brief ParamManager::Import2nNdata Imports data for 2&N decays from a file. The file is a library of nuclides, every one
+/// starts with a line "nuclide name activity", followed by its decay branches. Branches before the first such line belong
+/// to a nuclide named "default" with activity 1. Nuclides are appended to the ones imported before.
 /// \param inFile Text file containing data.
 ///
 void ParamManager::Import2nNdata(const std::string& inFile)
@@ -287,6 +438,7 @@ void ParamManager::Import2nNdata(const std::string& inFile)
     if(!fSilentMode_) std::cout<<"[INFO] Importing 2&Ndata from file: "<<inFile<<std::endl;
     std::ifstream param_file(inFile.c_str());
     std::string row;
+    const int firstNuclide = fNuclideName_.size();
 
     //read line by line
     while (getline(param_file, row))
@@ -297,22 +449,50 @@ void ParamManager::Import2nNdata(const std::string& inFile)
           }
           row = reduce(row); //get rid of white spaces
           std::istringstream is(row);
+          if(row.compare(0, 7, "nuclide")==0)
+          {
+              std::string keyword;
+              std::string name;
+              double activity = 1.0;
+              is >> keyword >> name >> activity;
+              fNuclideName_.push_back(name);
+              fNuclideActivity_.push_back(activity);
+              continue;
+          }
+          if(static_cast<int>(fNuclideName_.size()) == firstNuclide)
+          {
+              fNuclideName_.push_back("default");
+              fNuclideActivity_.push_back(1.0);
+          }
           double pB; //probability of choosing a particular decay branch
           double eG; //energy of emitted gamma
           is >> pB;
           if(pB > 0.0)
           {
-            fDecayBranchProbability_.push_back(pB);
-            fGammaEnergy_.push_back(std::vector<double>()); //making space for gamma energies
+            fLibraryBranchProbability_.push_back(pB);
+            fLibraryGammaEnergy_.push_back(std::vector<double>()); //making space for gamma energies
+            fLibraryBranchNuclide_.push_back(fNuclideName_.size()-1);
           }
-          int index = fGammaEnergy_.size()-1;
+          int index = fLibraryGammaEnergy_.size()-1;
           while(is>> eG)
           {
-              (fGammaEnergy_.at(index)).push_back(eG); //pushing gamma energies
+              (fLibraryGammaEnergy_.at(index)).push_back(eG); //pushing gamma energies
           }
     f2nNdataImported_=true;
     }
-    ValidatePromptData_(); //checking if data is OK
+    BuildDecayBranches_(); //checking if data is OK and mixing selected nuclides
+}
+
+///
+/// \brief ParamManager::SetSelectedNuclides Selects nuclides simulated in 2&N decays, decays of all of them are mixed
+/// according to their activities. Can be called before or after importing the data.
+/// \param names Names of nuclides from the 2&N data file, all nuclides are simulated if empty.
+///
+void ParamManager::SetSelectedNuclides(const std::vector<std::string>& names)
+{
+    fSelectedNuclides_ = names;
+    if(f2nNdataImported_)
+        BuildDecayBranches_();
 }
 
 ///
@@ -355,8 +535,21 @@ void ParamManager::PrintParams()
     {
         std::cout<<"DISABLED"<<std::endl;
     }
+    std::cout<<"[INFO] Acceptance sampling of the first photon: ";
+    if(fAcceptanceSampling_)
+        std::cout<<"ENABLED"<<std::endl;
+    else
+        std::cout<<"DISABLED"<<std::endl;
     std::string seedToShow = fSeed_==0 ? "random" : std::to_string(fSeed_);
     std::cout<<"[INFO] Seed: "<<seedToShow<<std::endl;
+    std::string threadsToShow = fThreads_<=0 ? "all available" : std::to_string(fThreads_);
+    std::cout<<"[INFO] Worker threads: "<<threadsToShow<<std::endl;
+    std::string runThreadsToShow = fRunThreads_<=0 ? "all available" : std::to_string(fRunThreads_);
+    std::cout<<"[INFO] Concurrent runs: "<<runThreadsToShow<<std::endl;
+    if(fShardCount_>1)
+        std::cout<<"[INFO] Shard: "<<fShardIndex_<<" of "<<fShardCount_<<" (indices start from 0)"<<std::endl;
+    std::cout<<"[INFO] Output queue size: "<<fOutputQueueSize_<<" events"<<std::endl;
+    std::cout<<"[INFO] Compton sampling method: "<<(fComptonSampling_==KAHN ? "KAHN" : "TABLE")<<std::endl;
     std::cout<<"[INFO] Smearing lower limit: "<<fSmearLowLimit_<<" [MeV]"<<std::endl;
     std::cout<<"[INFO] Smearing higher limit: "<<fSmearHighLimit_<<" [MeV]"<<std::endl;
     std::cout<<"[INFO] Silent mode: ";
@@ -374,6 +567,9 @@ void ParamManager::PrintParams()
         case BOTH:
             std::cout<<"ROOT TREE & PNG IMAGES"<<std::endl;
             break;
+        case HEADLESS:
+            std::cout<<"ROOT TREE ONLY, NO HISTOGRAMS"<<std::endl;
+            break;
         default:
             break;
     }
@@ -392,6 +588,29 @@ void ParamManager::PrintParams()
         default:
             break;
     }
+    std::cout<<"[INFO] Early rejection of events that missed the detector: ";
+    if(IsEarlyRejectActive())
+        std::cout<<"ENABLED"<<std::endl;
+    else if(fEarlyReject_)
+        std::cout<<"DISABLED (failed events are saved)"<<std::endl;
+    else
+        std::cout<<"DISABLED"<<std::endl;
+    std::cout<<"[INFO] Tree schema: "<<(fTreeSchema_==FLAT ? "FLAT" : "OBJECT")<<std::endl;
+    std::cout<<"[INFO] Histograms: ";
+    switch (fHistogramLevel_)
+    {
+        case NO_HISTOGRAMS:
+            std::cout<<"NONE"<<std::endl;
+            break;
+        case STANDARD_HISTOGRAMS:
+            std::cout<<"STANDARD"<<std::endl;
+            break;
+        case FULL_HISTOGRAMS:
+            std::cout<<"FULL"<<std::endl;
+            break;
+        default:
+            break;
+    }
 }
 
 ///
@@ -400,7 +619,17 @@ void ParamManager::PrintParams()
 ///
 void ParamManager::Print2nNdata()
 {
-    std::cout<<"[INFO] Printing decay branches:"<<std::endl;
+    std::cout<<"[INFO] Nuclides in 2&N data (name, activity):";
+    for(unsigned ii = 0; ii< fNuclideName_.size(); ii++)
+        std::cout<<" "<<fNuclideName_[ii]<<" "<<fNuclideActivity_[ii]<<";";
+    std::cout<<std::endl;
+    std::cout<<"[INFO] Selected nuclides: ";
+    if(fSelectedNuclides_.empty())
+        std::cout<<"all";
+    for(unsigned ii = 0; ii< fSelectedNuclides_.size(); ii++)
+        std::cout<<(ii>0 ? "," : "")<<fSelectedNuclides_[ii];
+    std::cout<<std::endl;
+    std::cout<<"[INFO] Printing decay branches of selected nuclides:"<<std::endl;
     for(unsigned ii = 0; ii< fDecayBranchProbability_.size(); ii++)
     {
         std::cout<<fDecayBranchProbability_.at(ii)<<" ";
@@ -429,19 +658,51 @@ std::vector<double> ParamManager::GetDataAt(const int index) const
 }
 
 ///
-/// \brief ParamManager::ValidatePromptData_ Cheks if decay branch probabilities sum to 1. If not, then it renormalizes it.
+/// \brief ParamManager::BuildDecayBranches_ Mixes decay branches of selected nuclides. Branch probabilities of every nuclide
+/// are renormalized if they don't sum to 1, then they are multiplied by the fraction of the activity of the nuclide.
+/// The alias table for drawing branches is built afterwards.
 ///
-void ParamManager::ValidatePromptData_()
+void ParamManager::BuildDecayBranches_()
 {
-    double sum = 0;
-    for(std::vector<double>::iterator it = fDecayBranchProbability_.begin(); it!=fDecayBranchProbability_.end(); ++it)
+    std::vector<bool> selected(fNuclideName_.size(), fSelectedNuclides_.empty());
+    for(unsigned ii=0; ii<fSelectedNuclides_.size(); ii++)
     {
-        sum+=*it;
+        std::vector<std::string>::iterator it = std::find(fNuclideName_.begin(), fNuclideName_.end(), fSelectedNuclides_[ii]);
+        if(it == fNuclideName_.end())
+            std::cout<<"[WARNING] Nuclide "<<fSelectedNuclides_[ii]<<" not found in 2&N data!"<<std::endl;
+        else
+            selected[it-fNuclideName_.begin()] = true;
     }
-    if(TMath::Abs(sum - 1.00) > 1e-6)
+    double activity = 0;
+    std::vector<double> sum(fNuclideName_.size(), 0.0);
+    for(unsigned ii=0; ii<fNuclideName_.size(); ii++)
     {
-        std::cout<<"[WARNING] Decay branch probabilities don\'t sum to 1! Renormalizing."<<std::endl;
-        std::for_each(fDecayBranchProbability_.begin(), fDecayBranchProbability_.end(), [sum](double &p){ p/=sum; });
+        if(selected[ii] && fNuclideActivity_[ii] <= 0)
+        {
+            std::cout<<"[WARNING] Activity of nuclide "<<fNuclideName_[ii]<<" is not positive! Skipping it."<<std::endl;
+            selected[ii] = false;
+        }
+        if(selected[ii])
+            activity += fNuclideActivity_[ii];
     }
-
+    for(unsigned ii=0; ii<fLibraryBranchProbability_.size(); ii++)
+        sum[fLibraryBranchNuclide_[ii]] += fLibraryBranchProbability_[ii];
+    fDecayBranchProbability_.clear();
+    fGammaEnergy_.clear();
+    for(unsigned ii=0; ii<fNuclideName_.size(); ii++)
+    {
+        if(selected[ii] && TMath::Abs(sum[ii] - 1.00) > 1e-6)
+            std::cout<<"[WARNING] Decay branch probabilities of "<<fNuclideName_[ii]<<" don\'t sum to 1! Renormalizing."<<std::endl;
+    }
+    for(unsigned ii=0; ii<fLibraryBranchProbability_.size(); ii++)
+    {
+        int nuclide = fLibraryBranchNuclide_[ii];
+        if(!selected[nuclide])
+            continue;
+        fDecayBranchProbability_.push_back(fNuclideActivity_[nuclide]/activity*fLibraryBranchProbability_[ii]/sum[nuclide]);
+        fGammaEnergy_.push_back(fLibraryGammaEnergy_[ii]);
+    }
+    if(fDecayBranchProbability_.empty() && !fLibraryBranchProbability_.empty())
+        std::cout<<"[WARNING] No decay branches of selected nuclides in 2&N data!"<<std::endl;
+    fDecayBranchTable_.Build(fDecayBranchProbability_);
 }
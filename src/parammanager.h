@@ -5,6 +5,8 @@
 #define PARAMMANAGER_H
 #include <string>
 #include <vector>
+#include "TRandom.h"
+#include "aliastable.h"
 
 ///
 /// \brief The OutputOptions enum Specifies type of output.
@@ -13,7 +15,8 @@ enum OutputOptions
 {
     TREE = 0,
     PNG = 1,
-    BOTH = 2
+    BOTH = 2,
+    HEADLESS = 3 //only the tree, histograms are neither created, filled nor drawn
 };
 
 ///
@@ -26,6 +29,34 @@ enum EventTypeToSave
     ALL = 2
 };
 
+///
+/// \brief The ComptonSamplingMethod enum Specifies how Compton scattering angles are drawn.
+///
+enum ComptonSamplingMethod
+{
+    TABLE = 0,
+    KAHN = 1
+};
+
+///
+/// \brief The TreeSchema enum Specifies the layout of events in the output tree.
+///
+enum TreeSchema
+{
+    OBJECT = 0, //Event objects in the split branch "event_split"
+    FLAT = 1 //one branch per primitive column, see FlatEvent
+};
+
+///
+/// \brief The HistogramLevel enum Specifies which diagnostic histograms are created by the stages of the simulation.
+///
+enum HistogramLevel
+{
+    NO_HISTOGRAMS = 0, //production mode, stages only count accepted events
+    STANDARD_HISTOGRAMS = 1, //distributions of generated, cut and scattered photons
+    FULL_HISTOGRAMS = 2 //standard histograms and plots of the Klein-Nishina function
+};
+
 class TwoAndNTestFixture; // for testing
 
 ///
@@ -50,6 +81,12 @@ class ParamManager
         inline float GetSmearLowLimit() const {return fSmearLowLimit_;}
         inline float GetSmearHighLimit() const {return fSmearHighLimit_;}
         inline int GetSeed() const {return fSeed_;}
+        inline int GetThreads() const {return fThreads_;}
+        inline int GetRunThreads() const {return fRunThreads_;}
+        inline int GetShardIndex() const {return fShardIndex_;}
+        inline int GetShardCount() const {return fShardCount_;}
+        inline int GetOutputQueueSize() const {return fOutputQueueSize_;}
+        inline ComptonSamplingMethod GetComptonSampling() const {return fComptonSampling_;}
         inline bool IsSilentMode() const {return fSilentMode_;}
         //methods used for 2&N decays
         inline bool Is2nNDataImported() const {return f2nNdataImported_;}
@@ -60,10 +97,19 @@ class ParamManager
             {if(index<fDecayBranchProbability_.size()) return fDecayBranchProbability_[index]; else return 0;}
         inline double GetGammaEnergyAt(const unsigned branch, const unsigned gamma) const
             {if(branch<fDecayBranchProbability_.size() && gamma<(fGammaEnergy_.at(branch)).size()) return (fGammaEnergy_[branch])[gamma]; else return 0;}
+        //draws a decay branch of the selected nuclides with one random number
+        inline int SampleDecayBranch(TRandom* rng) const {return fDecayBranchTable_.Sample(rng);}
+        inline int GetNumberOfNuclides() const {return fNuclideName_.size();}
+        inline const std::vector<std::string>& GetSelectedNuclides() const {return fSelectedNuclides_;}
+        void SetSelectedNuclides(const std::vector<std::string>& names);
         inline double GetPhantomNaive511Prob() const {return fPPhantom511_;}
         inline double GetPhantomNaivePromptProb() const {return fPPhantomPrompt_;}
         inline double GetPhantomUse() const {return fUsePhantom_;}
         inline bool GetPhantomSmear() const {return fPhantomSmear_;}
+        inline bool IsAcceptanceSampling() const {return fAcceptanceSampling_;}
+        inline bool IsEarlyReject() const {return fEarlyReject_;}
+        //events that cannot pass cuts are removed before other stages only if failed events are not saved
+        inline bool IsEarlyRejectActive() const {return fEarlyReject_ && fEventTypeToSave_==PASS;}
         //////////////////////////////////
         inline void SetR(float r) {fR_=r;}
         inline void SetL(float l) {fL_=l;}
@@ -73,19 +119,34 @@ class ParamManager
         inline void SetSmearLowLimit(float limit) {fSmearLowLimit_=limit;}
         inline void SetSmearHighLimit(float limit) {fSmearHighLimit_=limit;}
         inline void SetNoOfGammas(int no) {fNoOfGammas_=no;}
+        inline void SetSimEvents(int events) {fSimEvents_=events;}
         inline void EnableSilentMode() {fSilentMode_=true;}
         inline void DisableSilentMode() {fSilentMode_=false;}
         inline OutputOptions GetOutputType() const {return fOutput_;}
         inline void SetOutputType(OutputOptions type) {fOutput_=type;}
         inline EventTypeToSave GetEventTypeToSave() const {return fEventTypeToSave_;}
         inline void SetEventTypeToSave(EventTypeToSave type) {fEventTypeToSave_=type;}
+        inline TreeSchema GetTreeSchema() const {return fTreeSchema_;}
+        inline void SetTreeSchema(TreeSchema schema) {fTreeSchema_=schema;}
+        inline HistogramLevel GetHistogramLevel() const {return fHistogramLevel_;}
+        inline bool AreHistogramsEnabled() const {return fHistogramLevel_!=NO_HISTOGRAMS && fOutput_!=HEADLESS;}
+        inline void SetHistogramLevel(HistogramLevel level) {fHistogramLevel_=level;}
         inline void SetSeed(int seed){fSeed_=seed;}
+        inline void SetThreads(int threads){fThreads_=threads;}
+        inline void SetRunThreads(int threads){fRunThreads_=threads;}
+        inline void SetShard(int index, int count){fShardIndex_=index; fShardCount_=count;}
+        inline void SetOutputQueueSize(int size){fOutputQueueSize_=size;}
+        inline void SetComptonSampling(ComptonSamplingMethod method){fComptonSampling_=method;}
         inline void SetUseOfPhantom(bool isPhantom){fUsePhantom_=isPhantom;}
         inline void SetPhantomNaive511Prob(double p){fPPhantom511_=p;}
         inline void SetPhantomNaivePromptProb(double p){fPPhantomPrompt_=p;}
         inline void SetPhantomSmear(bool isSmear){fPhantomSmear_=isSmear;}
+        inline void SetAcceptanceSampling(bool isBiased){fAcceptanceSampling_=isBiased;}
+        inline void SetEarlyReject(bool isEarly){fEarlyReject_=isEarly;}
         //access source parameters
         std::vector<double> GetDataAt(const int index=0) const;
+        //digest of parameters affecting results, used to check if a simulation can be resumed
+        std::string GetDigest() const;
 
         //import parameters from external file
 
@@ -108,20 +169,38 @@ class ParamManager
         float fSmearLowLimit_; //lower limit for smearing effect
         float fSmearHighLimit_; //higher limit for smearing effect
         int fSeed_; //seed of the random generator, if set to 0 then different for different program executions
+        int fThreads_; //number of worker threads used in the event loop, if set to 0 then cores left by run threads are used
+        int fRunThreads_; //number of runs (source positions) simulated concurrently, if set to 0 then cores left by worker threads are used
+        int fShardIndex_; //index of the shard simulated by this process, from 0 to fShardCount_-1
+        int fShardCount_; //number of processes sharing events of every run, each simulates a contiguous range of blocks
+        int fOutputQueueSize_; //maximal number of simulated events waiting for writing to the tree
+        ComptonSamplingMethod fComptonSampling_; //method of drawing Compton scattering angles
         bool fSilentMode_; //if set to true, less output to std::cout will be printed
         bool f2nNdataImported_; //set to true after importing 2&N data
         bool fUsePhantom_; //set true to use phantom
         double fPPhantom511_; //probability for a 511 keV phantom to scatter inside a phantom in naive mode
         double fPPhantomPrompt_; //probability for a prompt phantom to scatter inside a phantom in naive mode
         bool fPhantomSmear_;
+        bool fAcceptanceSampling_; //if true, the first photon is emitted only towards the barrel and weights of events are corrected
+        bool fEarlyReject_; //if true and only passed events are saved, events that missed the detector skip phantom and Compton stages
 
         OutputOptions fOutput_; //what kind of output will be produced
         EventTypeToSave fEventTypeToSave_; //what kind of events should be saved
+        TreeSchema fTreeSchema_; //layout of events in the tree
+        HistogramLevel fHistogramLevel_; //which histograms are created and filled
         std::vector<std::vector<double> > fData_; //this is where source parameters are stored
         //fields to store info for 2&N decays
         std::vector<double> fDecayBranchProbability_; //probability that a certain decay branch will be realized (can be abundance also)
         std::vector<std::vector<double> > fGammaEnergy_; //keV
-        void ValidatePromptData_(); //validate the 2&N data
+        AliasTable fDecayBranchTable_; //table for drawing decay branches, built from fDecayBranchProbability_
+        //library of nuclides imported from the 2&N data file, decay branches of selected nuclides are copied to the fields above
+        std::vector<std::string> fNuclideName_;
+        std::vector<double> fNuclideActivity_; //rate of positron emissions, in arbitrary units
+        std::vector<int> fLibraryBranchNuclide_; //index of the nuclide of every decay branch of the library
+        std::vector<double> fLibraryBranchProbability_;
+        std::vector<std::vector<double> > fLibraryGammaEnergy_; //keV
+        std::vector<std::string> fSelectedNuclides_; //names of simulated nuclides, all nuclides are simulated if empty
+        void BuildDecayBranches_(); //validate the 2&N data and mix decay branches of selected nuclides
 
         friend class TwoAndNTestFixture; // for testing
 };
@@ -2,9 +2,12 @@
 #define PARTICLEGENERATOR_H
 
 #include <TLorentzVector.h>
-#include <TRandom3.h>
-#include "TGenPhaseSpace.h"
+#include <TRandom.h>
+#include "phasespacegenerator.h"
+#include "masslessphasespace.h"
 #include "event.h"
+#include "eventbatch.h"
+#include "randomstream.h"
 #include "parammanager.h"
 #include <vector>
 #include <iostream>
@@ -13,16 +16,15 @@
 ///
 /// \brief generateSingleGamma Generates a single gamma in a random direction.
 /// \param energy Energy of emitted gamma.
-/// \return Pointer to fourmomentum of created gamma.
+/// \param rng Random number generator to be used.
+/// \return Fourmomentum of created gamma.
 ///
-inline TLorentzVector* generateSingleGamma(double energy)
+inline TLorentzVector generateSingleGamma(double energy, TRandom* rng)
 {
-    if(energy==0)
-        return nullptr;
-    double theta = TMath::ACos(gRandom->Uniform(-1.0, 1.0));
-    double phi = gRandom->Uniform(0.0, 2*TMath::Pi());
+    double theta = TMath::ACos(rng->Uniform(-1.0, 1.0));
+    double phi = rng->Uniform(0.0, 2*TMath::Pi());
     double P = energy/1000.0; //GeV
-    return new TLorentzVector(P*TMath::Sin(theta)*TMath::Cos(phi), P*TMath::Sin(theta)*TMath::Sin(phi), P*TMath::Cos(theta), P);
+    return TLorentzVector(P*TMath::Sin(theta)*TMath::Cos(phi), P*TMath::Sin(theta)*TMath::Sin(phi), P*TMath::Cos(theta), P);
 }
 
 
@@ -69,86 +71,185 @@ inline std::string recognizeType(const DecayType type, int& noOfGammas)
 }
 
 ///
-/// \brief generateEvent
-/// \param phaseSpaceGen Reference to TGenPhaseSpace object used to quickly generate Ps decays.
+/// \brief generateEvent Generates a decay and stores it in the given event. No memory is allocated if the event
+/// already held the same (or higher) number of decay products.
+/// \tparam kType Type of decay.
+/// \param event Event object or EventBatch::EventSlot to be filled, its previous content is removed.
+/// \param phaseSpaceGen Reference to the generator of Ps decays: PhaseSpaceGenerator, MasslessPhaseSpace or its DeferredDecay.
 /// \param source Position and radius of the source.
 /// \param pManag Reference to ParamManger with all parameters of the program stored.
-/// \param type Type of decay.
-/// \return Pointer to Event object, which contains all information about the event (emitted gammas, energy deposited etc.).
+/// \param rng Random number generator to be used.
 ///
-inline Event* generateEvent(TGenPhaseSpace& phaseSpaceGen, const TLorentzVector& source, const ParamManager& pManag, const DecayType type)
+template<DecayType kType, typename EventType, typename PhaseSpaceType>
+inline void generateEvent(EventType& event, PhaseSpaceType& phaseSpaceGen, const TLorentzVector& source, const ParamManager& pManag, TRandom* rng)
 {
        //Generation of a decay
-       double weight;
-       std::vector<TLorentzVector*> fourMomenta;// = new std::vector<TLorentzVector*>();
-       std::vector<TLorentzVector*> sourcePar;// = new std::vector<TLorentzVector*>();
-       if(type == ONE)
+       double weight = 1.0;
+       TLorentzVector singleGamma;
+       if(kType == ONE)
        {
            if(pManag.GetE()<=0.0)
                throw("[ERROR] When gamma has no energy there is no gamma!");
-           weight = 1.0;
-           fourMomenta.push_back(generateSingleGamma(pManag.GetE()/1000.0));
+           singleGamma = generateSingleGamma(pManag.GetE()/1000.0, rng);
        }
        else
-       {
-           weight = phaseSpaceGen.Generate();
-           //have to make copies here, because the objects are held by the instance of TGenPhaseSpace
-           fourMomenta.push_back(new TLorentzVector(*phaseSpaceGen.GetDecay(0)));
-           fourMomenta.push_back(new TLorentzVector(*phaseSpaceGen.GetDecay(1)));
-       }
+           weight = phaseSpaceGen.Generate(rng);
 
-       //Generating emission point inside a ball
+       //Generating emission point inside a ball or just using a point source
+       TLorentzVector emissionPoint(source.X(), source.Y(), source.Z(), 0.0);
        if(source.T() != 0)
-            sourcePar.push_back(new TLorentzVector(source.X()+gRandom->Uniform(-1.0,1.0)*source.T(), source.Y()+gRandom->Uniform(-1.0,1.0)*source.T(),\
-                                                      source.Z()+gRandom->Uniform(-1.0,1.0)*source.T(), 0.0));
-       else //or just using a point source
-           sourcePar.push_back(new TLorentzVector(source.X(), source.Y(), source.Z(), 0.0));
-
-       if(type != ONE) //origination point of second gamma
-           sourcePar.push_back(new TLorentzVector(*sourcePar.at(0))); //making copies
-
-       //adding additional (3,4,5..) photons
-       if(type == THREE)
        {
-           fourMomenta.push_back(new TLorentzVector(*phaseSpaceGen.GetDecay(2)));
-           sourcePar.push_back(new TLorentzVector(*sourcePar.at(0)));
+           double x = source.X()+rng->Uniform(-1.0,1.0)*source.T();
+           double y = source.Y()+rng->Uniform(-1.0,1.0)*source.T();
+           double z = source.Z()+rng->Uniform(-1.0,1.0)*source.T();
+           emissionPoint.SetXYZT(x, y, z, 0.0);
        }
-       else if(type == TWOandONE && gRandom->Uniform() < pManag.GetP() && pManag.GetE()>0.0)
+
+       //Packing everything to EVENT object, all photons are emitted from the same point
+       event.Reset(kType, weight);
+       if(kType == ONE)
+           event.AddDecayProduct(emissionPoint, singleGamma);
+       else
        {
-           fourMomenta.push_back(generateSingleGamma(pManag.GetE()/1000.0)); //E in [MeV]
-           sourcePar.push_back(new TLorentzVector(*sourcePar.at(0)));
+           //the objects are held by the instance of the generator
+           event.AddDecayProduct(emissionPoint, *phaseSpaceGen.GetDecay(0));
+           event.AddDecayProduct(emissionPoint, *phaseSpaceGen.GetDecay(1));
        }
-       else if(type == TWOandN)
+
+       //adding additional (3,4,5..) photons
+       if(kType == THREE)
+           event.AddDecayProduct(emissionPoint, *phaseSpaceGen.GetDecay(2));
+       else if(kType == TWOandONE && rng->Uniform() < pManag.GetP() && pManag.GetE()>0.0)
+           event.AddDecayProduct(emissionPoint, generateSingleGamma(pManag.GetE()/1000.0, rng)); //E in [MeV]
+       else if(kType == TWOandN)
        {
-           //loop over all beta decay branches
-           for(int ii=0; ii< pManag.GetNumberOfDecayBranches(); ii++)
+           //one beta decay branch is drawn from the alias table, photons without energy are skipped
+           int branch = pManag.SampleDecayBranch(rng);
+           for(int jj=0; branch>=0 && jj<pManag.GetBranchSize(branch); jj++)
            {
-               //check if a beta decay occurs
-               if(gRandom->Uniform() < pManag.GetDecayBranchProbabilityAt(ii))
-               {
-                   //loop over all possible gamma emissions
-                   for(int jj=0; jj<pManag.GetBranchSize(ii); jj++)
-                   {
-                       fourMomenta.push_back(generateSingleGamma(pManag.GetGammaEnergyAt(ii, jj)/1000.0)); //E in [MeV]
-                       sourcePar.push_back(new TLorentzVector(*sourcePar.at(0)));
-                   }
-               }
+               if(pManag.GetGammaEnergyAt(branch, jj)==0)
+                   continue;
+               event.AddDecayProduct(emissionPoint, generateSingleGamma(pManag.GetGammaEnergyAt(branch, jj)/1000.0, rng)); //E in [MeV]
            }
        }
+}
+
+///
+/// \brief generateEvent Generates a decay and stores it in the given event, the decay type is dispatched at run time.
+/// \param event Event object or EventBatch::EventSlot to be filled, its previous content is removed.
+/// \param phaseSpaceGen Reference to the generator of Ps decays: PhaseSpaceGenerator, MasslessPhaseSpace or its DeferredDecay.
+/// \param source Position and radius of the source.
+/// \param pManag Reference to ParamManger with all parameters of the program stored.
+/// \param type Type of decay.
+/// \param rng Random number generator to be used.
+///
+template<typename EventType, typename PhaseSpaceType>
+inline void generateEvent(EventType& event, PhaseSpaceType& phaseSpaceGen, const TLorentzVector& source, const ParamManager& pManag, const DecayType type, TRandom* rng)
+{
+    switch(type)
+    {
+        case ONE: generateEvent<ONE>(event, phaseSpaceGen, source, pManag, rng); break;
+        case TWO: generateEvent<TWO>(event, phaseSpaceGen, source, pManag, rng); break;
+        case THREE: generateEvent<THREE>(event, phaseSpaceGen, source, pManag, rng); break;
+        case TWOandONE: generateEvent<TWOandONE>(event, phaseSpaceGen, source, pManag, rng); break;
+        case TWOandN: generateEvent<TWOandN>(event, phaseSpaceGen, source, pManag, rng); break;
+        default: throw(std::string("[ERROR] Wrong decay type!"));
+    }
+}
+
+///
+/// \brief generateEvents Generates a batch of decays, every event with random numbers from its own substream.
+/// \param batch Batch to be filled, its previous content is removed.
+/// \param firstEvent Index of the first generated event in the run.
+/// \param noOfEvents Number of generated events.
+/// \param phaseSpaceGen Reference to PhaseSpaceGenerator object used to quickly generate Ps decays.
+/// \param source Position and radius of the source.
+/// \param pManag Reference to ParamManger with all parameters of the program stored.
+/// \param rng Random number generator, switched to the substream of every event before it is generated.
+///
+inline void generateEvents(EventBatch& batch, long firstEvent, int noOfEvents, PhaseSpaceGenerator& phaseSpaceGen, const TLorentzVector& source, const ParamManager& pManag, RandomStream* rng)
+{
+    batch.Clear(firstEvent);
+    for(int ii=0; ii<noOfEvents; ii++)
+    {
+        rng->SetSubstream(firstEvent+ii);
+        EventBatch::EventSlot slot = batch.AddEvent();
+        generateEvent(slot, phaseSpaceGen, source, pManag, batch.GetDecayType(), rng);
+    }
+}
 
-       //Packing everything to EVENT object
-       Event* eventDecay = new Event(&sourcePar, &fourMomenta, weight, type);
+///
+/// \brief generateEvents Generates a batch of decays into massless products, every event with random numbers from its own
+/// substream. Events are the same as the ones generated by the PhaseSpaceGenerator version, but momenta of the decay products
+/// are calculated for the whole batch at once, after all random numbers are drawn.
+/// \tparam kType Type of decays, the same as the type of the batch.
+/// \param batch Batch to be filled, its previous content is removed.
+/// \param firstEvent Index of the first generated event in the run.
+/// \param noOfEvents Number of generated events.
+/// \param masslessGen Reference to MasslessPhaseSpace object, the decay has to be set unless the type is ONE.
+/// \param source Position and radius of the source.
+/// \param pManag Reference to ParamManger with all parameters of the program stored.
+/// \param rng Random number generator, switched to the substream of every event before it is generated.
+///
+template<DecayType kType>
+inline void generateEvents(EventBatch& batch, long firstEvent, int noOfEvents, MasslessPhaseSpace& masslessGen, const TLorentzVector& source, const ParamManager& pManag, RandomStream* rng)
+{
+    batch.Clear(firstEvent);
+    for(int ii=0; ii<noOfEvents; ii++)
+    {
+        rng->SetSubstream(firstEvent+ii);
+        EventBatch::EventSlot slot = batch.AddEvent();
+        MasslessPhaseSpace::DeferredDecay decay(masslessGen, slot.GetIndex());
+        generateEvent<kType>(slot, decay, source, pManag, rng);
+    }
+    if(DecayTraits<kType>::kDecayPhotons > 0)
+        masslessGen.GenerateBatch(batch);
+}
 
-       //Releasing memory
-       for(std::vector<TLorentzVector*>::iterator it = fourMomenta.begin(); it != fourMomenta.end(); ++it)
+///
+/// \brief generateEvents Generates a batch of decays into massless products, the decay type of the batch is dispatched at run time.
+/// \param batch Batch to be filled, its previous content is removed.
+/// \param firstEvent Index of the first generated event in the run.
+/// \param noOfEvents Number of generated events.
+/// \param masslessGen Reference to MasslessPhaseSpace object, the decay has to be set unless the type is ONE.
+/// \param source Position and radius of the source.
+/// \param pManag Reference to ParamManger with all parameters of the program stored.
+/// \param rng Random number generator, switched to the substream of every event before it is generated.
+///
+inline void generateEvents(EventBatch& batch, long firstEvent, int noOfEvents, MasslessPhaseSpace& masslessGen, const TLorentzVector& source, const ParamManager& pManag, RandomStream* rng)
+{
+    switch(batch.GetDecayType())
+    {
+        case ONE: generateEvents<ONE>(batch, firstEvent, noOfEvents, masslessGen, source, pManag, rng); break;
+        case TWO: generateEvents<TWO>(batch, firstEvent, noOfEvents, masslessGen, source, pManag, rng); break;
+        case THREE: generateEvents<THREE>(batch, firstEvent, noOfEvents, masslessGen, source, pManag, rng); break;
+        case TWOandONE: generateEvents<TWOandONE>(batch, firstEvent, noOfEvents, masslessGen, source, pManag, rng); break;
+        case TWOandN: generateEvents<TWOandN>(batch, firstEvent, noOfEvents, masslessGen, source, pManag, rng); break;
+        default: throw(std::string("[ERROR] Wrong decay type of EventBatch!"));
+    }
+}
+
+///
+/// \brief generateEvent Generates a decay and stores it in a new event.
+/// \param phaseSpaceGen Reference to PhaseSpaceGenerator object used to quickly generate Ps decays.
+/// \param source Position and radius of the source.
+/// \param pManag Reference to ParamManger with all parameters of the program stored.
+/// \param type Type of decay.
+/// \param rng Random number generator to be used.
+/// \return Pointer to Event object, which contains all information about the event (emitted gammas, energy deposited etc.).
+///
+inline Event* generateEvent(PhaseSpaceGenerator& phaseSpaceGen, const TLorentzVector& source, const ParamManager& pManag, const DecayType type, TRandom* rng)
+{
+       Event* eventDecay = new Event(type);
+       try
        {
-           delete *it;
+           generateEvent(*eventDecay, phaseSpaceGen, source, pManag, type, rng);
+       }
+       catch(...)
+       {
+           delete eventDecay;
+           throw;
        }
-       for(std::vector<TLorentzVector*>::iterator it = sourcePar.begin(); it != sourcePar.end(); ++it)
-            delete *it;
-       fourMomenta.clear();
-       sourcePar.clear();
-
        return eventDecay;
 }
 
@@ -1,5 +1,6 @@
 #include "phantom.h"
 #include <TLorentzVector.h>
+#include <string>
 
 ///
 /// \brief Phantom::Phantom Full constructor.
@@ -26,8 +27,11 @@ fNaiveProbprompt_(0)
 /// \param p511 Probability to scatter 511 keV photons inside the phantom.
 /// \param pPrompt Probability to scatter prompt photons inside the phantom.
 /// \param isSmear True if detector-like smearing is enabled.
+/// \param type Type of the scattered decays. If provided, the scattering engine is created here instead of on the first call
+/// of NaiveScatter, what is required when the phantom is used by a worker thread. Histograms of in-phantom scattering are
+/// never drawn, so the scattering engine is created without them.
 ///
-Phantom::Phantom(double p511, double pPrompt, bool isSmear) :
+Phantom::Phantom(double p511, double pPrompt, bool isSmear, DecayType type) :
 fType_(Elipsoid),
 fA_(0.0),
 fB_(0.0),
@@ -37,6 +41,8 @@ fNaiveProb511_(p511),
 fNaiveProbprompt_(pPrompt)
 {
     cs = nullptr;
+    if(type != WRONG)
+        cs = new ComptonScattering(type, 0.0, 2.0, false);
 }
 
 Phantom::~Phantom()
@@ -44,6 +50,17 @@ Phantom::~Phantom()
     if(cs) delete cs;
 }
 
+///
+/// \brief Phantom::SetComptonSamplingMethod Sets the method of drawing scattering angles for naive scattering.
+/// Has effect only if the scattering engine was already created (the decay type was passed to the constructor).
+/// \param method TABLE or KAHN.
+///
+void Phantom::SetComptonSamplingMethod(ComptonSamplingMethod method)
+{
+    if(cs)
+        cs->SetSamplingMethod(method);
+}
+
 ///
 /// \brief Phantom::Scatter Phantom simulation -- NOT IMPLEMENTED!
 /// \param event
@@ -56,22 +73,23 @@ void Phantom::Scatter(Event* event)
 ///
 /// \brief Phantom::NaiveScatter Naive model of in-phantom scattering, in which only the energy of photons is altered according to Klein-Nishina formula.
 /// \param event Pointer to Event class object, for which in-phantom scattering is done.
+/// \param rng Random number generator to be used.
 ///
-void Phantom::NaiveScatter(Event* event)
+void Phantom::NaiveScatter(Event* event, TRandom* rng)
 {
     if(cs==nullptr)
     {
         //create ne ComptonScattering object to perform in-phantom scattering
-        cs = new ComptonScattering(event->GetDecayType());
+        cs = new ComptonScattering(event->GetDecayType(), 0.0, 2.0, false);
     }
     //loop over photons
     for(int ii=0; ii<event->GetNumberOfDecayProducts(); ii++)
     {
         int noOf511 = event->GetDecayType() == THREE ? 3 : 2; //two or three first photons are 511 keV photons
         double prob = ii < noOf511 ? fNaiveProb511_ : fNaiveProbprompt_;
-        if(gRandom->Uniform(0.0, 1.0)<prob)
+        if(rng->Uniform(0.0, 1.0)<prob)
         {
-            cs->Scatter(event, ii);
+            cs->Scatter(event, rng, ii);
             TLorentzVector* v = event->GetFourMomentumOf(ii);
             double newE = 0.0;
             if(fSmear_)
@@ -91,3 +109,66 @@ void Phantom::NaiveScatter(Event* event)
 
     }
 }
+
+///
+/// \brief Phantom::NaiveScatter Naive in-phantom scattering of all events in a batch, the same as NaiveScatter for Event.
+/// \tparam kType Type of decays stored in the batch.
+/// \param batch Batch of events, for which in-phantom scattering is done.
+/// \param rng Random number generator, switched to the substream of every event before it is scattered.
+///
+template<DecayType kType>
+void Phantom::NaiveScatter(EventBatch& batch, RandomStream* rng)
+{
+    if(cs==nullptr)
+    {
+        //create ne ComptonScattering object to perform in-phantom scattering
+        cs = new ComptonScattering(batch.GetDecayType(), 0.0, 2.0, false);
+    }
+    const int noOf511 = DecayTraits<kType>::kRequiredPhotons; //two or three first photons are 511 keV photons
+    for(int jj=0; jj<batch.GetSize(); jj++)
+    {
+        rng->SetSubstream(batch.GetIndexInRun(jj));
+        //loop over photons
+        for(int ii=0; ii<batch.GetNumberOfDecayProducts<kType>(jj); ii++)
+        {
+            double prob = ii < noOf511 ? fNaiveProb511_ : fNaiveProbprompt_;
+            if(rng->Uniform(0.0, 1.0)<prob)
+            {
+                cs->Scatter(batch, jj, rng, ii);
+                int kk = batch.Index(ii, jj);
+                double newE = fSmear_ ? batch.fEdepSmear[kk] : batch.fEdep[kk];
+                newE = newE > 0 ? newE : 0.0;
+                //altering the fourmomenta, but without change of their directions
+                batch.fPx[kk] = batch.fPx[kk]/batch.fE[kk]*newE;
+                batch.fPy[kk] = batch.fPy[kk]/batch.fE[kk]*newE;
+                batch.fPz[kk] = batch.fPz[kk]/batch.fE[kk]*newE;
+                batch.fE[kk] = newE;
+                batch.fPrimaryPhoton[kk] = false;
+            }
+        }
+    }
+}
+
+template void Phantom::NaiveScatter<ONE>(EventBatch& batch, RandomStream* rng);
+template void Phantom::NaiveScatter<TWO>(EventBatch& batch, RandomStream* rng);
+template void Phantom::NaiveScatter<THREE>(EventBatch& batch, RandomStream* rng);
+template void Phantom::NaiveScatter<TWOandONE>(EventBatch& batch, RandomStream* rng);
+template void Phantom::NaiveScatter<TWOandN>(EventBatch& batch, RandomStream* rng);
+
+///
+/// \brief Phantom::NaiveScatter Naive in-phantom scattering of all events in a batch, the decay type is dispatched at run time.
+/// \param batch Batch of events, for which in-phantom scattering is done.
+/// \param rng Random number generator, switched to the substream of every event before it is scattered.
+///
+void Phantom::NaiveScatter(EventBatch& batch, RandomStream* rng)
+{
+    switch(batch.GetDecayType())
+    {
+        case ONE: NaiveScatter<ONE>(batch, rng); break;
+        case TWO: NaiveScatter<TWO>(batch, rng); break;
+        case THREE: NaiveScatter<THREE>(batch, rng); break;
+        case TWOandONE: NaiveScatter<TWOandONE>(batch, rng); break;
+        case TWOandN: NaiveScatter<TWOandN>(batch, rng); break;
+        default: throw(std::string("[ERROR] Wrong decay type of EventBatch!"));
+    }
+}
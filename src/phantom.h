@@ -1,6 +1,8 @@
 #ifndef PHANTOM_H
 #define PHANTOM_H
 #include "event.h"
+#include "eventbatch.h"
+#include "randomstream.h"
 #include "comptonscattering.h"
 
 enum PhantomType
@@ -14,10 +16,13 @@ class Phantom
 {
     public:
         Phantom(PhantomType type = Box, double a=1, double b=1, double c=1, bool isSmear=false);
-        Phantom(double p511, double pPrompt, bool isSmear); // NaiveConstructor
+        Phantom(double p511, double pPrompt, bool isSmear, DecayType type=WRONG); // NaiveConstructor
         ~Phantom();
         void Scatter(Event* event);
-        void NaiveScatter(Event* event); //naive scattering, only energy of photons is altered
+        void NaiveScatter(Event* event, TRandom* rng); //naive scattering, only energy of photons is altered
+        void NaiveScatter(EventBatch& batch, RandomStream* rng); //naive scattering of all events of a batch
+        template<DecayType kType> void NaiveScatter(EventBatch& batch, RandomStream* rng); //the same, the type known at compile time
+        void SetComptonSamplingMethod(ComptonSamplingMethod method);
     private:
         //dimensions of the phantom in mm
         PhantomType fType_; //type of the phantom
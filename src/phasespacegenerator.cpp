@@ -0,0 +1,145 @@
+/// @file phasespacegenerator.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <algorithm>
+#include "TMath.h"
+#include "phasespacegenerator.h"
+
+///
+/// \brief PhaseSpaceGenerator::PhaseSpaceGenerator Basic constructor, SetDecay must be called before generation.
+///
+PhaseSpaceGenerator::PhaseSpaceGenerator() :
+    fNt_(0),
+    fTeCmTm_(0.0),
+    fWtMax_(0.0)
+{
+    for(int ii=0; ii<kMaxProducts; ii++)
+        fMass_[ii] = 0.0;
+    fBeta_[0] = fBeta_[1] = fBeta_[2] = 0.0;
+}
+
+///
+/// \brief PhaseSpaceGenerator::PDK Calculates the momentum of products in a two-body decay.
+/// \param a Mass of the decaying particle.
+/// \param b Mass of the first product.
+/// \param c Mass of the second product.
+/// \return Momentum of the products in the rest frame of the decaying particle.
+///
+double PhaseSpaceGenerator::PDK_(double a, double b, double c)
+{
+    double x = (a-b-c)*(a+b+c)*(a-b+c)*(a+b-c);
+    x = TMath::Sqrt(x)/(2*a);
+    return x;
+}
+
+///
+/// \brief PhaseSpaceGenerator::SetDecay Sets the decaying particle and masses of the products.
+/// \param P Four-momentum of the decaying particle [GeV].
+/// \param nt Number of decay products.
+/// \param mass Array with masses of the decay products [GeV].
+/// \return False if the decay is kinematically forbidden or there are too many products.
+///
+bool PhaseSpaceGenerator::SetDecay(const TLorentzVector& P, int nt, const double* mass)
+{
+    fNt_ = nt;
+    if(fNt_<2 || fNt_>kMaxProducts)
+        return false;
+    fTeCmTm_ = P.Mag();
+    for(int n=0; n<fNt_; n++)
+    {
+        fMass_[n] = mass[n];
+        fTeCmTm_ -= mass[n];
+    }
+    if(fTeCmTm_<=0)
+        return false;
+    //constant cross section as a function of TECM
+    double emmax = fTeCmTm_ + fMass_[0];
+    double emmin = 0;
+    double wtmax = 1;
+    for(int n=1; n<fNt_; n++)
+    {
+        emmin += fMass_[n-1];
+        emmax += fMass_[n];
+        wtmax *= PDK_(emmax, emmin, fMass_[n]);
+    }
+    fWtMax_ = 1/wtmax;
+    //saving betas of the decaying particle
+    if(P.Beta())
+    {
+        double w = P.Beta()/P.Rho();
+        fBeta_[0] = P(0)*w;
+        fBeta_[1] = P(1)*w;
+        fBeta_[2] = P(2)*w;
+    }
+    else
+        fBeta_[0] = fBeta_[1] = fBeta_[2] = 0;
+    return true;
+}
+
+///
+/// \brief PhaseSpaceGenerator::Generate Generates a single decay.
+/// \param rng Random number generator to be used.
+/// \return Weight of the generated decay.
+///
+double PhaseSpaceGenerator::Generate(TRandom* rng)
+{
+    double rno[kMaxProducts];
+    rno[0] = 0;
+    if(fNt_>2)
+    {
+        for(int n=1; n<fNt_-1; n++)
+            rno[n] = rng->Rndm();
+        std::sort(rno+1, rno+fNt_-1);
+    }
+    rno[fNt_-1] = 1;
+
+    double invMas[kMaxProducts];
+    double sum = 0;
+    for(int n=0; n<fNt_; n++)
+    {
+        sum += fMass_[n];
+        invMas[n] = rno[n]*fTeCmTm_ + sum;
+    }
+    //weight of the current event
+    double wt = fWtMax_;
+    double pd[kMaxProducts];
+    for(int n=0; n<fNt_-1; n++)
+    {
+        pd[n] = PDK_(invMas[n+1], invMas[n], fMass_[n+1]);
+        wt *= pd[n];
+    }
+    //complete specification of the event (Raubold-Lynch method)
+    fDecPro_[0].SetPxPyPzE(0, pd[0], 0, TMath::Sqrt(pd[0]*pd[0]+fMass_[0]*fMass_[0]));
+    int ii = 1;
+    while(true)
+    {
+        fDecPro_[ii].SetPxPyPzE(0, -pd[ii-1], 0, TMath::Sqrt(pd[ii-1]*pd[ii-1]+fMass_[ii]*fMass_[ii]));
+        double cZ = 2*rng->Rndm() - 1;
+        double sZ = TMath::Sqrt(1-cZ*cZ);
+        double angY = 2*TMath::Pi()*rng->Rndm();
+        double cY = TMath::Cos(angY);
+        double sY = TMath::Sin(angY);
+        for(int jj=0; jj<=ii; jj++)
+        {
+            TLorentzVector* v = fDecPro_+jj;
+            double x = v->Px();
+            double y = v->Py();
+            v->SetPx(cZ*x - sZ*y);
+            v->SetPy(sZ*x + cZ*y); //rotation around Z
+            x = v->Px();
+            double z = v->Pz();
+            v->SetPx(cY*x - sY*z);
+            v->SetPz(sY*x + cY*z); //rotation around Y
+        }
+        if(ii == (fNt_-1))
+            break;
+        double beta = pd[ii] / TMath::Sqrt(pd[ii]*pd[ii] + invMas[ii]*invMas[ii]);
+        for(int jj=0; jj<=ii; jj++)
+            fDecPro_[jj].Boost(0, beta, 0);
+        ii++;
+    }
+    //final boost of all particles
+    for(int n=0; n<fNt_; n++)
+        fDecPro_[n].Boost(fBeta_[0], fBeta_[1], fBeta_[2]);
+    return wt;
+}
@@ -0,0 +1,40 @@
+/// @file phasespacegenerator.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef PHASESPACEGENERATOR_H
+#define PHASESPACEGENERATOR_H
+#include "TLorentzVector.h"
+#include "TRandom.h"
+
+///
+/// \brief The PhaseSpaceGenerator class N-body phase space generator (Raubold-Lynch method).
+///
+/// This is a port of TGenPhaseSpace which draws random numbers from the generator passed to Generate()
+/// instead of the global gRandom, so that every worker thread can own an independent instance.
+/// For the same sequence of random numbers the generated decays are identical to the TGenPhaseSpace ones.
+///
+class PhaseSpaceGenerator
+{
+    public:
+        PhaseSpaceGenerator();
+        bool SetDecay(const TLorentzVector& P, int nt, const double* mass);
+        double Generate(TRandom* rng);
+        inline TLorentzVector* GetDecay(const int index)
+            {return index<fNt_ ? &fDecPro_[index] : nullptr;}
+        inline int GetNt() const {return fNt_;}
+        inline double GetWtMax() const {return fWtMax_;}
+
+        static const int kMaxProducts = 18; //the same limit as in TGenPhaseSpace
+
+    private:
+        int fNt_; //number of decay products
+        double fMass_[kMaxProducts]; //masses of the decay products
+        double fBeta_[3]; //betas of the decaying particle
+        double fTeCmTm_; //total energy in the C.M. minus the total mass
+        double fWtMax_; //maximum weight
+        TLorentzVector fDecPro_[kMaxProducts]; //four-momenta of the decay products
+
+        static double PDK_(double a, double b, double c); //momentum in a two-body decay
+};
+
+#endif // PHASESPACEGENERATOR_H
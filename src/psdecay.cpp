@@ -8,6 +8,7 @@
 #include <iomanip>
 #include "TLegend.h"
 #include "TText.h"
+#include "particlegenerator.h"
 #include "psdecay.h"
 
 unsigned PsDecay::objectID_;
@@ -16,9 +17,11 @@ unsigned PsDecay::objectID_;
 ///
 /// \brief PsDecay::PsDecay The only used constructor.
 /// \param type Type of decay. Can be TWO, THREE or TWOandONE.
+/// \param histograms If false, no histograms are created and filling them is skipped (production mode).
 ///
-PsDecay::PsDecay(DecayType type) :
+PsDecay::PsDecay(DecayType type, bool histograms) :
       fSilentMode_(false),
+      fHistograms_(histograms),
       fDecayType_(type)
 {
     fH_12_=nullptr;
@@ -32,13 +35,25 @@ PsDecay::PsDecay(DecayType type) :
     fH_min_mid_ = nullptr;
     fH_min_max_ = nullptr;
     fH_mid_max_ = nullptr;
+    int noOfGammas = 0;
+    fTypeString_ = recognizeType(fDecayType_, noOfGammas);
+    if(noOfGammas == 0)
+        throw(std::string("Invalid no of decay products!"));
+    if(fHistograms_)
+        CreateHistograms_();
+}
+
+///
+/// \brief PsDecay::CreateHistograms_ Creates histograms applicable to the type of decay.
+///
+void PsDecay::CreateHistograms_()
+{
     //Creating histograms for angle distributions
     if(fDecayType_ == THREE)
     {
-        fTypeString_="3";
         //general purpose histograms are created here to ensure right limits
         fH_en_ = new TH1F((std::string("fH_en_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.0, 0.6);
-        fH_p_ = new TH1F((std::string("fH_p_")+fTypeString_).c_str(), "fH_p_", 52, 0.0, 0.6);
+        fH_p_ = new TH1F((std::string("fH_p_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_p_", 52, 0.0, 0.6);
         //histograms for all events generated
         fH_12_23_ = new TH2F((std::string("fH_12_23_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(),"fH_12_23_all", 50,0, 3.15, 50,0,3.15);
         fH_12_23_ -> SetTitle("Polar angle distr, 12 vs 23");
@@ -86,7 +101,6 @@ PsDecay::PsDecay(DecayType type) :
     }
     else if(fDecayType_ == TWO)
     {
-        fTypeString_="2";
         //general purpose histograms are created here to ensure right limits
         fH_en_ = new TH1F((std::string("fH_en_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.0, 0.6);
         fH_p_ = new TH1F((std::string("fH_p_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_p_", 52, 0.0, 0.6);
@@ -103,7 +117,6 @@ PsDecay::PsDecay(DecayType type) :
     }
     else if(fDecayType_ == TWOandONE)
     {
-        fTypeString_="2&1";
         //general purpose histograms are created here to ensure right limits
         fH_en_ = new TH1F((std::string("fH_en_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.3, 1.3);
         fH_p_ = new TH1F((std::string("fH_p_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_p_", 52, 0.3, 1.3);
@@ -136,12 +149,11 @@ PsDecay::PsDecay(DecayType type) :
     }
     else if(fDecayType_ == TWOandN)
     {
-        fTypeString_="2&N";
         //general purpose histograms are created here to ensure right limits
         fH_en_ = new TH1F((std::string("fH_en_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_en_", 104, 0.0, 4.0);
         fH_p_ = new TH1F((std::string("fH_p_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_p_", 104, 0.0, 4.0);
         //histogram for all events generated
-        fH_12_ = new TH1F("fH_12_all", "fH_12_all", 19, 3.10, 3.2);
+        fH_12_ = new TH1F((std::string("fH_12_all")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_12_all", 19, 3.10, 3.2);
         fH_12_->SetFillColor(kBlue);
         fH_12_ -> SetTitle("Distribution of polar angle between 2 gammas");
         fH_12_ -> GetXaxis()->SetNdivisions(5, false);
@@ -153,7 +165,6 @@ PsDecay::PsDecay(DecayType type) :
     }
     else if(fDecayType_ == ONE)
     {
-        fTypeString_="1";
         //general purpose histograms are created here to ensure right limits
         fH_en_ = new TH1F((std::string("fH_en_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_en_", 52, 0.0, 2.0);
         fH_p_ = new TH1F((std::string("fH_p_")+fTypeString_+"_"+std::to_string(objectID_)).c_str(), "fH_p_", 52, 0.0, 2.0);
@@ -201,45 +212,12 @@ PsDecay::PsDecay(DecayType type) :
 PsDecay::PsDecay(const PsDecay& est)
 {
     fSilentMode_=est.fSilentMode_;
+    fHistograms_=est.fHistograms_;
     fDecayType_=est.fDecayType_;
     fTypeString_ = est.fTypeString_;
 
-    fH_12_23_ = nullptr;
-    fH_12_31_ = nullptr;
-    fH_23_31_ = nullptr;
-    fH_min_mid_ = nullptr;
-    fH_min_max_ = nullptr;
-    fH_mid_max_ = nullptr;
-    fH_12_ = nullptr;
-    fH_23_ = nullptr;
-    fH_31_ = nullptr;
-
-    if(fDecayType_==TWO)
-    {
-        fH_12_ = new TH1F(*est.fH_12_);
-    }
-    else if(fDecayType_==THREE)
-    {
-        fH_12_23_ = new TH2F(*est.fH_12_23_);
-        fH_12_31_ = new TH2F(*est.fH_12_31_);
-        fH_23_31_ = new TH2F(*est.fH_23_31_);
-        fH_min_mid_ = new TH2F(*est.fH_min_mid_);
-        fH_min_max_ = new TH2F(*est.fH_min_max_);
-        fH_mid_max_ = new TH2F(*est.fH_mid_max_);
-
-    }
-    else if(fDecayType_==TWOandONE)
-    {
-        fH_12_ = new TH1F(*est.fH_12_);
-        fH_23_ = new TH1F(*est.fH_23_);
-        fH_31_ = new TH1F(*est.fH_31_);
-    }
-
-    fH_en_ = new TH1F(*est.fH_en_);
-    fH_p_ = new TH1F(*est.fH_p_);
-    fH_phi_= new TH1F(*est.fH_phi_);
-    fH_cosTheta_ = new TH1F(*est.fH_cosTheta_);
-
+    if(fHistograms_)
+        CopyHistograms_(est);
 }
 
 ///
@@ -250,9 +228,21 @@ PsDecay::PsDecay(const PsDecay& est)
 PsDecay& PsDecay::operator=(const PsDecay& est)
 {
     fSilentMode_=est.fSilentMode_;
+    fHistograms_=est.fHistograms_;
     fDecayType_=est.fDecayType_;
     fTypeString_ = est.fTypeString_;
 
+    if(fHistograms_)
+        CopyHistograms_(est);
+    return *this;
+}
+
+///
+/// \brief PsDecay::CopyHistograms_ Creates copies of histograms of another instance.
+/// \param est Instance of PsDecay with histograms enabled.
+///
+void PsDecay::CopyHistograms_(const PsDecay& est)
+{
     fH_12_23_ = nullptr;
     fH_12_31_ = nullptr;
     fH_23_31_ = nullptr;
@@ -265,30 +255,28 @@ PsDecay& PsDecay::operator=(const PsDecay& est)
 
     if(fDecayType_==TWO)
     {
-        fH_12_ = new TH1F(*est.fH_12_);
+        fH_12_ = new TH1F(*est.fH_12_.Get());
     }
     else if(fDecayType_==THREE)
     {
-        fH_12_23_ = new TH2F(*est.fH_12_23_);
-        fH_12_31_ = new TH2F(*est.fH_12_31_);
-        fH_23_31_ = new TH2F(*est.fH_23_31_);
-        fH_min_mid_ = new TH2F(*est.fH_min_mid_);
-        fH_min_max_ = new TH2F(*est.fH_min_max_);
-        fH_mid_max_ = new TH2F(*est.fH_mid_max_);
-
+        fH_12_23_ = new TH2F(*est.fH_12_23_.Get());
+        fH_12_31_ = new TH2F(*est.fH_12_31_.Get());
+        fH_23_31_ = new TH2F(*est.fH_23_31_.Get());
+        fH_min_mid_ = new TH2F(*est.fH_min_mid_.Get());
+        fH_min_max_ = new TH2F(*est.fH_min_max_.Get());
+        fH_mid_max_ = new TH2F(*est.fH_mid_max_.Get());
     }
     else if(fDecayType_==TWOandONE)
     {
-        fH_12_ = new TH1F(*est.fH_12_);
-        fH_23_ = new TH1F(*est.fH_23_);
-        fH_31_ = new TH1F(*est.fH_31_);
+        fH_12_ = new TH1F(*est.fH_12_.Get());
+        fH_23_ = new TH1F(*est.fH_23_.Get());
+        fH_31_ = new TH1F(*est.fH_31_.Get());
     }
 
-    fH_en_ = new TH1F(*est.fH_en_);
-    fH_p_ = new TH1F(*est.fH_p_);
-    fH_phi_= new TH1F(*est.fH_phi_);
-    fH_cosTheta_ = new TH1F(*est.fH_cosTheta_);
-    return *this;
+    fH_en_ = new TH1F(*est.fH_en_.Get());
+    fH_p_ = new TH1F(*est.fH_p_.Get());
+    fH_phi_= new TH1F(*est.fH_phi_.Get());
+    fH_cosTheta_ = new TH1F(*est.fH_cosTheta_.Get());
 }
 
 ///
@@ -296,19 +284,46 @@ PsDecay& PsDecay::operator=(const PsDecay& est)
 ///
 PsDecay::~PsDecay()
 {
-    if(fH_12_23_) delete fH_12_23_;
-    if(fH_12_31_) delete fH_12_31_;
-    if(fH_23_31_) delete fH_23_31_;
-    if(fH_min_mid_) delete fH_min_mid_;
-    if(fH_min_max_) delete fH_min_max_;
-    if(fH_mid_max_) delete fH_mid_max_;
-    if(fH_12_) delete fH_12_;
-    if(fH_23_) delete fH_23_;
-    if(fH_31_) delete fH_31_;
-    if(fH_en_) delete fH_en_;
-    if(fH_p_) delete fH_p_;
-    if(fH_phi_) delete fH_phi_;
-    if(fH_cosTheta_) delete fH_cosTheta_;
+    delete fH_12_23_.Release();
+    delete fH_12_31_.Release();
+    delete fH_23_31_.Release();
+    delete fH_min_mid_.Release();
+    delete fH_min_max_.Release();
+    delete fH_mid_max_.Release();
+    delete fH_12_.Release();
+    delete fH_23_.Release();
+    delete fH_31_.Release();
+    delete fH_en_.Release();
+    delete fH_p_.Release();
+    delete fH_phi_.Release();
+    delete fH_cosTheta_.Release();
+}
+
+///
+/// \brief PsDecay::Merge Adds histograms filled by another instance to histograms of this one.
+/// \param est Instance of PsDecay created for the same decay type, e.g. by a worker thread.
+///
+void PsDecay::Merge(const PsDecay& est)
+{
+    if(fDecayType_ != est.fDecayType_)
+        throw(std::string("[ERROR] Cannot merge PsDecay objects created for different decay types!"));
+    if(fHistograms_ != est.fHistograms_)
+        throw(std::string("[ERROR] Cannot merge PsDecay objects with and without histograms!"));
+    if(!fHistograms_)
+        return;
+    if(fH_12_.Get()) fH_12_->Add(est.fH_12_.Get());
+    if(fH_23_.Get()) fH_23_->Add(est.fH_23_.Get());
+    if(fH_31_.Get()) fH_31_->Add(est.fH_31_.Get());
+    if(fH_12_23_.Get()) fH_12_23_->Add(est.fH_12_23_.Get());
+    if(fH_12_31_.Get()) fH_12_31_->Add(est.fH_12_31_.Get());
+    if(fH_23_31_.Get()) fH_23_31_->Add(est.fH_23_31_.Get());
+    if(fH_min_mid_.Get()) fH_min_mid_->Add(est.fH_min_mid_.Get());
+    if(fH_min_max_.Get()) fH_min_max_->Add(est.fH_min_max_.Get());
+    if(fH_mid_max_.Get()) fH_mid_max_->Add(est.fH_mid_max_.Get());
+    fH_en_->Add(est.fH_en_.Get());
+    fH_p_->Add(est.fH_p_.Get());
+    fH_phi_->Add(est.fH_phi_.Get());
+    fH_cosTheta_->Add(est.fH_cosTheta_.Get());
 }
 
 ///
@@ -317,6 +332,8 @@ PsDecay::~PsDecay()
 ///
 void PsDecay::AddEvent(const Event* event) const
 {
+    if(!fHistograms_)
+        return;
     bool thirdGammaExists = false; //check if 3rd pointer !=nullptr
     for(int ii=0; ii<event->GetNumberOfDecayProducts(); ii++)
     {
@@ -324,45 +341,112 @@ void PsDecay::AddEvent(const Event* event) const
         {
             //filling histograms for all gammas
             if(ii==2) {thirdGammaExists = true;}
-            fH_en_->Fill(event->GetFourMomentumOf(ii)->Energy());
-            fH_p_->Fill(event->GetFourMomentumOf(ii)->P());
-            fH_phi_->Fill(event->GetFourMomentumOf(ii)->Phi());
-            fH_cosTheta_->Fill(event->GetFourMomentumOf(ii)->CosTheta());
+            fH_en_.Fill(event->GetFourMomentumOf(ii)->Energy());
+            fH_p_.Fill(event->GetFourMomentumOf(ii)->P());
+            fH_phi_.Fill(event->GetFourMomentumOf(ii)->Phi());
+            fH_cosTheta_.Fill(event->GetFourMomentumOf(ii)->CosTheta());
         }
     }
     if(fDecayType_==TWO || fDecayType_==TWOandONE || fDecayType_==TWOandN)
     {
-        fH_12_->Fill(event->GetFourMomentumOf(0)->Angle((event->GetFourMomentumOf(1))->Vect()), event->GetWeight());
+        fH_12_.Fill(event->GetFourMomentumOf(0)->Angle((event->GetFourMomentumOf(1))->Vect()), event->GetWeight());
     }
 
     if((fDecayType_==TWOandONE) & thirdGammaExists)
     {
-        fH_23_->Fill(event->GetFourMomentumOf(1)->Angle((event->GetFourMomentumOf(2))->Vect()), event->GetWeight());
-        fH_31_->Fill(event->GetFourMomentumOf(2)->Angle((event->GetFourMomentumOf(0))->Vect()), event->GetWeight());
+        fH_23_.Fill(event->GetFourMomentumOf(1)->Angle((event->GetFourMomentumOf(2))->Vect()), event->GetWeight());
+        fH_31_.Fill(event->GetFourMomentumOf(2)->Angle((event->GetFourMomentumOf(0))->Vect()), event->GetWeight());
     }
     else if(fDecayType_==THREE)
     {
         double theta12 = event->GetFourMomentumOf(0)->Angle(event->GetFourMomentumOf(1)->Vect());
         double theta23 = event->GetFourMomentumOf(1)->Angle(event->GetFourMomentumOf(2)->Vect());
         double theta31 = event->GetFourMomentumOf(2)->Angle(event->GetFourMomentumOf(0)->Vect());
-        fH_12_23_->Fill(theta12, theta23, event->GetWeight());
-        fH_12_31_->Fill(theta12, theta31, event->GetWeight());
-        fH_23_31_->Fill(theta23, theta31, event->GetWeight());
-        //sorting the angles
-        double thetas[3] = {theta12, theta23, theta31};
-        unsigned indMin = 0;
-        unsigned indMid = 0;
-        unsigned indMax = 0;
-        for(int ii=0; ii<3; ii++)
+        FillThreeGammaAngles_(theta12, theta23, theta31, event->GetWeight());
+   }
+}
+
+///
+/// \brief PsDecay::AddEvents Fills the histograms with all events of a batch, the same as AddEvent called for each event.
+/// \tparam kType Type of decays, the same as the type of this instance.
+/// \param batch Batch of events generated for the decay type of this instance.
+///
+template<DecayType kType>
+void PsDecay::AddEvents(const EventBatch& batch) const
+{
+    if(!fHistograms_)
+        return;
+    //histograms are filled in the same order as by AddEvent
+    for(int jj=0; jj<batch.GetSize(); jj++)
+    {
+        for(int ii=0; ii<batch.GetNumberOfDecayProducts<kType>(jj); ii++)
         {
-            indMin = thetas[ii] < thetas[indMin] ? ii : indMin;
-            indMax = thetas[ii] > thetas[indMin] ? ii : indMax;
+            fH_en_.Fill(batch.fE[batch.Index(ii, jj)]);
+            fH_p_.Fill(batch.GetMomentum(ii, jj));
+            fH_phi_.Fill(batch.GetPhi(ii, jj));
+            fH_cosTheta_.Fill(batch.GetCosTheta(ii, jj));
         }
-        indMid = indMax==indMin ? indMax : 3-indMax-indMin;
-        fH_min_max_->Fill(thetas[indMin], thetas[indMax], event->GetWeight());
-        fH_min_mid_->Fill(thetas[indMin], thetas[indMid], event->GetWeight());
-        fH_mid_max_->Fill(thetas[indMid], thetas[indMax], event->GetWeight());
-   }
+        if(kType==TWO || kType==TWOandONE || kType==TWOandN)
+            fH_12_.Fill(batch.GetAngle(0, 1, jj), batch.fWeight[jj]);
+        if(kType==TWOandONE && batch.GetNumberOfDecayProducts(jj)>2)
+        {
+            fH_23_.Fill(batch.GetAngle(1, 2, jj), batch.fWeight[jj]);
+            fH_31_.Fill(batch.GetAngle(2, 0, jj), batch.fWeight[jj]);
+        }
+        else if(kType==THREE)
+            FillThreeGammaAngles_(batch.GetAngle(0, 1, jj), batch.GetAngle(1, 2, jj), batch.GetAngle(2, 0, jj), batch.fWeight[jj]);
+    }
+}
+
+template void PsDecay::AddEvents<ONE>(const EventBatch& batch) const;
+template void PsDecay::AddEvents<TWO>(const EventBatch& batch) const;
+template void PsDecay::AddEvents<THREE>(const EventBatch& batch) const;
+template void PsDecay::AddEvents<TWOandONE>(const EventBatch& batch) const;
+template void PsDecay::AddEvents<TWOandN>(const EventBatch& batch) const;
+
+///
+/// \brief PsDecay::AddEvents Fills the histograms with all events of a batch, the decay type is dispatched at run time.
+/// \param batch Batch of events generated for the decay type of this instance.
+///
+void PsDecay::AddEvents(const EventBatch& batch) const
+{
+    switch(fDecayType_)
+    {
+        case ONE: AddEvents<ONE>(batch); break;
+        case TWO: AddEvents<TWO>(batch); break;
+        case THREE: AddEvents<THREE>(batch); break;
+        case TWOandONE: AddEvents<TWOandONE>(batch); break;
+        case TWOandN: AddEvents<TWOandN>(batch); break;
+        default: break;
+    }
+}
+
+///
+/// \brief PsDecay::FillThreeGammaAngles_ Fills histograms of relative angles for a 3-gamma decay.
+/// \param theta12 Angle between the first and the second gamma.
+/// \param theta23 Angle between the second and the third gamma.
+/// \param theta31 Angle between the third and the first gamma.
+/// \param weight Weight of the event.
+///
+void PsDecay::FillThreeGammaAngles_(double theta12, double theta23, double theta31, double weight) const
+{
+    fH_12_23_.Fill(theta12, theta23, weight);
+    fH_12_31_.Fill(theta12, theta31, weight);
+    fH_23_31_.Fill(theta23, theta31, weight);
+    //sorting the angles
+    double thetas[3] = {theta12, theta23, theta31};
+    unsigned indMin = 0;
+    unsigned indMid = 0;
+    unsigned indMax = 0;
+    for(int ii=0; ii<3; ii++)
+    {
+        indMin = thetas[ii] < thetas[indMin] ? ii : indMin;
+        indMax = thetas[ii] > thetas[indMin] ? ii : indMax;
+    }
+    indMid = indMax==indMin ? indMax : 3-indMax-indMin;
+    fH_min_max_.Fill(thetas[indMin], thetas[indMax], weight);
+    fH_min_mid_.Fill(thetas[indMin], thetas[indMid], weight);
+    fH_mid_max_.Fill(thetas[indMid], thetas[indMax], weight);
 }
 
 ///
@@ -372,6 +456,8 @@ void PsDecay::AddEvent(const Event* event) const
 ///
 void PsDecay::DrawHistograms(std::string prefix, OutputOptions output)
 {
+    if(!fHistograms_)
+        return;
     std::string outFile1;
     std::string outFile2;
     std::string outFile3;
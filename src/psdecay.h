@@ -13,8 +13,10 @@
 #include "TImage.h"
 #include "TTree.h"
 #include "event.h"
+#include "eventbatch.h"
 #include "comptonscattering.h"
 #include "parammanager.h"
+#include "histogramaccumulator.h"
 
 class TwoAndNTestFixture; //for testing
 
@@ -24,39 +26,49 @@ class TwoAndNTestFixture; //for testing
 class PsDecay
 {
     public:
-        PsDecay(DecayType type=TWO);
+        PsDecay(DecayType type=TWO, bool histograms=true);
         PsDecay(const PsDecay&);
         PsDecay& operator=(const PsDecay& est);
         ~PsDecay();
         void AddEvent(const Event* event) const;
+        void AddEvents(const EventBatch& batch) const;
+        template<DecayType kType> void AddEvents(const EventBatch& batch) const;
+        void Merge(const PsDecay& est); //adds histograms of another instance (e.g. filled by a worker thread)
         void DrawHistograms(std::string prefix="RM", OutputOptions output=PNG);
 
         //silent mode switch on/off
         inline void EnableSilentMode(){fSilentMode_=true;}
         inline void DisableSilentMode(){fSilentMode_=false;}
+        inline bool HasHistograms() const {return fHistograms_;}
     private:
         //if set to true, no output is generated to std::cout
         bool fSilentMode_; //false by default
+        //if set to false, histograms are neither created nor filled
+        bool fHistograms_; //true by default
 
         DecayType fDecayType_;
         std::string fTypeString_;
 
         // histograms with relative angles for all events generated
-        TH1F* fH_12_; //used when TWO or TWOandONE
-        TH1F* fH_23_; //used only when TWOandONE
-        TH1F* fH_31_; //used only when TWOandONE
-        TH2F* fH_12_23_; //used only when THREE
-        TH2F* fH_12_31_; //used only when TWOandONE
-        TH2F* fH_23_31_; //used only when TWOandONE
-        TH2F* fH_min_mid_; //used only when TWOandONE
-        TH2F* fH_min_max_; //used only when TWOandONE
-        TH2F* fH_mid_max_; //used only when TWOandONE
+        HistogramAccumulator<TH1F> fH_12_; //used when TWO or TWOandONE
+        HistogramAccumulator<TH1F> fH_23_; //used only when TWOandONE
+        HistogramAccumulator<TH1F> fH_31_; //used only when TWOandONE
+        HistogramAccumulator<TH2F> fH_12_23_; //used only when THREE
+        HistogramAccumulator<TH2F> fH_12_31_; //used only when TWOandONE
+        HistogramAccumulator<TH2F> fH_23_31_; //used only when TWOandONE
+        HistogramAccumulator<TH2F> fH_min_mid_; //used only when TWOandONE
+        HistogramAccumulator<TH2F> fH_min_max_; //used only when TWOandONE
+        HistogramAccumulator<TH2F> fH_mid_max_; //used only when TWOandONE
 
         // histograms with distributions of basic quantities for all events generated
-        TH1F* fH_en_;
-        TH1F* fH_p_;
-        TH1F* fH_phi_;
-        TH1F* fH_cosTheta_;
+        HistogramAccumulator<TH1F> fH_en_;
+        HistogramAccumulator<TH1F> fH_p_;
+        HistogramAccumulator<TH1F> fH_phi_;
+        HistogramAccumulator<TH1F> fH_cosTheta_;
+
+        void CreateHistograms_();
+        void CopyHistograms_(const PsDecay& est);
+        void FillThreeGammaAngles_(double theta12, double theta23, double theta31, double weight) const;
 
         friend class TwoAndNTestFixture; // for testing
 
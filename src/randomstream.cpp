@@ -0,0 +1,163 @@
+/// @file randomstream.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <random>
+#include "randomstream.h"
+
+///
+/// \brief splitMix64 SplitMix64 mixing function, used to derive keys of streams.
+/// \param z Value to be mixed.
+/// \return Mixed value.
+///
+static unsigned long long splitMix64(unsigned long long z)
+{
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+///
+/// \brief RandomStream::RandomStream Basic constructor.
+/// \param seed Seed of the generator, 0 means that a random seed is drawn (as in TRandom3).
+///
+RandomStream::RandomStream(unsigned seed) :
+    TRandom(seed)
+{
+    SetSeed(seed);
+}
+
+///
+/// \brief RandomStream::DeriveKey Derives the key of a stream.
+/// \param seed Global seed of the simulation.
+/// \param run Number of the run.
+/// \param type Type of simulated decays.
+/// \param stage Stage of the simulation which uses the stream.
+/// \return Key of the stream.
+///
+unsigned long long RandomStream::DeriveKey(unsigned seed, int run, DecayType type, Stage stage)
+{
+    unsigned long long z = splitMix64(seed);
+    z = splitMix64(z ^ static_cast<unsigned long long>(run));
+    z = splitMix64(z ^ static_cast<unsigned long long>(type));
+    return splitMix64(z ^ static_cast<unsigned long long>(stage));
+}
+
+///
+/// \brief RandomStream::SetStream Selects the stream and its substream, next number is the first one of the substream.
+/// \param key Key of the stream, see DeriveKey.
+/// \param index Index of the substream.
+///
+void RandomStream::SetStream(unsigned long long key, unsigned long long index)
+{
+    fKey_ = key;
+    fIndex_ = index;
+    fCounter_ = 0;
+    fPosition_ = 4;
+}
+
+///
+/// \brief RandomStream::SetSeed Sets the stream derived only from the seed (run 0, no decay type, GENERATION stage).
+/// \param seed Seed of the generator, 0 means that a random seed is drawn.
+///
+void RandomStream::SetSeed(ULong_t seed)
+{
+    if(seed==0)
+    {
+        std::random_device device;
+        while(seed==0)
+            seed = device();
+    }
+    fSeed_ = static_cast<unsigned>(seed);
+    SetStream(DeriveKey(fSeed_));
+}
+
+///
+/// \brief RandomStream::GetSeed Returns the seed passed to the constructor or SetSeed.
+/// \return Seed of the generator.
+///
+UInt_t RandomStream::GetSeed() const
+{
+    return fSeed_;
+}
+
+///
+/// \brief RandomStream::NextBlock_ Fills the buffer with the next block of Philox4x32-10 output.
+///
+void RandomStream::NextBlock_()
+{
+    const unsigned long long M0 = 0xD2511F53ULL;
+    const unsigned long long M1 = 0xCD9E8D57ULL;
+    unsigned c0 = static_cast<unsigned>(fCounter_);
+    unsigned c1 = static_cast<unsigned>(fCounter_ >> 32);
+    unsigned c2 = static_cast<unsigned>(fIndex_);
+    unsigned c3 = static_cast<unsigned>(fIndex_ >> 32);
+    unsigned k0 = static_cast<unsigned>(fKey_);
+    unsigned k1 = static_cast<unsigned>(fKey_ >> 32);
+    for(int round=0; round<10; round++)
+    {
+        unsigned long long p0 = M0*c0;
+        unsigned long long p1 = M1*c2;
+        unsigned hi0 = static_cast<unsigned>(p0 >> 32);
+        unsigned lo0 = static_cast<unsigned>(p0);
+        unsigned hi1 = static_cast<unsigned>(p1 >> 32);
+        unsigned lo1 = static_cast<unsigned>(p1);
+        c0 = hi1^c1^k0;
+        c1 = lo1;
+        c2 = hi0^c3^k1;
+        c3 = lo0;
+        k0 += 0x9E3779B9U;
+        k1 += 0xBB67AE85U;
+    }
+    fBuffer_[0] = c0;
+    fBuffer_[1] = c1;
+    fBuffer_[2] = c2;
+    fBuffer_[3] = c3;
+    fPosition_ = 0;
+    fCounter_++;
+}
+
+///
+/// \brief RandomStream::NextWord_ Returns the next 32-bit word of the current substream.
+/// \return Random 32-bit word.
+///
+unsigned RandomStream::NextWord_()
+{
+    if(fPosition_>=4)
+        NextBlock_();
+    return fBuffer_[fPosition_++];
+}
+
+///
+/// \brief RandomStream::Rndm Returns a uniformly distributed number from (0,1) with 53 random bits.
+/// \return Random number.
+///
+Double_t RandomStream::Rndm()
+{
+    unsigned long long hi = NextWord_();
+    unsigned long long lo = NextWord_();
+    unsigned long long bits = ((hi << 32) | lo) >> 11;
+    return (bits + 0.5) * (1.0/9007199254740992.0);
+}
+
+///
+/// \brief RandomStream::RndmArray Fills an array with uniformly distributed numbers from (0,1).
+/// \param n Size of the array.
+/// \param array Array to be filled.
+///
+void RandomStream::RndmArray(Int_t n, Float_t* array)
+{
+    for(int ii=0; ii<n; ii++)
+        array[ii] = static_cast<Float_t>(Rndm());
+}
+
+///
+/// \brief RandomStream::RndmArray Fills an array with uniformly distributed numbers from (0,1).
+/// \param n Size of the array.
+/// \param array Array to be filled.
+///
+void RandomStream::RndmArray(Int_t n, Double_t* array)
+{
+    for(int ii=0; ii<n; ii++)
+        array[ii] = Rndm();
+}
@@ -0,0 +1,51 @@
+/// @file randomstream.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef RANDOMSTREAM_H
+#define RANDOMSTREAM_H
+#include "TRandom.h"
+#include "event.h"
+
+///
+/// \brief The RandomStream class Counter-based (Philox4x32-10) random number generator with independent substreams.
+///
+/// A stream is identified by a 64-bit key derived from the global seed, the run number, the decay type and the stage
+/// of the simulation which uses it. Every stream is split into substreams selected by an index (the number of event
+/// in the run), so any event can be simulated in any order, by any thread, and always gets the same random numbers.
+/// The class derives from TRandom, so Uniform, Gaus etc. are available as usual.
+///
+class RandomStream : public TRandom
+{
+    public:
+        ///
+        /// \brief The Stage enum Stages of the simulation, every stage draws from its own stream.
+        ///
+        enum Stage {GENERATION=0, PHANTOM, CUTS, COMPTON, ACCEPTANCE};
+
+        RandomStream(unsigned seed=0);
+        virtual ~RandomStream() {}
+        void SetStream(unsigned long long key, unsigned long long index=0);
+        inline void SetSubstream(unsigned long long index) {SetStream(fKey_, index);}
+        inline unsigned long long GetKey() const {return fKey_;}
+        inline unsigned long long GetSubstream() const {return fIndex_;}
+        virtual Double_t Rndm();
+        virtual void RndmArray(Int_t n, Float_t* array);
+        virtual void RndmArray(Int_t n, Double_t* array);
+        virtual void SetSeed(ULong_t seed=0);
+        virtual UInt_t GetSeed() const;
+
+        static unsigned long long DeriveKey(unsigned seed, int run=0, DecayType type=WRONG, Stage stage=GENERATION);
+
+    private:
+        unsigned fSeed_; //seed from which the key was derived
+        unsigned long long fKey_; //key of the stream
+        unsigned long long fIndex_; //index of the current substream
+        unsigned long long fCounter_; //number of Philox blocks already used in the current substream
+        unsigned fBuffer_[4]; //output of the last Philox block
+        int fPosition_; //number of words of the buffer already used
+
+        void NextBlock_();
+        unsigned NextWord_();
+};
+
+#endif // RANDOMSTREAM_H
@@ -0,0 +1,150 @@
+/// @file rootwriter.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include "rootwriter.h"
+
+///
+/// \brief RootWriter::RootWriter The only constructor used.
+/// \param useThread If true, tasks are executed by a dedicated writer thread, otherwise by the calling thread.
+///
+RootWriter::RootWriter(bool useThread) :
+    fStop_(false),
+    fFailed_(false)
+{
+    if(useThread)
+        fThread_ = std::thread(&RootWriter::Loop_, this);
+}
+
+///
+/// \brief RootWriter::~RootWriter Finishes queued tasks and joins the writer thread.
+/// Errors of posted tasks are not reported here, see Close.
+///
+RootWriter::~RootWriter()
+{
+    Stop_();
+}
+
+///
+/// \brief RootWriter::Close Finishes queued tasks and joins the writer thread. Later tasks are executed by the calling thread.
+/// The first exception of a posted task which was not rethrown by Execute is rethrown here.
+///
+void RootWriter::Close()
+{
+    Stop_();
+    RethrowPostedError_();
+}
+
+///
+/// \brief RootWriter::HasFailed Checks if any posted task threw an exception, e.g. so that a run is not marked as completed.
+/// \return True if a posted task failed.
+///
+bool RootWriter::HasFailed() const
+{
+    std::lock_guard<std::mutex> lock(fMutex_);
+    return fFailed_;
+}
+
+///
+/// \brief RootWriter::Execute Executes the task in the writer thread and waits for its completion.
+/// Exceptions thrown by the task are rethrown in the calling thread.
+/// \param task Operation on the output file.
+///
+void RootWriter::Execute(const std::function<void()>& task)
+{
+    if(!fThread_.joinable())
+    {
+        task();
+        return;
+    }
+    std::packaged_task<void()> packagedTask(task);
+    std::future<void> result = packagedTask.get_future();
+    {
+        std::lock_guard<std::mutex> lock(fMutex_);
+        fTasks_.push_back(std::move(packagedTask));
+    }
+    fCondition_.notify_one();
+    result.get();
+    RethrowPostedError_();
+}
+
+///
+/// \brief RootWriter::Post Queues the task for the writer thread without waiting for its completion.
+/// Tasks are executed in the order of submission, also with respect to tasks passed to Execute.
+/// \param task Operation on the output file. Its exception is kept and rethrown by the next Execute or by Close.
+///
+void RootWriter::Post(const std::function<void()>& task)
+{
+    if(!fThread_.joinable())
+    {
+        task();
+        return;
+    }
+    std::packaged_task<void()> packagedTask([this, task]()
+    {
+        try
+        {
+            task();
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(fMutex_);
+            if(!fError_ && !fFailed_)
+                fError_ = std::current_exception();
+            fFailed_ = true;
+        }
+    });
+    {
+        std::lock_guard<std::mutex> lock(fMutex_);
+        fTasks_.push_back(std::move(packagedTask));
+    }
+    fCondition_.notify_one();
+}
+
+///
+/// \brief RootWriter::Loop_ Main loop of the writer thread, tasks are executed in the order of submission.
+///
+void RootWriter::Loop_()
+{
+    while(true)
+    {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(fMutex_);
+            fCondition_.wait(lock, [this]{return fStop_ || !fTasks_.empty();});
+            if(fTasks_.empty())
+                return;
+            task = std::move(fTasks_.front());
+            fTasks_.pop_front();
+        }
+        task();
+    }
+}
+
+///
+/// \brief RootWriter::Stop_ Finishes queued tasks and joins the writer thread, if it is running.
+///
+void RootWriter::Stop_()
+{
+    if(!fThread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(fMutex_);
+        fStop_ = true;
+    }
+    fCondition_.notify_one();
+    fThread_.join();
+}
+
+///
+/// \brief RootWriter::RethrowPostedError_ Rethrows the kept exception of a posted task, only once.
+///
+void RootWriter::RethrowPostedError_()
+{
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(fMutex_);
+        std::swap(error, fError_);
+    }
+    if(error)
+        std::rethrow_exception(error);
+}
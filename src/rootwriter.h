@@ -0,0 +1,52 @@
+/// @file rootwriter.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef ROOTWRITER_H
+#define ROOTWRITER_H
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+///
+/// \brief The RootWriter class Executes all operations on the output file (and ROOT graphics) in one thread.
+///
+/// Runs simulated concurrently pass their writes (creating directories, filling and writing trees, drawing histograms)
+/// to Execute, which queues them for the writer thread and waits until they are done. Hence the TFile is used by one
+/// thread only, while the simulation of other runs continues. Tasks passed to Post are queued without waiting (e.g. filling
+/// trees, see TreeFiller). If the writer is created without a thread, tasks are executed directly by the calling thread.
+/// The first exception thrown by a posted task is kept and rethrown by the next Execute or by Close, HasFailed tells
+/// the following tasks that an earlier one failed.
+///
+class RootWriter
+{
+    public:
+        explicit RootWriter(bool useThread);
+        RootWriter(const RootWriter&) = delete;
+        RootWriter& operator=(const RootWriter&) = delete;
+        ~RootWriter();
+
+        void Execute(const std::function<void()>& task);
+        void Post(const std::function<void()>& task);
+        void Close();
+        bool HasFailed() const;
+        inline bool IsThreaded() const {return fThread_.joinable();}
+
+    private:
+        std::thread fThread_; //the writer thread
+        mutable std::mutex fMutex_; //protects the queue and errors
+        std::condition_variable fCondition_; //notifies the writer thread about new tasks
+        std::deque<std::packaged_task<void()> > fTasks_; //tasks waiting for execution
+        bool fStop_; //set by the destructor to finish the writer thread
+        std::exception_ptr fError_; //first exception thrown by a posted task, not rethrown yet
+        bool fFailed_; //true if any posted task threw an exception
+
+        void Loop_();
+        void Stop_();
+        void RethrowPostedError_();
+};
+
+#endif // ROOTWRITER_H
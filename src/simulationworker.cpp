@@ -0,0 +1,284 @@
+/// @file simulationworker.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include "particlegenerator.h"
+#include "simulationworker.h"
+
+///
+/// \brief SimulationWorker::SimulationWorker The only constructor used. All ROOT objects are created here, so it should be
+/// called from the main thread. Histograms are created only if they are enabled (see ParamManager::AreHistogramsEnabled)
+/// and the scattering engine of the phantom only if the phantom is used.
+/// \param Ps Fourmomentum of the source [GeV].
+/// \param source Fourvector with the position of the source, fourth coordinate represents radius of the source ball [mm].
+/// \param pManag ParamManager reference containing parameters of the simulation.
+/// \param type Type of simulated decays.
+/// \param simRun Number of the current run.
+/// \param storeEvents If true, events are kept after processing to be written to the tree.
+///
+SimulationWorker::SimulationWorker(const TLorentzVector& Ps, const TLorentzVector& source, const ParamManager& pManag, DecayType type, int simRun, bool storeEvents) :
+    fParams_(pManag),
+    fSource_(source),
+    fDecayType_(type),
+    fSimRun_(simRun),
+    fStoreEvents_(storeEvents),
+    fEventIdOffset_(0),
+    fPhaseSpaceGen_(kBlockSize),
+    fGenerationRandom_(pManag.GetSeed()),
+    fPhantomRandom_(pManag.GetSeed()),
+    fCutsRandom_(pManag.GetSeed()),
+    fComptonRandom_(pManag.GetSeed()),
+    fAcceptanceRandom_(pManag.GetSeed()),
+    fAcceptance_(pManag.GetR(), pManag.GetL()),
+    fDecay_(type, pManag.AreHistogramsEnabled()),
+    fPhantom_(pManag.GetPhantomNaive511Prob(), pManag.GetPhantomNaivePromptProb(), pManag.GetPhantomSmear(), pManag.GetPhantomUse() ? type : WRONG),
+    fCuts_(type, pManag.GetR(), pManag.GetL(), pManag.GetEff(), pManag.AreHistogramsEnabled()),
+    fCompton_(type, pManag.GetSmearLowLimit(), pManag.GetSmearHighLimit(), pManag.AreHistogramsEnabled()),
+    fNoOfStoredEvents_(0),
+    fMaxDecayProducts_(MaxDecayProducts_(type, pManag)),
+    fBatch_(type, kBlockSize, fMaxDecayProducts_),
+    fProcessBlock_(nullptr)
+{
+    unsigned seed = fGenerationRandom_.GetSeed();
+    fGenerationRandom_.SetStream(RandomStream::DeriveKey(seed, simRun, type, RandomStream::GENERATION));
+    fPhantomRandom_.SetStream(RandomStream::DeriveKey(seed, simRun, type, RandomStream::PHANTOM));
+    fCutsRandom_.SetStream(RandomStream::DeriveKey(seed, simRun, type, RandomStream::CUTS));
+    fComptonRandom_.SetStream(RandomStream::DeriveKey(seed, simRun, type, RandomStream::COMPTON));
+    fAcceptanceRandom_.SetStream(RandomStream::DeriveKey(seed, simRun, type, RandomStream::ACCEPTANCE));
+    int noOfGammas = 0;
+    recognizeType(type, noOfGammas);
+    //photons are massless (Momentum, Energy units are Gev/C, GeV)
+    if(noOfGammas>1)
+        fPhaseSpaceGen_.SetDecay(Ps, noOfGammas);
+    //the decay type is dispatched once, all stages of ProcessBlock_ are specialized for it
+    switch(type)
+    {
+        case ONE: fProcessBlock_ = &SimulationWorker::ProcessBlock_<ONE>; break;
+        case TWO: fProcessBlock_ = &SimulationWorker::ProcessBlock_<TWO>; break;
+        case THREE: fProcessBlock_ = &SimulationWorker::ProcessBlock_<THREE>; break;
+        case TWOandONE: fProcessBlock_ = &SimulationWorker::ProcessBlock_<TWOandONE>; break;
+        case TWOandN: fProcessBlock_ = &SimulationWorker::ProcessBlock_<TWOandN>; break;
+        default: throw(std::string("[ERROR] Wrong decay type of SimulationWorker!"));
+    }
+    fPhantom_.SetComptonSamplingMethod(pManag.GetComptonSampling());
+    fCompton_.SetSamplingMethod(pManag.GetComptonSampling());
+    if(pManag.IsSilentMode())
+    {
+        fDecay_.EnableSilentMode();
+        fCuts_.EnableSilentMode();
+        fCompton_.EnableSilentMode();
+    }
+}
+
+///
+/// \brief SimulationWorker::~SimulationWorker Releases the pool of events.
+///
+SimulationWorker::~SimulationWorker()
+{
+    for(std::vector<Event*>::iterator it = fEventPool_.begin(); it != fEventPool_.end(); ++it)
+        delete *it;
+}
+
+///
+/// \brief SimulationWorker::GetNumberOfBlocks Calculates in how many blocks events of a run are simulated.
+/// \param events Number of events in the run.
+/// \return Number of blocks.
+///
+long SimulationWorker::GetNumberOfBlocks(long events)
+{
+    return (events + kBlockSize - 1)/kBlockSize;
+}
+
+///
+/// \brief SimulationWorker::GetShardBlocks Calculates which blocks of a run are simulated by a shard (one of processes sharing the run).
+/// Shards simulate contiguous, disjoint ranges of blocks, so their trees concatenated in the order of shards are identical
+/// to the tree of a single process: events are simulated with the same random number substreams and get the same ids.
+/// \param events Number of events in the run.
+/// \param shardIndex Index of the shard, from 0 to shardCount-1.
+/// \param shardCount Number of shards.
+/// \param firstBlock Index of the first block simulated by the shard.
+/// \param lastBlock Index of the block after the last one simulated by the shard.
+///
+void SimulationWorker::GetShardBlocks(long events, int shardIndex, int shardCount, long& firstBlock, long& lastBlock)
+{
+    long noOfBlocks = GetNumberOfBlocks(events);
+    firstBlock = noOfBlocks*shardIndex/shardCount;
+    lastBlock = noOfBlocks*(shardIndex+1)/shardCount;
+}
+
+///
+/// \brief SimulationWorker::GetEventIdOffset Calculates the offset of ids of events simulated in a run. Ids are derived only
+/// from the run, decay type, block and index of the event in the block (see GetEventId), so they are the same in every
+/// execution with the same parameters, regardless of threads and shards, and unique within the output file.
+/// \param simRun Number of the run.
+/// \param events Number of events of every decay type in a run.
+/// \param decayTypesInRun Number of decay types simulated in a run (two if 2 and 3-gamma decays are mixed).
+/// \param decayTypeIndex Index of the simulated decay type among types of the run.
+/// \return Offset of ids, the first event of the run and decay type gets id equal to offset+1.
+///
+long SimulationWorker::GetEventIdOffset(int simRun, long events, int decayTypesInRun, int decayTypeIndex)
+{
+    return (static_cast<long>(simRun)*decayTypesInRun+decayTypeIndex)*events;
+}
+
+///
+/// \brief SimulationWorker::MaxDecayProducts_ Calculates the highest possible number of photons in an event.
+/// \param type Type of simulated decays.
+/// \param pManag ParamManager reference containing parameters of the simulation.
+/// \return Maximal number of photons.
+///
+int SimulationWorker::MaxDecayProducts_(DecayType type, const ParamManager& pManag)
+{
+    int noOfGammas = 0;
+    recognizeType(type, noOfGammas);
+    int maxDecayProducts = type==TWOandONE ? noOfGammas+1 : noOfGammas; //noOfGammas does not include deexcitation photons
+    if(type==TWOandN)
+    {
+        //only one decay branch is realized in an event
+        int maxBranchSize = 0;
+        for(int ii=0; ii<pManag.GetNumberOfDecayBranches(); ii++)
+            maxBranchSize = pManag.GetBranchSize(ii) > maxBranchSize ? pManag.GetBranchSize(ii) : maxBranchSize;
+        maxDecayProducts += maxBranchSize;
+    }
+    return maxDecayProducts;
+}
+
+///
+/// \brief SimulationWorker::IsToBeStored_ Checks if the event is of the type selected to be saved in the tree.
+/// \param passFlag Pass flag of the processed event.
+/// \return True if the event should be written to the tree.
+///
+bool SimulationWorker::IsToBeStored_(bool passFlag) const
+{
+    return (fParams_.GetEventTypeToSave()==PASS && passFlag) || (fParams_.GetEventTypeToSave()==FAIL && !passFlag)\
+            || (fParams_.GetEventTypeToSave()==ALL);
+}
+
+///
+/// \brief SimulationWorker::ProcessBlock_ Simulates one block of events with stages specialized for the decay type.
+/// \tparam kType Type of simulated decays.
+/// \param block Index of the block, events from block*kBlockSize up to (block+1)*kBlockSize-1 are simulated.
+///
+template<DecayType kType>
+void SimulationWorker::ProcessBlock_(long block)
+{
+    long firstEvent = block*kBlockSize;
+    long lastEvent = firstEvent+kBlockSize < fParams_.GetSimEvents() ? firstEvent+kBlockSize : fParams_.GetSimEvents();
+    int noOfEvents = 0; //number of generated events, some of them may be removed before storage
+    try
+    {
+        //every stage switches its stream to the substream of each event, so the events do not depend on the order of stages
+        {
+            PROFILE_STAGE(fProfiler_, StageProfiler::GENERATION);
+            generateEvents<kType>(fBatch_, firstEvent, lastEvent-firstEvent, fPhaseSpaceGen_, fSource_, fParams_, &fGenerationRandom_);
+            //the first photon is turned towards the barrel and the weight of the event is corrected
+            if(fParams_.IsAcceptanceSampling())
+                fAcceptance_.Sample<kType>(fBatch_, &fAcceptanceRandom_);
+            noOfEvents = fBatch_.GetSize();
+        }
+        //Removing events that cannot pass cuts, so the following stages are applied only to events that will be saved
+        if(fParams_.IsEarlyRejectActive())
+        {
+            PROFILE_STAGE(fProfiler_, StageProfiler::CUTS);
+            fCuts_.RejectMissed<kType>(fBatch_, &fCutsRandom_);
+        }
+        //Getting initial distributions, this stage only fills histograms
+        if(fDecay_.HasHistograms())
+        {
+            PROFILE_STAGE(fProfiler_, StageProfiler::DECAY);
+            fDecay_.AddEvents<kType>(fBatch_);
+        }
+        //Aplying Compton scattering in phantom
+        if(fParams_.GetPhantomUse())
+        {
+            PROFILE_STAGE(fProfiler_, StageProfiler::PHANTOM);
+            fPhantom_.NaiveScatter<kType>(fBatch_, &fPhantomRandom_);
+        }
+        //Applying cuts
+        {
+            PROFILE_STAGE(fProfiler_, StageProfiler::CUTS);
+            fCuts_.AddCuts<kType>(fBatch_, &fCutsRandom_);
+        }
+        //Performing the Compton Scattering
+        {
+            PROFILE_STAGE(fProfiler_, StageProfiler::COMPTON);
+            fCompton_.Scatter<kType>(fBatch_, &fComptonRandom_);
+        }
+    }
+    catch(...)
+    {
+        //kept for the thread that owns the worker, see RethrowError
+        fError_ = std::current_exception();
+        return;
+    }
+    fProfiler_.AddEvents(noOfEvents);
+    if(!fStoreEvents_)
+        return;
+    PROFILE_STAGE(fProfiler_, StageProfiler::STORAGE);
+    //we select what kind of events will be saved to the tree, only they are converted to Event objects
+    for(int ii=0; ii<fBatch_.GetSize(); ii++)
+    {
+        if(!IsToBeStored_(fBatch_.fPassFlag[ii]))
+            continue;
+        if(fNoOfStoredEvents_ == static_cast<long>(fEventPool_.size()))
+            fEventPool_.push_back(new Event(fDecayType_, fMaxDecayProducts_));
+        Event* eventDecay = fEventPool_[fNoOfStoredEvents_++];
+        fBatch_.CopyToEvent(ii, *eventDecay);
+        eventDecay->fId = GetEventId(fEventIdOffset_, block, fBatch_.fIndexInBlock[ii]);
+    }
+}
+
+///
+/// \brief SimulationWorker::ProcessBlock Simulates one block of events. Can be called from a worker thread.
+/// An error of the simulation does not stop the thread, it is kept and rethrown by RethrowError; further blocks are skipped.
+/// \param block Index of the block, events from block*kBlockSize up to (block+1)*kBlockSize-1 are simulated.
+///
+void SimulationWorker::ProcessBlock(long block)
+{
+    if(!fError_)
+        (this->*fProcessBlock_)(block);
+}
+
+///
+/// \brief SimulationWorker::RethrowError Throws the error kept by ProcessBlock, if any. Called after the worker thread is joined.
+///
+void SimulationWorker::RethrowError() const
+{
+    if(fError_)
+        std::rethrow_exception(fError_);
+}
+
+///
+/// \brief SimulationWorker::ClearStoredEvents Marks events kept after processing of the last block as free, so they are reused.
+///
+void SimulationWorker::ClearStoredEvents()
+{
+    fNoOfStoredEvents_ = 0;
+}
+
+///
+/// \brief SimulationWorker::ExchangeStoredEvent Takes a stored event out of the pool and puts another event in its place.
+/// \param index Index of the stored event.
+/// \param replacement Event reused by the pool, it should have memory reserved for GetMaxDecayProducts() photons.
+/// \return The stored event, owned by the caller from now on.
+///
+Event* SimulationWorker::ExchangeStoredEvent(long index, Event* replacement)
+{
+    Event* event = fEventPool_[index];
+    fEventPool_[index] = replacement;
+    return event;
+}
+
+///
+/// \brief SimulationWorker::Merge Adds histograms, counters and stage times of another worker to histograms and counters of this one.
+/// \param worker Worker that simulated the same decay type in the same run.
+///
+void SimulationWorker::Merge(const SimulationWorker& worker)
+{
+    fDecay_.Merge(worker.fDecay_);
+    fCuts_.Merge(worker.fCuts_);
+    fCompton_.Merge(worker.fCompton_);
+    fProfiler_.Merge(worker.fProfiler_);
+}
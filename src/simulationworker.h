@@ -0,0 +1,97 @@
+/// @file simulationworker.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef SIMULATIONWORKER_H
+#define SIMULATIONWORKER_H
+#include <exception>
+#include <vector>
+#include "TLorentzVector.h"
+#include "event.h"
+#include "eventbatch.h"
+#include "parammanager.h"
+#include "masslessphasespace.h"
+#include "acceptancesampler.h"
+#include "randomstream.h"
+#include "psdecay.h"
+#include "phantom.h"
+#include "initialcuts.h"
+#include "comptonscattering.h"
+#include "stageprofiler.h"
+
+///
+/// \brief The SimulationWorker class Complete simulation pipeline (generation, phantom, cuts, Compton scattering) used by one thread.
+///
+/// Events of a run are divided into blocks of kBlockSize events, which are distributed among workers. Every stage of the
+/// pipeline draws from its own RandomStream, switched to the substream of the event before it is simulated. Hence the
+/// simulated events do not depend on which worker (and how many of them) processed the block.
+/// A block is simulated as an EventBatch (structure of arrays), which is processed by each stage in turn. The stages are
+/// specialized for the decay type at compile time (see DecayTraits) and the specialization is chosen in the constructor.
+/// If only passed events are saved (see ParamManager::IsEarlyRejectActive), events in which a required photon missed
+/// the detector are removed from the batch right after generation, so the other stages skip them.
+/// Only events selected to be written to the tree are converted to Event objects, kept in a pool, so no memory is
+/// allocated per event in the steady state.
+///
+class SimulationWorker
+{
+    public:
+        SimulationWorker(const TLorentzVector& Ps, const TLorentzVector& source, const ParamManager& pManag, DecayType type, int simRun, bool storeEvents);
+        SimulationWorker(const SimulationWorker&) = delete;
+        SimulationWorker& operator=(const SimulationWorker&) = delete;
+        ~SimulationWorker();
+
+        void ProcessBlock(long block);
+        void RethrowError() const;
+        inline bool HasFailed() const {return static_cast<bool>(fError_);}
+        void ClearStoredEvents();
+        void Merge(const SimulationWorker& worker);
+        //setters and getters
+        inline long GetNumberOfStoredEvents() const {return fNoOfStoredEvents_;}
+        inline Event* GetStoredEvent(long index) const {return fEventPool_[index];}
+        Event* ExchangeStoredEvent(long index, Event* replacement);
+        inline int GetMaxDecayProducts() const {return fMaxDecayProducts_;}
+        inline PsDecay& GetPsDecay() {return fDecay_;}
+        inline InitialCuts& GetCuts() {return fCuts_;}
+        inline ComptonScattering& GetComptonScattering() {return fCompton_;}
+        inline StageProfiler& GetProfiler() {return fProfiler_;}
+        inline void SetEventIdOffset(long offset) {fEventIdOffset_=offset;}
+        static long GetNumberOfBlocks(long events);
+        static void GetShardBlocks(long events, int shardIndex, int shardCount, long& firstBlock, long& lastBlock);
+        static long GetEventIdOffset(int simRun, long events, int decayTypesInRun=1, int decayTypeIndex=0);
+        //id of an event, derived from its position in the run (see GetEventIdOffset)
+        static inline long GetEventId(long idOffset, long block, long index) {return idOffset+block*kBlockSize+index+1;}
+
+        static const long kBlockSize = 1000; //number of events simulated with one random number generator seed
+
+    private:
+        const ParamManager& fParams_; //parameters of the simulation
+        TLorentzVector fSource_; //position and radius of the source
+        DecayType fDecayType_; //type of simulated decays
+        int fSimRun_; //number of the current run
+        bool fStoreEvents_; //if true, events selected by the eventType parameter are kept for writing to the tree
+        long fEventIdOffset_; //ids of events of this run and decay type start from fEventIdOffset_+1
+        MasslessPhaseSpace fPhaseSpaceGen_; //generator of decays, the batch is generated at once
+        RandomStream fGenerationRandom_; //random numbers for the generation of decays
+        RandomStream fPhantomRandom_; //random numbers for the scattering in phantom
+        RandomStream fCutsRandom_; //random numbers for the detection cut
+        RandomStream fComptonRandom_; //random numbers for the Compton scattering in the detector
+        RandomStream fAcceptanceRandom_; //random numbers for the direction of the first photon in the acceptance sampling mode
+        AcceptanceSampler fAcceptance_; //biases directions of first photons towards the barrel, if enabled
+        PsDecay fDecay_;
+        Phantom fPhantom_;
+        InitialCuts fCuts_;
+        ComptonScattering fCompton_;
+        std::vector<Event*> fEventPool_; //events reused in every block, the first fNoOfStoredEvents_ are to be written to the tree
+        long fNoOfStoredEvents_; //number of events kept since the last call of ClearStoredEvents
+        int fMaxDecayProducts_; //the highest possible number of photons in an event, memory for them is reserved in advance
+        EventBatch fBatch_; //events of the currently simulated block
+        StageProfiler fProfiler_; //time spent in stages by this worker
+        std::exception_ptr fError_; //error thrown while processing a block, rethrown by RethrowError
+
+        void (SimulationWorker::*fProcessBlock_)(long block); //ProcessBlock_ specialized for the decay type, chosen once per run
+
+        template<DecayType kType> void ProcessBlock_(long block);
+        bool IsToBeStored_(bool passFlag) const;
+        static int MaxDecayProducts_(DecayType type, const ParamManager& pManag);
+};
+
+#endif // SIMULATIONWORKER_H
@@ -0,0 +1,93 @@
+/// @file stageprofiler.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <iomanip>
+#include <sstream>
+#include "stageprofiler.h"
+
+///
+/// \brief StageProfiler::StageProfiler Basic constructor, all times and counters are set to zero.
+///
+StageProfiler::StageProfiler()
+{
+    Reset();
+}
+
+///
+/// \brief StageProfiler::Reset Sets all times and counters to zero.
+///
+void StageProfiler::Reset()
+{
+    for(int ii=0; ii<kNoOfStages; ii++)
+        fTime_[ii] = 0;
+    fEvents_ = 0;
+}
+
+///
+/// \brief StageProfiler::Merge Adds times and counters of another profiler (e.g. of another thread).
+/// \param profiler Profiler to be added.
+///
+void StageProfiler::Merge(const StageProfiler& profiler)
+{
+    for(int ii=0; ii<kNoOfStages; ii++)
+        fTime_[ii] += profiler.fTime_[ii];
+    fEvents_ += profiler.fEvents_;
+}
+
+///
+/// \brief StageProfiler::GetNsPerEvent Calculates the mean time of a stage per event.
+/// \param stage Stage of the simulation.
+/// \return Time per event [ns], summed over all threads.
+///
+double StageProfiler::GetNsPerEvent(Stage stage) const
+{
+    return fEvents_>0 ? fTime_[stage]/static_cast<double>(fEvents_) : 0.0;
+}
+
+///
+/// \brief StageProfiler::GetStageName Name of a stage used in reports.
+/// \param stage Stage of the simulation.
+/// \return Name of the stage.
+///
+const char* StageProfiler::GetStageName(Stage stage)
+{
+    static const char* names[kNoOfStages] = {"generation", "decay", "phantom", "cuts", "compton", "storage", "output"};
+    return names[stage];
+}
+
+///
+/// \brief StageProfiler::IsEnabled Checks if stages are timed, see NO_STAGE_PROFILING.
+/// \return False if the program was compiled without profiling.
+///
+bool StageProfiler::IsEnabled()
+{
+#ifndef NO_STAGE_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+///
+/// \brief StageProfiler::GetReport Summary of the profiled simulation.
+/// \param wallTime Wall time of the simulation [s].
+/// \param acceptedEvents Number of events which passed the cuts (see InitialCuts::GetAcceptedEvents).
+/// \return Report with one quantity per line.
+///
+std::string StageProfiler::GetReport(double wallTime, long acceptedEvents) const
+{
+    std::ostringstream report;
+    report<<"[INFO] Wall time: "<<wallTime<<" s"<<std::endl;
+    report<<"[INFO] Events: "<<fEvents_<<" ("<<(wallTime>0 ? fEvents_/wallTime : 0.0)<<" events/s)"<<std::endl;
+    report<<"[INFO] Pass fraction: "<<(fEvents_>0 ? acceptedEvents/static_cast<double>(fEvents_) : 0.0)<<std::endl;
+    if(!IsEnabled())
+    {
+        report<<"[INFO] Stage times: DISABLED (compiled with NO_STAGE_PROFILING)"<<std::endl;
+        return report.str();
+    }
+    report<<"[INFO] Stage times [ns/event, summed over threads]:";
+    for(int ii=0; ii<kNoOfStages; ii++)
+        report<<" "<<GetStageName(static_cast<Stage>(ii))<<"="<<std::fixed<<std::setprecision(1)<<GetNsPerEvent(static_cast<Stage>(ii));
+    report<<std::endl;
+    return report.str();
+}
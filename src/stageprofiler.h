@@ -0,0 +1,79 @@
+/// @file stageprofiler.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef STAGEPROFILER_H
+#define STAGEPROFILER_H
+#include <chrono>
+#include <string>
+
+///
+/// \brief The StageProfiler class Time spent in stages of the simulation and number of processed events.
+///
+/// Every thread owns its profiler (e.g. one per SimulationWorker), so no synchronisation is needed. Profilers are merged
+/// after the event loop and summarised by GetReport. Stages are timed with the PROFILE_STAGE macro, which expands
+/// to nothing if the program is compiled with NO_STAGE_PROFILING (make PROFILING=0).
+///
+class StageProfiler
+{
+    public:
+        ///
+        /// \brief The Stage enum Stages of the simulation.
+        ///
+        enum Stage
+        {
+            GENERATION = 0, //generation of decays
+            DECAY = 1, //histograms of generated decays (PsDecay)
+            PHANTOM = 2, //scattering in the phantom
+            CUTS = 3, //hit points and detection cuts
+            COMPTON = 4, //Compton scattering in the detector
+            STORAGE = 5, //conversion of events to be written to Event objects
+            OUTPUT = 6, //passing events to the tree writer, including waiting for it
+            kNoOfStages = 7
+        };
+
+        StageProfiler();
+        inline void AddTime(Stage stage, long nanoseconds) {fTime_[stage] += nanoseconds;}
+        inline void AddEvents(long events) {fEvents_ += events;}
+        void Merge(const StageProfiler& profiler);
+        void Reset();
+        inline long GetTime(Stage stage) const {return fTime_[stage];}
+        inline long GetEvents() const {return fEvents_;}
+        double GetNsPerEvent(Stage stage) const;
+        std::string GetReport(double wallTime, long acceptedEvents) const;
+        static const char* GetStageName(Stage stage);
+        static bool IsEnabled();
+
+    private:
+        long fTime_[kNoOfStages]; //time spent in stages [ns]
+        long fEvents_; //number of processed events
+};
+
+///
+/// \brief The ScopedStageTimer class Adds the time elapsed between its construction and destruction to a stage.
+///
+class ScopedStageTimer
+{
+    public:
+        inline ScopedStageTimer(StageProfiler& profiler, StageProfiler::Stage stage) :
+            fProfiler_(profiler), fStage_(stage), fStart_(std::chrono::steady_clock::now()) {}
+        inline ~ScopedStageTimer()
+            {fProfiler_.AddTime(fStage_, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-fStart_).count());}
+        ScopedStageTimer(const ScopedStageTimer&) = delete;
+        ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+    private:
+        StageProfiler& fProfiler_;
+        StageProfiler::Stage fStage_;
+        std::chrono::steady_clock::time_point fStart_;
+};
+
+#ifndef NO_STAGE_PROFILING
+#define PROFILE_STAGE_CONCAT_(a, b) a##b
+#define PROFILE_STAGE_NAME_(line) PROFILE_STAGE_CONCAT_(stageTimer, line)
+//times the rest of the enclosing scope
+#define PROFILE_STAGE(profiler, stage) ScopedStageTimer PROFILE_STAGE_NAME_(__LINE__)((profiler), (stage))
+#else
+#define PROFILE_STAGE(profiler, stage)
+#endif
+
+#endif // STAGEPROFILER_H
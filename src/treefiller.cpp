@@ -0,0 +1,170 @@
+/// @file treefiller.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "treefiller.h"
+
+///
+/// \brief TreeFiller::TreeFiller The only constructor used, all events of the pool are created here.
+/// \param tree Tree to be filled, branches are created if they do not exist.
+/// \param writer RootWriter which fills the tree.
+/// \param type Type of simulated decays.
+/// \param maxDecayProducts Maximal number of photons in an event, memory for them is reserved in advance.
+/// \param capacity Maximal number of events waiting for writing, rounded up to a power of two.
+/// \param silentMode If true, no output is generated to std::cout.
+/// \param schema Layout of events in the tree.
+///
+TreeFiller::TreeFiller(TTree* tree, RootWriter& writer, DecayType type, int maxDecayProducts, unsigned capacity, bool silentMode,\
+                       TreeSchema schema) :
+    fTree_(tree),
+    fWriter_(writer),
+    fSilentMode_(silentMode),
+    fSchema_(schema),
+    fFlatEvent_(schema==FLAT ? new FlatEvent(maxDecayProducts) : nullptr),
+    fFilled_(capacity > 0 ? capacity : 1),
+    fFree_(capacity > 0 ? capacity : 1),
+    fDrainScheduled_(false),
+    fBranchEvent_(nullptr),
+    fBranchReady_(false),
+    fPushes_(0),
+    fMaxDepth_(0),
+    fDepthSum_(0.0),
+    fStalls_(0),
+    fStallTime_(0.0),
+    fEventsWritten_(0),
+    fFillTime_(0.0)
+{
+    for(unsigned ii=0; ii<fFree_.GetCapacity(); ii++)
+        fFree_.TryPush(new Event(type, maxDecayProducts));
+}
+
+///
+/// \brief TreeFiller::~TreeFiller Writes remaining events and releases the pool.
+///
+TreeFiller::~TreeFiller()
+{
+    //the branch must not point to events released here
+    fWriter_.Execute([this]()
+    {
+        Drain_();
+        if(fBranchReady_)
+            fTree_->ResetBranchAddresses();
+    });
+    //events are exchanged with the simulation, so the filler releases those in its pool, not those it allocated
+    Event* event = nullptr;
+    while(fFree_.TryPop(event))
+        delete event;
+    delete fFlatEvent_;
+}
+
+///
+/// \brief TreeFiller::AcquireEvent Takes an empty event from the pool, waits if all events wait for writing.
+/// Called only by the simulation thread.
+/// \return Event which may be overwritten.
+///
+Event* TreeFiller::AcquireEvent()
+{
+    Event* event = nullptr;
+    if(fFree_.TryPop(event))
+        return event;
+    fStalls_++;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while(!fFree_.TryPop(event))
+    {
+        ScheduleDrain_();
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    fStallTime_ += std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+    return event;
+}
+
+///
+/// \brief TreeFiller::Push Passes a simulated event to the writer. Called only by the simulation thread.
+/// \param event Event taken from the pool with AcquireEvent (possibly swapped with an event of the same capacity).
+///
+void TreeFiller::Push(Event* event)
+{
+    if(!fFilled_.TryPush(event))
+        throw(std::string("[ERROR] More events pushed to TreeFiller than taken from it!"));
+    unsigned depth = fFilled_.Size();
+    fMaxDepth_ = depth > fMaxDepth_ ? depth : fMaxDepth_;
+    fDepthSum_ += depth;
+    fPushes_++;
+    ScheduleDrain_();
+}
+
+///
+/// \brief TreeFiller::Flush Waits until all pushed events are filled into the tree.
+///
+void TreeFiller::Flush()
+{
+    fWriter_.Execute([this](){Drain_();});
+}
+
+///
+/// \brief TreeFiller::PrintMetrics Prints statistics of the output queue.
+///
+void TreeFiller::PrintMetrics() const
+{
+    std::cout<<"[INFO] Output queue: "<<fEventsWritten_<<" events written, max depth "<<fMaxDepth_<<"/"<<GetCapacity()\
+             <<", mean depth "<<GetMeanDepth()<<", simulation stalls "<<fStalls_<<" ("<<fStallTime_<<" s), filling time "\
+             <<fFillTime_<<" s"<<std::endl;
+}
+
+///
+/// \brief TreeFiller::ScheduleDrain_ Queues a task filling the tree, unless one is already waiting.
+///
+void TreeFiller::ScheduleDrain_()
+{
+    if(!fDrainScheduled_.exchange(true))
+        fWriter_.Post([this](){Drain_();});
+}
+
+///
+/// \brief TreeFiller::Drain_ Fills the tree with all waiting events and returns them to the pool. Executed by the writer.
+///
+void TreeFiller::Drain_()
+{
+    //events pushed after this point schedule another task
+    fDrainScheduled_.store(false);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Event* event = nullptr;
+    while(fFilled_.TryPop(event))
+    {
+        fBranchEvent_ = event; //set before the branch is created, so ROOT does not allocate its own event
+        if(!fBranchReady_)
+            AttachBranches_();
+        if(fSchema_==FLAT)
+            fFlatEvent_->Set(*event);
+        fTree_->Fill();
+        fFree_.TryPush(event);
+        fEventsWritten_++;
+    }
+    fFillTime_ += std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+}
+
+///
+/// \brief TreeFiller::AttachBranches_ Creates branches of the selected schema or sets their addresses, if they exist.
+/// Executed by the writer.
+///
+void TreeFiller::AttachBranches_()
+{
+    if(fSchema_==FLAT)
+    {
+        if(!fSilentMode_ && !fTree_->GetBranch("nPhotons"))
+            std::cout<<"[INFO] Creating flat branches for storing events.\n"<<std::endl;
+        fFlatEvent_->Attach(fTree_);
+    }
+    else if(fTree_->GetBranch("event_split"))
+        fTree_->SetBranchAddress("event_split", &fBranchEvent_);
+    else
+    {
+        if(!fSilentMode_)
+            std::cout<<"[INFO] Creating a new branch for storing events.\n"<<std::endl;
+        fTree_->Branch("event_split", "Event", &fBranchEvent_, 32000, 99);
+    }
+    fBranchReady_ = true;
+}
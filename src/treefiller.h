@@ -0,0 +1,71 @@
+/// @file treefiller.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+#ifndef TREEFILLER_H
+#define TREEFILLER_H
+#include <atomic>
+#include "TTree.h"
+#include "event.h"
+#include "flatevent.h"
+#include "parammanager.h"
+#include "boundedqueue.h"
+#include "rootwriter.h"
+
+///
+/// \brief The TreeFiller class Asynchronous filling of the tree with simulated events.
+///
+/// The simulation thread takes an empty event with AcquireEvent, swaps it with a simulated one (see
+/// SimulationWorker::ExchangeStoredEvent) and passes the simulated event to Push. Events are filled into the tree by the
+/// thread of the RootWriter and returned to the pool of empty events, so no event is allocated after construction.
+/// When all events of the pool wait for writing, AcquireEvent blocks the simulation (back-pressure).
+/// Events are written either as Event objects (OBJECT schema) or as flat columns (FLAT schema, see FlatEvent).
+///
+class TreeFiller
+{
+    public:
+        TreeFiller(TTree* tree, RootWriter& writer, DecayType type, int maxDecayProducts, unsigned capacity, bool silentMode=false,\
+                   TreeSchema schema=OBJECT);
+        TreeFiller(const TreeFiller&) = delete;
+        TreeFiller& operator=(const TreeFiller&) = delete;
+        ~TreeFiller();
+
+        Event* AcquireEvent();
+        void Push(Event* event);
+        void Flush();
+        void PrintMetrics() const;
+        //metrics
+        inline long GetEventsWritten() const {return fEventsWritten_;}
+        inline unsigned GetCapacity() const {return fFilled_.GetCapacity();}
+        inline unsigned GetMaxDepth() const {return fMaxDepth_;}
+        inline double GetMeanDepth() const {return fPushes_>0 ? fDepthSum_/static_cast<double>(fPushes_) : 0.0;}
+        inline long GetStalls() const {return fStalls_;}
+        inline double GetStallTime() const {return fStallTime_;}
+        inline double GetFillTime() const {return fFillTime_;}
+
+    private:
+        TTree* fTree_; //tree filled with events, used only by the writer thread
+        RootWriter& fWriter_; //executes filling of the tree
+        bool fSilentMode_; //if true, no output is generated to std::cout
+        TreeSchema fSchema_; //layout of events in the tree
+        FlatEvent* fFlatEvent_; //buffers of the flat schema, nullptr for the OBJECT schema
+        BoundedQueue<Event*> fFilled_; //events waiting for writing, pushed by the simulation thread
+        BoundedQueue<Event*> fFree_; //written events, returned by the writer thread
+        std::atomic<bool> fDrainScheduled_; //true if a task filling the tree is queued in the writer
+        Event* fBranchEvent_; //address of the branch in the OBJECT schema
+        bool fBranchReady_; //true if branch addresses are set
+        //metrics of the simulation thread
+        long fPushes_; //number of pushed events
+        unsigned fMaxDepth_; //maximal number of events waiting for writing
+        double fDepthSum_; //sum of queue depths after each push
+        long fStalls_; //number of times the simulation waited for an empty event
+        double fStallTime_; //total time of waiting [s]
+        //metrics of the writer thread
+        std::atomic<long> fEventsWritten_; //number of events filled into the tree
+        double fFillTime_; //total time of filling [s]
+
+        void ScheduleDrain_();
+        void Drain_();
+        void AttachBranches_();
+};
+
+#endif // TREEFILLER_H
@@ -8,8 +8,11 @@
 /// an excited atomic state, deexcitation is followed with the emission of N photons.
 #include "gtest/gtest.h"
 #include "../../src/particlegenerator.h"
+#include "../../src/randomstream.h"
 #include "../../src/parammanager.h"
 #include "../../src/psdecay.h"
+#include "../../src/aliastable.h"
+#include "TMath.h"
 #include <fstream>
 #include <TLorentzVector.h>
 #define BOOST_NO_CXX11_SCOPED_ENUMS //CXX11 support hacks
@@ -22,20 +25,19 @@ class TwoAndNTestFixture: public ::testing::Test
 {
     //TODO: fix the linker problem
     public:
-       TGenPhaseSpace event; //event generator
+       PhaseSpaceGenerator event; //event generator
+       RandomStream rng; //random number generator
        TLorentzVector sourcePos; //position of the source
        ParamManager pManag;    //objects for 2- and 3- gamma decays
        DecayType type;
        TLorentzVector Ps;  //four-momentum vector of the source
        double masses2[2];
        PsDecay* decay;
-       TH1F* hist;
        TwoAndNTestFixture( )
        {
           // initialization code here
           type = TWOandN;
           decay = new PsDecay(type);
-          hist = decay->fH_en_;
           Ps = TLorentzVector(0.000000001, 0.000000001, 0.000000001, 1.022/1000);
           for(int ii=0; ii<4; ii++)
           {
@@ -51,6 +53,13 @@ class TwoAndNTestFixture: public ::testing::Test
 
        }
        ///
+       /// \brief GetEnergyHistogram Histogram of energies filled by the decay, with the accumulated content merged.
+       ///
+       TH1F* GetEnergyHistogram()
+       {
+           return decay->fH_en_.Get();
+       }
+       ///
        /// \brief SetUp Creates a dummy file with 2&N data. File is removed by destructor.
        ///
        void SetUp()
@@ -87,6 +96,7 @@ class TwoAndNTestFixture: public ::testing::Test
                 en1.push_back(250.0+ii*500.0);
           pManag.fGammaEnergy_.push_back(en1);
           pManag.fGammaEnergy_.push_back(en2);
+          pManag.fDecayBranchTable_.Build(pManag.fDecayBranchProbability_);
        }
 
        ~TwoAndNTestFixture( )
@@ -122,7 +132,7 @@ TEST_F(TwoAndNTestFixture, ParticleGeneration)
     {
         try
         {
-            eventDecay = generateEvent(event, sourcePos, pManag, TWOandN);
+            eventDecay = generateEvent(event, sourcePos, pManag, TWOandN, &rng);
             decay->AddEvent(eventDecay);
         }
         catch(std::string ex)
@@ -130,7 +140,85 @@ TEST_F(TwoAndNTestFixture, ParticleGeneration)
             FAIL();
         }
     }
+    //taken after filling, so the content accumulated by PsDecay is merged into the histogram
+    TH1F* hist = GetEnergyHistogram();
     double max = hist->GetBinContent(hist->GetMaximumBin());
     double all = hist->Integral();
     ASSERT_NEAR(20.0/52.0, max/all, 10e-3);
 }
+
+///
+/// \brief TEST Checks that the alias table draws indices with probabilities proportional to their weights.
+///
+TEST(AliasTableTest, ProbabilitiesEqualWeights)
+{
+    std::vector<double> weights = {0.5, 0.1, 0.0, 2.4, 1.0, 1.0};
+    const double sum = 5.0;
+    AliasTable table(weights);
+    ASSERT_EQ(6, table.GetSize());
+    for(unsigned ii=0; ii<weights.size(); ii++)
+        ASSERT_NEAR(weights[ii]/sum, table.GetProbabilityOf(ii), 1e-12);
+    RandomStream rng(2357);
+    const int noOfDraws = 1000000;
+    std::vector<int> counts(weights.size(), 0);
+    for(int n=0; n<noOfDraws; n++)
+    {
+        int index = table.Sample(&rng);
+        ASSERT_GE(index, 0);
+        ASSERT_LT(index, 6);
+        counts[index]++;
+    }
+    ASSERT_EQ(0, counts[2]);
+    for(unsigned ii=0; ii<weights.size(); ii++)
+    {
+        double p = weights[ii]/sum;
+        EXPECT_NEAR(p, counts[ii]/static_cast<double>(noOfDraws), 5*TMath::Sqrt(p*(1-p)/noOfDraws)+1e-9);
+    }
+    ASSERT_GE(table.Sample(0.0), 0);
+    ASSERT_LT(table.Sample(1.0-1e-16), 6);
+    ASSERT_EQ(-1, AliasTable().Sample(0.5));
+}
+
+///
+/// \brief TEST_F Checks that decay branches of selected nuclides from a library are mixed according to activities.
+///
+TEST_F(TwoAndNTestFixture, NuclideLibrary)
+{
+    std::ofstream library("tmp_library.dat");
+    library << "#library of two nuclides\n";
+    library << "nuclide A 3.0\n";
+    library << "0.5 1000\n";
+    library << "0.5 0\n";
+    library << "nuclide B 1.0\n";
+    library << "2.0 300 600\n";
+    library.close();
+    //all nuclides
+    pManag.Import2nNdata("tmp_library.dat");
+    ASSERT_EQ(2, pManag.GetNumberOfNuclides());
+    ASSERT_EQ(3, pManag.GetNumberOfDecayBranches());
+    ASSERT_DOUBLE_EQ(0.375, pManag.GetDecayBranchProbabilityAt(0));
+    ASSERT_DOUBLE_EQ(0.375, pManag.GetDecayBranchProbabilityAt(1));
+    ASSERT_DOUBLE_EQ(0.25, pManag.GetDecayBranchProbabilityAt(2));
+    ASSERT_EQ(600, pManag.GetGammaEnergyAt(2, 1));
+    //one nuclide, selected after the import
+    pManag.SetSelectedNuclides(std::vector<std::string>(1, "B"));
+    ASSERT_EQ(1, pManag.GetNumberOfDecayBranches());
+    ASSERT_DOUBLE_EQ(1.0, pManag.GetDecayBranchProbabilityAt(0));
+    ASSERT_EQ(300, pManag.GetGammaEnergyAt(0, 0));
+    //selection made before the import and kept by copies
+    ParamManager selected;
+    selected.EnableSilentMode();
+    selected.SetSelectedNuclides(std::vector<std::string>(1, "A"));
+    selected.Import2nNdata("tmp_library.dat");
+    ParamManager copy(selected);
+    ASSERT_TRUE(copy == selected);
+    ASSERT_EQ(2, copy.GetNumberOfDecayBranches());
+    ASSERT_DOUBLE_EQ(0.5, copy.GetDecayBranchProbabilityAt(0));
+    for(int n=0; n<1000; n++)
+    {
+        rng.SetSubstream(n);
+        int branch = copy.SampleDecayBranch(&rng);
+        ASSERT_TRUE(branch==0 || branch==1);
+    }
+    boost::filesystem::remove_all("tmp_library.dat");
+}
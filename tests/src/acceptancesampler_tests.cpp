@@ -0,0 +1,116 @@
+/// @file acceptancesampler_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check that AcceptanceSampler emits first photons only towards the barrel and that weighted results
+/// of the acceptance sampling mode agree with unbiased simulations.
+/// Statistical tests use fixed seeds, so they give the same result in every run.
+#include "gtest/gtest.h"
+#include "TMath.h"
+#include "../../src/acceptancesampler.h"
+#include "../../src/hitpointkernel.h"
+#include "../../src/simulationworker.h"
+
+///
+/// \brief TEST This test checks that sampled directions hit the barrel and that rotations preserve angles between photons.
+///
+TEST(AcceptanceSamplerTest, DirectionsHitBarrel)
+{
+    const double R = 437.3;
+    const double L = 100.0;
+    AcceptanceSampler sampler(R, L);
+    RandomStream rng(1618);
+    for(int n=0; n<100000; n++)
+    {
+        rng.SetSubstream(n);
+        //emission points inside the barrel, also beyond its ends
+        double r = 0.99*R*TMath::Sqrt(rng.Rndm());
+        double phi = 2*TMath::Pi()*rng.Rndm();
+        double x0 = r*TMath::Cos(phi);
+        double y0 = r*TMath::Sin(phi);
+        double z0 = rng.Uniform(-L, L);
+        double direction[3];
+        double weight = sampler.SampleDirection(x0, y0, z0, rng.Rndm(), rng.Rndm(), direction);
+        ASSERT_GT(weight, 0.0);
+        ASSERT_LE(weight, 0.5);
+        ASSERT_NEAR(1.0, direction[0]*direction[0]+direction[1]*direction[1]+direction[2]*direction[2], 1e-12);
+        double hitX, hitY, hitZ, hitT, hitPhi, hitTheta;
+        HitPointKernel::CalculateOne(x0, y0, z0, direction[0], direction[1], direction[2], 1.0, R, L, hitX, hitY, hitZ, hitT, hitPhi, hitTheta);
+        ASSERT_LE(TMath::Abs(hitZ), L/2.0);
+        ASSERT_NEAR(R, TMath::Sqrt(hitX*hitX+hitY*hitY), 1e-6);
+    }
+    //rotation maps the first direction onto the second one and preserves scalar products, also for opposite directions
+    const double from[3] = {0.0, 0.6, 0.8};
+    const double targets[3][3] = {{1.0, 0.0, 0.0}, {0.0, -0.6, -0.8}, {0.0, 0.6, 0.8}};
+    for(int ii=0; ii<3; ii++)
+    {
+        double px[2] = {0.0, 3.0};
+        double py[2] = {0.6, -1.0};
+        double pz[2] = {0.8, 2.0};
+        AcceptanceSampler::Rotate(from, targets[ii], 2, px, py, pz);
+        EXPECT_NEAR(targets[ii][0], px[0], 1e-12);
+        EXPECT_NEAR(targets[ii][1], py[0], 1e-12);
+        EXPECT_NEAR(targets[ii][2], pz[0], 1e-12);
+        EXPECT_NEAR(14.0, px[1]*px[1]+py[1]*py[1]+pz[1]*pz[1], 1e-12);
+        EXPECT_NEAR(1.0, px[0]*px[1]+py[0]*py[1]+pz[0]*pz[1], 1e-12);
+    }
+}
+
+///
+/// \brief TEST This test checks that the weighted number of events that passed cuts is the same in the acceptance sampling
+/// mode and in unbiased simulations, and that its statistical error is lower.
+///
+TEST(AcceptanceSamplerTest, WeightedPassEqualsUnbiased)
+{
+    const DecayType types[] = {TWO, THREE, TWOandONE};
+    const long noOfBlocks = 100;
+    ParamManager pManag;
+    pManag.SetR(437.3);
+    pManag.SetL(100);
+    pManag.SetEff(0.8);
+    pManag.SetE(1157);
+    pManag.SetP(0.5);
+    pManag.SetSeed(4669);
+    pManag.SetSimEvents(noOfBlocks*SimulationWorker::kBlockSize);
+    pManag.SetEventTypeToSave(ALL);
+    pManag.SetHistogramLevel(NO_HISTOGRAMS);
+    pManag.EnableSilentMode();
+    const TLorentzVector Ps(0.0, 0.0, 0.0, 1.022/1000);
+    const TLorentzVector sourcePos(150.0, -80.0, 30.0, 10.0);
+    for(DecayType type : types)
+    {
+        //sums of weights of events that passed cuts and of their squares, unbiased (index 0) and biased (index 1)
+        double sum[2] = {0.0, 0.0};
+        double sum2[2] = {0.0, 0.0};
+        for(int kk=0; kk<2; kk++)
+        {
+            pManag.SetAcceptanceSampling(kk==1);
+            SimulationWorker worker(Ps, sourcePos, pManag, type, 0, true);
+            for(long block=0; block<noOfBlocks; block++)
+            {
+                worker.ClearStoredEvents();
+                worker.ProcessBlock(block);
+                for(long ii=0; ii<worker.GetNumberOfStoredEvents(); ii++)
+                {
+                    const Event* event = worker.GetStoredEvent(ii);
+                    double weight = event->GetPassFlag() ? event->GetWeight() : 0.0;
+                    sum[kk] += weight;
+                    sum2[kk] += weight*weight;
+                }
+            }
+        }
+        const double noOfEvents = pManag.GetSimEvents();
+        double mean[2];
+        double error[2];
+        for(int kk=0; kk<2; kk++)
+        {
+            mean[kk] = sum[kk]/noOfEvents;
+            error[kk] = TMath::Sqrt((sum2[kk]/noOfEvents-mean[kk]*mean[kk])/noOfEvents);
+        }
+        ASSERT_GT(mean[0], 0.0);
+        EXPECT_NEAR(mean[0], mean[1], 5*TMath::Sqrt(error[0]*error[0]+error[1]*error[1])) << "type=" << type;
+        EXPECT_LT(error[1], error[0]) << "type=" << type;
+    }
+}
@@ -0,0 +1,79 @@
+/// @file allocation_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check that the event loop does not allocate memory per event in the steady state.
+/// Global operator new is replaced in this file to count allocations made by the whole test executable.
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "gtest/gtest.h"
+#include "../../src/simulationworker.h"
+
+static std::atomic<long> allocationCounter(0); //number of calls of operator new
+
+void* operator new(std::size_t size)
+{
+    allocationCounter++;
+    void* ptr = std::malloc(size ? size : 1);
+    if(!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+///
+/// \brief The AllocationTestFixture class Sets the necessary fields for tests in this test case.
+///
+class AllocationTestFixture: public ::testing::Test
+{
+    public:
+       ParamManager pManag;
+       TLorentzVector Ps;  //four-momentum vector of the source
+       TLorentzVector sourcePos; //position of the source
+
+       AllocationTestFixture( )
+       {
+          Ps = TLorentzVector(0.0, 0.0, 0.0, 1.022/1000);
+          sourcePos = TLorentzVector(0.0, 0.0, 0.0, 10.0);
+          pManag.SetR(437.3);
+          pManag.SetL(500);
+          pManag.SetEff(0.5);
+          pManag.SetP(0.98);
+          pManag.SetE(1157);
+          pManag.SetSeed(123456789);
+          pManag.SetSimEvents(3*SimulationWorker::kBlockSize);
+          pManag.SetUseOfPhantom(true);
+          pManag.SetPhantomNaive511Prob(0.5);
+          pManag.SetPhantomNaivePromptProb(0.5);
+          pManag.SetEventTypeToSave(ALL);
+          pManag.EnableSilentMode();
+       }
+};
+
+///
+/// \brief TEST_F This test checks that blocks processed after the first one do not allocate memory.
+///
+TEST_F(AllocationTestFixture, NoAllocationsPerEvent)
+{
+    const DecayType types[] = {TWO, THREE, TWOandONE};
+    for(DecayType type : types)
+    {
+        SimulationWorker worker(Ps, sourcePos, pManag, type, 0, true);
+        //the first block fills the pool of events
+        worker.ProcessBlock(0);
+        worker.ClearStoredEvents();
+        long before = allocationCounter.load();
+        worker.ProcessBlock(1);
+        worker.ClearStoredEvents();
+        worker.ProcessBlock(2);
+        ASSERT_EQ(SimulationWorker::kBlockSize, worker.GetNumberOfStoredEvents());
+        ASSERT_EQ(before, allocationCounter.load());
+    }
+}
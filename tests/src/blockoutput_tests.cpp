@@ -0,0 +1,83 @@
+/// @file blockoutput_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check that BlockOutput passes blocks simulated by many threads in the order of their indices.
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "../../src/blockoutput.h"
+
+///
+/// \brief TEST This test checks that blocks taken from workers of persistent threads are ordered and complete.
+///
+TEST(BlockOutputTest, BlocksTakenInOrder)
+{
+    ParamManager pManag;
+    pManag.SetR(437.3);
+    pManag.SetL(500);
+    pManag.SetEff(0.5);
+    pManag.SetSeed(2718);
+    pManag.SetSimEvents(12*SimulationWorker::kBlockSize);
+    pManag.SetEventTypeToSave(ALL);
+    pManag.EnableSilentMode();
+    const TLorentzVector Ps(0.0, 0.0, 0.0, 1.022/1000);
+    const TLorentzVector sourcePos(0.0, 0.0, 0.0, 10.0);
+    const long firstBlock = 2, lastBlock = 12;
+    const int noOfThreads = 3;
+    std::vector<SimulationWorker*> workers;
+    for(int ii=0; ii<noOfThreads; ii++)
+        workers.push_back(new SimulationWorker(Ps, sourcePos, pManag, THREE, 0, true));
+    BlockOutput output(firstBlock, 2, THREE, workers[0]->GetMaxDecayProducts());
+    std::atomic<long> nextBlock(firstBlock);
+    std::vector<std::thread> threads;
+    for(int ii=0; ii<noOfThreads; ii++)
+    {
+        threads.push_back(std::thread([&, ii]()
+        {
+            for(long block=nextBlock++; block<lastBlock; block=nextBlock++)
+            {
+                workers[ii]->ProcessBlock(block);
+                output.Put(block, *workers[ii]);
+            }
+        }));
+    }
+    long expectedId = firstBlock*SimulationWorker::kBlockSize+1;
+    std::vector<Event*> events;
+    for(long block=firstBlock; block<lastBlock; block++)
+    {
+        ASSERT_TRUE(output.Take(block, events));
+        ASSERT_EQ(SimulationWorker::kBlockSize, static_cast<long>(events.size()));
+        for(std::vector<Event*>::iterator it = events.begin(); it != events.end(); ++it)
+            ASSERT_EQ(expectedId++, (*it)->fId);
+        output.Release(events);
+    }
+    for(std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+        it->join();
+    for(int ii=0; ii<noOfThreads; ii++)
+    {
+        ASSERT_EQ(0, workers[ii]->GetNumberOfStoredEvents());
+        delete workers[ii];
+    }
+}
+
+///
+/// \brief TEST This test checks that an aborted output does not wait for blocks that are never put.
+///
+TEST(BlockOutputTest, AbortWakesOutputThread)
+{
+    BlockOutput output(0, 1, TWO, 2);
+    std::thread aborting([&output]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        output.Abort();
+    });
+    std::vector<Event*> events;
+    ASSERT_FALSE(output.Take(0, events));
+    aborting.join();
+    ASSERT_TRUE(events.empty());
+}
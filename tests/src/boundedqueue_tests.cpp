@@ -0,0 +1,68 @@
+/// @file boundedqueue_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check the lock-free queue passing events to the writer thread.
+#include <thread>
+#include "gtest/gtest.h"
+#include "../../src/boundedqueue.h"
+
+///
+/// \brief TEST This test checks that the capacity is rounded up to a power of two and the queue refuses elements when full.
+///
+TEST(BoundedQueueTest, FullAndEmpty)
+{
+    BoundedQueue<int> queue(5);
+    ASSERT_EQ(8u, queue.GetCapacity());
+    int value = -1;
+    ASSERT_FALSE(queue.TryPop(value));
+    for(int ii=0; ii<8; ii++)
+        ASSERT_TRUE(queue.TryPush(ii));
+    ASSERT_FALSE(queue.TryPush(8));
+    ASSERT_EQ(8u, queue.Size());
+    ASSERT_TRUE(queue.TryPop(value));
+    ASSERT_EQ(0, value);
+    ASSERT_TRUE(queue.TryPush(8));
+    for(int ii=1; ii<=8; ii++)
+    {
+        ASSERT_TRUE(queue.TryPop(value));
+        ASSERT_EQ(ii, value);
+    }
+    ASSERT_FALSE(queue.TryPop(value));
+    ASSERT_EQ(0u, queue.Size());
+}
+
+///
+/// \brief TEST This test checks that elements pushed by the producer thread are popped by the consumer in the same order.
+///
+TEST(BoundedQueueTest, ProducerConsumerOrder)
+{
+    BoundedQueue<long> queue(64);
+    const long noOfElements = 200000;
+    bool ordered = true;
+    std::thread consumer([&]()
+    {
+        long expected = 0;
+        long value = 0;
+        while(expected < noOfElements)
+        {
+            if(queue.TryPop(value))
+            {
+                ordered &= value==expected;
+                expected++;
+            }
+            else
+                std::this_thread::yield();
+        }
+    });
+    for(long ii=0; ii<noOfElements; ii++)
+    {
+        while(!queue.TryPush(ii))
+            std::this_thread::yield();
+    }
+    consumer.join();
+    ASSERT_TRUE(ordered);
+    ASSERT_EQ(0u, queue.Size());
+}
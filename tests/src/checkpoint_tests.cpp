@@ -0,0 +1,93 @@
+/// @file checkpoint_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check recording of completed runs, used to resume interrupted simulations.
+#include <fstream>
+#include <string>
+#include "boost/filesystem.hpp"
+#include "gtest/gtest.h"
+#include "../../src/checkpoint.h"
+#include "../../src/parammanager.h"
+
+///
+/// \brief TEST This test checks that completed runs and the seed are restored from the checkpoint file.
+///
+TEST(CheckpointTest, CompletedRunsRestored)
+{
+    const std::string fileName = "tmp.checkpoint";
+    {
+        Checkpoint checkpoint(fileName);
+        checkpoint.Start(1234, 100000, 5, "0123abcd");
+        checkpoint.MarkCompleted(0, "0_0_0_0_0_0");
+        checkpoint.MarkCompleted(3, "10_0_0_0_0_0");
+        ASSERT_TRUE(checkpoint.IsCompleted(3));
+    }
+    Checkpoint checkpoint(fileName);
+    ASSERT_TRUE(checkpoint.Load());
+    ASSERT_EQ(1234, checkpoint.GetSeed());
+    ASSERT_EQ(100000, checkpoint.GetEvents());
+    ASSERT_EQ(5, checkpoint.GetRuns());
+    ASSERT_EQ("0123abcd", checkpoint.GetParamDigest());
+    ASSERT_EQ(2, checkpoint.GetNumberOfCompletedRuns());
+    ASSERT_TRUE(checkpoint.IsCompleted(0));
+    ASSERT_FALSE(checkpoint.IsCompleted(1));
+    ASSERT_TRUE(checkpoint.IsCompleted(3));
+    ASSERT_TRUE(checkpoint.IsCompletedRunDirectory("10_0_0_0_0_0"));
+    ASSERT_FALSE(checkpoint.IsCompletedRunDirectory("20_0_0_0_0_0"));
+    //a new simulation forgets completed runs
+    checkpoint.Start(99, 10, 1, "ff");
+    Checkpoint restarted(fileName);
+    ASSERT_TRUE(restarted.Load());
+    ASSERT_EQ(99, restarted.GetSeed());
+    ASSERT_EQ(0, restarted.GetNumberOfCompletedRuns());
+    boost::filesystem::remove_all(fileName);
+}
+
+///
+/// \brief TEST This test checks that a run written partially before an interruption is not treated as completed.
+///
+TEST(CheckpointTest, IncompleteLastLine)
+{
+    const std::string fileName = "tmp.checkpoint";
+    {
+        Checkpoint checkpoint(fileName);
+        checkpoint.Start(7, 10, 3, "ff");
+        checkpoint.MarkCompleted(1, "0_0_0_0_0_0");
+        std::ofstream file(fileName.c_str(), std::ios::app);
+        file<<"run 2";
+    }
+    Checkpoint checkpoint(fileName);
+    ASSERT_TRUE(checkpoint.Load());
+    ASSERT_TRUE(checkpoint.IsCompleted(1));
+    ASSERT_FALSE(checkpoint.IsCompleted(2));
+    boost::filesystem::remove_all(fileName);
+    ASSERT_FALSE(checkpoint.Load());
+}
+
+///
+/// \brief TEST This test checks that the digest of parameters changes with parameters affecting results only.
+///
+TEST(CheckpointTest, ParamDigest)
+{
+    ParamManager pManag;
+    pManag.SetSimEvents(1000);
+    const std::string digest = pManag.GetDigest();
+    ASSERT_FALSE(digest.empty());
+    ASSERT_EQ(digest, ParamManager(pManag).GetDigest());
+    //threads do not change simulated events
+    pManag.SetThreads(8);
+    pManag.SetSeed(42);
+    ASSERT_EQ(digest, pManag.GetDigest());
+    ParamManager schema(pManag);
+    schema.SetTreeSchema(FLAT);
+    ASSERT_NE(digest, schema.GetDigest());
+    ParamManager saved(pManag);
+    saved.SetEventTypeToSave(PASS);
+    ASSERT_NE(digest, saved.GetDigest());
+    ParamManager shard(pManag);
+    shard.SetShard(1, 2);
+    ASSERT_NE(digest, shard.GetDigest());
+}
@@ -11,8 +11,8 @@
 #include "gtest/gtest.h"
 #include "../../src/initialcuts.h"
 #include "../../src/event.h"
-#include "TGenPhaseSpace.h"
-#include "TRandom3.h"
+#include "../../src/phasespacegenerator.h"
+#include "../../src/randomstream.h"
 #include <sys/stat.h>
 #define BOOST_NO_CXX11_SCOPED_ENUMS //CXX11 support hacks
 #include "boost/filesystem.hpp"
@@ -25,7 +25,8 @@ class cutsTestFixture: public ::testing::Test
 {
     //TODO: fix the linker problem
     public:
-       TGenPhaseSpace* event; //event generator
+       PhaseSpaceGenerator* event; //event generator
+       RandomStream rng; //random number generator
        double* sourcePos; //position of the source
        ParamManager* pManag;    //objects for 2- and 3- gamma decays
        double masses2[2];
@@ -37,7 +38,7 @@ class cutsTestFixture: public ::testing::Test
        {
           // initialization code here
           type = THREE;
-          event = new TGenPhaseSpace();
+          event = new PhaseSpaceGenerator();
           sourcePos = new double[3]();
           Ps = TLorentzVector(0.000000001, 0.000000001, 0.000000001, 1.022/1000);
           for(int ii=0; ii<3; ii++)
@@ -107,7 +108,7 @@ TEST_F (cutsTestFixture, GeometricalAcceptanceTestCenter)
     // Generating 3-gamma events
     for (int n=0; n<simSteps; n++)
     {
-       weight = event->Generate();
+       weight = event->Generate(&rng);
        for(int ii=0; ii<3; ii++)
        {
            fourMomenta[ii]=event->GetDecay(ii);
@@ -115,7 +116,7 @@ TEST_F (cutsTestFixture, GeometricalAcceptanceTestCenter)
 
        eventDecay = new Event(&sourcePar, &fourMomenta, weight, type);
        //Applying cuts
-       cuts3->AddCuts(eventDecay);
+       cuts3->AddCuts(eventDecay, &rng);
        delete eventDecay;
 
     }
@@ -132,12 +133,12 @@ TEST_F (cutsTestFixture, GeometricalAcceptanceTestCenter)
     fourMomenta[2]=nullptr;
     for (int n=0; n<simSteps; n++)
     {
-       weight = event->Generate();
+       weight = event->Generate(&rng);
        fourMomenta[0] = event->GetDecay(0);
        fourMomenta[1] = event->GetDecay(1);
        eventDecay = new Event(&sourcePar, &fourMomenta, weight, type);
        //Applying cuts
-       cuts2->AddCuts(eventDecay);
+       cuts2->AddCuts(eventDecay, &rng);
        delete eventDecay;
     }
 //     how many gammas hit the detector
@@ -186,13 +187,13 @@ TEST_F (cutsTestFixture, GeometricalAcceptanceTestZAxis)
     // Generating 3-gamma events
     for (int n=0; n<simSteps; n++)
     {
-       weight = event->Generate();
+       weight = event->Generate(&rng);
        fourMomenta[0] = event->GetDecay(0);
        fourMomenta[1] = event->GetDecay(1);
        fourMomenta[2] = event->GetDecay(2);
        eventDecay = new Event(&sourcePar, &fourMomenta, weight, type);
        //Applying cuts
-       cuts3->AddCuts(eventDecay);
+       cuts3->AddCuts(eventDecay, &rng);
        delete eventDecay;
     }
 
@@ -208,12 +209,12 @@ TEST_F (cutsTestFixture, GeometricalAcceptanceTestZAxis)
     fourMomenta[2]=nullptr;
     for (int n=0; n<simSteps; n++)
     {
-       weight = event->Generate();
+       weight = event->Generate(&rng);
        fourMomenta[0] = event->GetDecay(0);
        fourMomenta[1] = event->GetDecay(1);
        eventDecay = new Event(&sourcePar, &fourMomenta, weight, type);
 //       //Applying cuts
-       cuts2->AddCuts(eventDecay);
+       cuts2->AddCuts(eventDecay, &rng);
        delete eventDecay;
     }
 //    // how many gammas hit the detector
@@ -257,14 +258,14 @@ TEST_F(cutsTestFixture, InteractionProbability3Gammas)
     // Generating 3-gamma events
     for (int n=0; n<simSteps; n++)
     {
-       double weight = event->Generate();
+       double weight = event->Generate(&rng);
        fourMomenta[0] = event->GetDecay(0);
        fourMomenta[1] = event->GetDecay(1);
        fourMomenta[2] = event->GetDecay(2);
        eventDecay = new Event(&sourcePar, &fourMomenta, weight, type);
        //Applying cuts
-       cuts3->AddCuts(eventDecay);
-       cuts3_p1->AddCuts(eventDecay);
+       cuts3->AddCuts(eventDecay, &rng);
+       cuts3_p1->AddCuts(eventDecay, &rng);
        delete eventDecay;
     }
     //number of accepted events when interaction probability is set to 1.0
@@ -315,13 +316,13 @@ TEST_F(cutsTestFixture, InteractionProbability2Gammas)
     // Generating 3-gamma events
     for (int n=0; n<simSteps; n++)
     {
-       double weight = event->Generate();
+       double weight = event->Generate(&rng);
        fourMomenta[0] = event->GetDecay(0);
        fourMomenta[1] = event->GetDecay(1);
        eventDecay = new Event(&sourcePar, &fourMomenta, weight, type);
        //Applying cuts
-       cuts2->AddCuts(eventDecay);
-       cuts2_p1->AddCuts(eventDecay);
+       cuts2->AddCuts(eventDecay, &rng);
+       cuts2_p1->AddCuts(eventDecay, &rng);
        delete eventDecay;
     }
     //number of accepted events when interaction probability is set to 1.0
@@ -364,13 +365,13 @@ TEST_F(cutsTestFixture, DiskAccessAndInitialCutsNoOfHistograms)
     // Generating 3-gamma events
     for (int n=0; n<simSteps; n++)
     {
-       double weight = event->Generate();
+       double weight = event->Generate(&rng);
        fourMomenta[0] = event->GetDecay(0);
        fourMomenta[1] = event->GetDecay(1);
        fourMomenta[2] = event->GetDecay(2);
        eventDecay = new Event(&sourcePar, &fourMomenta, weight, type);
        //Applying cuts
-       cuts3->AddCuts(eventDecay);
+       cuts3->AddCuts(eventDecay, &rng);
        delete eventDecay;
     }
 
@@ -407,3 +408,51 @@ TEST_F(cutsTestFixture, DiskAccessAndInitialCutsNoOfHistograms)
     boost::filesystem::remove_all("test_tmp");
     ASSERT_FALSE(boost::filesystem::exists("test_tmp")); //check if the folder was removed*/
 }
+
+///
+/// \brief TEST_F (cutsTestFixture, CountersWithoutHistograms) Tests if InitialCuts created without histograms accepts the same
+/// events and gammas as the one with histograms, and that no files are written when drawing.
+///
+TEST_F (cutsTestFixture, CountersWithoutHistograms)
+{
+    int simSteps = 10000;
+    std::vector<TLorentzVector*> sourcePar;
+    std::vector<TLorentzVector*> fourMomenta;
+    for(int ii=0; ii<3; ii++)
+    {
+        fourMomenta.push_back(nullptr);
+        sourcePar.push_back(new TLorentzVector(0.0, 0.0, 0.0, 0.0));
+    }
+    InitialCuts cuts(THREE, pManag->GetR(), pManag->GetL(), pManag->GetEff());
+    InitialCuts cutsNoHist(THREE, pManag->GetR(), pManag->GetL(), pManag->GetEff(), false);
+    cuts.EnableSilentMode();
+    cutsNoHist.EnableSilentMode();
+    EXPECT_TRUE(cuts.HasHistograms());
+    EXPECT_FALSE(cutsNoHist.HasHistograms());
+    RandomStream rngCuts(1);
+    RandomStream rngCutsNoHist(1);
+
+    event->SetDecay(Ps, 3, masses3);
+    for (int n=0; n<simSteps; n++)
+    {
+       double weight = event->Generate(&rng);
+       for(int ii=0; ii<3; ii++)
+           fourMomenta[ii] = event->GetDecay(ii);
+       Event eventDecay(&sourcePar, &fourMomenta, weight, type);
+       Event eventDecayNoHist(&sourcePar, &fourMomenta, weight, type);
+       cuts.AddCuts(&eventDecay, &rngCuts);
+       cutsNoHist.AddCuts(&eventDecayNoHist, &rngCutsNoHist);
+       EXPECT_EQ(eventDecay.GetPassFlag(), eventDecayNoHist.GetPassFlag());
+    }
+    EXPECT_EQ(cuts.GetAcceptedEvents(), cutsNoHist.GetAcceptedEvents());
+    EXPECT_EQ(cuts.GetAcceptedGammas(), cutsNoHist.GetAcceptedGammas());
+    EXPECT_GT(cutsNoHist.GetAcceptedEvents(), 0);
+    EXPECT_THROW(cuts.Merge(cutsNoHist), std::string);
+
+    mkdir("test_tmp_nohist", ACCESSPERMS);
+    cutsNoHist.DrawHistograms("test_tmp_nohist/");
+    EXPECT_TRUE(boost::filesystem::is_empty("test_tmp_nohist"));
+    boost::filesystem::remove_all("test_tmp_nohist");
+    for(unsigned ii=0; ii<sourcePar.size(); ii++)
+        delete sourcePar[ii];
+}
@@ -0,0 +1,212 @@
+/// @file eventbatch_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check that events processed as an EventBatch are identical to events processed one by one.
+#include "gtest/gtest.h"
+#include "../../src/simulationworker.h"
+#include "../../src/particlegenerator.h"
+
+///
+/// \brief The EventBatchTestFixture class Sets the necessary fields for tests in this test case.
+///
+class EventBatchTestFixture: public ::testing::Test
+{
+    public:
+       ParamManager pManag;
+       TLorentzVector Ps;  //four-momentum vector of the source
+       TLorentzVector sourcePos; //position of the source
+
+       EventBatchTestFixture( )
+       {
+          Ps = TLorentzVector(0.0, 0.0, 0.0, 1.022/1000);
+          sourcePos = TLorentzVector(0.0, 0.0, 0.0, 10.0);
+          pManag.SetR(437.3);
+          pManag.SetL(500);
+          pManag.SetEff(0.5);
+          pManag.SetP(0.98);
+          pManag.SetE(1157);
+          pManag.SetSeed(123456789);
+          pManag.SetSimEvents(SimulationWorker::kBlockSize);
+          pManag.SetUseOfPhantom(true);
+          pManag.SetPhantomNaive511Prob(0.5);
+          pManag.SetPhantomNaivePromptProb(0.5);
+          pManag.SetEventTypeToSave(ALL);
+          pManag.EnableSilentMode();
+       }
+};
+
+///
+/// \brief TEST_F This test compares events simulated by a worker (as a batch) with events simulated one by one.
+///
+TEST_F(EventBatchTestFixture, BatchEqualsSingleEvents)
+{
+    const DecayType types[] = {TWO, THREE, TWOandONE};
+    for(DecayType type : types)
+    {
+        SimulationWorker worker(Ps, sourcePos, pManag, type, 0, true);
+        worker.ProcessBlock(0);
+        ASSERT_EQ(SimulationWorker::kBlockSize, worker.GetNumberOfStoredEvents());
+
+        //the same pipeline, event by event
+        int noOfGammas = 0;
+        recognizeType(type, noOfGammas);
+        PhaseSpaceGenerator generator;
+        double masses[3] = {0.0, 0.0, 0.0};
+        generator.SetDecay(Ps, noOfGammas, masses);
+        RandomStream generationRandom(pManag.GetSeed());
+        RandomStream phantomRandom(pManag.GetSeed());
+        RandomStream cutsRandom(pManag.GetSeed());
+        RandomStream comptonRandom(pManag.GetSeed());
+        generationRandom.SetStream(RandomStream::DeriveKey(pManag.GetSeed(), 0, type, RandomStream::GENERATION));
+        phantomRandom.SetStream(RandomStream::DeriveKey(pManag.GetSeed(), 0, type, RandomStream::PHANTOM));
+        cutsRandom.SetStream(RandomStream::DeriveKey(pManag.GetSeed(), 0, type, RandomStream::CUTS));
+        comptonRandom.SetStream(RandomStream::DeriveKey(pManag.GetSeed(), 0, type, RandomStream::COMPTON));
+        Phantom phantom(pManag.GetPhantomNaive511Prob(), pManag.GetPhantomNaivePromptProb(), pManag.GetPhantomSmear(), type);
+        InitialCuts cuts(type, pManag.GetR(), pManag.GetL(), pManag.GetEff());
+        ComptonScattering compton(type, pManag.GetSmearLowLimit(), pManag.GetSmearHighLimit());
+        Event event(type);
+        for(long n=0; n<SimulationWorker::kBlockSize; n++)
+        {
+            generationRandom.SetSubstream(n);
+            phantomRandom.SetSubstream(n);
+            cutsRandom.SetSubstream(n);
+            comptonRandom.SetSubstream(n);
+            generateEvent(event, generator, sourcePos, pManag, type, &generationRandom);
+            phantom.NaiveScatter(&event, &phantomRandom);
+            cuts.AddCuts(&event, &cutsRandom);
+            compton.Scatter(&event, &comptonRandom);
+
+            const Event* stored = worker.GetStoredEvent(n);
+            ASSERT_EQ(event.GetNumberOfDecayProducts(), stored->GetNumberOfDecayProducts());
+            ASSERT_EQ(event.GetWeight(), stored->GetWeight());
+            ASSERT_EQ(event.GetPassFlag(), stored->GetPassFlag());
+            for(int ii=0; ii<event.GetNumberOfDecayProducts(); ii++)
+            {
+                ASSERT_TRUE(*event.GetEmissionPointOf(ii) == *stored->GetEmissionPointOf(ii));
+                ASSERT_TRUE(*event.GetFourMomentumOf(ii) == *stored->GetFourMomentumOf(ii));
+                ASSERT_TRUE(*event.GetHitPointOf(ii) == *stored->GetHitPointOf(ii));
+                ASSERT_EQ(event.GetHitPhiOf(ii), stored->GetHitPhiOf(ii));
+                ASSERT_EQ(event.GetHitThetaOf(ii), stored->GetHitThetaOf(ii));
+                ASSERT_EQ(event.GetCutPassingOf(ii), stored->GetCutPassingOf(ii));
+                ASSERT_EQ(event.GetPrimaryPhoton(ii), stored->GetPrimaryPhoton(ii));
+                ASSERT_EQ(event.GetEdepOf(ii), stored->GetEdepOf(ii));
+                ASSERT_EQ(event.GetEdepSmearOf(ii), stored->GetEdepSmearOf(ii));
+            }
+        }
+    }
+}
+
+///
+/// \brief checkDecayTraits Generates a batch of the given type and checks that its events agree with DecayTraits.
+/// \tparam kType Type of decays.
+/// \param pManag Parameters of the simulation.
+/// \param Ps Four-momentum of the source.
+/// \param sourcePos Position of the source.
+///
+template<DecayType kType>
+void checkDecayTraits(const ParamManager& pManag, const TLorentzVector& Ps, const TLorentzVector& sourcePos)
+{
+    MasslessPhaseSpace generator(SimulationWorker::kBlockSize);
+    generator.SetDecay(Ps, DecayTraits<kType>::kDecayPhotons);
+    RandomStream rng(pManag.GetSeed());
+    EventBatch batch(kType, SimulationWorker::kBlockSize, 3);
+    generateEvents(batch, 0, SimulationWorker::kBlockSize, generator, sourcePos, pManag, &rng);
+    for(int ii=0; ii<batch.GetSize(); ii++)
+    {
+        ASSERT_EQ(batch.GetNumberOfDecayProducts(ii), batch.GetNumberOfDecayProducts<kType>(ii));
+        ASSERT_LE(DecayTraits<kType>::kDecayPhotons, batch.GetNumberOfDecayProducts(ii));
+        ASSERT_LE(batch.GetNumberOfDecayProducts(ii), DecayTraits<kType>::kMaxPhotons);
+    }
+}
+
+///
+/// \brief TEST_F This test checks that numbers of photons known at compile time agree with generated events.
+///
+TEST_F(EventBatchTestFixture, DecayTraitsMatchEvents)
+{
+    checkDecayTraits<ONE>(pManag, Ps, sourcePos);
+    checkDecayTraits<TWO>(pManag, Ps, sourcePos);
+    checkDecayTraits<THREE>(pManag, Ps, sourcePos);
+    checkDecayTraits<TWOandONE>(pManag, Ps, sourcePos);
+    ASSERT_EQ(0, DecayTraits<TWOandONE>::kFixedPhotons);
+    ASSERT_EQ(0, DecayTraits<TWOandN>::kMaxPhotons);
+}
+
+///
+/// \brief TEST_F This test checks that removing events that missed the detector right after generation does not change
+/// saved events and counters of cuts.
+///
+TEST_F(EventBatchTestFixture, EarlyRejectEqualsFullPipeline)
+{
+    const DecayType types[] = {TWO, THREE, TWOandONE};
+    pManag.SetL(100);
+    pManag.SetSimEvents(3*SimulationWorker::kBlockSize);
+    pManag.SetEventTypeToSave(PASS);
+    sourcePos = TLorentzVector(150.0, -80.0, 30.0, 10.0);
+    for(DecayType type : types)
+    {
+        SimulationWorker full(Ps, sourcePos, pManag, type, 0, true);
+        pManag.SetEarlyReject(true);
+        ASSERT_TRUE(pManag.IsEarlyRejectActive());
+        SimulationWorker early(Ps, sourcePos, pManag, type, 0, true);
+        pManag.SetEarlyReject(false);
+        for(long block=0; block<3; block++)
+        {
+            full.ClearStoredEvents();
+            early.ClearStoredEvents();
+            full.ProcessBlock(block);
+            early.ProcessBlock(block);
+            ASSERT_GT(full.GetNumberOfStoredEvents(), 0);
+            ASSERT_EQ(full.GetNumberOfStoredEvents(), early.GetNumberOfStoredEvents());
+            for(long ii=0; ii<early.GetNumberOfStoredEvents(); ii++)
+            {
+                const Event* expected = full.GetStoredEvent(ii);
+                const Event* event = early.GetStoredEvent(ii);
+                ASSERT_EQ(expected->fId, event->fId);
+                ASSERT_EQ(expected->GetWeight(), event->GetWeight());
+                ASSERT_TRUE(event->GetPassFlag());
+                ASSERT_EQ(expected->GetNumberOfDecayProducts(), event->GetNumberOfDecayProducts());
+                for(int jj=0; jj<event->GetNumberOfDecayProducts(); jj++)
+                {
+                    ASSERT_TRUE(*expected->GetFourMomentumOf(jj) == *event->GetFourMomentumOf(jj));
+                    ASSERT_EQ(expected->GetEdepOf(jj), event->GetEdepOf(jj));
+                    ASSERT_EQ(expected->GetEdepSmearOf(jj), event->GetEdepSmearOf(jj));
+                    ASSERT_EQ(expected->GetCutPassingOf(jj), event->GetCutPassingOf(jj));
+                }
+            }
+        }
+        ASSERT_EQ(full.GetCuts().GetAcceptedEvents(), early.GetCuts().GetAcceptedEvents());
+        ASSERT_EQ(full.GetCuts().GetAcceptedGammas(), early.GetCuts().GetAcceptedGammas());
+    }
+}
+
+///
+/// \brief TEST_F This test checks that fourmomenta copied from the batch (already in MeV) are not scaled again.
+///
+TEST_F(EventBatchTestFixture, CopyToEventKeepsMeV)
+{
+    EventBatch batch(TWO, 1, 2);
+    batch.Clear(0);
+    EventBatch::EventSlot slot = batch.AddEvent();
+    slot.Reset(TWO, 1.0);
+    Event expected(TWO, 2);
+    expected.Reset(TWO, 1.0);
+    const TLorentzVector emissionPoint(1.0, 2.0, 3.0, 0.0);
+    const TLorentzVector fourMomenta[2] = {TLorentzVector(0.3, 0.4, 0.0, 0.5), TLorentzVector(-0.3, -0.4, 0.0, 0.5)};
+    for(const TLorentzVector& fourMomentum : fourMomenta)
+    {
+        slot.AddDecayProduct(emissionPoint, fourMomentum);
+        expected.AddDecayProduct(emissionPoint, fourMomentum);
+    }
+    Event event(TWO, 2);
+    batch.CopyToEvent(0, event);
+    ASSERT_EQ(2, event.GetNumberOfDecayProducts());
+    for(int ii=0; ii<2; ii++)
+    {
+        ASSERT_TRUE(*expected.GetFourMomentumOf(ii) == *event.GetFourMomentumOf(ii));
+        ASSERT_DOUBLE_EQ(500.0, event.GetFourMomentumOf(ii)->T());
+    }
+}
@@ -0,0 +1,112 @@
+/// @file flatevent_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check that events written in the flat tree schema are identical to simulated Event objects.
+#include "gtest/gtest.h"
+#include "TTree.h"
+#include "../../src/flatevent.h"
+#include "../../src/simulationworker.h"
+
+///
+/// \brief TEST This test writes events of two decay types to one flat tree and compares the columns with the events.
+///
+TEST(FlatEventTest, ColumnsEqualEvents)
+{
+    ParamManager pManag;
+    pManag.SetR(437.3);
+    pManag.SetL(500);
+    pManag.SetEff(0.5);
+    pManag.SetP(0.98);
+    pManag.SetE(1157);
+    pManag.SetSeed(123456789);
+    pManag.SetSimEvents(100);
+    pManag.SetEventTypeToSave(ALL);
+    pManag.EnableSilentMode();
+    TLorentzVector Ps(0.0, 0.0, 0.0, 1.022/1000);
+    TLorentzVector sourcePos(0.0, 0.0, 0.0, 10.0);
+
+    SimulationWorker twoWorker(Ps, sourcePos, pManag, TWO, 0, true);
+    SimulationWorker twoAndOneWorker(Ps, sourcePos, pManag, TWOandONE, 0, true);
+    twoWorker.ProcessBlock(0);
+    twoAndOneWorker.ProcessBlock(0);
+    TTree tree("flat", "flat");
+    tree.SetDirectory(nullptr);
+    {
+        //the second buffer reuses branches created by the first one
+        FlatEvent twoFlat(twoWorker.GetMaxDecayProducts());
+        FlatEvent twoAndOneFlat(twoAndOneWorker.GetMaxDecayProducts());
+        twoFlat.Attach(&tree);
+        for(long ii=0; ii<twoWorker.GetNumberOfStoredEvents(); ii++)
+        {
+            twoFlat.Set(*twoWorker.GetStoredEvent(ii));
+            tree.Fill();
+        }
+        twoAndOneFlat.Attach(&tree);
+        for(long ii=0; ii<twoAndOneWorker.GetNumberOfStoredEvents(); ii++)
+        {
+            twoAndOneFlat.Set(*twoAndOneWorker.GetStoredEvent(ii));
+            tree.Fill();
+        }
+        tree.ResetBranchAddresses();
+    }
+    ASSERT_EQ(twoWorker.GetNumberOfStoredEvents()+twoAndOneWorker.GetNumberOfStoredEvents(), tree.GetEntries());
+
+    const int kMax = 3;
+    Long64_t id = 0;
+    Int_t decayType = 0, nPhotons = 0;
+    Double_t weight = 0.0, px[kMax], E[kMax], hitX[kMax], hitT[kMax], hitTheta[kMax], edepSmear[kMax];
+    Bool_t passFlag = false, cutPassing[kMax], primary[kMax];
+    tree.SetBranchAddress("id", &id);
+    tree.SetBranchAddress("decayType", &decayType);
+    tree.SetBranchAddress("weight", &weight);
+    tree.SetBranchAddress("passFlag", &passFlag);
+    tree.SetBranchAddress("nPhotons", &nPhotons);
+    tree.SetBranchAddress("px", px);
+    tree.SetBranchAddress("E", E);
+    tree.SetBranchAddress("hitX", hitX);
+    tree.SetBranchAddress("hitT", hitT);
+    tree.SetBranchAddress("hitTheta", hitTheta);
+    tree.SetBranchAddress("edepSmear", edepSmear);
+    tree.SetBranchAddress("cutPassing", cutPassing);
+    tree.SetBranchAddress("primary", primary);
+    for(Long64_t entry=0; entry<tree.GetEntries(); entry++)
+    {
+        tree.GetEntry(entry);
+        const bool isTwo = entry < twoWorker.GetNumberOfStoredEvents();
+        const Event* event = isTwo ? twoWorker.GetStoredEvent(entry)\
+                                   : twoAndOneWorker.GetStoredEvent(entry-twoWorker.GetNumberOfStoredEvents());
+        ASSERT_EQ(event->fId, id);
+        ASSERT_EQ(event->GetDecayType(), decayType);
+        ASSERT_EQ(event->GetWeight(), weight);
+        ASSERT_EQ(event->GetPassFlag(), passFlag);
+        ASSERT_EQ(event->GetNumberOfDecayProducts(), nPhotons);
+        for(int ii=0; ii<nPhotons; ii++)
+        {
+            ASSERT_EQ(event->GetFourMomentumOf(ii)->Px(), px[ii]);
+            ASSERT_EQ(event->GetFourMomentumOf(ii)->E(), E[ii]);
+            ASSERT_EQ(event->GetHitPointOf(ii)->X(), hitX[ii]);
+            ASSERT_EQ(event->GetHitPointOf(ii)->T(), hitT[ii]);
+            ASSERT_EQ(event->GetHitThetaOf(ii), hitTheta[ii]);
+            ASSERT_EQ(event->GetEdepSmearOf(ii), edepSmear[ii]);
+            ASSERT_EQ(event->GetCutPassingOf(ii), cutPassing[ii]);
+            ASSERT_EQ(event->GetPrimaryPhoton(ii), primary[ii]);
+        }
+    }
+    tree.ResetBranchAddresses();
+}
+
+///
+/// \brief TEST This test checks that an event with more photons than the capacity is refused.
+///
+TEST(FlatEventTest, CapacityExceeded)
+{
+    Event event(TWO, 2);
+    event.Reset(TWO, 1.0);
+    for(int ii=0; ii<2; ii++)
+        event.AddDecayProduct(TLorentzVector(0.0, 0.0, 0.0, 0.0), TLorentzVector(0.0, 0.0, 0.000511, 0.000511));
+    FlatEvent flat(1);
+    ASSERT_THROW(flat.Set(event), std::string);
+}
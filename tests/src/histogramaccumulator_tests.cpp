@@ -0,0 +1,94 @@
+/// @file histogramaccumulator_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check that histograms filled through HistogramAccumulator are identical to histograms filled directly.
+#include "gtest/gtest.h"
+#include "TH1F.h"
+#include "TH2F.h"
+#include "../../src/histogramaccumulator.h"
+#include "../../src/randomstream.h"
+
+///
+/// \brief TEST This test compares one-dimensional histograms, including underflow, overflow and weighted fills.
+///
+TEST(HistogramAccumulatorTest, OneDimensional)
+{
+    TH1F direct("direct1D", "direct1D", 52, -1.0, 1.0);
+    TH1F* target = new TH1F("accumulated1D", "accumulated1D", 52, -1.0, 1.0);
+    HistogramAccumulator<TH1F> accumulator;
+    accumulator = target;
+    RandomStream rng(123456789);
+    for(int ii=0; ii<10000; ii++)
+    {
+        double x = rng.Uniform(-1.2, 1.2);
+        double w = ii%3 ? 1.0 : rng.Uniform(0.5, 1.5);
+        direct.Fill(x, w);
+        accumulator.Fill(x, w);
+        //the content is merged several times, statistics must still be correct
+        if(ii%2500==0)
+        {
+            ASSERT_EQ(direct.GetEntries(), accumulator->GetEntries());
+        }
+    }
+    accumulator.Fill(-1.0); //edges of the axis
+    direct.Fill(-1.0);
+    accumulator.Fill(1.0);
+    direct.Fill(1.0);
+    ASSERT_EQ(direct.GetEntries(), accumulator->GetEntries());
+    ASSERT_EQ(direct.GetSumw2N(), accumulator->GetSumw2N());
+    for(int bin=0; bin<=direct.GetNbinsX()+1; bin++)
+    {
+        ASSERT_NEAR(direct.GetBinContent(bin), accumulator->GetBinContent(bin), 1e-3);
+        ASSERT_NEAR(direct.GetBinError(bin), accumulator->GetBinError(bin), 1e-3);
+    }
+    ASSERT_NEAR(direct.GetMean(), accumulator->GetMean(), 1e-9);
+    ASSERT_NEAR(direct.GetRMS(), accumulator->GetRMS(), 1e-9);
+    //the histogram is given back to its owner, the accumulator no longer refers to it
+    accumulator.Fill(0.5);
+    ASSERT_EQ(target, accumulator.Release());
+    ASSERT_EQ(direct.GetEntries()+1, target->GetEntries());
+    ASSERT_EQ(nullptr, accumulator.Get());
+    delete target;
+}
+
+///
+/// \brief TEST This test compares two-dimensional histograms and their Fill(x, y) and Fill(x, y, w).
+///
+TEST(HistogramAccumulatorTest, TwoDimensional)
+{
+    TH2F direct("direct2D", "direct2D", 50, 0.0, 3.15, 40, 0.0, 3.15);
+    TH2F* target = new TH2F("accumulated2D", "accumulated2D", 50, 0.0, 3.15, 40, 0.0, 3.15);
+    HistogramAccumulator<TH2F> accumulator;
+    accumulator = target;
+    RandomStream rng(123456789);
+    for(int ii=0; ii<10000; ii++)
+    {
+        double x = rng.Uniform(-0.1, 3.3);
+        double y = rng.Uniform(-0.1, 3.3);
+        if(ii%2)
+        {
+            direct.Fill(x, y);
+            accumulator.Fill(x, y);
+        }
+        else
+        {
+            direct.Fill(x, y, 0.25);
+            accumulator.Fill(x, y, 0.25);
+        }
+    }
+    ASSERT_EQ(direct.GetEntries(), accumulator->GetEntries());
+    for(int binx=0; binx<=direct.GetNbinsX()+1; binx++)
+    {
+        for(int biny=0; biny<=direct.GetNbinsY()+1; biny++)
+        {
+            ASSERT_NEAR(direct.GetBinContent(binx, biny), accumulator->GetBinContent(binx, biny), 1e-3);
+        }
+    }
+    ASSERT_NEAR(direct.GetMean(1), accumulator->GetMean(1), 1e-9);
+    ASSERT_NEAR(direct.GetMean(2), accumulator->GetMean(2), 1e-9);
+    ASSERT_NEAR(direct.GetCorrelationFactor(), accumulator->GetCorrelationFactor(), 1e-9);
+    delete accumulator.Release();
+}
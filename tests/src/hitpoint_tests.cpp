@@ -0,0 +1,122 @@
+/// @file hitpoint_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check the HitPointKernel against the previous scalar implementation of Event::CalculateHitPoints.
+#include <vector>
+#include <algorithm>
+#include "gtest/gtest.h"
+#include "../../src/hitpointkernel.h"
+#include "../../src/randomstream.h"
+#include "../../src/constants.h"
+
+///
+/// \brief The HitPointTestFixture class Generates photon rays used by tests in this test case.
+///
+class HitPointTestFixture: public ::testing::Test
+{
+    public:
+       static const int kNoOfRays = 1003; //not a multiple of the vector width, so remainders are tested too
+       const double R = 437.3;
+       const double L = 500;
+       std::vector<double> x0, y0, z0, px, py, pz, E;
+       std::vector<double> hitX, hitY, hitZ, hitT, hitPhi, hitTheta;
+
+       HitPointTestFixture( ) : x0(kNoOfRays), y0(kNoOfRays), z0(kNoOfRays), px(kNoOfRays), py(kNoOfRays), pz(kNoOfRays),\
+           E(kNoOfRays), hitX(kNoOfRays), hitY(kNoOfRays), hitZ(kNoOfRays), hitT(kNoOfRays), hitPhi(kNoOfRays), hitTheta(kNoOfRays)
+       {
+          RandomStream rng(123456789);
+          for(int ii=0; ii<kNoOfRays; ii++)
+          {
+              x0[ii] = rng.Uniform(-10.0, 10.0);
+              y0[ii] = rng.Uniform(-10.0, 10.0);
+              z0[ii] = rng.Uniform(-10.0, 10.0);
+              E[ii] = rng.Uniform(0.0, 2.0);
+              double cosTheta = rng.Uniform(-1.0, 1.0);
+              double sinTheta = TMath::Sqrt(1-cosTheta*cosTheta);
+              double phi = rng.Uniform(0.0, 2*TMath::Pi());
+              px[ii] = E[ii]*sinTheta*TMath::Cos(phi);
+              py[ii] = E[ii]*sinTheta*TMath::Sin(phi);
+              pz[ii] = E[ii]*cosTheta;
+          }
+          //special cases: photons along the axis, without energy and emitted from the center
+          px[0] = py[0] = 0.0;
+          px[1] = py[1] = pz[1] = E[1] = 0.0;
+          x0[2] = y0[2] = z0[2] = 0.0;
+          px[3] = 1e-12;
+          py[3] = 0.0;
+       }
+
+       PhotonRays GetRays() const
+       {
+           PhotonRays rays = {x0.data(), y0.data(), z0.data(), px.data(), py.data(), pz.data(), E.data()};
+           return rays;
+       }
+
+       CylinderHits GetHits()
+       {
+           CylinderHits hits = {hitX.data(), hitY.data(), hitZ.data(), hitT.data(), hitPhi.data(), hitTheta.data()};
+           return hits;
+       }
+};
+
+///
+/// \brief TEST_F Compares the scalar kernel with the previous implementation of Event::CalculateHitPoints.
+/// Hit points and angles have to be identical, time of flight was calculated in long double and may differ in the last bits.
+///
+TEST_F(HitPointTestFixture, KernelEqualsPreviousImplementation)
+{
+    CylinderHits hits = GetHits();
+    HitPointKernel::Calculate(kNoOfRays, GetRays(), R, L, hits, HitPointKernel::SCALAR);
+    for(int ii=0; ii<kNoOfRays; ii++)
+    {
+        double refX = -2000, refY = -2000, refZ = -2000, refT = -2000, refPhi = -4, refTheta = -4;
+        double pt2 = px[ii]*px[ii]+py[ii]*py[ii];
+        if(TMath::Sqrt(pt2) > TMath::Power(10, -10))
+        {
+            double delta = 4*(x0[ii]*px[ii]+y0[ii]*py[ii])*(x0[ii]*px[ii]+y0[ii]*py[ii]) - 4*(x0[ii]*x0[ii]+y0[ii]*y0[ii]-R*R)*pt2;
+            double s = (-2*(x0[ii]*px[ii]+y0[ii]*py[ii])+TMath::Sqrt(delta))/2/pt2;
+            if(!(TMath::Abs(z0[ii]+pz[ii]*s) > L/2.0))
+            {
+                refX = x0[ii]+px[ii]*s;
+                refY = y0[ii]+py[ii]*s;
+                refZ = z0[ii]+pz[ii]*s;
+                refT = E[ii]*s*1000000/light_speed_SI;
+                refPhi = refX == 0.0 && refY == 0.0 ? 0.0 : TMath::ATan2(refY, refX);
+                refTheta = refX == 0.0 && refY == 0.0 && refZ == 0.0 ? 0.0 : TMath::ATan2(TMath::Sqrt(refX*refX + refY*refY), refZ);
+            }
+        }
+        ASSERT_EQ(refX, hitX[ii]);
+        ASSERT_EQ(refY, hitY[ii]);
+        ASSERT_EQ(refZ, hitZ[ii]);
+        ASSERT_DOUBLE_EQ(refT, hitT[ii]);
+        ASSERT_EQ(refPhi, hitPhi[ii]);
+        ASSERT_EQ(refTheta, hitTheta[ii]);
+    }
+}
+
+///
+/// \brief TEST_F Checks that all vector implementations supported by the CPU give results identical to the scalar one.
+///
+TEST_F(HitPointTestFixture, VectorEqualsScalar)
+{
+    CylinderHits hits = GetHits();
+    HitPointKernel::Calculate(kNoOfRays, GetRays(), R, L, hits, HitPointKernel::SCALAR);
+    std::vector<double> scalar[6] = {hitX, hitY, hitZ, hitT, hitPhi, hitTheta};
+    const HitPointKernel::Implementation impls[] = {HitPointKernel::AVX2, HitPointKernel::AVX512, HitPointKernel::AUTO};
+    for(HitPointKernel::Implementation impl : impls)
+    {
+        if(!HitPointKernel::IsSupported(impl))
+            continue;
+        std::vector<double>* results[6] = {&hitX, &hitY, &hitZ, &hitT, &hitPhi, &hitTheta};
+        for(int jj=0; jj<6; jj++)
+            std::fill(results[jj]->begin(), results[jj]->end(), 0.0);
+        HitPointKernel::Calculate(kNoOfRays, GetRays(), R, L, hits, impl);
+        std::vector<double> vect[6] = {hitX, hitY, hitZ, hitT, hitPhi, hitTheta};
+        for(int jj=0; jj<6; jj++)
+            for(int ii=0; ii<kNoOfRays; ii++)
+                ASSERT_EQ(scalar[jj][ii], vect[jj][ii]);
+    }
+}
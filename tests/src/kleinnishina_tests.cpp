@@ -0,0 +1,75 @@
+/// @file kleinnishina_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check if KleinNishinaSampler reproduces the Klein-Nishina distribution.
+/// Statistical tests use fixed seeds, so they give the same result in every run.
+#include <algorithm>
+#include <vector>
+#include "gtest/gtest.h"
+#include "../../src/kleinnishinasampler.h"
+#include "../../src/randomstream.h"
+
+///
+/// \brief maxCDFDistance Calculates the largest distance between the empirical and the exact cumulative distribution.
+/// \param E Energy of the incident photon [MeV].
+/// \param samples Drawn cosines of the scattering angle, they are sorted by this function.
+/// \return Kolmogorov-Smirnov-like distance evaluated on a grid of cosines.
+///
+double maxCDFDistance(double E, std::vector<double>& samples)
+{
+    std::sort(samples.begin(), samples.end());
+    double distance = 0.0;
+    for(int ii=1; ii<100; ii++)
+    {
+        double cosTheta = -1.0 + ii*0.02;
+        double empirical = (std::lower_bound(samples.begin(), samples.end(), cosTheta) - samples.begin())/double(samples.size());
+        distance = std::max(distance, std::abs(empirical - KleinNishinaSampler::CDF(E, cosTheta)));
+    }
+    return distance;
+}
+
+///
+/// \brief TEST This test checks if the interpolated table inverts the cumulative distribution.
+///
+TEST(KleinNishinaSamplerTest, TableInvertsCDF)
+{
+    const KleinNishinaSampler& sampler = KleinNishinaSampler::GetDefault();
+    const double energies[] = {0.05, 0.341, 0.511, 1.157, 4.0};
+    for(double E : energies)
+    {
+        for(int ii=0; ii<=100; ii++)
+        {
+            double u = ii*0.01;
+            ASSERT_NEAR(u, KleinNishinaSampler::CDF(E, sampler.InverseCDF(E, u), 100000), 1e-4);
+        }
+    }
+}
+
+///
+/// \brief TEST This test compares distributions drawn with the table and with Kahn's method with the exact one.
+///
+TEST(KleinNishinaSamplerTest, TableAndKahnDistributions)
+{
+    const KleinNishinaSampler& sampler = KleinNishinaSampler::GetDefault();
+    const double energies[] = {0.2, 0.511, 1.157, 25.0}; //the last one is outside of the table
+    const int noOfSamples = 100000;
+    RandomStream rng(123456789);
+    for(double E : energies)
+    {
+        std::vector<double> table(noOfSamples);
+        std::vector<double> kahn(noOfSamples);
+        for(int ii=0; ii<noOfSamples; ii++)
+        {
+            table[ii] = sampler.SampleCosTheta(E, &rng);
+            kahn[ii] = KleinNishinaSampler::SampleCosThetaKahn(E, &rng);
+            ASSERT_LE(-1.0, table[ii]);
+            ASSERT_GE(1.0, table[ii]);
+        }
+        //critical value of the Kolmogorov-Smirnov test at the 0.001 level is 1.95/sqrt(N)
+        ASSERT_LT(maxCDFDistance(E, table), 0.0062);
+        ASSERT_LT(maxCDFDistance(E, kahn), 0.0062);
+    }
+}
@@ -0,0 +1,184 @@
+/// @file masslessphasespace_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check that MasslessPhaseSpace generates the same decays as PhaseSpaceGenerator and the same
+/// distributions as TGenPhaseSpace, for sources at rest and moving ones.
+/// Statistical tests use fixed seeds, so they give the same result in every run.
+#include <string>
+#include "gtest/gtest.h"
+#include "TGenPhaseSpace.h"
+#include "TRandom.h"
+#include "TH1D.h"
+#include "TMath.h"
+#include "../../src/masslessphasespace.h"
+#include "../../src/particlegenerator.h"
+
+///
+/// \brief The MasslessPhaseSpaceTestFixture class Sets the necessary fields for tests in this test case.
+///
+class MasslessPhaseSpaceTestFixture: public ::testing::Test
+{
+    public:
+       ParamManager pManag;
+       TLorentzVector sources[2]; //four-momenta of sources at rest and moving [GeV]
+       TLorentzVector sourcePos; //position of the source
+
+       MasslessPhaseSpaceTestFixture() :
+           sourcePos(0.0, 0.0, 0.0, 10.0)
+       {
+           pManag.SetSeed(31415);
+           pManag.EnableSilentMode();
+           sources[0] = TLorentzVector(0.0, 0.0, 0.0, 1.022/1000);
+           sources[1] = TLorentzVector(20.0/1000000, -10.0/1000000, 35.0/1000000, 1.022/1000);
+       }
+};
+
+///
+/// \brief TEST_F This test checks that decays are bit-identical to the ones of PhaseSpaceGenerator.
+///
+TEST_F(MasslessPhaseSpaceTestFixture, EqualsPhaseSpaceGenerator)
+{
+    double masses[3] = {0.0, 0.0, 0.0};
+    for(const TLorentzVector& Ps : sources)
+    {
+        for(int nt=2; nt<=3; nt++)
+        {
+            PhaseSpaceGenerator generic;
+            MasslessPhaseSpace massless;
+            ASSERT_TRUE(generic.SetDecay(Ps, nt, masses));
+            ASSERT_TRUE(massless.SetDecay(Ps, nt));
+            ASSERT_EQ(generic.GetWtMax(), massless.GetWtMax());
+            RandomStream genericRandom(pManag.GetSeed());
+            RandomStream masslessRandom(pManag.GetSeed());
+            for(long n=0; n<10000; n++)
+            {
+                genericRandom.SetSubstream(n);
+                masslessRandom.SetSubstream(n);
+                ASSERT_EQ(generic.Generate(&genericRandom), massless.Generate(&masslessRandom));
+                for(int ii=0; ii<nt; ii++)
+                    ASSERT_TRUE(*generic.GetDecay(ii) == *massless.GetDecay(ii));
+                //the same number of random numbers was drawn
+                ASSERT_EQ(genericRandom.Rndm(), masslessRandom.Rndm());
+            }
+        }
+    }
+    MasslessPhaseSpace massless;
+    ASSERT_FALSE(massless.SetDecay(sources[0], 4));
+    ASSERT_FALSE(massless.SetDecay(TLorentzVector(0.0, 0.0, 0.0, 0.0), 2));
+}
+
+///
+/// \brief TEST_F This test checks that batches generated at once are bit-identical to batches generated event by event.
+///
+TEST_F(MasslessPhaseSpaceTestFixture, BatchEqualsGenericBatch)
+{
+    const int capacity = 500;
+    const DecayType types[] = {TWO, THREE, TWOandONE};
+    double masses[3] = {0.0, 0.0, 0.0};
+    for(const TLorentzVector& Ps : sources)
+    {
+        for(DecayType type : types)
+        {
+            int noOfGammas = 0;
+            recognizeType(type, noOfGammas);
+            PhaseSpaceGenerator generic;
+            MasslessPhaseSpace massless(capacity);
+            generic.SetDecay(Ps, noOfGammas, masses);
+            massless.SetDecay(Ps, noOfGammas);
+            RandomStream rng(pManag.GetSeed());
+            EventBatch expected(type, capacity, 3);
+            EventBatch batch(type, capacity, 3);
+            generateEvents(expected, 3*capacity, capacity, generic, sourcePos, pManag, &rng);
+            generateEvents(batch, 3*capacity, capacity, massless, sourcePos, pManag, &rng);
+            ASSERT_EQ(expected.GetSize(), batch.GetSize());
+            for(int ii=0; ii<batch.GetSize(); ii++)
+            {
+                ASSERT_EQ(expected.fWeight[ii], batch.fWeight[ii]);
+                ASSERT_EQ(expected.GetNumberOfDecayProducts(ii), batch.GetNumberOfDecayProducts(ii));
+                for(int jj=0; jj<batch.GetNumberOfDecayProducts(ii); jj++)
+                {
+                    const int index = batch.Index(jj, ii);
+                    ASSERT_EQ(expected.fPx[index], batch.fPx[index]);
+                    ASSERT_EQ(expected.fPy[index], batch.fPy[index]);
+                    ASSERT_EQ(expected.fPz[index], batch.fPz[index]);
+                    ASSERT_EQ(expected.fE[index], batch.fE[index]);
+                    ASSERT_EQ(expected.fX[index], batch.fX[index]);
+                }
+            }
+        }
+    }
+}
+
+///
+/// \brief TEST_F This test compares distributions of energies and angles of photons with the ones of TGenPhaseSpace.
+///
+TEST_F(MasslessPhaseSpaceTestFixture, DistributionsEqualTGenPhaseSpace)
+{
+    const int noOfEvents = 200000;
+    double masses[3] = {0.0, 0.0, 0.0};
+    int histId = 0;
+    for(TLorentzVector Ps : sources)
+    {
+        for(int nt=2; nt<=3; nt++)
+        {
+            TGenPhaseSpace reference;
+            MasslessPhaseSpace massless;
+            ASSERT_TRUE(reference.SetDecay(Ps, nt, masses));
+            ASSERT_TRUE(massless.SetDecay(Ps, nt));
+            gRandom->SetSeed(27182);
+            RandomStream rng(pManag.GetSeed());
+            //histograms of TGenPhaseSpace (index 0) and MasslessPhaseSpace (index 1) decays
+            TH1D* energy[2];
+            TH1D* cosTheta[2];
+            TH1D* cosAngle[2];
+            for(int kk=0; kk<2; kk++)
+            {
+                const std::string suffix = std::to_string(histId++);
+                energy[kk] = new TH1D(("massless_energy_"+suffix).c_str(), "E [GeV]", 100, 0.0, 0.0006);
+                cosTheta[kk] = new TH1D(("massless_cosTheta_"+suffix).c_str(), "cos(theta)", 50, -1.0, 1.0);
+                cosAngle[kk] = new TH1D(("massless_cosAngle_"+suffix).c_str(), "cos of the angle between photons", 50, -1.0, 1.0);
+                energy[kk]->Sumw2();
+                cosTheta[kk]->Sumw2();
+                cosAngle[kk]->Sumw2();
+            }
+            for(int n=0; n<noOfEvents; n++)
+            {
+                double weights[2];
+                weights[0] = reference.Generate();
+                rng.SetSubstream(n);
+                weights[1] = massless.Generate(&rng);
+                for(int kk=0; kk<2; kk++)
+                {
+                    TLorentzVector* photons[3];
+                    for(int ii=0; ii<nt; ii++)
+                    {
+                        photons[ii] = kk==0 ? reference.GetDecay(ii) : massless.GetDecay(ii);
+                        energy[kk]->Fill(photons[ii]->E(), weights[kk]);
+                    }
+                    cosTheta[kk]->Fill(photons[0]->CosTheta(), weights[kk]);
+                    cosAngle[kk]->Fill(TMath::Cos(photons[0]->Angle(photons[1]->Vect())), weights[kk]);
+                }
+            }
+            //the same physical distribution, so the p-value of the chi2 test is not extremely small;
+            //energies and angles of 2-body decays at rest are fixed, hence they are compared only by their means
+            const bool continuous = nt==3 || Ps.Beta()>0;
+            if(continuous)
+            {
+                EXPECT_GT(energy[0]->Chi2Test(energy[1], "WW"), 1e-4) << "nt=" << nt << ", Pz=" << Ps.Pz();
+                EXPECT_GT(cosAngle[0]->Chi2Test(cosAngle[1], "WW"), 1e-4) << "nt=" << nt << ", Pz=" << Ps.Pz();
+            }
+            EXPECT_GT(cosTheta[0]->Chi2Test(cosTheta[1], "WW"), 1e-4) << "nt=" << nt << ", Pz=" << Ps.Pz();
+            EXPECT_NEAR(energy[0]->GetMean(), energy[1]->GetMean(), 5*energy[0]->GetMeanError()+1e-12);
+            EXPECT_NEAR(cosAngle[0]->GetMean(), cosAngle[1]->GetMean(), 5*cosAngle[0]->GetMeanError()+1e-9);
+            for(int kk=0; kk<2; kk++)
+            {
+                delete energy[kk];
+                delete cosTheta[kk];
+                delete cosAngle[kk];
+            }
+        }
+    }
+}
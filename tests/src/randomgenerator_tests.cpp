@@ -11,6 +11,7 @@
 #include "../../src/parammanager.h"
 #include "../../src/comptonscattering.h"
 #include "../../src/initialcuts.h"
+#include "../../src/randomstream.h"
 #include <fstream>
 #include <TLorentzVector.h>
 #define BOOST_NO_CXX11_SCOPED_ENUMS //CXX11 support hacks
@@ -24,7 +25,7 @@ class RandomGeneratorTestFixture: public ::testing::Test
 {
     //TODO: fix the linker problem
     public:
-       TGenPhaseSpace event; //event generator
+       PhaseSpaceGenerator event; //event generator
        TLorentzVector sourcePos; //position of the source
        ParamManager pManag;    //objects for 2- and 3- gamma decays
        DecayType type;
@@ -85,28 +86,28 @@ TEST_F(RandomGeneratorTestFixture, RandomResults)
     InitialCuts cuts1(type, pManag.GetR(),pManag.GetL(), pManag.GetEff());
     ComptonScattering cs2(type, 0.0, 2.0);
     InitialCuts cuts2(type, pManag.GetR(),pManag.GetL(), pManag.GetEff());
-    gRandom = new TRandom3(0);
+    RandomStream rng1(0);
     for (int n=0; n<100; n++)
     {
         try
         {
-            eventDecay = generateEvent(event, sourcePos, pManag, type);
-            cuts1.AddCuts(eventDecay);
-            cs1.Scatter(eventDecay);
+            eventDecay = generateEvent(event, sourcePos, pManag, type, &rng1);
+            cuts1.AddCuts(eventDecay, &rng1);
+            cs1.Scatter(eventDecay, &rng1);
         }
         catch(std::string ex)
         {
             FAIL();
         }
     }
-    gRandom = new TRandom3(0);
+    RandomStream rng2(0);
     for (int n=0; n<100; n++)
     {
         try
         {
-            eventDecay = generateEvent(event, sourcePos, pManag, type);
-            cuts2.AddCuts(eventDecay);
-            cs2.Scatter(eventDecay);
+            eventDecay = generateEvent(event, sourcePos, pManag, type, &rng2);
+            cuts2.AddCuts(eventDecay, &rng2);
+            cs2.Scatter(eventDecay, &rng2);
         }
         catch(std::string ex)
         {
@@ -126,28 +127,28 @@ TEST_F(RandomGeneratorTestFixture, RepeatableResults)
     InitialCuts cuts1(type, pManag.GetR(),pManag.GetL(), pManag.GetEff());
     ComptonScattering cs2(type, 0.0, 2.0);
     InitialCuts cuts2(type, pManag.GetR(),pManag.GetL(), pManag.GetEff());
-    gRandom = new TRandom3(pManag.GetSeed());
+    RandomStream rng1(pManag.GetSeed());
     for (int n=0; n<100; n++)
     {
         try
         {
-            eventDecay = generateEvent(event, sourcePos, pManag, type);
-            cuts1.AddCuts(eventDecay);
-            cs1.Scatter(eventDecay);
+            eventDecay = generateEvent(event, sourcePos, pManag, type, &rng1);
+            cuts1.AddCuts(eventDecay, &rng1);
+            cs1.Scatter(eventDecay, &rng1);
         }
         catch(std::string ex)
         {
             FAIL();
         }
     }
-    gRandom = new TRandom3(pManag.GetSeed());
+    RandomStream rng2(pManag.GetSeed());
     for (int n=0; n<100; n++)
     {
         try
         {
-            eventDecay = generateEvent(event, sourcePos, pManag, type);
-            cuts2.AddCuts(eventDecay);
-            cs2.Scatter(eventDecay);
+            eventDecay = generateEvent(event, sourcePos, pManag, type, &rng2);
+            cuts2.AddCuts(eventDecay, &rng2);
+            cs2.Scatter(eventDecay, &rng2);
         }
         catch(std::string ex)
         {
@@ -156,3 +157,34 @@ TEST_F(RandomGeneratorTestFixture, RepeatableResults)
     }
     ASSERT_TRUE(cs1==cs2);
 }
+
+///
+/// \brief TEST_F This test checks if substreams do not depend on the order in which they are used.
+///
+TEST_F(RandomGeneratorTestFixture, IndependentSubstreams)
+{
+    const int noOfSubstreams = 10;
+    const int noOfNumbers = 7;
+    double forward[noOfSubstreams][noOfNumbers];
+    RandomStream rng(pManag.GetSeed());
+    unsigned long long key = RandomStream::DeriveKey(pManag.GetSeed(), 3, type, RandomStream::CUTS);
+    for(int ii=0; ii<noOfSubstreams; ii++)
+    {
+        rng.SetStream(key, ii);
+        for(int jj=0; jj<noOfNumbers; jj++)
+            forward[ii][jj] = rng.Rndm();
+    }
+    //the same substreams in the reversed order give the same numbers
+    for(int ii=noOfSubstreams-1; ii>=0; ii--)
+    {
+        rng.SetStream(key, ii);
+        for(int jj=0; jj<noOfNumbers; jj++)
+            ASSERT_EQ(forward[ii][jj], rng.Rndm());
+    }
+    //other stages, runs and substreams give different numbers
+    rng.SetStream(RandomStream::DeriveKey(pManag.GetSeed(), 3, type, RandomStream::COMPTON), 0);
+    ASSERT_NE(forward[0][0], rng.Rndm());
+    rng.SetStream(RandomStream::DeriveKey(pManag.GetSeed(), 4, type, RandomStream::CUTS), 0);
+    ASSERT_NE(forward[0][0], rng.Rndm());
+    ASSERT_NE(forward[0][0], forward[1][0]);
+}
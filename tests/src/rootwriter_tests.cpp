@@ -0,0 +1,95 @@
+/// @file rootwriter_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check that RootWriter executes all tasks in one thread.
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "../../src/rootwriter.h"
+
+///
+/// \brief TEST This test checks that tasks submitted by many threads are executed one at a time by the writer thread.
+///
+TEST(RootWriterTest, TasksExecutedByWriterThread)
+{
+    RootWriter writer(true);
+    ASSERT_TRUE(writer.IsThreaded());
+    std::thread::id writerId;
+    writer.Execute([&writerId](){writerId = std::this_thread::get_id();});
+    ASSERT_NE(std::this_thread::get_id(), writerId);
+
+    const int noOfThreads = 8;
+    const int noOfTasks = 1000;
+    long counter = 0; //not atomic, tasks must not run concurrently
+    bool sameThread = true;
+    std::vector<std::thread> threads;
+    for(int ii=0; ii<noOfThreads; ii++)
+    {
+        threads.push_back(std::thread([&]()
+        {
+            for(int jj=0; jj<noOfTasks; jj++)
+                writer.Execute([&](){counter++; sameThread &= std::this_thread::get_id()==writerId;});
+        }));
+    }
+    for(std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+        it->join();
+    ASSERT_EQ(noOfThreads*noOfTasks, counter);
+    ASSERT_TRUE(sameThread);
+}
+
+///
+/// \brief TEST This test checks that exceptions thrown by tasks are passed to the submitting thread.
+///
+TEST(RootWriterTest, ExceptionsPassedToCaller)
+{
+    RootWriter writer(true);
+    ASSERT_THROW(writer.Execute([](){throw(std::string("[ERROR] Test"));}), std::string);
+    //the writer still works after an exception
+    int value = 0;
+    writer.Execute([&value](){value = 1;});
+    ASSERT_EQ(1, value);
+}
+
+///
+/// \brief TEST This test checks that the first exception of a posted task is rethrown once, by the next Execute or by Close.
+///
+TEST(RootWriterTest, PostedExceptionsRethrown)
+{
+    RootWriter writer(true);
+    writer.Post([](){throw(std::string("[ERROR] First"));});
+    writer.Post([](){throw(std::string("[ERROR] Second"));});
+    try
+    {
+        writer.Execute([](){});
+        FAIL();
+    }
+    catch(std::string e)
+    {
+        ASSERT_EQ("[ERROR] First", e);
+    }
+    ASSERT_TRUE(writer.HasFailed());
+    ASSERT_NO_THROW(writer.Execute([](){}));
+
+    RootWriter closedWriter(true);
+    ASSERT_FALSE(closedWriter.HasFailed());
+    closedWriter.Post([](){throw(std::string("[ERROR] Test"));});
+    ASSERT_THROW(closedWriter.Close(), std::string);
+    ASSERT_TRUE(closedWriter.HasFailed());
+    ASSERT_FALSE(closedWriter.IsThreaded());
+}
+
+///
+/// \brief TEST This test checks that a writer without a thread executes tasks directly.
+///
+TEST(RootWriterTest, InlineWriter)
+{
+    RootWriter writer(false);
+    ASSERT_FALSE(writer.IsThreaded());
+    std::thread::id taskId;
+    writer.Execute([&taskId](){taskId = std::this_thread::get_id();});
+    ASSERT_EQ(std::this_thread::get_id(), taskId);
+}
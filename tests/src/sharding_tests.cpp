@@ -0,0 +1,194 @@
+/// @file sharding_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check that shards (processes sharing runs) simulate the same events, with the same ids, as a single process,
+/// and that results of shards merged by the shard merger are the same as results of a single process.
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "TFile.h"
+#include "TCanvas.h"
+#include "../../src/simulationworker.h"
+#include "../../src/cutflow.h"
+#include "../../tools/shard_merger/src/shardmerger.h"
+#define BOOST_NO_CXX11_SCOPED_ENUMS //CXX11 support hacks
+#include "boost/filesystem.hpp"
+#undef BOOST_NO_CXX11_SCOPED_ENUMS
+
+///
+/// \brief TEST This test checks that blocks of shards are contiguous, disjoint and cover the whole run.
+///
+TEST(ShardingTest, BlocksPartitionRun)
+{
+    const long events[] = {1, SimulationWorker::kBlockSize, 10*SimulationWorker::kBlockSize+1, 1000*SimulationWorker::kBlockSize};
+    const int shardCounts[] = {1, 2, 3, 7, 64};
+    for(long noOfEvents : events)
+    {
+        for(int shardCount : shardCounts)
+        {
+            long expectedFirst = 0;
+            for(int shard=0; shard<shardCount; shard++)
+            {
+                long firstBlock = -1, lastBlock = -1;
+                SimulationWorker::GetShardBlocks(noOfEvents, shard, shardCount, firstBlock, lastBlock);
+                ASSERT_EQ(expectedFirst, firstBlock);
+                ASSERT_LE(firstBlock, lastBlock);
+                expectedFirst = lastBlock;
+            }
+            ASSERT_EQ(SimulationWorker::GetNumberOfBlocks(noOfEvents), expectedFirst);
+        }
+    }
+}
+
+///
+/// \brief TEST This test checks that a block simulated alone (by a shard) is identical to the same block simulated in order.
+///
+TEST(ShardingTest, ShardEventsEqualSingleProcess)
+{
+    ParamManager pManag;
+    pManag.SetR(437.3);
+    pManag.SetL(500);
+    pManag.SetEff(0.5);
+    pManag.SetSeed(2718);
+    pManag.SetSimEvents(3*SimulationWorker::kBlockSize);
+    pManag.SetEventTypeToSave(ALL);
+    pManag.EnableSilentMode();
+    const TLorentzVector Ps(0.0, 0.0, 0.0, 1.022/1000);
+    const TLorentzVector sourcePos(0.0, 0.0, 0.0, 10.0);
+    SimulationWorker single(Ps, sourcePos, pManag, THREE, 4, true);
+    SimulationWorker shard(Ps, sourcePos, pManag, THREE, 4, true);
+    for(long block=0; block<3; block++)
+    {
+        single.ClearStoredEvents();
+        single.ProcessBlock(block);
+    }
+    shard.ProcessBlock(2);
+    ASSERT_EQ(single.GetNumberOfStoredEvents(), shard.GetNumberOfStoredEvents());
+    for(long ii=0; ii<shard.GetNumberOfStoredEvents(); ii++)
+    {
+        const Event* expected = single.GetStoredEvent(ii);
+        const Event* event = shard.GetStoredEvent(ii);
+        ASSERT_EQ(2*SimulationWorker::kBlockSize+ii+1, event->fId);
+        ASSERT_EQ(expected->fId, event->fId);
+        ASSERT_EQ(expected->GetWeight(), event->GetWeight());
+        ASSERT_EQ(expected->GetPassFlag(), event->GetPassFlag());
+        ASSERT_TRUE(*expected->GetFourMomentumOf(0) == *event->GetFourMomentumOf(0));
+    }
+}
+
+///
+/// \brief TEST This test checks that ids of events are derived from their run, decay type, block and index only.
+///
+TEST(ShardingTest, EventIdsDerivedFromPosition)
+{
+    //ids of consecutive runs and decay types do not overlap
+    ASSERT_EQ(0, SimulationWorker::GetEventIdOffset(0, 5000));
+    ASSERT_EQ(15000, SimulationWorker::GetEventIdOffset(3, 5000));
+    ASSERT_EQ(30000, SimulationWorker::GetEventIdOffset(3, 5000, 2, 0));
+    ASSERT_EQ(35000, SimulationWorker::GetEventIdOffset(3, 5000, 2, 1));
+    ASSERT_EQ(35000+2*SimulationWorker::kBlockSize+8, SimulationWorker::GetEventId(35000, 2, 7));
+    //creating events does not change ids of other events
+    Event first(TWO, 2);
+    Event second(THREE, 3);
+    ASSERT_EQ(0, first.fId);
+    ASSERT_EQ(0, second.fId);
+
+    ParamManager pManag;
+    pManag.SetSeed(2718);
+    pManag.SetSimEvents(2*SimulationWorker::kBlockSize);
+    pManag.SetEventTypeToSave(ALL);
+    pManag.EnableSilentMode();
+    SimulationWorker worker(TLorentzVector(0.0, 0.0, 0.0, 1.022/1000), TLorentzVector(0.0, 0.0, 0.0, 10.0), pManag, TWO, 3, true);
+    worker.SetEventIdOffset(SimulationWorker::GetEventIdOffset(3, pManag.GetSimEvents()));
+    worker.ProcessBlock(1);
+    for(long ii=0; ii<worker.GetNumberOfStoredEvents(); ii++)
+        ASSERT_EQ(3*pManag.GetSimEvents()+SimulationWorker::kBlockSize+ii+1, worker.GetStoredEvent(ii)->fId);
+}
+
+///
+/// \brief writeCutFlow Simulates blocks and writes the cut flow of the worker to a file.
+/// \param pManag Parameters of the simulation.
+/// \param firstBlock First simulated block.
+/// \param lastBlock Block after the last simulated one.
+/// \param fileName Name of the file.
+///
+void writeCutFlow(const ParamManager& pManag, long firstBlock, long lastBlock, const std::string& fileName)
+{
+    SimulationWorker worker(TLorentzVector(0.0, 0.0, 0.0, 1.022/1000), TLorentzVector(0.0, 0.0, 0.0, 10.0), pManag, THREE, 1, false);
+    for(long block=firstBlock; block<lastBlock; block++)
+        worker.ProcessBlock(block);
+    TFile file(fileName.c_str(), "recreate");
+    worker.GetCuts().DrawCutsHistograms("", TREE);
+    file.Close();
+}
+
+///
+/// \brief TEST This test checks that the cut flow merged from two shards is the same as the one of a single process.
+///
+TEST(ShardingTest, MergedCutFlowEqualsSingleProcess)
+{
+    ParamManager pManag;
+    pManag.SetR(437.3);
+    pManag.SetL(500);
+    pManag.SetEff(0.5);
+    pManag.SetSeed(2718);
+    pManag.SetSimEvents(4*SimulationWorker::kBlockSize);
+    pManag.EnableSilentMode();
+    writeCutFlow(pManag, 0, 4, "tmp_single.root");
+    writeCutFlow(pManag, 0, 1, "tmp_shard0.root");
+    writeCutFlow(pManag, 1, 4, "tmp_shard1.root");
+    {
+        TFile shard0("tmp_shard0.root", "read");
+        TFile shard1("tmp_shard1.root", "read");
+        TFile merged("tmp_merged.root", "recreate");
+        mergeDirectories(std::vector<TDirectory*>{&shard0, &shard1}, &merged);
+        merged.Write();
+        merged.Close();
+    }
+    TFile single("tmp_single.root", "read");
+    TFile merged("tmp_merged.root", "read");
+    const std::string type = "3";
+    TCanvas* singleCanvas = nullptr;
+    TCanvas* mergedCanvas = nullptr;
+    single.GetObject((type+"-gammas_cuts_passed").c_str(), singleCanvas);
+    merged.GetObject((type+"-gammas_cuts_passed").c_str(), mergedCanvas);
+    ASSERT_TRUE(singleCanvas != nullptr);
+    ASSERT_TRUE(mergedCanvas != nullptr);
+    for(int pad=1; pad<=2; pad++)
+    {
+        const std::string countsName = CutFlow::GetCountsName(type, pad==2);
+        TH1D* singleCounts = nullptr;
+        TH1D* mergedCounts = nullptr;
+        single.GetObject(countsName.c_str(), singleCounts);
+        merged.GetObject(countsName.c_str(), mergedCounts);
+        ASSERT_TRUE(singleCounts != nullptr);
+        ASSERT_TRUE(mergedCounts != nullptr);
+        TH1* singlePercent = nullptr;
+        TH1* mergedPercent = nullptr;
+        TText* singleLabel = nullptr;
+        TText* mergedLabel = nullptr;
+        findCutFlow(singleCanvas, pad, singlePercent, singleLabel);
+        findCutFlow(mergedCanvas, pad, mergedPercent, mergedLabel);
+        ASSERT_TRUE(singlePercent != nullptr && mergedPercent != nullptr);
+        ASSERT_TRUE(singleLabel != nullptr && mergedLabel != nullptr);
+        ASSERT_GT(singleCounts->GetBinContent(1), 0.0);
+        ASSERT_DOUBLE_EQ(100.0, mergedPercent->GetBinContent(1));
+        for(int bin=1; bin<=3; bin++)
+        {
+            ASSERT_EQ(singleCounts->GetBinContent(bin), mergedCounts->GetBinContent(bin));
+            ASSERT_DOUBLE_EQ(singlePercent->GetBinContent(bin), mergedPercent->GetBinContent(bin));
+        }
+        ASSERT_STREQ(singleLabel->GetTitle(), mergedLabel->GetTitle());
+        delete singleCounts;
+        delete mergedCounts;
+    }
+    delete singleCanvas;
+    delete mergedCanvas;
+    boost::filesystem::remove("tmp_single.root");
+    boost::filesystem::remove("tmp_shard0.root");
+    boost::filesystem::remove("tmp_shard1.root");
+    boost::filesystem::remove("tmp_merged.root");
+}
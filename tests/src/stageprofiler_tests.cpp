@@ -0,0 +1,53 @@
+/// @file stageprofiler_tests.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// The following tests check timing of simulation stages.
+#include <chrono>
+#include <thread>
+#include "gtest/gtest.h"
+#include "../../src/stageprofiler.h"
+
+///
+/// \brief TEST This test checks that a scoped timer adds the elapsed time to its stage only.
+///
+TEST(StageProfilerTest, ScopedTimer)
+{
+    StageProfiler profiler;
+    {
+        ScopedStageTimer timer(profiler, StageProfiler::CUTS);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    ASSERT_GE(profiler.GetTime(StageProfiler::CUTS), 2000000);
+    for(int ii=0; ii<StageProfiler::kNoOfStages; ii++)
+    {
+        if(ii!=StageProfiler::CUTS)
+        {
+            ASSERT_EQ(0, profiler.GetTime(static_cast<StageProfiler::Stage>(ii)));
+        }
+    }
+}
+
+///
+/// \brief TEST This test checks merging of profilers and the time per event.
+///
+TEST(StageProfilerTest, MergeAndTimePerEvent)
+{
+    StageProfiler first, second;
+    first.AddTime(StageProfiler::GENERATION, 300);
+    first.AddEvents(10);
+    second.AddTime(StageProfiler::GENERATION, 500);
+    second.AddTime(StageProfiler::OUTPUT, 40);
+    second.AddEvents(30);
+    first.Merge(second);
+    ASSERT_EQ(40, first.GetEvents());
+    ASSERT_EQ(800, first.GetTime(StageProfiler::GENERATION));
+    ASSERT_DOUBLE_EQ(20.0, first.GetNsPerEvent(StageProfiler::GENERATION));
+    ASSERT_DOUBLE_EQ(1.0, first.GetNsPerEvent(StageProfiler::OUTPUT));
+    ASSERT_NE(std::string::npos, first.GetReport(1.0, 10).find("Pass fraction: 0.25"));
+    first.Reset();
+    ASSERT_EQ(0, first.GetEvents());
+    ASSERT_DOUBLE_EQ(0.0, first.GetNsPerEvent(StageProfiler::GENERATION));
+}
@@ -10,11 +10,11 @@ import os
 
 if len(sys.argv) < 4:
 	print("Insufficient number of arguments!")
-	print("python convert.py [input file path] [output file name] [1 if goja2jpos, 0 otherwise]")
+	print("python convert.py [input file path] [output file name] [1 for jpos->gate conversion, 0 gate->jpos] [optional: memory limit for sorting GATE hits in MB]")
 	sys.exit(1)
 else:
 	# input file must have specific name
-	if sys.argv[3]:
+	if sys.argv[3] == "0":
 		in_name = "gate.root"
 	else:
 		in_name="jpos.root"
@@ -23,8 +23,17 @@ else:
 		out_name = sys.argv[2]
 	else:
 		out_name = sys.argv[2]+".root"
-	# prepare and execute bash commands
-	cp_command = "cp "+sys.argv[1]+" ./data/"+in_name
+	# input files can be huge, so they are linked instead of copied
+	in_path = os.path.join("data", in_name)
+	if not os.path.isdir("data"):
+		os.mkdir("data")
+	if os.path.realpath(sys.argv[1]) != os.path.realpath(in_path):
+		if os.path.lexists(in_path):
+			os.remove(in_path)
+		os.symlink(os.path.abspath(sys.argv[1]), in_path)
 	command = "./converter"+" "+out_name+" "+sys.argv[3]
-	os.system(cp_command)
-	os.system(command)
+	if len(sys.argv) > 4:
+		command += " "+sys.argv[4]
+	# the converter fails with a non-zero status, which is passed on
+	if os.system(command) != 0:
+		sys.exit(1)
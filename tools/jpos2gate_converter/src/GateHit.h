@@ -0,0 +1,43 @@
+/// @file GateHit.h
+/// @author Rafal Maselek <rafalmaselek@gmail.com>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// Plain record of one GATE hit, used to group hits by event.
+///
+#ifndef GateHit_h
+#define GateHit_h
+
+#include <Rtypes.h>
+
+///
+/// \brief The GateHit struct Data of one GATE hit needed to build a jpos event. It is written to temporary files as it is.
+///
+struct GateHit
+{
+    Int_t runID;
+    Int_t eventID;
+    Long64_t order; //number of the hit in the input, keeps the order of hits inside events
+    Double_t time;
+    Float_t edep;
+    Float_t sourcePos[3];
+    Float_t pos[3];
+    Bool_t primary; //true if the photon was not scattered before
+
+    ///
+    /// \brief SameEvent Checks if two hits belong to the same event.
+    ///
+    inline bool SameEvent(const GateHit& hit) const {return runID==hit.runID && eventID==hit.eventID;}
+    ///
+    /// \brief operator< Orders hits by run, event and their position in the input.
+    ///
+    inline bool operator<(const GateHit& hit) const
+    {
+        if(runID != hit.runID) return runID < hit.runID;
+        if(eventID != hit.eventID) return eventID < hit.eventID;
+        return order < hit.order;
+    }
+};
+
+#endif
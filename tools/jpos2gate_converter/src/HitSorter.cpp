@@ -0,0 +1,289 @@
+/// @file HitSorter.cpp
+/// @author Rafal Maselek <rafalmaselek@gmail.com>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// Class that groups GATE hits by event in bounded memory: sorted runs of hits are spilled to temporary files and merged.
+///
+#include "HitSorter.h"
+#include <algorithm>
+#include <functional>
+#include <stdlib.h>
+#include <unistd.h>
+
+///
+/// \brief HitSorter::HitSorter Basic constructor.
+/// \param maxHits Maximal number of hits kept in memory.
+/// \param directory Directory of temporary files.
+///
+HitSorter::HitSorter(Long64_t maxHits, const std::string& directory) :
+    fMaxHits_(maxHits > 0 ? maxHits : 1),
+    fDirectory_(directory),
+    fBufferPosition_(0),
+    fNumberOfRuns_(0),
+    fFinished_(false)
+{}
+
+///
+/// \brief HitSorter::~HitSorter Closes (and therefore removes) temporary files.
+///
+HitSorter::~HitSorter()
+{
+    for(std::vector<FILE*>& level : fRuns_)
+    {
+        for(FILE* run : level)
+            fclose(run);
+    }
+    for(RunReader& reader : fReaders_)
+    {
+        if(reader.file != 0)
+            fclose(reader.file);
+    }
+}
+
+///
+/// \brief HitSorter::Add Adds a hit, the buffer is spilled to disk when it is full.
+/// \param hit Hit to be added.
+///
+void HitSorter::Add(const GateHit& hit)
+{
+    if(fFinished_)
+        throw(std::string("[ERROR] Hits cannot be added to a finished HitSorter!"));
+    fBuffer_.push_back(hit);
+    if(static_cast<Long64_t>(fBuffer_.size()) >= fMaxHits_)
+        Spill_();
+}
+
+///
+/// \brief HitSorter::Finish Ends adding hits and prepares the merge. Called automatically by the first Next.
+///
+void HitSorter::Finish()
+{
+    if(fFinished_)
+        return;
+    fFinished_ = true;
+    if(fNumberOfRuns_ == 0)
+    {
+        // all hits fit into memory
+        std::sort(fBuffer_.begin(), fBuffer_.end());
+        return;
+    }
+    Spill_();
+    std::vector<GateHit>().swap(fBuffer_);
+    // runs of all levels, the shortest first
+    std::vector<FILE*> runs;
+    for(std::vector<FILE*>& level : fRuns_)
+        runs.insert(runs.end(), level.begin(), level.end());
+    fRuns_.clear();
+    // too many runs to be merged at once, they are merged in portions into longer runs
+    while(runs.size() > static_cast<size_t>(kMaxFanIn))
+    {
+        std::vector<FILE*> portion(runs.begin(), runs.begin()+kMaxFanIn);
+        runs.erase(runs.begin(), runs.begin()+kMaxFanIn);
+        runs.push_back(MergeRuns_(portion));
+    }
+    StartMerge_(runs, fReaders_, fHeap_);
+}
+
+///
+/// \brief HitSorter::Next Returns hits ordered by run, event and their position in the input.
+/// \param hit Filled with the next hit.
+/// \return False if there are no more hits.
+///
+bool HitSorter::Next(GateHit& hit)
+{
+    Finish();
+    if(fNumberOfRuns_ > 0)
+        return PopMerged_(fReaders_, fHeap_, hit);
+    if(fBufferPosition_ >= fBuffer_.size())
+        return false;
+    hit = fBuffer_[fBufferPosition_++];
+    return true;
+}
+
+///
+/// \brief HitSorter::Spill_ Sorts the buffer and writes it to a new run.
+///
+void HitSorter::Spill_()
+{
+    if(fBuffer_.empty())
+        return;
+    std::sort(fBuffer_.begin(), fBuffer_.end());
+    FILE* run = OpenRun_();
+    WriteHits_(run, fBuffer_);
+    rewind(run);
+    fNumberOfRuns_++;
+    fBuffer_.clear();
+    AddRun_(run, 0);
+}
+
+///
+/// \brief HitSorter::AddRun_ Adds a run to its level, kMaxFanIn runs of one level are merged into a run of the next level.
+/// \param run Sorted run.
+/// \param level Number of merges that produced the run.
+///
+void HitSorter::AddRun_(FILE* run, size_t level)
+{
+    if(fRuns_.size() <= level)
+        fRuns_.resize(level+1);
+    fRuns_[level].push_back(run);
+    if(fRuns_[level].size() < static_cast<size_t>(kMaxFanIn))
+        return;
+    std::vector<FILE*> portion;
+    portion.swap(fRuns_[level]);
+    // the buffer of hits is empty after a spill, its memory is used by the merge
+    std::vector<GateHit>().swap(fBuffer_);
+    AddRun_(MergeRuns_(portion), level+1);
+}
+
+///
+/// \brief HitSorter::MergeRuns_ Merges runs into a new run.
+/// \param runs Sorted runs, they are closed.
+/// \return The merged run, rewound.
+///
+FILE* HitSorter::MergeRuns_(const std::vector<FILE*>& runs)
+{
+    std::vector<RunReader> readers;
+    std::vector<MergeSource> heap;
+    StartMerge_(runs, readers, heap);
+    FILE* merged = OpenRun_();
+    std::vector<GateHit> hits;
+    hits.reserve(GetChunkSize_(runs.size()+1));
+    GateHit hit;
+    while(PopMerged_(readers, heap, hit))
+    {
+        hits.push_back(hit);
+        if(hits.size() == hits.capacity())
+        {
+            WriteHits_(merged, hits);
+            hits.clear();
+        }
+    }
+    WriteHits_(merged, hits);
+    rewind(merged);
+    fNumberOfRuns_++;
+    return merged;
+}
+
+///
+/// \brief HitSorter::OpenRun_ Creates a temporary file and removes its name, so it is deleted when closed.
+/// \return Temporary file opened for writing and reading, without a stdio buffer.
+///
+FILE* HitSorter::OpenRun_()
+{
+    std::string path = fDirectory_+"/gate2jpos_XXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    int descriptor = mkstemp(name.data());
+    if(descriptor < 0)
+        throw(std::string("[ERROR] Cannot create a temporary file in ")+fDirectory_+"!");
+    unlink(name.data());
+    FILE* run = fdopen(descriptor, "w+b");
+    if(run == 0)
+    {
+        close(descriptor);
+        throw(std::string("[ERROR] Cannot open a temporary file in ")+fDirectory_+"!");
+    }
+    // hits are read and written in chunks, so idle runs hold no memory
+    setvbuf(run, 0, _IONBF, 0);
+    return run;
+}
+
+///
+/// \brief HitSorter::GetChunkSize_ Divides the memory limit among buffers of a merge.
+/// \param buffers Number of buffers (merged runs and the output).
+/// \return Number of hits in every buffer, at least kMinChunk.
+///
+size_t HitSorter::GetChunkSize_(size_t buffers) const
+{
+    Long64_t chunk = fMaxHits_/static_cast<Long64_t>(buffers);
+    return chunk > kMinChunk ? chunk : kMinChunk;
+}
+
+///
+/// \brief HitSorter::StartMerge_ Reads the first hit of every run and builds a heap of runs.
+/// \param runs Sorted runs, they are closed when all their hits are read.
+/// \param readers Filled with readers of runs.
+/// \param heap Heap to be filled.
+///
+void HitSorter::StartMerge_(const std::vector<FILE*>& runs, std::vector<RunReader>& readers, std::vector<MergeSource>& heap)
+{
+    const size_t chunk = GetChunkSize_(runs.size());
+    readers.clear();
+    heap.clear();
+    for(FILE* run : runs)
+    {
+        readers.push_back(RunReader());
+        RunReader& reader = readers.back();
+        reader.file = run;
+        reader.chunk.resize(chunk);
+        reader.position = 0;
+        reader.size = 0;
+        MergeSource source;
+        source.reader = readers.size()-1;
+        if(ReadHit_(reader, source.hit))
+            heap.push_back(source);
+    }
+    std::make_heap(heap.begin(), heap.end(), std::greater<MergeSource>());
+}
+
+///
+/// \brief HitSorter::ReadHit_ Takes the next hit of a run, the next chunk is read when the current one is exhausted.
+/// \param reader Reader of the run, its file is closed and its memory is released at the end of the run.
+/// \param hit Filled with the next hit.
+/// \return False if all hits of the run are read.
+///
+bool HitSorter::ReadHit_(RunReader& reader, GateHit& hit)
+{
+    if(reader.position == reader.size)
+    {
+        if(reader.file == 0)
+            return false;
+        reader.size = fread(reader.chunk.data(), sizeof(GateHit), reader.chunk.size(), reader.file);
+        reader.position = 0;
+        if(ferror(reader.file))
+            throw(std::string("[ERROR] Failed to read hits from a temporary file!"));
+        if(reader.size == 0)
+        {
+            fclose(reader.file);
+            reader.file = 0;
+            std::vector<GateHit>().swap(reader.chunk);
+            return false;
+        }
+    }
+    hit = reader.chunk[reader.position++];
+    return true;
+}
+
+///
+/// \brief HitSorter::PopMerged_ Takes the smallest hit from the heap of runs and reads the next hit of its run.
+/// \param readers Readers of runs.
+/// \param heap Heap of runs.
+/// \param hit Filled with the smallest hit.
+/// \return False if all runs are exhausted.
+///
+bool HitSorter::PopMerged_(std::vector<RunReader>& readers, std::vector<MergeSource>& heap, GateHit& hit)
+{
+    if(heap.empty())
+        return false;
+    std::pop_heap(heap.begin(), heap.end(), std::greater<MergeSource>());
+    MergeSource& source = heap.back();
+    hit = source.hit;
+    if(ReadHit_(readers[source.reader], source.hit))
+        std::push_heap(heap.begin(), heap.end(), std::greater<MergeSource>());
+    else
+        heap.pop_back();
+    return true;
+}
+
+///
+/// \brief HitSorter::WriteHits_ Appends hits to a run.
+/// \param run Temporary file.
+/// \param hits Hits to be written.
+///
+void HitSorter::WriteHits_(FILE* run, const std::vector<GateHit>& hits)
+{
+    if(fwrite(hits.data(), sizeof(GateHit), hits.size(), run) != hits.size())
+        throw(std::string("[ERROR] Failed to write hits to a temporary file!"));
+}
@@ -0,0 +1,82 @@
+/// @file HitSorter.h
+/// @author Rafal Maselek <rafalmaselek@gmail.com>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// Class that groups GATE hits by event in bounded memory: sorted runs of hits are spilled to temporary files and merged.
+///
+#ifndef HitSorter_h
+#define HitSorter_h
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "GateHit.h"
+
+///
+/// \brief The HitSorter class External merge sort of hits. At most maxHits hits are kept in memory, when the buffer is full
+/// it is sorted and written to a temporary file (a run). Runs are merged at the end, so hits of every event are contiguous.
+/// Runs are merged in levels: kMaxFanIn runs of one level are merged into one run of the next level as soon as they
+/// are written, so the number of open temporary files grows only logarithmically with the input. Runs are read and written
+/// without stdio buffers, merges use buffers sharing the same memory limit as the buffer of hits.
+/// Temporary files are removed from the directory as soon as they are created, so they disappear when closed.
+/// If all hits fit into the buffer, nothing is written to disk.
+///
+class HitSorter
+{
+    public:
+        HitSorter(Long64_t maxHits, const std::string& directory);
+        ~HitSorter();
+        HitSorter(const HitSorter&) = delete;
+        HitSorter& operator=(const HitSorter&) = delete;
+        void Add(const GateHit& hit);
+        void Finish();
+        bool Next(GateHit& hit);
+        inline int GetNumberOfRuns() const {return fNumberOfRuns_;}
+
+        static const int kMaxFanIn = 256; //maximal number of runs merged at once
+        static const int kMinChunk = 1<<10; //minimal number of hits read or written at once by a merge
+
+    private:
+        ///
+        /// \brief The RunReader struct Sorted run being merged, read in chunks.
+        ///
+        struct RunReader
+        {
+            FILE* file; //closed when all hits are read
+            std::vector<GateHit> chunk; //hits read from the file
+            size_t position; //next hit to be taken from the chunk
+            size_t size; //number of hits in the chunk
+        };
+        ///
+        /// \brief The MergeSource struct Run being merged with its current (smallest unread) hit.
+        ///
+        struct MergeSource
+        {
+            GateHit hit;
+            size_t reader; //index of the RunReader of the run
+            inline bool operator>(const MergeSource& source) const {return source.hit < hit;}
+        };
+        void Spill_();
+        void AddRun_(FILE* run, size_t level);
+        FILE* MergeRuns_(const std::vector<FILE*>& runs);
+        FILE* OpenRun_();
+        size_t GetChunkSize_(size_t buffers) const;
+        void StartMerge_(const std::vector<FILE*>& runs, std::vector<RunReader>& readers, std::vector<MergeSource>& heap);
+        bool ReadHit_(RunReader& reader, GateHit& hit);
+        bool PopMerged_(std::vector<RunReader>& readers, std::vector<MergeSource>& heap, GateHit& hit);
+        void WriteHits_(FILE* run, const std::vector<GateHit>& hits);
+
+        Long64_t fMaxHits_; //size of the buffer
+        std::string fDirectory_; //directory of temporary files
+        std::vector<GateHit> fBuffer_; //hits not written to disk yet
+        size_t fBufferPosition_; //next hit to be read from the buffer, if there are no runs
+        std::vector<std::vector<FILE*> > fRuns_; //temporary files with sorted runs, fRuns_[l] holds runs merged l times
+        std::vector<RunReader> fReaders_; //runs in the final merge
+        std::vector<MergeSource> fHeap_; //heap of runs in the final merge
+        int fNumberOfRuns_; //number of runs written to disk, including intermediate merges
+        bool fFinished_; //true if no more hits can be added
+};
+
+#endif
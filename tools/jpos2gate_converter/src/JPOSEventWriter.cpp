@@ -0,0 +1,83 @@
+/// @file JPOSEventWriter.cpp
+/// @author Rafal Maselek <rafalmaselek@gmail.com>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// Class that builds jpos events from a stream of GATE hits grouped by event and writes them to a tree.
+///
+#include "JPOSEventWriter.h"
+#include <math.h>       /* atan2 */
+
+///
+/// \brief JPOSEventWriter::JPOSEventWriter Creates the branch for events.
+/// \param tree Output tree.
+/// \param decayType Type of decay stored in events.
+///
+JPOSEventWriter::JPOSEventWriter(TTree* tree, int decayType) :
+    fTree_(tree),
+    fEvent_(new Event()), //set before the branch is created, so ROOT does not allocate its own event
+    fDecayType_(decayType),
+    fEvents_(0)
+{
+    fTree_->Branch("event_split", "Event", &fEvent_, 32000, 99);
+}
+
+///
+/// \brief JPOSEventWriter::~JPOSEventWriter Detaches the branch and deletes the last event.
+///
+JPOSEventWriter::~JPOSEventWriter()
+{
+    fTree_->ResetBranchAddresses();
+    delete fEvent_;
+}
+
+///
+/// \brief JPOSEventWriter::Add Adds a hit to the current event. If the hit belongs to another event, the current one is written first.
+/// \param hit Hit to be added.
+///
+void JPOSEventWriter::Add(const GateHit& hit)
+{
+    if(!fHits_.empty() && !hit.SameEvent(fLastHit_))
+        Flush_();
+    fEmissionPoints_.push_back(TLorentzVector(hit.sourcePos[0], hit.sourcePos[1], hit.sourcePos[2], 0.0));
+    fHits_.push_back(TLorentzVector(hit.pos[0], hit.pos[1], hit.pos[2], hit.time));
+    fFourMomenta_.push_back(TLorentzVector(0.0, 0.0, 0.0, hit.edep));
+    fPrimaryPhotons_.push_back(hit.primary);
+    fCutPassing_.push_back(true);
+    fEdep_.push_back(hit.edep);
+    fHitPhi_.push_back(atan2(hit.pos[1], hit.pos[0]));
+    fHitTheta_.push_back(atan(sqrt(hit.pos[1]*hit.pos[1]+hit.pos[0]*hit.pos[0])/hit.pos[2]));
+    fLastHit_ = hit;
+}
+
+///
+/// \brief JPOSEventWriter::Finish Writes the last event.
+///
+void JPOSEventWriter::Finish()
+{
+    Flush_();
+}
+
+///
+/// \brief JPOSEventWriter::Flush_ Fills the tree with the current event and clears buffers. The id of the event is its run id.
+///
+void JPOSEventWriter::Flush_()
+{
+    if(fHits_.empty())
+        return;
+    Event* event = new Event(fEmissionPoints_, fHits_, fFourMomenta_, fHitPhi_, fHitTheta_, fCutPassing_, fPrimaryPhotons_,\
+                             fEdep_, fEdep_, fLastHit_.runID, fDecayType_);
+    delete fEvent_;
+    fEvent_ = event;
+    fTree_->Fill();
+    fEvents_++;
+    fEmissionPoints_.clear();
+    fHits_.clear();
+    fFourMomenta_.clear();
+    fPrimaryPhotons_.clear();
+    fCutPassing_.clear();
+    fEdep_.clear();
+    fHitPhi_.clear();
+    fHitTheta_.clear();
+}
@@ -0,0 +1,51 @@
+/// @file JPOSEventWriter.h
+/// @author Rafal Maselek <rafalmaselek@gmail.com>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// Class that builds jpos events from a stream of GATE hits grouped by event and writes them to a tree.
+///
+#ifndef JPOSEventWriter_h
+#define JPOSEventWriter_h
+
+#include <TTree.h>
+#include <TLorentzVector.h>
+#include <vector>
+#include "GateHit.h"
+#include "event.h"
+
+///
+/// \brief The JPOSEventWriter class Collects hits of the current event and fills the tree with it, when a hit of another
+/// event arrives. Only one event is kept in memory, so hits of every event have to be contiguous in the stream.
+///
+class JPOSEventWriter
+{
+    public:
+        JPOSEventWriter(TTree* tree, int decayType);
+        ~JPOSEventWriter();
+        JPOSEventWriter(const JPOSEventWriter&) = delete;
+        JPOSEventWriter& operator=(const JPOSEventWriter&) = delete;
+        void Add(const GateHit& hit);
+        void Finish();
+        inline Long64_t GetNumberOfEvents() const {return fEvents_;}
+
+    private:
+        void Flush_();
+
+        TTree* fTree_; //output tree
+        Event* fEvent_; //address of the branch
+        int fDecayType_; //type of decay stored in events
+        Long64_t fEvents_; //number of written events
+        GateHit fLastHit_; //last added hit, identifies the current event
+        std::vector<TLorentzVector> fEmissionPoints_;
+        std::vector<TLorentzVector> fFourMomenta_;
+        std::vector<TLorentzVector> fHits_;
+        std::vector<bool> fPrimaryPhotons_;
+        std::vector<bool> fCutPassing_;
+        std::vector<double> fEdep_;
+        std::vector<double> fHitPhi_;
+        std::vector<double> fHitTheta_;
+};
+
+#endif
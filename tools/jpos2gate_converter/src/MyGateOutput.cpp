@@ -8,84 +8,116 @@
 ///
 
 #include "MyGateOutput.h"
-#include <math.h>       /* atan2 */
-#include <iostream>
+#include <cstring>
+
 ///
-/// \brief MyGateOutput::Loop Function that loop over data and fills fields of the MyGateOutput class.
+/// \brief MyGateOutput::MyGateOutput Connects the tree.
+/// \param tree Tree with GATE hits, if not provided the default file is opened.
 ///
-void MyGateOutput::Loop()
+MyGateOutput::MyGateOutput(TTree *tree) : GateOutput(tree), fEntries_(0), fEntry_(-1), fConversionBranches_(false)
 {
-	if (fChain == 0) return;
-
-   	Long64_t nentries = fChain->GetEntriesFast();
-   	entries = nentries;
-   	Long64_t nbytes = 0, nb = 0;
-
-        // define bufors and initial values
-   	std::vector<TLorentzVector> buforSource;
-   	std::vector<TLorentzVector> buforMomentum;
-   	std::vector<TLorentzVector> buforHits;
-   	std::vector<bool> buforPrimaries;
-   	std::vector<double> buforEdep;
-        std::vector<double> buforPhi;
-        std::vector<double> buforTheta;
-   	int lastEventID = -1;
-        events = 0;
-        // loop over entries in the ROOT tree in data
+    if (fChain == 0) return;
+    fEntries_ = fChain->GetEntries();
+}
 
-        std::cout<<"[LOADING DATA]"<<std::endl;
-   	for (Long64_t jentry=0; jentry<nentries;jentry++) 
-   	{
-            
-            Long64_t ientry = LoadTree(jentry);
-            if (ientry < 0) break;
-            nb = fChain->GetEntry(jentry);   nbytes += nb;
-            // if (Cut(ientry) < 0) continue;
-            if(jentry==0) lastEventID=eventID;
-            if(!(strcmp("Compton", processName) == 0 || strcmp("compt", processName) == 0))
-                    continue;
+///
+/// \brief MyGateOutput::IsSorted Checks if Compton hits are ordered by run and event, so hits of every event are contiguous.
+/// Only runID, eventID and processName branches are read.
+/// \return True if hits can be grouped without sorting.
+///
+bool MyGateOutput::IsSorted()
+{
+    if (fChain == 0) return true;
+    const char* branches[] = {"runID", "eventID", "processName"};
+    SelectBranches_(branches, 3);
+    fConversionBranches_ = false;
+    bool first = true;
+    Int_t lastRunID = 0;
+    Int_t lastEventID = 0;
+    for (Long64_t jentry=0; jentry<fEntries_; jentry++)
+    {
+        if (LoadTree(jentry) < 0) break;
+        fChain->GetEntry(jentry);
+        if (!IsCompton_()) continue;
+        if (!first && (runID < lastRunID || (runID == lastRunID && eventID < lastEventID)))
+            return false;
+        first = false;
+        lastRunID = runID;
+        lastEventID = eventID;
+    }
+    return true;
+}
 
-//            std::cout<<((double)jentry/(double)nentries * 100.0 - (int)((double)jentry/(double)nentries * 100.0))<<std::endl;
-            // print progress to std::out
-            if( ((double)jentry/(double)nentries * 100.0 - (int)((double)jentry/(double)nentries * 100.0)) < 100.0/nentries)
-                std::cout<<"["<<jentry*100/nentries<<"\% LOADED]"<<std::endl;
+///
+/// \brief MyGateOutput::Next Reads entries until the next Compton hit.
+/// \param hit Filled with data of the hit.
+/// \return False if there are no more hits.
+///
+bool MyGateOutput::Next(GateHit& hit)
+{
+    if (fChain == 0) return false;
+    if (!fConversionBranches_)
+    {
+        const char* branches[] = {"runID", "eventID", "processName", "time", "edep", "posX", "posY", "posZ",\
+                                  "sourcePosX", "sourcePosY", "sourcePosZ", "nPhantomCompton", "nCrystalCompton"};
+        SelectBranches_(branches, 13);
+        fConversionBranches_ = true;
+    }
+    while (fEntry_+1 < fEntries_)
+    {
+        fEntry_++;
+        if (LoadTree(fEntry_) < 0) return false;
+        fChain->GetEntry(fEntry_);
+        if (!IsCompton_()) continue;
+        hit.runID = runID;
+        hit.eventID = eventID;
+        hit.order = fEntry_;
+        hit.time = time;
+        hit.edep = edep;
+        hit.sourcePos[0] = sourcePosX;
+        hit.sourcePos[1] = sourcePosY;
+        hit.sourcePos[2] = sourcePosZ;
+        hit.pos[0] = posX;
+        hit.pos[1] = posY;
+        hit.pos[2] = posZ;
+        hit.primary = (nPhantomCompton==0 && nCrystalCompton==0);
+        return true;
+    }
+    return false;
+}
 
-            // event ID changed or end of file, move data from bufors
-            if(eventID != lastEventID || jentry==nentries)
-            {
-                emissionPoints.push_back(buforSource);
-                fourMomenta.push_back(buforMomentum);
-                hits.push_back(buforHits);
-                primaryPhotons.push_back(buforPrimaries);
-                edepVec.push_back(buforEdep);
-                edepSmearVec.push_back(buforEdep);
-                hitTheta.push_back(buforTheta);
-                hitPhi.push_back(buforPhi);
+///
+/// \brief MyGateOutput::GetBytesRead Returns the number of bytes read from the input file so far.
+/// \return Number of bytes (compressed, as stored on disk).
+///
+Long64_t MyGateOutput::GetBytesRead() const
+{
+    if (fChain == 0 || fChain->GetCurrentFile() == 0) return 0;
+    return fChain->GetCurrentFile()->GetBytesRead();
+}
 
-                // clear content of bufors
-                buforSource.clear();
-                buforMomentum.clear();
-                buforHits.clear();
-                buforPrimaries.clear();
-                buforEdep.clear();
-                buforTheta.clear();
-                buforPhi.clear();
-                events++;
-            }
+///
+/// \brief MyGateOutput::IsCompton_ Checks if the current entry is a Compton hit, other hits are not converted.
+///
+bool MyGateOutput::IsCompton_() const
+{
+    return strcmp("Compton", processName) == 0 || strcmp("compt", processName) == 0;
+}
 
-            // add data to bufors
-            buforSource.push_back(TLorentzVector(sourcePosX, sourcePosY, sourcePosZ, 0.0));
-            buforHits.push_back(TLorentzVector(posX, posY, posZ, time));
-            buforMomentum.push_back(TLorentzVector(0.0, 0.0, 0.0, edep));
-            if(nPhantomCompton==0 && nCrystalCompton==0)
-                buforPrimaries.push_back(true);
-            else
-                buforPrimaries.push_back(false);
-            buforEdep.push_back(edep);
-            buforPhi.push_back(atan2(posY, posX));
-            buforTheta.push_back(atan(sqrt(posY*posY+posX*posX)/posZ));
-            ids.push_back(runID);
-            lastEventID = eventID;
-        }
-        std::cout<<"[DATA LOADED]"<<std::endl;
+///
+/// \brief MyGateOutput::SelectBranches_ Disables all branches except the given ones and puts them into a new TTreeCache.
+/// \param branches Names of branches to be read.
+/// \param noOfBranches Number of branches.
+///
+void MyGateOutput::SelectBranches_(const char* const* branches, int noOfBranches)
+{
+    fChain->SetCacheSize(0);
+    fChain->SetBranchStatus("*", 0);
+    fChain->SetCacheSize(kCacheSize);
+    for (int ii=0; ii<noOfBranches; ii++)
+    {
+        fChain->SetBranchStatus(branches[ii], 1);
+        fChain->AddBranchToCache(branches[ii], kTRUE);
+    }
+    fChain->StopCacheLearningPhase();
 }
@@ -12,26 +12,34 @@
 #include <TObject.h>
 #include <TLorentzVector.h>
 #include "GateOutput.h"
+#include "GateHit.h"
 
+///
+/// \brief The MyGateOutput class Streams Compton hits of a GATE Hits tree one at a time, so the memory used does not depend
+/// on the size of the input. Only branches needed for the conversion are read, with the read-ahead of TTreeCache.
+///
 class MyGateOutput : public GateOutput, public TObject
 {
    public:
-        long entries;
-        long events;
-        std::vector<std::vector<TLorentzVector> > emissionPoints;
-        std::vector<std::vector<TLorentzVector> > fourMomenta;
-        std::vector<std::vector<TLorentzVector> > hits;
-        std::vector<std::vector<bool> > primaryPhotons;
-        std::vector<std::vector<double> > edepVec;
-        std::vector<std::vector<double> > edepSmearVec;
-        std::vector<std::vector<double> > hitPhi;
-        std::vector<std::vector<double> >hitTheta;
-        std::vector<long> ids;
-
-        MyGateOutput(){}
+        MyGateOutput(TTree *tree=0);
         virtual ~MyGateOutput(){}
-        virtual void  Loop();
-        ClassDef(MyGateOutput, 1)
+        bool IsSorted();
+        bool Next(GateHit& hit);
+        inline Long64_t GetEntries() const {return fEntries_;}
+        inline Long64_t GetEntryNumber() const {return fEntry_;}
+        Long64_t GetBytesRead() const;
+
+        static const Long64_t kCacheSize = 100000000; //size of TTreeCache [B]
+
+   private:
+        bool IsCompton_() const;
+        void SelectBranches_(const char* const* branches, int noOfBranches);
+
+        Long64_t fEntries_; //! number of entries in the tree
+        Long64_t fEntry_; //! number of the current entry, -1 before the first one
+        bool fConversionBranches_; //! true if branches for the conversion are selected
+
+        ClassDef(MyGateOutput, 2)
         typedef TObject inherited;
 };
 
@@ -9,40 +9,46 @@
 ///
 #define MyJPOSOutput_cxx
 #include "MyJPOSOutput.h"
-#include <TH2.h>
-#include <TStyle.h>
-#include <TCanvas.h>
-#include <iostream>
-//#include <math.h>
 
-// Function that loads data from the input file and fills fields of MyJPOSOutput class.
-void MyJPOSOutput::Loop()
+///
+/// \brief MyJPOSOutput::MyJPOSOutput Connects the tree and enables TTreeCache for branches used in the conversion.
+/// \param tree Tree with JPOS events, if not provided the default file is opened.
+///
+MyJPOSOutput::MyJPOSOutput(TTree *tree) : JPOSOutput(tree), fEntries_(0), fEntry_(-1)
 {
     if (fChain == 0) return;
-
-    Long64_t nentries = fChain->GetEntriesFast();
-    entries = nentries;
-
-    Long64_t nbytes = 0, nb = 0;
-    std::cout<<"[LOADING DATA]"<<std::endl;
-    for (Long64_t jentry=0; jentry<nentries;jentry++)
+    fEntries_ = fChain->GetEntries();
+    // other branches are not read at all
+    const char* branches[] = {"fId", "fEmissionPoint_*", "fCutPassing_*", "fHitPoint_*", "fEdepSmear_*"};
+    fChain->SetBranchStatus("*", 0);
+    fChain->SetCacheSize(kCacheSize);
+    for(const char* branch : branches)
     {
-        Long64_t ientry = LoadTree(jentry);
-        if (ientry < 0) break;
-        nb = fChain->GetEntry(jentry);   nbytes += nb;
-        // if (Cut(ientry) < 0) continue;
-        if( (double)jentry/nentries * 100 - (int)((double)jentry/nentries * 100) < 100.0/nentries)
-            std::cout<<"["<<jentry*100/nentries<<"\% LOADED]"<<std::endl;
+        fChain->SetBranchStatus(branch, 1);
+        fChain->AddBranchToCache(branch, kTRUE);
+    }
+    fChain->StopCacheLearningPhase();
+}
 
-        EmissionPoint.push_back(fEmissionPoint_);
-        FourMomentum.push_back(fFourMomentum_);
-        CutPassing.push_back(fCutPassing_);
-        PassFlag.push_back(fPassFlag_);
-        PrimaryPhoton.push_back(fPrimaryPhoton_);
-        HitPoint.push_back(fHitPoint_);
-        Edep.push_back(fEdep_);
-        EdepSmear.push_back(fEdepSmear_);
-        Id.push_back(fId);
-   }
-   std::cout<<"[DATA LOADED]"<<std::endl;
+///
+/// \brief MyJPOSOutput::Next Reads the next entry, its data replace the data of the previous one.
+/// \return False if there are no more entries.
+///
+bool MyJPOSOutput::Next()
+{
+    if (fChain == 0 || fEntry_+1 >= fEntries_) return false;
+    fEntry_++;
+    if (LoadTree(fEntry_) < 0) return false;
+    fChain->GetEntry(fEntry_);
+    return true;
+}
+
+///
+/// \brief MyJPOSOutput::GetBytesRead Returns the number of bytes read from the input file so far.
+/// \return Number of bytes (compressed, as stored on disk).
+///
+Long64_t MyJPOSOutput::GetBytesRead() const
+{
+    if (fChain == 0 || fChain->GetCurrentFile() == 0) return 0;
+    return fChain->GetCurrentFile()->GetBytesRead();
 }
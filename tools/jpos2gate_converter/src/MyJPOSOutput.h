@@ -18,24 +18,30 @@
 #include "TObject.h"
 #include "JPOSOutput.h"
 
+///
+/// \brief The MyJPOSOutput class Streams entries of a JPOS tree one at a time, so the memory used does not depend on the size
+/// of the input. Only branches needed for the conversion are read, with the read-ahead of TTreeCache.
+///
 class MyJPOSOutput : JPOSOutput 
 {
     public:
-    	int entries;
+        MyJPOSOutput(TTree *tree=0);
+        inline virtual ~MyJPOSOutput(){}
+        bool Next();
+        inline Long64_t GetEntries() const {return fEntries_;}
+        inline Long64_t GetEntryNumber() const {return fEntry_;}
+        Long64_t GetBytesRead() const;
+        inline Long_t GetId() const {return fId;}
+        inline const std::vector<TLorentzVector>& GetEmissionPoint() const {return fEmissionPoint_;} //x, y, z, t(irrelevant) [mm and s]
+        inline const std::vector<bool>& GetCutPassing() const {return fCutPassing_;} //indicates if gamma failed passing through cuts
+        inline const std::vector<TLorentzVector>& GetHitPoint() const {return fHitPoint_;} //x, y, z, t [mm and mikro s]
+        inline const std::vector<double>& GetEdepSmear() const {return fEdepSmear_;} //deposited energy by gammas with experimental smearing
 
-        std::vector<std::vector<TLorentzVector> > EmissionPoint; //x, y, z, t(irrelevant) [mm and s]
-        std::vector<std::vector<TLorentzVector> > FourMomentum; //pX, pY, pZ, E [MeV/c and MeV]
-        std::vector<std::vector<bool> > CutPassing; //indicates if gamma failed passing through cuts
-        std::vector<bool> PassFlag; //if true, event can be reconstructed -- all necessary gammas passed through cuts
-        std::vector<std::vector<bool> > PrimaryPhoton; //true is photon is primary (not scattered)
-        std::vector<std::vector<TLorentzVector> > HitPoint; //x, y, z, t [mm and mikro s]
-        std::vector<std::vector<double> > Edep; //deposited energy by gammas
-        std::vector<std::vector<double> > EdepSmear; //deposited energy by gammas with experimental smearing
-        std::vector<int> Id;
+        static const Long64_t kCacheSize = 100000000; //size of TTreeCache [B]
 
-        inline MyJPOSOutput(TTree *tree=0) {}
-        inline virtual ~MyJPOSOutput(){}
-        virtual void     Loop();
+    private:
+        Long64_t fEntries_; //number of entries in the tree
+        Long64_t fEntry_; //number of the current entry, -1 before the first one
 };
 
 #endif
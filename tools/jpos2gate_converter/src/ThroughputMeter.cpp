@@ -0,0 +1,76 @@
+/// @file ThroughputMeter.cpp
+/// @author Rafal Maselek <rafalmaselek@gmail.com>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// Class that reports progress of a streaming conversion as the number of processed entries and the read throughput.
+///
+#include "ThroughputMeter.h"
+#include <iostream>
+#include <iomanip>
+
+///
+/// \brief ThroughputMeter::ThroughputMeter Starts measuring time.
+/// \param label Name of processed units, e.g. "ENTRIES".
+/// \param entries Total number of entries to be processed, 0 if unknown.
+/// \param interval Minimal time between two reports [s].
+///
+ThroughputMeter::ThroughputMeter(const std::string& label, Long64_t entries, double interval) :
+    fLabel_(label),
+    fEntries_(entries),
+    fInterval_(interval),
+    fLastReport_(0.0),
+    fStart_(std::chrono::steady_clock::now())
+{}
+
+///
+/// \brief ThroughputMeter::Update Prints the progress if enough time has passed since the last report.
+/// \param entries Number of entries processed so far.
+/// \param bytes Number of bytes read so far.
+///
+void ThroughputMeter::Update(Long64_t entries, Long64_t bytes)
+{
+    double seconds = Elapsed_();
+    if(seconds-fLastReport_ < fInterval_)
+        return;
+    fLastReport_ = seconds;
+    Print_(entries, bytes, seconds);
+}
+
+///
+/// \brief ThroughputMeter::Finish Prints the final report.
+/// \param entries Number of processed entries.
+/// \param bytes Number of read bytes.
+///
+void ThroughputMeter::Finish(Long64_t entries, Long64_t bytes)
+{
+    double seconds = Elapsed_();
+    std::cout<<"[DONE IN "<<std::fixed<<std::setprecision(1)<<seconds<<" s] ";
+    Print_(entries, bytes, seconds);
+}
+
+///
+/// \brief ThroughputMeter::Elapsed_ Calculates the time since the creation of the meter.
+/// \return Elapsed time [s].
+///
+double ThroughputMeter::Elapsed_() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now()-fStart_).count();
+}
+
+///
+/// \brief ThroughputMeter::Print_ Prints the number of processed entries and the mean throughput.
+/// \param entries Number of processed entries.
+/// \param bytes Number of read bytes.
+/// \param seconds Elapsed time [s].
+///
+void ThroughputMeter::Print_(Long64_t entries, Long64_t bytes, double seconds) const
+{
+    double megabytes = bytes/(1024.0*1024.0);
+    std::cout<<"["<<entries;
+    if(fEntries_ > 0)
+        std::cout<<"/"<<fEntries_;
+    std::cout<<" "<<fLabel_<<", "<<std::fixed<<std::setprecision(1)<<megabytes<<" MB READ, "\
+             <<(seconds > 0.0 ? megabytes/seconds : 0.0)<<" MB/s]"<<std::endl;
+}
@@ -0,0 +1,34 @@
+/// @file ThroughputMeter.h
+/// @author Rafal Maselek <rafalmaselek@gmail.com>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// Class that reports progress of a streaming conversion as the number of processed entries and the read throughput.
+///
+#ifndef ThroughputMeter_h
+#define ThroughputMeter_h
+
+#include <Rtypes.h>
+#include <chrono>
+#include <string>
+
+class ThroughputMeter
+{
+    public:
+        ThroughputMeter(const std::string& label, Long64_t entries, double interval=5.0);
+        void Update(Long64_t entries, Long64_t bytes);
+        void Finish(Long64_t entries, Long64_t bytes);
+
+    private:
+        double Elapsed_() const;
+        void Print_(Long64_t entries, Long64_t bytes, double seconds) const;
+
+        std::string fLabel_; //name of processed units, printed in reports
+        Long64_t fEntries_; //total number of entries, 0 if unknown
+        double fInterval_; //minimal time between two reports [s]
+        double fLastReport_; //time of the last report [s]
+        std::chrono::steady_clock::time_point fStart_; //time of the creation of the meter
+};
+
+#endif
@@ -9,11 +9,15 @@
 ///
 /// @section USAGE
 /// Use convert.py python script. 
-/// python convert.py [input file path] [output file name] [1 for jpos->gate conversion, 0 gate->jpos]
+/// python convert.py [input file path] [output file name] [1 for jpos->gate conversion, 0 gate->jpos] [optional: memory limit for sorting GATE hits in MB]
 
 #include "MyGateOutput.h"
 #include "MyJPOSOutput.h"
+#include "ThroughputMeter.h"
+#include "HitSorter.h"
+#include "JPOSEventWriter.h"
 #include "event.h"
+#include <TSystem.h>
 #include <iostream>
 ///
 /// \brief jpos2gate Converts root file generated by jpos into root file wich has the same format as Gate output.
@@ -59,9 +63,8 @@ void jpos2gate(TFile* file)
     char          comptVolName[5] = "NULL";
     char          RayleighVolName[5] = "NULL";
 
-    // create input object and load data
+    // create input object, entries are read one at a time while writing
     MyJPOSOutput my_jpos_out;
-    my_jpos_out.Loop();
 
     // assign branches
     file->cd();
@@ -104,48 +107,52 @@ void jpos2gate(TFile* file)
     Hits->Branch("RayleighVolName", &RayleighVolName,"RayleighVolName[5]/C");
 
     Hits->SetAutoSave(10e6);
-    // Writing data
-    std::cout<<"[SAVING DATA]"<<std::endl;
-    for(int eventNo = 0; eventNo<my_jpos_out.entries; eventNo++)
+    // Converting data entry by entry, memory usage does not depend on the size of the input
+    std::cout<<"[CONVERTING DATA]"<<std::endl;
+    ThroughputMeter meter("ENTRIES", my_jpos_out.GetEntries());
+    while(my_jpos_out.Next())
     {
+      const std::vector<bool>& cutPassing = my_jpos_out.GetCutPassing();
       for(int particleNo=0; particleNo<5; particleNo++)
       {
-        if(my_jpos_out.CutPassing[eventNo].size() > (unsigned long)particleNo && my_jpos_out.CutPassing[eventNo][particleNo])
+        if(cutPassing.size() > (unsigned long)particleNo && cutPassing[particleNo])
         {
-          time = my_jpos_out.EmissionPoint[eventNo][particleNo].T();
-          sourcePosX = my_jpos_out.EmissionPoint[eventNo][particleNo].X();
-          sourcePosY= my_jpos_out.EmissionPoint[eventNo][particleNo].Y();
-          sourcePosZ = my_jpos_out.EmissionPoint[eventNo][particleNo].Z();
-          posX = my_jpos_out.HitPoint[eventNo][particleNo].X();
-          posY = my_jpos_out.HitPoint[eventNo][particleNo].Y();
-          posZ = my_jpos_out.HitPoint[eventNo][particleNo].Z();
-          edep = my_jpos_out.EdepSmear[eventNo][particleNo];
+          const TLorentzVector& emissionPoint = my_jpos_out.GetEmissionPoint()[particleNo];
+          const TLorentzVector& hitPoint = my_jpos_out.GetHitPoint()[particleNo];
+          time = emissionPoint.T();
+          sourcePosX = emissionPoint.X();
+          sourcePosY= emissionPoint.Y();
+          sourcePosZ = emissionPoint.Z();
+          posX = hitPoint.X();
+          posY = hitPoint.Y();
+          posZ = hitPoint.Z();
+          edep = my_jpos_out.GetEdepSmear()[particleNo];
           if(edep<0.0) edep = 0.0;
-          eventID = my_jpos_out.Id[eventNo];
+          eventID = my_jpos_out.GetId();
           Hits->Fill();
-          if( (double)eventNo/my_jpos_out.entries * 100 - (int)((double)eventNo/my_jpos_out.entries * 100) < 100.0/my_jpos_out.entries)
-          {
-                std::cout<<"["<<eventNo*100/my_jpos_out.entries<<"\% SAVED]"<<std::endl;
-          }
         }
         else
           break;
-      }  	
+      }
+      meter.Update(my_jpos_out.GetEntryNumber()+1, my_jpos_out.GetBytesRead());
     }
    	Hits->Write();
+    meter.Finish(my_jpos_out.GetEntryNumber()+1, my_jpos_out.GetBytesRead());
     std::cout<<"[DATA SAVED]"<<std::endl;
 
 }
 
 ///
 /// \brief gate2jpos Function that converts a root file with Gate output to a root file with jpos-like output.
+/// Compton hits are grouped by run and event in bounded memory: sorted input is converted as it is read, otherwise hits are
+/// grouped by the external sort of HitSorter.
 /// \param file TFile* pointer to an object representing an output file.
+/// \param memoryLimit Maximal size of hits kept in memory while sorting [MB].
 ///
-void gate2jpos(TFile* file)
+void gate2jpos(TFile* file, double memoryLimit)
 {  	
-    // creating input object and loading data
+    // creating input object, hits are read one at a time
     MyGateOutput mygate;
-    mygate.Loop();
     int decayType = 4;
 
     file->cd();
@@ -154,57 +161,81 @@ void gate2jpos(TFile* file)
 
     TTree* tree = new TTree("tree", "tree");
     tree->SetAutoSave(10e6);
+    JPOSEventWriter writer(tree, decayType);
 
-    std::cout<<"[SAVING DATA]"<<std::endl;
-    for(int eventNo = 0; eventNo<mygate.events; eventNo++)
-    {      
-        std::vector<bool> cutPassing;
-        for(int ii=0; (unsigned int)ii<mygate.primaryPhotons[eventNo].size(); ii++)
+    ThroughputMeter meter("ENTRIES", mygate.GetEntries());
+    std::cout<<"[CHECKING ORDER OF HITS]"<<std::endl;
+    GateHit hit;
+    if(mygate.IsSorted())
+    {
+        std::cout<<"[CONVERTING DATA]"<<std::endl;
+        while(mygate.Next(hit))
         {
-            cutPassing.push_back(true);
+            writer.Add(hit);
+            meter.Update(mygate.GetEntryNumber()+1, mygate.GetBytesRead());
         }
-        // Saving data
-        Event event(mygate.emissionPoints[eventNo], mygate.hits[eventNo], mygate.fourMomenta[eventNo],\
-        mygate.hitPhi[eventNo], mygate.hitTheta[eventNo], cutPassing, mygate.primaryPhotons[eventNo],\
-        mygate.edepVec[eventNo], mygate.edepSmearVec[eventNo], mygate.ids[eventNo], decayType);
-        tree->Branch("event_split", "Event", &event, 32000, 99);
-        tree->Fill();
-        if( (double)eventNo/mygate.events * 100 - (int)((double)eventNo/mygate.events * 100) < 100.0/mygate.events)
+    }
+    else
+    {
+        Long64_t maxHits = memoryLimit*1024*1024/sizeof(GateHit);
+        std::cout<<"[HITS ARE NOT SORTED, GROUPING WITH AT MOST "<<maxHits<<" HITS IN MEMORY]"<<std::endl;
+        HitSorter sorter(maxHits, gSystem->TempDirectory());
+        while(mygate.Next(hit))
         {
-            std::cout<<"["<<eventNo*100/mygate.events<<"\% SAVED]"<<std::endl;
+            sorter.Add(hit);
+            meter.Update(mygate.GetEntryNumber()+1, mygate.GetBytesRead());
         }
+        sorter.Finish();
+        std::cout<<"[MERGING "<<sorter.GetNumberOfRuns()<<" TEMPORARY FILES]"<<std::endl;
+        while(sorter.Next(hit))
+            writer.Add(hit);
     }
+    writer.Finish();
     tree->Write();
-    std::cout<<"[DATA SAVED]"<<std::endl;
+    meter.Finish(mygate.GetEntryNumber()+1, mygate.GetBytesRead());
+    std::cout<<"[DATA SAVED: "<<writer.GetNumberOfEvents()<<" EVENTS]"<<std::endl;
 }
 
 ///
 /// \brief main Main function of the program, launches gate2jpos or jpos2gate depending on the provided arguments.
 /// \param argc Number of provided arguments + 1 (name of the program).
 /// \param argv Array with provided arguments (argv[0] contains name of the program).
-/// \return nothing
+/// \return 0 on success, 1 if the conversion failed (the output file is then removed)
 ///
 int main (int argc, char* argv[])
 {
     char* out_file = "output.root";
     bool jpos_to_goja = true;
+    double memoryLimit = 1024.0;
 
     if(argc>1)
     {
         out_file = argv[1];
         jpos_to_goja = (bool)atoi(argv[2]);
     }
+    if(argc>3)
+        memoryLimit = atof(argv[3]);
 
     TFile* file = new TFile(out_file, "recreate");
-    if(jpos_to_goja)
-        jpos2gate(file);
-    else
-        gate2jpos(file);
-
-    if(file)
+    try
     {
-        file->Write();
+        if(jpos_to_goja)
+            jpos2gate(file);
+        else
+            gate2jpos(file, memoryLimit);
+    }
+    catch(const std::string& e)
+    {
+        std::cerr<<e<<std::endl;
+        // partial output is not written, the file is removed so it is not taken for a converted one
         file->Close();
         delete file;
+        gSystem->Unlink(out_file);
+        return 1;
     }
+
+    file->Write();
+    file->Close();
+    delete file;
+    return 0;
 }
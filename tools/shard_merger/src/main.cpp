@@ -0,0 +1,66 @@
+/// @file main.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// Merges output files of shards (processes simulating disjoint ranges of blocks of every run, see sim -s) into one file
+/// with the same structure as the output of a single process, see shardmerger.h.
+///
+/// @section USAGE
+/// ./merger [output file] [file of shard 0] [file of shard 1] ...
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "TFile.h"
+#include "shardmerger.h"
+
+///
+/// \brief main Main function of the program.
+/// \param argc Number of provided arguments + 1 (name of the program).
+/// \param argv Output file followed by files of shards, in the order of shard indices.
+/// \return 0 on success.
+///
+int main(int argc, char* argv[])
+{
+    if(argc<3)
+    {
+        std::cerr<<"[ERROR] Usage: ./merger [output file] [file of shard 0] [file of shard 1] ..."<<std::endl;
+        return 1;
+    }
+    std::vector<TFile*> files;
+    std::vector<TDirectory*> shards;
+    for(int ii=2; ii<argc; ii++)
+    {
+        TFile* file = TFile::Open(argv[ii], "read");
+        if(file==nullptr || file->IsZombie())
+        {
+            std::cerr<<"[ERROR] Cannot open file: "<<argv[ii]<<"!"<<std::endl;
+            return 1;
+        }
+        files.push_back(file);
+        shards.push_back(file);
+    }
+    TFile* output = new TFile(argv[1], "recreate");
+    int status = 0;
+    try
+    {
+        mergeDirectories(shards, output);
+        std::cout<<"[INFO] Merged "<<shards.size()<<" shards into: "<<argv[1]<<std::endl;
+    }
+    catch(std::string e)
+    {
+        std::cerr<<e<<std::endl;
+        status = 1;
+    }
+    output->Write();
+    output->Close();
+    delete output;
+    for(unsigned ii=0; ii<files.size(); ii++)
+    {
+        files[ii]->Close();
+        delete files[ii];
+    }
+    return status;
+}
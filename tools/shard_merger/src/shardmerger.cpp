@@ -0,0 +1,223 @@
+/// @file shardmerger.cpp
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// Merges output files of shards into one file with the same structure as the output of a single process. Trees are
+/// concatenated in the order of shards, histograms are summed, cut flows are drawn again from summed counts.
+
+#include <iostream>
+#include <set>
+#include "TKey.h"
+#include "TClass.h"
+#include "TTree.h"
+#include "TNamed.h"
+#include "TList.h"
+#include "../../../src/cutflow.h"
+#include "shardmerger.h"
+
+///
+/// \brief sumPads Adds histograms drawn on a pad of a shard to the corresponding histograms of the merged pad.
+/// Canvases of all shards are drawn by the same code, so their primitives are in the same order.
+/// \param merged Pad of the merged canvas.
+/// \param shard The same pad of a shard.
+///
+void sumPads(TPad* merged, TPad* shard)
+{
+    TIter nextMerged(merged->GetListOfPrimitives());
+    TIter nextShard(shard->GetListOfPrimitives());
+    TObject* mergedObject = nullptr;
+    while((mergedObject = nextMerged()))
+    {
+        TObject* shardObject = nextShard();
+        if(shardObject==nullptr || std::string(mergedObject->ClassName())!=shardObject->ClassName())
+            throw(std::string("[ERROR] Canvases of shards have different contents: ")+merged->GetName());
+        if(mergedObject->InheritsFrom(TPad::Class()))
+            sumPads(static_cast<TPad*>(mergedObject), static_cast<TPad*>(shardObject));
+        else if(mergedObject->InheritsFrom(TH1::Class()))
+            static_cast<TH1*>(mergedObject)->Add(static_cast<TH1*>(shardObject));
+    }
+}
+
+///
+/// \brief mergeStageTimes Averages times of stages [ns/event] of two profiles, weighted by numbers of their events.
+/// \param merged Times of stages of the already merged shards, entries are the number of events.
+/// \param shard Times of stages of the next shard.
+///
+void mergeStageTimes(TH1* merged, const TH1* shard)
+{
+    const double mergedEvents = merged->GetEntries();
+    const double shardEvents = shard->GetEntries();
+    if(mergedEvents+shardEvents<=0)
+        return;
+    for(int ii=1; ii<=merged->GetNbinsX(); ii++)
+    {
+        merged->SetBinContent(ii, (merged->GetBinContent(ii)*mergedEvents+shard->GetBinContent(ii)*shardEvents)\
+                              /(mergedEvents+shardEvents));
+    }
+    merged->SetEntries(mergedEvents+shardEvents);
+}
+
+///
+/// \brief findCutFlow Finds the histogram with percentages and the label with the percent of gammas/events that passed
+/// all cuts, drawn by InitialCuts::DrawCutsHistograms.
+/// \param canvas Canvas with the cut flow.
+/// \param pad Number of the pad: 1 for gammas, 2 for events.
+/// \param percent Set to the histogram, nullptr if not found.
+/// \param label Set to the label (the last text on the pad), nullptr if not found.
+///
+void findCutFlow(TPad* canvas, int pad, TH1*& percent, TText*& label)
+{
+    percent = nullptr;
+    label = nullptr;
+    TVirtualPad* subPad = canvas->GetPad(pad);
+    if(subPad==nullptr)
+        return;
+    TIter next(subPad->GetListOfPrimitives());
+    TObject* object = nullptr;
+    while((object = next()))
+    {
+        if(percent==nullptr && object->InheritsFrom(TH1::Class()))
+            percent = static_cast<TH1*>(object);
+        else if(object->InheritsFrom(TText::Class()))
+            label = static_cast<TText*>(object);
+    }
+}
+
+///
+/// \brief mergeCutsCanvas Draws the cut flow of merged shards. Percentages cannot be summed, so they are derived from
+/// the counts of all shards, in the same way as by a single process.
+/// \param merged Canvas with the cut flow of the first shard, it is modified.
+/// \param shards Directories of shards, containing counts written next to the canvas.
+/// \param type Type of decay as a string, prefix of names of the canvas and counts.
+///
+void mergeCutsCanvas(TPad* merged, const std::vector<TDirectory*>& shards, const std::string& type)
+{
+    for(int pad=1; pad<=2; pad++)
+    {
+        const std::string name = CutFlow::GetCountsName(type, pad==2);
+        TH1D* counts = nullptr;
+        for(unsigned ii=0; ii<shards.size(); ii++)
+        {
+            TH1D* shardCounts = nullptr;
+            shards[ii]->GetObject(name.c_str(), shardCounts);
+            if(shardCounts==nullptr)
+                throw(std::string("[ERROR] Counts ")+name+" not found in shard "+std::to_string(ii)+", cut flow cannot be merged!");
+            if(counts==nullptr)
+                counts = shardCounts;
+            else
+            {
+                counts->Add(shardCounts);
+                delete shardCounts;
+            }
+        }
+        TH1* drawn = nullptr;
+        TText* label = nullptr;
+        findCutFlow(merged, pad, drawn, label);
+        if(drawn==nullptr || label==nullptr)
+            throw(std::string("[ERROR] Cut flow not found on canvas: ")+merged->GetName());
+        TH1D* percent = CutFlow::MakePercent(counts, name);
+        for(int bin=0; bin<=drawn->GetNbinsX()+1; bin++)
+        {
+            drawn->SetBinContent(bin, percent->GetBinContent(bin));
+            drawn->SetBinError(bin, percent->GetBinError(bin));
+        }
+        drawn->SetEntries(percent->GetEntries());
+        label->SetTitle(CutFlow::GetPassedLabel(counts).c_str());
+        delete percent;
+        delete counts;
+    }
+}
+
+///
+/// \brief mergeDirectories Merges the same directory of all shards, subdirectories are merged recursively.
+/// \param shards Directories of shards, in the order of shard indices.
+/// \param output Directory of the merged file.
+///
+void mergeDirectories(const std::vector<TDirectory*>& shards, TDirectory* output)
+{
+    std::set<std::string> merged; //keys are listed for every cycle, only the last one is merged
+    TIter nextKey(shards[0]->GetListOfKeys());
+    TKey* key = nullptr;
+    while((key = static_cast<TKey*>(nextKey())))
+    {
+        const std::string name = key->GetName();
+        if(!merged.insert(name).second)
+            continue;
+        TClass* objectClass = TClass::GetClass(key->GetClassName());
+        if(objectClass==nullptr)
+        {
+            std::cout<<"[WARNING] Unknown class "<<key->GetClassName()<<" of object "<<name<<", skipping!"<<std::endl;
+            continue;
+        }
+        if(objectClass->InheritsFrom(TDirectory::Class()))
+        {
+            std::vector<TDirectory*> subDirs;
+            for(unsigned ii=0; ii<shards.size(); ii++)
+            {
+                subDirs.push_back(shards[ii]->GetDirectory(name.c_str()));
+                if(subDirs.back()==nullptr)
+                    throw(std::string("[ERROR] Directory ")+name+" not found in shard "+std::to_string(ii)+"!");
+            }
+            std::cout<<"[INFO] Merging directory: "<<subDirs[0]->GetPath()<<std::endl;
+            mergeDirectories(subDirs, output->mkdir(name.c_str()));
+            continue;
+        }
+        std::vector<TObject*> objects;
+        for(unsigned ii=0; ii<shards.size(); ii++)
+        {
+            objects.push_back(shards[ii]->Get(name.c_str()));
+            if(objects.back()==nullptr)
+                throw(std::string("[ERROR] Object ")+name+" not found in shard "+std::to_string(ii)+"!");
+        }
+        output->cd();
+        if(objectClass->InheritsFrom(TTree::Class()))
+        {
+            //events are copied without unpacking, in the order of shards
+            TTree* tree = static_cast<TTree*>(objects[0])->CloneTree(0);
+            tree->SetDirectory(output);
+            for(unsigned ii=0; ii<objects.size(); ii++)
+                tree->CopyEntries(static_cast<TTree*>(objects[ii]), -1, "fast");
+            tree->Write();
+            delete tree;
+        }
+        else
+        {
+            if(objectClass->InheritsFrom(TH1::Class()))
+            {
+                TH1* histogram = static_cast<TH1*>(objects[0]);
+                for(unsigned ii=1; ii<objects.size(); ii++)
+                {
+                    if(name.find("stageTimes_")==0)
+                        mergeStageTimes(histogram, static_cast<TH1*>(objects[ii]));
+                    else
+                        histogram->Add(static_cast<TH1*>(objects[ii]));
+                }
+            }
+            else if(objectClass->InheritsFrom(TPad::Class()))
+            {
+                const std::string cutsSuffix = "-gammas_cuts_passed";
+                if(name.size()>cutsSuffix.size() && name.compare(name.size()-cutsSuffix.size(), cutsSuffix.size(), cutsSuffix)==0)
+                    mergeCutsCanvas(static_cast<TPad*>(objects[0]), shards, name.substr(0, name.size()-cutsSuffix.size()));
+                else
+                {
+                    for(unsigned ii=1; ii<objects.size(); ii++)
+                        sumPads(static_cast<TPad*>(objects[0]), static_cast<TPad*>(objects[ii]));
+                }
+            }
+            else if(objectClass->InheritsFrom(TNamed::Class()))
+            {
+                //reports of profiles are joined
+                TNamed* named = static_cast<TNamed*>(objects[0]);
+                std::string title = std::string("Shard 0:\n")+named->GetTitle();
+                for(unsigned ii=1; ii<objects.size(); ii++)
+                    title += "Shard "+std::to_string(ii)+":\n"+static_cast<TNamed*>(objects[ii])->GetTitle();
+                named->SetTitle(title.c_str());
+            }
+            output->WriteTObject(objects[0]);
+        }
+        for(unsigned ii=0; ii<objects.size(); ii++)
+            delete objects[ii];
+    }
+}
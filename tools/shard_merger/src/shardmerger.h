@@ -0,0 +1,25 @@
+/// @file shardmerger.h
+/// @author Rafal Maselek <rafal.maselek@ncbj.gov.pl>
+/// @date 18.10.2026
+/// @version 1.0
+///
+/// @section DESCRIPTION
+/// Functions merging output files of shards (processes simulating disjoint ranges of blocks of every run, see sim -s) into
+/// one file with the same structure as the output of a single process.
+#ifndef SHARDMERGER_H
+#define SHARDMERGER_H
+
+#include <string>
+#include <vector>
+#include "TDirectory.h"
+#include "TH1.h"
+#include "TPad.h"
+#include "TText.h"
+
+void sumPads(TPad* merged, TPad* shard);
+void mergeStageTimes(TH1* merged, const TH1* shard);
+void findCutFlow(TPad* canvas, int pad, TH1*& percent, TText*& label);
+void mergeCutsCanvas(TPad* merged, const std::vector<TDirectory*>& shards, const std::string& type);
+void mergeDirectories(const std::vector<TDirectory*>& shards, TDirectory* output);
+
+#endif // SHARDMERGER_H